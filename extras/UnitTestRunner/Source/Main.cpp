@@ -47,6 +47,10 @@ int main (int argc, char* argv[])
 {
     ignoreUnused (argc, argv);
 
+    // Some of the tests use timers and shared caches, which need a MessageManager. This
+    // also deletes any singletons that they create before the leak detectors are checked.
+    ScopedJuceInitialiser_GUI libraryInitialiser;
+
     ScopedPointer<ConsoleLogger> logger;
     Logger::setCurrentLogger (logger);
 
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#if JUCE_UNIT_TESTS && JUCE_COMPILER_SUPPORTS_LAMBDAS
+
+class AudioBufferTests  : public UnitTest
+{
+public:
+    AudioBufferTests() : UnitTest ("AudioBuffer") {}
+
+    void runTest() override
+    {
+        ThreadPool pool (4);
+
+        beginTest ("parallelTransform");
+
+        {
+            AudioBuffer<float> buffer (3, 1000);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (channel, i, (float) i);
+
+            Atomic<int> numCalls, numBadCalls;
+
+            parallelTransform (pool, buffer, [&] (int channel, float* samples, int startSample, int numSamples)
+            {
+                ++numCalls;
+
+                if (startSample != 0 || numSamples != buffer.getNumSamples()
+                     || samples != buffer.getReadPointer (channel))
+                    ++numBadCalls;
+
+                for (int i = 0; i < numSamples; ++i)
+                    samples[i] *= (float) (channel + 1);
+            });
+
+            // without a grain size, each channel is processed in one go
+            expectEquals (numCalls.get(), 3);
+            expectEquals (numBadCalls.get(), 0);
+
+            numCalls = 0;
+
+            parallelTransform (pool, buffer, [&] (int channel, float* samples, int startSample, int numSamples)
+            {
+                ++numCalls;
+
+                if (numSamples <= 0 || numSamples > 64 || startSample % 64 != 0
+                     || startSample + numSamples > buffer.getNumSamples()
+                     || samples != buffer.getReadPointer (channel, startSample))
+                    ++numBadCalls;
+
+                for (int i = 0; i < numSamples; ++i)
+                    samples[i] += 1.0f;
+            }, 64);
+
+            expectEquals (numCalls.get(), 3 * 16);
+            expectEquals (numBadCalls.get(), 0);
+
+            // every sample must have been processed exactly once by each pass
+            bool allOk = true;
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    allOk = allOk && buffer.getSample (channel, i) == (float) (i * (channel + 1) + 1);
+
+            expect (allOk);
+        }
+
+        {
+            // a cleared buffer must know that it has been written to
+            AudioBuffer<double> buffer (2, 100);
+            buffer.clear();
+
+            parallelTransform (pool, buffer, [] (int, double* samples, int, int numSamples)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    samples[i] = 0.5;
+            }, 10);
+
+            expect (! buffer.hasBeenCleared());
+            expectEquals (buffer.getSample (1, 99), 0.5);
+
+            AudioBuffer<double> empty (2, 0);
+            bool called = false;
+
+            parallelTransform (pool, empty, [&called] (int, double*, int, int) { called = true; });
+            expect (! called);
+        }
+    }
+};
+
+static AudioBufferTests audioBufferTests;
+
+#endif
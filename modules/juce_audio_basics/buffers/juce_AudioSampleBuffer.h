@@ -1069,5 +1069,58 @@ private:
 */
 typedef AudioBuffer<float> AudioSampleBuffer;
 
+#if JUCE_COMPILER_SUPPORTS_LAMBDAS || DOXYGEN
+//==============================================================================
+/**
+    Processes the channels of an AudioBuffer in parallel, using the threads in a ThreadPool
+    as well as the calling thread.
+
+    The function must have the signature:
+    @code
+    void (int channel, Type* samples, int startSample, int numSamples)
+    @endcode
+    ..and will be called concurrently for different channels, or for different blocks
+    of the same channel if a grain size is given. Each call gets a pointer to the first
+    sample that it should process.
+
+    @param pool         the pool whose threads should be used
+    @param buffer       the buffer to process
+    @param function     the function to call for each block
+    @param grainSize    the maximum number of samples to pass to each call, or zero to
+                        process each channel in a single call
+
+    @see parallelForRange
+*/
+template <typename Type, typename FunctionType>
+void parallelTransform (ThreadPool& pool, AudioBuffer<Type>& buffer,
+                        const FunctionType& function, int grainSize = 0)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples  = buffer.getNumSamples();
+
+    if (numChannels == 0 || numSamples == 0)
+        return;
+
+    if (grainSize <= 0 || grainSize > numSamples)
+        grainSize = numSamples;
+
+    const int blocksPerChannel = (numSamples + grainSize - 1) / grainSize;
+
+    // (get the write pointers here, so that the buffer's state is only touched on this thread)
+    Type* const* const channels = buffer.getArrayOfWritePointers();
+
+    parallelFor (pool, 0, numChannels * blocksPerChannel,
+                 [&function, channels, blocksPerChannel, numSamples, grainSize] (int block)
+                 {
+                     const int channel = block / blocksPerChannel;
+                     const int startSample = (block % blocksPerChannel) * grainSize;
+
+                     function (channel, channels[channel] + startSample,
+                               startSample, jmin (grainSize, numSamples - startSample));
+                 },
+                 1);
+}
+#endif
+
 
 #endif   // JUCE_AUDIOSAMPLEBUFFER_H_INCLUDED
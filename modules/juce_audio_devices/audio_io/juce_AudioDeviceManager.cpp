@@ -86,6 +86,239 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CallbackHandler)
 };
 
+//==============================================================================
+// Everything in here is written by the audio thread and read without locking by anyone
+// else, so individual values are consistent, but a snapshot may be mid-update.
+class AudioCallbackTimings
+{
+public:
+    AudioCallbackTimings() noexcept
+    {
+        reset();
+    }
+
+    enum
+    {
+        numHistogramBuckets = 64,
+        bucketsPerBlock = 32,
+        maxTimedClients = 16
+    };
+
+    void setBlockDuration (double ms) noexcept
+    {
+        blockMicros = jmax (0, roundToInt (ms * 1000.0));
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        numCallbacks = 0;
+        numDeadlineMisses = 0;
+        totalMicros = 0;
+        worstMicros = 0;
+        numXRuns = 0;
+        lastDeviceXRunCount = -1;
+
+        for (int i = 0; i < numHistogramBuckets; ++i)
+            histogram[i] = 0;
+
+        for (int i = 0; i < maxTimedClients; ++i)
+            clients[i].reset (nullptr);
+    }
+
+    // called with the callback lock held, after a client has been removed
+    void numClientsChanged (int numClients) noexcept
+    {
+        for (int i = jmax (0, numClients); i < maxTimedClients; ++i)
+            clients[i].reset (nullptr);
+    }
+
+    // called by the audio thread after each client's audioDeviceIOCallback()
+    void clientFinished (int index, AudioIODeviceCallback* callback, double msTaken) noexcept
+    {
+        if (isPositiveAndBelow (index, (int) maxTimedClients))
+        {
+            ClientCounters& c = clients[index];
+
+            if (c.callback.get() != callback) // (the callbacks have been rearranged)
+                c.reset (callback);
+
+            const int micros = roundToInt (msTaken * 1000.0);
+            ++c.numCalls;
+            c.totalMicros += micros;
+
+            if (micros > c.worstMicros.get())
+                c.worstMicros = micros;
+        }
+    }
+
+    // called by the audio thread at the end of each device callback - this returns true if
+    // the callback missed its deadline, or the device has reported any new xruns
+    bool callbackFinished (double msTaken, int deviceXRunCount) noexcept
+    {
+        const int micros = roundToInt (msTaken * 1000.0);
+        const int block = blockMicros.get();
+        bool problemDetected = false;
+
+        ++numCallbacks;
+        totalMicros += micros;
+
+        if (micros > worstMicros.get())
+            worstMicros = micros;
+
+        ++histogram [jmin ((int) numHistogramBuckets - 1, micros / getBucketMicros (block))];
+
+        if (block > 0 && micros > block)
+        {
+            ++numDeadlineMisses;
+            problemDetected = true;
+        }
+
+        if (deviceXRunCount >= 0)
+        {
+            const int last = lastDeviceXRunCount.get();
+
+            // (if the count has gone backwards, the device must have been re-opened)
+            const int newXRuns = (last < 0 || deviceXRunCount < last) ? deviceXRunCount
+                                                                      : deviceXRunCount - last;
+            if (newXRuns > 0)
+            {
+                numXRuns += newXRuns;
+                problemDetected = true;
+            }
+
+            lastDeviceXRunCount = deviceXRunCount;
+        }
+
+        return problemDetected;
+    }
+
+    AudioDeviceManager::CallbackStatistics getStatistics() const
+    {
+        AudioDeviceManager::CallbackStatistics s;
+        const int block = blockMicros.get();
+
+        s.numCallbacks      = numCallbacks.get();
+        s.numDeadlineMisses = numDeadlineMisses.get();
+        s.numXRuns          = lastDeviceXRunCount.get() < 0 ? -1 : numXRuns.get();
+        s.blockDurationMs   = block / 1000.0;
+        s.averageMs         = s.numCallbacks > 0 ? (totalMicros.get() / 1000.0) / (double) s.numCallbacks : 0.0;
+        s.worstCaseMs       = worstMicros.get() / 1000.0;
+        s.histogramBucketMs = getBucketMicros (block) / 1000.0;
+
+        s.histogram.ensureStorageAllocated (numHistogramBuckets);
+
+        for (int i = 0; i < numHistogramBuckets; ++i)
+            s.histogram.add (histogram[i].get());
+
+        for (int i = 0; i < maxTimedClients; ++i)
+        {
+            const ClientCounters& c = clients[i];
+
+            if (AudioIODeviceCallback* const callback = c.callback.get())
+            {
+                AudioDeviceManager::CallbackStatistics::ClientTiming t;
+                t.callback    = callback;
+                t.numCalls    = c.numCalls.get();
+                t.averageMs   = t.numCalls > 0 ? (c.totalMicros.get() / 1000.0) / (double) t.numCalls : 0.0;
+                t.worstCaseMs = c.worstMicros.get() / 1000.0;
+                s.clients.add (t);
+            }
+        }
+
+        return s;
+    }
+
+private:
+    struct ClientCounters
+    {
+        void reset (AudioIODeviceCallback* newCallback) noexcept
+        {
+            callback = newCallback;
+            numCalls = 0;
+            totalMicros = 0;
+            worstMicros = 0;
+        }
+
+        Atomic<AudioIODeviceCallback*> callback;
+        Atomic<int64> numCalls, totalMicros;
+        Atomic<int> worstMicros;
+    };
+
+    Atomic<int64> numCallbacks, numDeadlineMisses, totalMicros;
+    Atomic<int> worstMicros, blockMicros, numXRuns, lastDeviceXRunCount;
+    Atomic<int64> histogram [numHistogramBuckets];
+    ClientCounters clients [maxTimedClients];
+
+    // the histogram covers callbacks of up to two blocks long
+    static int getBucketMicros (int block) noexcept     { return block > 0 ? jmax (1, block / bucketsPerBlock) : 100; }
+
+    JUCE_DECLARE_NON_COPYABLE (AudioCallbackTimings)
+};
+
+//==============================================================================
+// Adds the listener notifications to the timings: they're delivered on the message thread,
+// so that a burst of problems in quick succession only gets reported once.
+class AudioDeviceManager::CallbackTelemetry  : public AudioCallbackTimings,
+                                               private AsyncUpdater
+{
+public:
+    CallbackTelemetry (AudioDeviceManager& adm) noexcept  : owner (adm) {}
+
+    ~CallbackTelemetry()
+    {
+        cancelPendingUpdate();
+    }
+
+    void callbackFinished (double msTaken, int deviceXRunCount) noexcept
+    {
+        if (AudioCallbackTimings::callbackFinished (msTaken, deviceXRunCount))
+            triggerAsyncUpdate();
+    }
+
+private:
+    AudioDeviceManager& owner;
+
+    void handleAsyncUpdate() override
+    {
+        owner.callbackStatisticsListeners.call (&CallbackStatisticsListener::audioCallbackProblemsDetected,
+                                                owner, getStatistics());
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CallbackTelemetry)
+};
+
+//==============================================================================
+AudioDeviceManager::CallbackStatistics::CallbackStatistics() noexcept
+    : numCallbacks (0), numDeadlineMisses (0), numXRuns (-1),
+      blockDurationMs (0), averageMs (0), worstCaseMs (0), histogramBucketMs (0)
+{
+}
+
+double AudioDeviceManager::CallbackStatistics::getPercentileMs (double proportion) const noexcept
+{
+    int64 total = 0;
+
+    for (int i = 0; i < histogram.size(); ++i)
+        total += histogram.getUnchecked (i);
+
+    if (total == 0)
+        return 0.0;
+
+    const double target = jlimit (0.0, 1.0, proportion) * (double) total;
+    int64 count = 0;
+
+    for (int i = 0; i < histogram.size() - 1; ++i)
+    {
+        count += histogram.getUnchecked (i);
+
+        if (count >= target)
+            return jmin (worstCaseMs, (i + 1) * histogramBucketMs);
+    }
+
+    return worstCaseMs;
+}
+
 //==============================================================================
 AudioDeviceManager::AudioDeviceManager()
     : numInputChansNeeded (0),
@@ -96,6 +329,7 @@ AudioDeviceManager::AudioDeviceManager()
       timeToCpuScale (0)
 {
     callbackHandler = new CallbackHandler (*this);
+    telemetry = new CallbackTelemetry (*this);
 }
 
 AudioDeviceManager::~AudioDeviceManager()
@@ -684,6 +918,7 @@ void AudioDeviceManager::removeAudioCallback (AudioIODeviceCallback* callbackToR
 
             needsDeinitialising = needsDeinitialising && callbacks.contains (callbackToRemove);
             callbacks.removeFirstMatchingValue (callbackToRemove);
+            telemetry->numClientsChanged (callbacks.size());
         }
 
         if (needsDeinitialising)
@@ -697,27 +932,34 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
                                                    int numOutputChannels,
                                                    int numSamples)
 {
+    JUCE_TRACE_SCOPE_IN ("audio", "AudioDeviceManager::audioDeviceIOCallback");
     const ScopedLock sl (audioCallbackLock);
 
     inputLevelMeter.updateLevel (inputChannelData, numInputChannels, numSamples);
     outputLevelMeter.updateLevel (const_cast<const float**> (outputChannelData), numOutputChannels, numSamples);
 
+    const double callbackStartTime = Time::getMillisecondCounterHiRes();
+
     if (callbacks.size() > 0)
     {
-        const double callbackStartTime = Time::getMillisecondCounterHiRes();
-
         tempBuffer.setSize (jmax (1, numOutputChannels), jmax (1, numSamples), false, false, true);
 
         callbacks.getUnchecked(0)->audioDeviceIOCallback (inputChannelData, numInputChannels,
                                                           outputChannelData, numOutputChannels, numSamples);
 
+        telemetry->clientFinished (0, callbacks.getUnchecked(0), Time::getMillisecondCounterHiRes() - callbackStartTime);
+
         float** const tempChans = tempBuffer.getArrayOfWritePointers();
 
         for (int i = callbacks.size(); --i > 0;)
         {
+            const double clientStartTime = Time::getMillisecondCounterHiRes();
+
             callbacks.getUnchecked(i)->audioDeviceIOCallback (inputChannelData, numInputChannels,
                                                               tempChans, numOutputChannels, numSamples);
 
+            telemetry->clientFinished (i, callbacks.getUnchecked(i), Time::getMillisecondCounterHiRes() - clientStartTime);
+
             for (int chan = 0; chan < numOutputChannels; ++chan)
             {
                 if (const float* const src = tempChans [chan])
@@ -750,6 +992,9 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
         if (testSoundPosition >= testSound->getNumSamples())
             testSound = nullptr;
     }
+
+    telemetry->callbackFinished (Time::getMillisecondCounterHiRes() - callbackStartTime,
+                                 currentAudioDevice != nullptr ? currentAudioDevice->getXRunCount() : -1);
 }
 
 void AudioDeviceManager::audioDeviceAboutToStartInt (AudioIODevice* const device)
@@ -763,6 +1008,11 @@ void AudioDeviceManager::audioDeviceAboutToStartInt (AudioIODevice* const device
     {
         const double msPerBlock = 1000.0 * blockSize / sampleRate;
         timeToCpuScale = (msPerBlock > 0.0) ? (1.0 / msPerBlock) : 0.0;
+        telemetry->setBlockDuration (msPerBlock);
+    }
+    else
+    {
+        telemetry->setBlockDuration (0);
     }
 
     {
@@ -797,6 +1047,26 @@ double AudioDeviceManager::getCpuUsage() const
     return jlimit (0.0, 1.0, timeToCpuScale * cpuUsageMs);
 }
 
+AudioDeviceManager::CallbackStatistics AudioDeviceManager::getCallbackStatistics() const
+{
+    return telemetry->getStatistics();
+}
+
+void AudioDeviceManager::resetCallbackStatistics()
+{
+    telemetry->reset();
+}
+
+void AudioDeviceManager::addCallbackStatisticsListener (CallbackStatisticsListener* listener)
+{
+    callbackStatisticsListeners.add (listener);
+}
+
+void AudioDeviceManager::removeCallbackStatisticsListener (CallbackStatisticsListener* listener)
+{
+    callbackStatisticsListeners.remove (listener);
+}
+
 //==============================================================================
 void AudioDeviceManager::setMidiInputEnabled (const String& name, const bool enabled)
 {
@@ -1002,3 +1272,257 @@ double AudioDeviceManager::getCurrentOutputLevel() const noexcept   { return out
 
 void AudioDeviceManager::enableInputLevelMeasurement  (bool enable) noexcept  { inputLevelMeter.setEnabled (enable); }
 void AudioDeviceManager::enableOutputLevelMeasurement (bool enable) noexcept  { outputLevelMeter.setEnabled (enable); }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioDeviceManagerTests  : public UnitTest
+{
+public:
+    AudioDeviceManagerTests() : UnitTest ("AudioDeviceManager callback statistics") {}
+
+    struct NullCallback  : public AudioIODeviceCallback
+    {
+        void audioDeviceIOCallback (const float**, int, float**, int, int) override {}
+        void audioDeviceAboutToStart (AudioIODevice*) override {}
+        void audioDeviceStopped() override {}
+    };
+
+    void runTest() override
+    {
+        beginTest ("Callback timings");
+        {
+            AudioCallbackTimings timings;
+            timings.setBlockDuration (10.0);
+
+            // 10ms blocks give histogram buckets of 312 microseconds
+            bool anyProblems = false;
+
+            for (int i = 0; i < 89; ++i)
+                anyProblems = timings.callbackFinished (1.1, -1) || anyProblems;
+
+            for (int i = 0; i < 9; ++i)
+                anyProblems = timings.callbackFinished (5.1, -1) || anyProblems;
+
+            // (taking exactly as long as the block still meets the deadline)
+            anyProblems = timings.callbackFinished (10.0, -1) || anyProblems;
+            expect (! anyProblems);
+            expect (timings.callbackFinished (15.0, -1));
+
+            const AudioDeviceManager::CallbackStatistics s (timings.getStatistics());
+            expectEquals (s.numCallbacks, (int64) 100);
+            expectEquals (s.numDeadlineMisses, (int64) 1);
+            expectEquals (s.numXRuns, -1);
+            expectEquals (s.blockDurationMs, 10.0);
+            expectEquals (s.histogramBucketMs, 0.312);
+            expectWithinAbsoluteError (s.averageMs, 1.688, 0.0001);
+            expectEquals (s.worstCaseMs, 15.0);
+
+            expectEquals (s.histogram[3], (int64) 89);
+            expectEquals (s.histogram[16], (int64) 9);
+            expectEquals (s.histogram[32], (int64) 1);
+            expectEquals (s.histogram[48], (int64) 1);
+
+            expectWithinAbsoluteError (s.getPercentileMs (0.5),  4 * 0.312, 0.0001);
+            expectWithinAbsoluteError (s.getPercentileMs (0.95), 17 * 0.312, 0.0001);
+            expectWithinAbsoluteError (s.getPercentileMs (0.99), 33 * 0.312, 0.0001);
+            expectEquals (s.getPercentileMs (1.0), 15.0);
+        }
+
+        beginTest ("Client timings and xruns");
+        {
+            AudioCallbackTimings timings;
+            NullCallback client1, client2;
+
+            timings.clientFinished (0, &client1, 1.0);
+            timings.clientFinished (1, &client2, 0.5);
+            timings.clientFinished (0, &client1, 3.0);
+            timings.clientFinished (1, &client2, 0.5);
+
+            AudioDeviceManager::CallbackStatistics s (timings.getStatistics());
+            expectEquals (s.clients.size(), 2);
+            expect (s.clients[0].callback == &client1);
+            expectEquals (s.clients[0].numCalls, (int64) 2);
+            expectEquals (s.clients[0].averageMs, 2.0);
+            expectEquals (s.clients[0].worstCaseMs, 3.0);
+            expectEquals (s.clients[1].averageMs, 0.5);
+
+            // when the clients get rearranged, their counts start again
+            timings.numClientsChanged (1);
+            timings.clientFinished (0, &client2, 0.25);
+            s = timings.getStatistics();
+            expectEquals (s.clients.size(), 1);
+            expect (s.clients[0].callback == &client2);
+            expectEquals (s.clients[0].numCalls, (int64) 1);
+
+            expect (! timings.callbackFinished (1.0, 0));
+            expectEquals (timings.getStatistics().numXRuns, 0);
+            expect (timings.callbackFinished (1.0, 3));
+            expect (! timings.callbackFinished (1.0, 3));
+            expectEquals (timings.getStatistics().numXRuns, 3);
+
+            // a count that goes backwards means that the device has been re-opened
+            expect (timings.callbackFinished (1.0, 1));
+            expectEquals (timings.getStatistics().numXRuns, 4);
+
+            timings.reset();
+            s = timings.getStatistics();
+            expectEquals (s.numCallbacks, (int64) 0);
+            expectEquals (s.numXRuns, -1);
+            expectEquals (s.worstCaseMs, 0.0);
+            expectEquals (s.clients.size(), 0);
+        }
+
+        beginTest ("The manager's statistics and listeners");
+        {
+            TestDeviceType* const type = new TestDeviceType();
+            AudioDeviceManager manager;
+            manager.addAudioDeviceType (type);
+
+            expectEquals (manager.initialise (0, 2, nullptr, false), String());
+            TestDevice* const device = type->lastDeviceCreated;
+            expect (device != nullptr && manager.getCurrentAudioDevice() == device);
+
+            NullCallback client;
+            manager.addAudioCallback (&client);
+
+            for (int i = 0; i < 5; ++i)
+                device->runCallback();
+
+            AudioDeviceManager::CallbackStatistics s (manager.getCallbackStatistics());
+            expectEquals (s.numCallbacks, (int64) 5);
+            expectEquals (s.blockDurationMs, 10.0);
+            expectEquals (s.numXRuns, 0);
+            expectEquals (s.clients.size(), 1);
+            expect (s.clients[0].callback == &client);
+
+           #if JUCE_MODAL_LOOPS_PERMITTED
+            TestListener listener;
+            manager.addCallbackStatisticsListener (&listener);
+
+            device->xRunCount = 2;
+            device->runCallback();
+            device->runCallback();
+
+            for (int i = 0; i < 50 && listener.numCalls == 0; ++i)
+                MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+            expectEquals (listener.numCalls, 1);
+            expectEquals (listener.lastNumXRuns, 2);
+            manager.removeCallbackStatisticsListener (&listener);
+           #endif
+
+            manager.resetCallbackStatistics();
+            s = manager.getCallbackStatistics();
+            expectEquals (s.numCallbacks, (int64) 0);
+            expectEquals (s.numXRuns, -1);
+
+            manager.removeAudioCallback (&client);
+        }
+    }
+
+private:
+    struct TestDevice  : public AudioIODevice
+    {
+        TestDevice() : AudioIODevice ("Test device", "Test"), callback (nullptr), xRunCount (0), isDeviceOpen (false) {}
+
+        StringArray getOutputChannelNames() override            { StringArray s; s.add ("1"); s.add ("2"); return s; }
+        StringArray getInputChannelNames() override             { return StringArray(); }
+        Array<double> getAvailableSampleRates() override        { Array<double> r; r.add (48000.0); return r; }
+        Array<int> getAvailableBufferSizes() override           { Array<int> b; b.add (480); return b; }
+        int getDefaultBufferSize() override                     { return 480; }
+
+        String open (const BigInteger&, const BigInteger& outputs, double, int) override
+        {
+            activeOutputs = outputs;
+            isDeviceOpen = true;
+            return String();
+        }
+
+        void close() override                                   { stop(); isDeviceOpen = false; }
+        bool isOpen() override                                  { return isDeviceOpen; }
+
+        void start (AudioIODeviceCallback* newCallback) override
+        {
+            newCallback->audioDeviceAboutToStart (this);
+            callback = newCallback;
+        }
+
+        void stop() override
+        {
+            if (AudioIODeviceCallback* const oldCallback = callback)
+            {
+                callback = nullptr;
+                oldCallback->audioDeviceStopped();
+            }
+        }
+
+        bool isPlaying() override                               { return callback != nullptr; }
+        String getLastError() override                          { return String(); }
+        int getCurrentBufferSizeSamples() override              { return 480; }
+        double getCurrentSampleRate() override                  { return 48000.0; }
+        int getCurrentBitDepth() override                       { return 32; }
+        BigInteger getActiveOutputChannels() const override     { return activeOutputs; }
+        BigInteger getActiveInputChannels() const override      { return BigInteger(); }
+        int getOutputLatencyInSamples() override                { return 0; }
+        int getInputLatencyInSamples() override                 { return 0; }
+        int getXRunCount() const noexcept override              { return xRunCount; }
+
+        void runCallback()
+        {
+            AudioSampleBuffer buffer (2, 480);
+            buffer.clear();
+            callback->audioDeviceIOCallback (nullptr, 0, buffer.getArrayOfWritePointers(), 2, 480);
+        }
+
+        AudioIODeviceCallback* callback;
+        int xRunCount;
+        bool isDeviceOpen;
+        BigInteger activeOutputs;
+    };
+
+    struct TestDeviceType  : public AudioIODeviceType
+    {
+        TestDeviceType() : AudioIODeviceType ("Test"), lastDeviceCreated (nullptr) {}
+
+        void scanForDevices() override {}
+
+        StringArray getDeviceNames (bool wantInputNames) const override
+        {
+            StringArray s;
+
+            if (! wantInputNames)
+                s.add ("Test device");
+
+            return s;
+        }
+
+        int getDefaultDeviceIndex (bool) const override                 { return 0; }
+        int getIndexOfDevice (AudioIODevice*, bool) const override      { return 0; }
+        bool hasSeparateInputsAndOutputs() const override               { return false; }
+
+        AudioIODevice* createDevice (const String& outputDeviceName, const String&) override
+        {
+            return outputDeviceName == "Test device" ? (lastDeviceCreated = new TestDevice()) : nullptr;
+        }
+
+        TestDevice* lastDeviceCreated;
+    };
+
+    struct TestListener  : public AudioDeviceManager::CallbackStatisticsListener
+    {
+        TestListener() : numCalls (0), lastNumXRuns (0) {}
+
+        void audioCallbackProblemsDetected (AudioDeviceManager&, const AudioDeviceManager::CallbackStatistics& s) override
+        {
+            ++numCalls;
+            lastNumXRuns = s.numXRuns;
+        }
+
+        int numCalls, lastNumXRuns;
+    };
+};
+
+static AudioDeviceManagerTests audioDeviceManagerTests;
+
+#endif
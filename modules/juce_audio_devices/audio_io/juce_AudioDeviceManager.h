@@ -307,6 +307,93 @@ public:
     */
     double getCpuUsage() const;
 
+    //==============================================================================
+    /** A snapshot of the timing of the audio callbacks.
+        @see getCallbackStatistics
+    */
+    struct JUCE_API  CallbackStatistics
+    {
+        CallbackStatistics() noexcept;
+
+        /** The number of device callbacks that have been timed. */
+        int64 numCallbacks;
+
+        /** The number of callbacks that took longer than the duration of the block they
+            were processing - unless the device has some spare buffering, each of these
+            will have caused a glitch.
+        */
+        int64 numDeadlineMisses;
+
+        /** The number of under- or over-runs that the device has reported, or -1 if the
+            device can't report them.
+            @see AudioIODevice::getXRunCount
+        */
+        int numXRuns;
+
+        /** The length of one block at the device's current sample rate and buffer size. */
+        double blockDurationMs;
+
+        /** The mean and longest durations of the callbacks. */
+        double averageMs, worstCaseMs;
+
+        /** A histogram of the callback durations. Each bucket is histogramBucketMs wide, and
+            the last one also counts any callbacks that were longer than that.
+        */
+        Array<int64> histogram;
+        double histogramBucketMs;
+
+        /** Uses the histogram to estimate the duration within which the given proportion
+            (0 to 1.0) of the callbacks completed, e.g. 0.99 for the 99th percentile.
+        */
+        double getPercentileMs (double proportion) const noexcept;
+
+        /** The time spent inside one of the registered AudioIODeviceCallback objects. */
+        struct ClientTiming
+        {
+            AudioIODeviceCallback* callback;
+            int64 numCalls;
+            double averageMs, worstCaseMs;
+        };
+
+        /** The timings of each registered callback, in the order that they were added. */
+        Array<ClientTiming> clients;
+    };
+
+    /** Returns the timing statistics that have been gathered since the current device
+        was started, or since resetCallbackStatistics() was last called.
+
+        The audio thread updates these without locking, so this is safe to poll
+        from a UI timer.
+    */
+    CallbackStatistics getCallbackStatistics() const;
+
+    /** Clears the statistics returned by getCallbackStatistics(). */
+    void resetCallbackStatistics();
+
+    /** Receives notifications when the audio callback runs into problems.
+        @see addCallbackStatisticsListener
+    */
+    class JUCE_API  CallbackStatisticsListener
+    {
+    public:
+        /** Destructor. */
+        virtual ~CallbackStatisticsListener() {}
+
+        /** Called on the message thread shortly after a callback has missed its deadline,
+            or the device has reported an under- or over-run.
+
+            A burst of problems that happen close together will be reported with a
+            single call.
+        */
+        virtual void audioCallbackProblemsDetected (AudioDeviceManager&, const CallbackStatistics&) = 0;
+    };
+
+    /** Registers a listener to be told about missed deadlines and xruns. */
+    void addCallbackStatisticsListener (CallbackStatisticsListener*);
+
+    /** Deregisters a listener that was added with addCallbackStatisticsListener(). */
+    void removeCallbackStatisticsListener (CallbackStatisticsListener*);
+
     //==============================================================================
     /** Enables or disables a midi input device.
 
@@ -492,6 +579,12 @@ private:
     friend struct ContainerDeletePolicy<CallbackHandler>;
     ScopedPointer<CallbackHandler> callbackHandler;
 
+    class CallbackTelemetry;
+    friend class CallbackTelemetry;
+    friend struct ContainerDeletePolicy<CallbackTelemetry>;
+    ScopedPointer<CallbackTelemetry> telemetry;
+    ListenerList<CallbackStatisticsListener> callbackStatisticsListeners;
+
     void audioDeviceIOCallbackInt (const float** inputChannelData, int totalNumInputChannels,
                                    float** outputChannelData, int totalNumOutputChannels, int numSamples);
     void audioDeviceAboutToStartInt (AudioIODevice*);
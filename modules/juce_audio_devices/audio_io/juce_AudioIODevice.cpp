@@ -32,6 +32,7 @@ AudioIODevice::~AudioIODevice() {}
 void AudioIODeviceCallback::audioDeviceError (const String&)    {}
 bool AudioIODevice::setAudioPreprocessingEnabled (bool)         { return false; }
 bool AudioIODevice::hasControlPanel() const                     { return false; }
+int  AudioIODevice::getXRunCount() const noexcept               { return -1; }
 
 bool AudioIODevice::showControlPanel()
 {
@@ -39,3 +40,37 @@ bool AudioIODevice::showControlPanel()
                      // their hasControlPanel() method.
     return false;
 }
+
+//==============================================================================
+struct AudioThreadRealtimeOptions
+{
+    AudioThreadRealtimeOptions()
+    {
+        // Real-time scheduling is opt-in, so by default the audio threads keep
+        // whatever policy and priority the devices have always given them.
+        options.policy = Thread::RealtimeOptions::unchanged;
+    }
+
+    static AudioThreadRealtimeOptions& getInstance()
+    {
+        static AudioThreadRealtimeOptions instance;
+        return instance;
+    }
+
+    SpinLock lock;
+    Thread::RealtimeOptions options;
+};
+
+void JUCE_CALLTYPE AudioIODevice::setRealtimeThreadOptions (const Thread::RealtimeOptions& newOptions)
+{
+    AudioThreadRealtimeOptions& o = AudioThreadRealtimeOptions::getInstance();
+    const SpinLock::ScopedLockType sl (o.lock);
+    o.options = newOptions;
+}
+
+Thread::RealtimeOptions JUCE_CALLTYPE AudioIODevice::getRealtimeThreadOptions()
+{
+    AudioThreadRealtimeOptions& o = AudioThreadRealtimeOptions::getInstance();
+    const SpinLock::ScopedLockType sl (o.lock);
+    return o.options;
+}
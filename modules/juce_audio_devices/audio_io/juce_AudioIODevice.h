@@ -295,6 +295,36 @@ public:
     */
     virtual bool setAudioPreprocessingEnabled (bool shouldBeEnabled);
 
+    /** Returns the number of under- or over-runs that the device has reported since
+        it was opened, or -1 if it can't report them.
+    */
+    virtual int getXRunCount() const noexcept;
+
+    //==============================================================================
+    /** Sets the real-time options that devices should apply to the threads on which
+        they make their audio callbacks.
+
+        This is currently used by the ALSA and JACK devices, and affects devices that
+        are started after it's called. The JACK server takes care of its own thread's
+        policy and priority, so for JACK only the affinity, stack and memory-locking
+        settings are used.
+
+        By default, the options leave the audio threads alone, so they're scheduled just
+        as they would be if this method didn't exist. If you want a real-time policy,
+        you need to ask for it, e.g.
+        @code
+        Thread::RealtimeOptions options;
+        options.policy = Thread::RealtimeOptions::firstInFirstOut;
+        options.priority = 9;
+        options.stackBytesToPrefault = 64 * 1024;
+        AudioIODevice::setRealtimeThreadOptions (options);
+        @endcode
+    */
+    static void JUCE_CALLTYPE setRealtimeThreadOptions (const Thread::RealtimeOptions& newOptions);
+
+    /** Returns the options that were set with setRealtimeThreadOptions(). */
+    static Thread::RealtimeOptions JUCE_CALLTYPE getRealtimeThreadOptions();
+
     //==============================================================================
 protected:
     /** Creates a device, setting its name and type member variables. */
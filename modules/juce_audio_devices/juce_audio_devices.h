@@ -99,6 +99,18 @@
  #define JUCE_ALSA 1
 #endif
 
+/** Config: JUCE_ALSA_MMAP
+    Makes ALSA devices transfer audio by converting it directly into and out of the
+    device's memory-mapped buffer, rather than copying it through snd_pcm_readi/writei.
+    The audio thread then waits for the devices with poll() and keeps the playback
+    buffer topped up by a fixed amount, which gives lower latency and works reliably
+    with smaller buffer sizes. Devices that can't be memory-mapped will fall back to
+    the read/write calls.
+*/
+#ifndef JUCE_ALSA_MMAP
+ #define JUCE_ALSA_MMAP 0
+#endif
+
 /** Config: JUCE_JACK
     Enables JACK audio devices (Linux only).
 */
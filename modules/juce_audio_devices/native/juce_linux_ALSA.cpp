@@ -148,14 +148,19 @@ static void silentErrorHandler (const char*, int, const char*, int, const char*,
 class ALSADevice
 {
 public:
-    ALSADevice (const String& devID, bool forInput)
+    ALSADevice (const String& devID, bool forInput, Atomic<int>& xrunCounter)
         : handle (nullptr),
           bitDepth (16),
           numChannelsRunning (0),
           latency (0),
           deviceID (devID),
           isInput (forInput),
-          isInterleaved (true)
+          isInterleaved (true),
+          isMmap (false),
+          numXRuns (xrunCounter),
+          numPollFds (0),
+          numBufferFrames (0),
+          numPlaybackFramesQueued (0)
     {
         JUCE_ALSA_LOG ("snd_pcm_open (" << deviceID.toUTF8().getAddress() << ", forInput=" << forInput << ")");
 
@@ -209,6 +214,21 @@ public:
             return false;
         }
 
+        isMmap = false;
+
+       #if JUCE_ALSA_MMAP
+        if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_MMAP_INTERLEAVED) >= 0)
+        {
+            isMmap = true;
+            isInterleaved = true;
+        }
+        else if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_MMAP_NONINTERLEAVED) >= 0)
+        {
+            isMmap = true;
+            isInterleaved = false;
+        }
+        else
+       #endif
         if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED) >= 0) // works better for plughw..
             isInterleaved = true;
         else if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_NONINTERLEAVED) >= 0)
@@ -243,7 +263,7 @@ public:
                                              (type & isFloatBit) != 0,
                                              (type & isLittleEndianBit) != 0,
                                              (type & onlyUseLower24Bits) != 0,
-                                             numChannels);
+                                             isInterleaved ? numChannels : 1);
                 break;
             }
         }
@@ -256,9 +276,12 @@ public:
         }
 
         int dir = 0;
-        unsigned int periods = 4;
         snd_pcm_uframes_t samplesPerPeriod = (snd_pcm_uframes_t) bufferSize;
 
+        // When memory-mapped, only a couple of periods are ever queued, so small periods can
+        // be given a longer buffer to absorb scheduling jitter without adding any latency
+        unsigned int periods = isMmap ? (unsigned int) jlimit (4, 16, 512 / jmax (1, bufferSize)) : 4;
+
         if (JUCE_ALSA_FAILED (snd_pcm_hw_params_set_rate_near (handle, hwParams, &sampleRate, 0))
             || JUCE_ALSA_FAILED (snd_pcm_hw_params_set_channels (handle, hwParams, (unsigned int ) numChannels))
             || JUCE_ALSA_FAILED (snd_pcm_hw_params_set_periods_near (handle, hwParams, &periods, &dir))
@@ -276,8 +299,36 @@ public:
         else
             latency = (int) frames * ((int) periods - 1); // (this is the method JACK uses to guess the latency..)
 
+        snd_pcm_uframes_t availMin = samplesPerPeriod;
+
+        if (isMmap)
+        {
+            snd_pcm_uframes_t bufferFrames = 0;
+
+            if (JUCE_ALSA_FAILED (snd_pcm_hw_params_get_buffer_size (hwParams, &bufferFrames)))
+                return false;
+
+            numBufferFrames = (int) bufferFrames;
+
+            if (isInput)
+            {
+                latency = bufferSize;
+            }
+            else
+            {
+                // The playback buffer is only ever topped up to a few periods rather than filled, so
+                // each write has to wait until there's room for it below that level. Otherwise, with
+                // nothing else to hold it back, the thread would run ahead by the whole buffer. A new
+                // block is then always written behind the rest of those periods, which is its latency.
+                numPlaybackFramesQueued = jmin (numBufferFrames, bufferSize * numPlaybackPeriodsQueued);
+                availMin = (snd_pcm_uframes_t) (numBufferFrames - numPlaybackFramesQueued + bufferSize);
+                latency = numPlaybackFramesQueued - bufferSize;
+            }
+        }
+
         JUCE_ALSA_LOG ("frames: " << (int) frames << ", periods: " << (int) periods
-                          << ", samplesPerPeriod: " << (int) samplesPerPeriod);
+                          << ", samplesPerPeriod: " << (int) samplesPerPeriod
+                          << ", availMin: " << (int) availMin);
 
         snd_pcm_sw_params_t* swParams;
         snd_pcm_sw_params_alloca (&swParams);
@@ -289,11 +340,21 @@ public:
             || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_silence_size (handle, swParams, boundary))
             || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_start_threshold (handle, swParams, samplesPerPeriod))
             || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_stop_threshold (handle, swParams, boundary))
+            || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_avail_min (handle, swParams, availMin))
             || JUCE_ALSA_FAILED (snd_pcm_sw_params (handle, swParams)))
         {
             return false;
         }
 
+        if (isMmap)
+        {
+            numPollFds = jmax (0, snd_pcm_poll_descriptors_count (handle));
+            pollFds.calloc ((size_t) numPollFds + 1);
+
+            if (numPollFds == 0 || JUCE_ALSA_FAILED (snd_pcm_poll_descriptors (handle, pollFds, (unsigned int) numPollFds)))
+                return false;
+        }
+
        #if JUCE_ALSA_LOGGING
         // enable this to dump the config of the devices that get opened
         snd_output_t* out;
@@ -308,12 +369,24 @@ public:
     }
 
     //==============================================================================
+    // A wrapper for snd_pcm_recover() which keeps count of the xruns it recovers from
+    int recover (int errorNum, bool silent)
+    {
+        if (errorNum == -EPIPE)
+            ++numXRuns;
+
+        return snd_pcm_recover (handle, errorNum, silent ? 1 : 0);
+    }
+
     bool writeToOutputDevice (AudioSampleBuffer& outputChannelBuffer, const int numSamples)
     {
         jassert (numChannelsRunning <= outputChannelBuffer.getNumChannels());
         float* const* const data = outputChannelBuffer.getArrayOfWritePointers();
         snd_pcm_sframes_t numDone = 0;
 
+        if (isMmap)
+            return waitAndTransferMappedFrames (data, numSamples);
+
         if (isInterleaved)
         {
             scratch.ensureSize ((size_t) ((int) sizeof (float) * numSamples * numChannelsRunning), false);
@@ -331,7 +404,7 @@ public:
             numDone = snd_pcm_writen (handle, (void**) data, (snd_pcm_uframes_t) numSamples);
         }
 
-        if (numDone < 0 && JUCE_ALSA_FAILED (snd_pcm_recover (handle, (int) numDone, 1 /* silent */)))
+        if (numDone < 0 && JUCE_ALSA_FAILED (recover ((int) numDone, true)))
             return false;
 
         if (numDone < numSamples)
@@ -345,6 +418,9 @@ public:
         jassert (numChannelsRunning <= inputChannelBuffer.getNumChannels());
         float* const* const data = inputChannelBuffer.getArrayOfWritePointers();
 
+        if (isMmap)
+            return waitAndTransferMappedFrames (data, numSamples);
+
         if (isInterleaved)
         {
             scratch.ensureSize ((size_t) ((int) sizeof (float) * numSamples * numChannelsRunning), false);
@@ -352,7 +428,7 @@ public:
 
             snd_pcm_sframes_t num = snd_pcm_readi (handle, scratch.getData(), (snd_pcm_uframes_t) numSamples);
 
-            if (num < 0 && JUCE_ALSA_FAILED (snd_pcm_recover (handle, (int) num, 1 /* silent */)))
+            if (num < 0 && JUCE_ALSA_FAILED (recover ((int) num, true)))
                 return false;
 
             if (num < numSamples)
@@ -365,7 +441,7 @@ public:
         {
             snd_pcm_sframes_t num = snd_pcm_readn (handle, (void**) data, (snd_pcm_uframes_t) numSamples);
 
-            if (num < 0 && JUCE_ALSA_FAILED (snd_pcm_recover (handle, (int) num, 1 /* silent */)))
+            if (num < 0 && JUCE_ALSA_FAILED (recover ((int) num, true)))
                 return false;
 
             if (num < numSamples)
@@ -378,6 +454,125 @@ public:
         return true;
     }
 
+    //==============================================================================
+    bool isMemoryMapped() const noexcept        { return isMmap; }
+
+    /** When memory-mapped, this is the number of periods that the audio thread keeps
+        queued in the playback buffer.
+    */
+    enum { numPlaybackPeriodsQueued = 2 };
+
+    /** Polls a memory-mapped device until the given number of frames can be transferred.
+        For playback, this also waits until they'll fit without taking the amount queued
+        above numPlaybackPeriodsQueued periods.
+        Returns 1 when they're ready, 0 if it timed out, or -1 if the device had stopped
+        because of an error, in which case it'll have been recovered, but needs restarting.
+    */
+    int waitForFrames (int numFrames, const int timeoutMs)
+    {
+        jassert (isMmap);
+
+        if (! isInput)
+            numFrames += numBufferFrames - numPlaybackFramesQueued;
+
+        for (;;)
+        {
+            const snd_pcm_sframes_t avail = snd_pcm_avail_update (handle);
+
+            if (avail < 0)
+            {
+                JUCE_ALSA_FAILED (recover ((int) avail, true));
+                return -1;
+            }
+
+            if (avail >= numFrames)
+                return 1;
+
+            const int numReady = poll (pollFds, (nfds_t) numPollFds, timeoutMs);
+
+            if (numReady == 0)
+                return 0;
+
+            if (numReady < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                return -1;
+            }
+
+            unsigned short revents = 0;
+
+            if (JUCE_ALSA_FAILED (snd_pcm_poll_descriptors_revents (handle, pollFds, (unsigned int) numPollFds, &revents)))
+                return -1;
+
+            if ((revents & (POLLERR | POLLNVAL)) != 0)
+            {
+                const snd_pcm_sframes_t state = snd_pcm_avail_update (handle);
+
+                if (state < 0)
+                    JUCE_ALSA_FAILED (recover ((int) state, true));
+
+                return -1;
+            }
+        }
+    }
+
+    /** Converts frames directly between the buffers and the device's memory-mapped area.
+        This never blocks, so waitForFrames() must already have said there's enough space.
+    */
+    bool transferMappedFrames (float* const* const data, const int numSamples)
+    {
+        jassert (isMmap);
+
+        for (int numDone = 0; numDone < numSamples;)
+        {
+            const snd_pcm_channel_area_t* areas = nullptr;
+            snd_pcm_uframes_t offset = 0, numFrames = (snd_pcm_uframes_t) (numSamples - numDone);
+
+            const int beginResult = snd_pcm_mmap_begin (handle, &areas, &offset, &numFrames);
+
+            if (beginResult < 0)
+            {
+                JUCE_ALSA_FAILED (recover (beginResult, true));
+                return false;
+            }
+
+            if (numFrames == 0)
+                return false;
+
+            for (int i = 0; i < numChannelsRunning; ++i)
+            {
+                const snd_pcm_channel_area_t& area = areas[i];
+
+                // (the converter assumes each channel's samples are evenly spaced in one of these two ways)
+                jassert (area.step == (unsigned int) (bitDepth * (isInterleaved ? numChannelsRunning : 1)));
+
+                char* const mappedData = static_cast<char*> (area.addr) + (area.first + area.step * offset) / 8;
+
+                if (isInput)
+                    converter->convertSamples (data[i] + numDone, 0, mappedData, 0, (int) numFrames);
+                else
+                    converter->convertSamples (mappedData, 0, data[i] + numDone, 0, (int) numFrames);
+            }
+
+            const snd_pcm_sframes_t numCommitted = snd_pcm_mmap_commit (handle, offset, numFrames);
+
+            if (numCommitted < 0)
+            {
+                JUCE_ALSA_FAILED (recover ((int) numCommitted, true));
+                return false;
+            }
+
+            if ((snd_pcm_uframes_t) numCommitted != numFrames)
+                return false;
+
+            numDone += (int) numFrames;
+        }
+
+        return true;
+    }
+
     //==============================================================================
     snd_pcm_t* handle;
     String error;
@@ -387,9 +582,35 @@ private:
     //==============================================================================
     String deviceID;
     const bool isInput;
-    bool isInterleaved;
+    bool isInterleaved, isMmap;
+    Atomic<int>& numXRuns;
     MemoryBlock scratch;
     ScopedPointer<AudioData::Converter> converter;
+    HeapBlock<pollfd> pollFds;
+    int numPollFds, numBufferFrames, numPlaybackFramesQueued;
+
+    // Gives memory-mapped devices the same blocking behaviour as snd_pcm_readi/writei, for
+    // when they're being driven by the normal read/write loop.
+    bool waitAndTransferMappedFrames (float* const* const data, const int numSamples)
+    {
+        for (int attempt = 0; attempt < 2; ++attempt)
+        {
+            // capture streams have to be started explicitly, including after they've been recovered
+            if (isInput && snd_pcm_state (handle) == SND_PCM_STATE_PREPARED
+                 && JUCE_ALSA_FAILED (snd_pcm_start (handle)))
+                return false;
+
+            const int result = waitForFrames (numSamples, 2000);
+
+            if (result > 0)
+                return transferMappedFrames (data, numSamples);
+
+            if (result == 0)
+                return false;
+        }
+
+        return false;
+    }
 
     //==============================================================================
     template <class SampleType>
@@ -483,6 +704,7 @@ public:
         close();
 
         error.clear();
+        numXRuns = 0;
         sampleRate = newSampleRate;
         bufferSize = newBufferSize;
 
@@ -530,7 +752,7 @@ public:
 
         if (outputChannelDataForCallback.size() > 0 && outputId.isNotEmpty())
         {
-            outputDevice = new ALSADevice (outputId, false);
+            outputDevice = new ALSADevice (outputId, false, numXRuns);
 
             if (outputDevice->error.isNotEmpty())
             {
@@ -554,7 +776,7 @@ public:
 
         if (inputChannelDataForCallback.size() > 0 && inputId.isNotEmpty())
         {
-            inputDevice = new ALSADevice (inputId, true);
+            inputDevice = new ALSADevice (inputId, true, numXRuns);
 
             if (inputDevice->error.isNotEmpty())
             {
@@ -592,6 +814,7 @@ public:
         if (outputDevice != nullptr && JUCE_ALSA_FAILED (snd_pcm_prepare (outputDevice->handle)))
             return;
 
+        setRealtimeOptions (AudioIODevice::getRealtimeThreadOptions());
         startThread (9);
 
         int count = 1000;
@@ -648,6 +871,15 @@ public:
 
     void run() override
     {
+        JUCE_ALSA_LOG ("audio thread scheduling: " << Thread::getCurrentThreadSchedulingDescription());
+
+        if ((inputDevice == nullptr || inputDevice->isMemoryMapped())
+             && (outputDevice == nullptr || outputDevice->isMemoryMapped()))
+        {
+            runMemoryMapped();
+            return;
+        }
+
         while (! threadShouldExit())
         {
             if (inputDevice != nullptr && inputDevice->handle != nullptr)
@@ -662,7 +894,7 @@ public:
                     snd_pcm_sframes_t avail = snd_pcm_avail_update (inputDevice->handle);
 
                     if (avail < 0)
-                        JUCE_ALSA_FAILED (snd_pcm_recover (inputDevice->handle, (int) avail, 0));
+                        JUCE_ALSA_FAILED (inputDevice->recover ((int) avail, false));
                 }
 
                 audioIoInProgress = true;
@@ -679,24 +911,7 @@ public:
             if (threadShouldExit())
                 break;
 
-            {
-                const ScopedLock sl (callbackLock);
-                ++numCallbacks;
-
-                if (callback != nullptr)
-                {
-                    callback->audioDeviceIOCallback (inputChannelDataForCallback.getRawDataPointer(),
-                                                     inputChannelDataForCallback.size(),
-                                                     outputChannelDataForCallback.getRawDataPointer(),
-                                                     outputChannelDataForCallback.size(),
-                                                     bufferSize);
-                }
-                else
-                {
-                    for (int i = 0; i < outputChannelDataForCallback.size(); ++i)
-                        zeromem (outputChannelDataForCallback[i], sizeof (float) * (size_t) bufferSize);
-                }
-            }
+            invokeCallback();
 
             if (outputDevice != nullptr && outputDevice->handle != nullptr)
             {
@@ -708,7 +923,7 @@ public:
                 snd_pcm_sframes_t avail = snd_pcm_avail_update (outputDevice->handle);
 
                 if (avail < 0)
-                    JUCE_ALSA_FAILED (snd_pcm_recover (outputDevice->handle, (int) avail, 0));
+                    JUCE_ALSA_FAILED (outputDevice->recover ((int) avail, false));
 
                 audioIoInProgress = true;
 
@@ -725,6 +940,150 @@ public:
         audioIoInProgress = false;
     }
 
+    // Used when all the devices are memory-mapped: rather than blocking in the transfer calls,
+    // this polls the devices and keeps a fixed number of periods queued for playback.
+    void runMemoryMapped()
+    {
+        if (! startMemoryMappedStreams())
+        {
+            JUCE_ALSA_LOG ("couldn't start the streams");
+            return;
+        }
+
+        while (! threadShouldExit())
+        {
+            if (inputDevice != nullptr)
+            {
+                if (! waitForMemoryMappedDevice (*inputDevice))
+                {
+                    if (threadShouldExit() || ! restartMemoryMappedStreams())
+                        break;
+
+                    continue;
+                }
+
+                if (! inputDevice->transferMappedFrames (inputChannelBuffer.getArrayOfWritePointers(), bufferSize))
+                {
+                    JUCE_ALSA_LOG ("Read failure");
+
+                    if (! restartMemoryMappedStreams())
+                        break;
+
+                    continue;
+                }
+            }
+
+            if (threadShouldExit())
+                break;
+
+            invokeCallback();
+
+            if (outputDevice != nullptr)
+            {
+                if (! waitForMemoryMappedDevice (*outputDevice))
+                {
+                    if (threadShouldExit() || ! restartMemoryMappedStreams())
+                        break;
+
+                    continue;
+                }
+
+                if (! outputDevice->transferMappedFrames (outputChannelBuffer.getArrayOfWritePointers(), bufferSize))
+                {
+                    JUCE_ALSA_LOG ("write failure");
+
+                    if (! restartMemoryMappedStreams())
+                        break;
+                }
+            }
+        }
+    }
+
+    bool waitForMemoryMappedDevice (ALSADevice& device)
+    {
+        // (polls in short steps so that the thread can be stopped promptly)
+        for (int i = 0; i < 20; ++i)
+        {
+            if (threadShouldExit())
+                return false;
+
+            const int result = device.waitForFrames (bufferSize, 100);
+
+            if (result != 0)
+                return result > 0;
+        }
+
+        JUCE_ALSA_LOG ("timed out waiting for the device");
+        return false;
+    }
+
+    bool startMemoryMappedStreams()
+    {
+        if (outputDevice != nullptr)
+        {
+            // Priming the playback buffer with silence will start it, and also the input
+            // if the two have been linked
+            outputChannelBuffer.clear();
+
+            for (int i = 0; i < ALSADevice::numPlaybackPeriodsQueued; ++i)
+                if (! outputDevice->transferMappedFrames (outputChannelBuffer.getArrayOfWritePointers(), bufferSize))
+                    return false;
+        }
+
+        if (inputDevice != nullptr && snd_pcm_state (inputDevice->handle) == SND_PCM_STATE_PREPARED)
+            return ! JUCE_ALSA_FAILED (snd_pcm_start (inputDevice->handle));
+
+        return true;
+    }
+
+    bool restartMemoryMappedStreams()
+    {
+        JUCE_ALSA_LOG ("restarting streams");
+
+        if (inputDevice != nullptr)
+        {
+            snd_pcm_drop (inputDevice->handle);
+
+            if (JUCE_ALSA_FAILED (snd_pcm_prepare (inputDevice->handle)))
+                return false;
+        }
+
+        if (outputDevice != nullptr)
+        {
+            snd_pcm_drop (outputDevice->handle);
+
+            if (JUCE_ALSA_FAILED (snd_pcm_prepare (outputDevice->handle)))
+                return false;
+        }
+
+        return startMemoryMappedStreams();
+    }
+
+    void invokeCallback()
+    {
+        const ScopedLock sl (callbackLock);
+        ++numCallbacks;
+
+        if (callback != nullptr)
+        {
+            callback->audioDeviceIOCallback (inputChannelDataForCallback.getRawDataPointer(),
+                                             inputChannelDataForCallback.size(),
+                                             outputChannelDataForCallback.getRawDataPointer(),
+                                             outputChannelDataForCallback.size(),
+                                             bufferSize);
+        }
+        else
+        {
+            for (int i = 0; i < outputChannelDataForCallback.size(); ++i)
+                zeromem (outputChannelDataForCallback[i], sizeof (float) * (size_t) bufferSize);
+        }
+    }
+
+    int getXRunCount() const noexcept
+    {
+        return numXRuns.get();
+    }
+
     int getBitDepth() const noexcept
     {
         if (outputDevice != nullptr)
@@ -752,6 +1111,7 @@ private:
     ScopedPointer<ALSADevice> outputDevice, inputDevice;
     int numCallbacks;
     bool audioIoInProgress;
+    Atomic<int> numXRuns;
 
     CriticalSection callbackLock;
 
@@ -888,6 +1248,7 @@ public:
     int getCurrentBufferSizeSamples() override       { return internal.bufferSize; }
     double getCurrentSampleRate() override           { return internal.sampleRate; }
     int getCurrentBitDepth() override                { return internal.getBitDepth(); }
+    int getXRunCount() const noexcept override       { return internal.getXRunCount(); }
 
     BigInteger getActiveOutputChannels() const override    { return internal.currentOutputChans; }
     BigInteger getActiveInputChannels() const override     { return internal.currentInputChans; }
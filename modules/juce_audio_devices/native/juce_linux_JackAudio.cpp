@@ -62,6 +62,8 @@ JUCE_DECL_JACK_FUNCTION (jack_nframes_t, jack_port_get_total_latency, (jack_clie
 JUCE_DECL_JACK_FUNCTION (jack_port_t* , jack_port_register, (jack_client_t* client, const char* port_name, const char* port_type, unsigned long flags, unsigned long buffer_size), (client, port_name, port_type, flags, buffer_size));
 JUCE_DECL_VOID_JACK_FUNCTION (jack_set_error_function, (void (*func)(const char*)), (func));
 JUCE_DECL_JACK_FUNCTION (int, jack_set_process_callback, (jack_client_t* client, JackProcessCallback process_callback, void* arg), (client, process_callback, arg));
+JUCE_DECL_JACK_FUNCTION (int, jack_set_thread_init_callback, (jack_client_t* client, JackThreadInitCallback thread_init_callback, void* arg), (client, thread_init_callback, arg));
+JUCE_DECL_JACK_FUNCTION (int, jack_set_xrun_callback, (jack_client_t* client, JackXRunCallback xrun_callback, void* arg), (client, xrun_callback, arg));
 JUCE_DECL_JACK_FUNCTION (const char**, jack_get_ports, (jack_client_t* client, const char* port_name_pattern, const char* type_name_pattern, unsigned long flags), (client, port_name_pattern, type_name_pattern, flags));
 JUCE_DECL_JACK_FUNCTION (int, jack_connect, (jack_client_t* client, const char* source_port, const char* destination_port), (client, source_port, destination_port));
 JUCE_DECL_JACK_FUNCTION (const char*, jack_port_name, (const jack_port_t* port), (port));
@@ -258,7 +260,10 @@ public:
         lastError.clear();
         close();
 
+        numXRuns = 0;
         juce::jack_set_process_callback (client, processCallback, this);
+        juce::jack_set_thread_init_callback (client, threadInitCallback, this);
+        juce::jack_set_xrun_callback (client, xrunCallback, this);
         juce::jack_set_port_connect_callback (client, portConnectCallback, this);
         juce::jack_on_shutdown (client, shutdownCallback, this);
         juce::jack_activate (client);
@@ -303,6 +308,7 @@ public:
         {
             juce::jack_deactivate (client);
             juce::jack_set_process_callback (client, processCallback, nullptr);
+            juce::jack_set_xrun_callback (client, xrunCallback, nullptr);
             juce::jack_set_port_connect_callback (client, portConnectCallback, nullptr);
             juce::jack_on_shutdown (client, shutdownCallback, nullptr);
         }
@@ -337,6 +343,7 @@ public:
     bool isOpen() override                           { return deviceIsOpen; }
     bool isPlaying() override                        { return callback != nullptr; }
     int getCurrentBitDepth() override                { return 32; }
+    int getXRunCount() const noexcept override       { return numXRuns.get(); }
     String getLastError() override                   { return lastError; }
 
     BigInteger getActiveOutputChannels() const override  { return activeOutputChannels; }
@@ -443,9 +450,24 @@ private:
             device->updateActivePorts();
     }
 
+    static int xrunCallback (void* callbackArgument)
+    {
+        if (JackAudioIODevice* device = static_cast<JackAudioIODevice*> (callbackArgument))
+            ++(device->numXRuns);
+
+        return 0;
+    }
+
     static void threadInitCallback (void* /* callbackArgument */)
     {
         JUCE_JACK_LOG ("JackAudioIODevice::initialise");
+
+        // the server has already given this thread its real-time policy and priority
+        Thread::RealtimeOptions options (AudioIODevice::getRealtimeThreadOptions());
+        options.policy = Thread::RealtimeOptions::unchanged;
+        Thread::setCurrentThreadRealtimeOptions (options);
+
+        JUCE_JACK_LOG ("audio thread scheduling: " + Thread::getCurrentThreadSchedulingDescription());
     }
 
     static void shutdownCallback (void* callbackArgument)
@@ -471,6 +493,7 @@ private:
     String lastError;
     AudioIODeviceCallback* callback;
     CriticalSection callbackLock;
+    Atomic<int> numXRuns;
 
     HeapBlock<float*> inChans, outChans;
     int totalNumberOfInputChannels;
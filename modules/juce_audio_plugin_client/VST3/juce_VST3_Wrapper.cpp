@@ -1863,8 +1863,14 @@ public:
                     else
                     {
                         const int index = getJuceIndexForVSTParamID (vstParamID);
+
                         if (isPositiveAndBelow (index, pluginInstance->getNumParameters()))
-                            pluginInstance->setParameter (index, static_cast<float> (value));
+                        {
+                            if (pluginInstance->wantsSampleAccurateParameterEvents())
+                                addParameterEvents (*paramQueue, index, static_cast<float> (value));
+                            else
+                                pluginInstance->setParameter (index, static_cast<float> (value));
+                        }
                     }
                 }
             }
@@ -2096,9 +2102,12 @@ private:
             const int numMidiEventsComingIn = midiBuffer.getNumEvents();
            #endif
 
+            ParameterEventBuffer& parameterEvents = pluginInstance->getParameterEvents();
+
             if (pluginInstance->isSuspended())
             {
                 buffer.clear();
+                parameterEvents.applyAllEvents (*pluginInstance);
             }
             else
             {
@@ -2106,12 +2115,23 @@ private:
                  && totalOutputChans == pluginInstance->getTotalNumOutputChannels())
                 {
                     if (isBypassed())
+                    {
+                        parameterEvents.applyAllEvents (*pluginInstance);
                         pluginInstance->processBlockBypassed (buffer, midiBuffer);
+                    }
                     else
+                    {
                         pluginInstance->processBlock (buffer, midiBuffer);
+                    }
+                }
+                else
+                {
+                    parameterEvents.applyAllEvents (*pluginInstance);
                 }
             }
 
+            parameterEvents.clear();
+
            #if JUCE_DEBUG && (! JucePlugin_ProducesMidiOutput)
             /*  This assertion is caused when you've added some events to the
                 midiMessages array in your processBlock() method, which usually means
@@ -2194,10 +2214,37 @@ private:
         return buffer.getWritePointer (channel);
     }
 
+    void addParameterEvents (Vst::IParamValueQueue& paramQueue, int parameterIndex, float finalValue)
+    {
+        ParameterEventBuffer& events = pluginInstance->getParameterEvents();
+        const Steinberg::int32 numPoints = paramQueue.getPointCount();
+
+        // If only some of the points would fit, the ones that were queued would be applied after
+        // any that had to be set straight away, and the block would end on a stale value. So when
+        // there's no room for all of them, the parameter just jumps to its final value instead.
+        if (numPoints > events.getCapacity() - events.getNumEvents())
+        {
+            pluginInstance->setParameter (parameterIndex, finalValue);
+            return;
+        }
+
+        for (Steinberg::int32 i = 0; i < numPoints; ++i)
+        {
+            Steinberg::int32 offsetSamples;
+            double value = 0.0;
+
+            if (paramQueue.getPoint (i, offsetSamples, value) == kResultTrue)
+                events.addEvent ((int) offsetSamples, parameterIndex, static_cast<float> (value));
+        }
+    }
+
     void preparePlugin (double sampleRate, int bufferSize)
     {
         AudioProcessor& p = getPluginInstance();
 
+        if (p.wantsSampleAccurateParameterEvents())
+            p.getParameterEvents().ensureCapacity (jmax (128, p.getNumParameters() * 4));
+
         p.setRateAndBufferSizeDetails (sampleRate, bufferSize);
         p.prepareToPlay (sampleRate, bufferSize);
     }
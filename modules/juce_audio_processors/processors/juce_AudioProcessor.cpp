@@ -59,6 +59,7 @@ void AudioProcessor::initialise (const BusesProperties& ioConfig)
     nonRealtime = false;
 
     processingPrecision = singlePrecision;
+    parameterEvents.ensureCapacity (128);
 
     const int numInputBuses  = ioConfig.inputLayouts.size();
     const int numOutputBuses = ioConfig.outputLayouts.size();
@@ -358,14 +359,12 @@ void AudioProcessor::setPlayHead (AudioPlayHead* const newPlayHead)
 
 void AudioProcessor::addListener (AudioProcessorListener* const newListener)
 {
-    const ScopedLock sl (listenerLock);
-    listeners.addIfNotAlreadyThere (newListener);
+    listeners.add (newListener);
 }
 
 void AudioProcessor::removeListener (AudioProcessorListener* const listenerToRemove)
 {
-    const ScopedLock sl (listenerLock);
-    listeners.removeFirstMatchingValue (listenerToRemove);
+    listeners.remove (listenerToRemove);
 }
 
 void AudioProcessor::setPlayConfigDetails (const int newNumIns,
@@ -456,19 +455,11 @@ void AudioProcessor::setParameterNotifyingHost (const int parameterIndex,
     sendParamChangeMessageToListeners (parameterIndex, newValue);
 }
 
-AudioProcessorListener* AudioProcessor::getListenerLocked (const int index) const noexcept
-{
-    const ScopedLock sl (listenerLock);
-    return listeners [index];
-}
-
 void AudioProcessor::sendParamChangeMessageToListeners (const int parameterIndex, const float newValue)
 {
     if (isPositiveAndBelow (parameterIndex, getNumParameters()))
     {
-        for (int i = listeners.size(); --i >= 0;)
-            if (AudioProcessorListener* l = getListenerLocked (i))
-                l->audioProcessorParameterChanged (this, parameterIndex, newValue);
+        listeners.call (&AudioProcessorListener::audioProcessorParameterChanged, this, parameterIndex, newValue);
     }
     else
     {
@@ -487,9 +478,7 @@ void AudioProcessor::beginParameterChangeGesture (int parameterIndex)
         changingParams.setBit (parameterIndex);
        #endif
 
-        for (int i = listeners.size(); --i >= 0;)
-            if (AudioProcessorListener* l = getListenerLocked (i))
-                l->audioProcessorParameterChangeGestureBegin (this, parameterIndex);
+        listeners.call (&AudioProcessorListener::audioProcessorParameterChangeGestureBegin, this, parameterIndex);
     }
     else
     {
@@ -509,9 +498,7 @@ void AudioProcessor::endParameterChangeGesture (int parameterIndex)
         changingParams.clearBit (parameterIndex);
        #endif
 
-        for (int i = listeners.size(); --i >= 0;)
-            if (AudioProcessorListener* l = getListenerLocked (i))
-                l->audioProcessorParameterChangeGestureEnd (this, parameterIndex);
+        listeners.call (&AudioProcessorListener::audioProcessorParameterChangeGestureEnd, this, parameterIndex);
     }
     else
     {
@@ -521,9 +508,7 @@ void AudioProcessor::endParameterChangeGesture (int parameterIndex)
 
 void AudioProcessor::updateHostDisplay()
 {
-    for (int i = listeners.size(); --i >= 0;)
-        if (AudioProcessorListener* l = getListenerLocked (i))
-            l->audioProcessorChanged (this);
+    listeners.call (&AudioProcessorListener::audioProcessorChanged, this);
 }
 
 const OwnedArray<AudioProcessorParameter>& AudioProcessor::getParameters() const noexcept
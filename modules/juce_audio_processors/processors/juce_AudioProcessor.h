@@ -814,6 +814,19 @@ public:
     /** Returns true if this is a midi effect plug-in and does no audio processing. */
     virtual bool isMidiEffect() const                           { return false; }
 
+    /** Returns true if the processor wants to receive parameter automation as timestamped
+        events via getParameterEvents().
+
+        If this returns false (the default), hosts will apply parameter changes by calling
+        setParameter() before processBlock(), possibly splitting the block into smaller
+        chunks to keep the automation timing accurate. If it returns true, the host will
+        leave the changes in the event buffer, and it's up to your processBlock() to apply
+        them, e.g. with a ParameterEventBuffer::SliceIterator.
+
+        @see getParameterEvents
+    */
+    virtual bool wantsSampleAccurateParameterEvents() const     { return false; }
+
     //==============================================================================
     /** This returns a critical section that will automatically be locked while the host
         is calling the processBlock() method.
@@ -863,6 +876,19 @@ public:
     */
     bool isSuspended() const noexcept                                   { return suspended; }
 
+    /** Returns the buffer of timestamped parameter changes for the block being processed.
+
+        A host fills this in before calling processBlock(), and clears it afterwards, so it's
+        only valid to read it from within your processBlock() method. The sample positions
+        of the events are relative to the start of the block.
+
+        Hosts should only add events to this from the audio thread. If you need more space
+        than the default, call ParameterEventBuffer::ensureCapacity() before processing starts.
+
+        @see wantsSampleAccurateParameterEvents, ParameterEventBuffer
+    */
+    ParameterEventBuffer& getParameterEvents() noexcept                 { return parameterEvents; }
+
     /** A plugin can override this to be told when it should reset any playing voices.
 
         The default implementation does nothing, but a host may call this to tell the
@@ -1224,10 +1250,17 @@ public:
     virtual void processorLayoutsChanged();
 
     //==============================================================================
-    /** Adds a listener that will be called when an aspect of this processor changes. */
+    /** Adds a listener that will be called when an aspect of this processor changes.
+
+        Parameter changes can be reported on the audio thread, so the listeners are called
+        without taking any locks. Adding or removing a listener waits for any calls that
+        are in progress on other threads to finish.
+    */
     virtual void addListener (AudioProcessorListener* newListener);
 
-    /** Removes a previously added listener. */
+    /** Removes a previously added listener.
+        Once this returns, the listener won't be called again by any thread.
+    */
     virtual void removeListener (AudioProcessorListener* listenerToRemove);
 
     //==============================================================================
@@ -1496,7 +1529,7 @@ private:
     void createBus (bool isInput, const BusProperties&);
 
     //==============================================================================
-    Array<AudioProcessorListener*> listeners;
+    RealtimeListenerList<AudioProcessorListener> listeners;
     Component::SafePointer<AudioProcessorEditor> activeEditor;
     double currentSampleRate;
     int blockSize, latencySamples;
@@ -1505,7 +1538,8 @@ private:
    #endif
     bool suspended, nonRealtime;
     ProcessingPrecision processingPrecision;
-    CriticalSection callbackLock, listenerLock;
+    CriticalSection callbackLock;
+    ParameterEventBuffer parameterEvents;
 
     friend class Bus;
     mutable OwnedArray<Bus> inputBuses, outputBuses;
@@ -1522,7 +1556,6 @@ private:
     BigInteger changingParams;
    #endif
 
-    AudioProcessorListener* getListenerLocked (int) const noexcept;
     void updateSpeakerFormatStrings();
     bool applyBusLayouts (const BusesLayout&);
     void audioIOChanged (bool busNumberChanged, bool channelNumChanged);
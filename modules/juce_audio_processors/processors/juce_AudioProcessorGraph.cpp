@@ -240,16 +240,21 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
     ProcessBufferOp (const AudioProcessorGraph::Node::Ptr& n,
                      const Array<int>& audioChannelsUsed,
                      const int totalNumChans,
-                     const int midiBuffer)
+                     const int midiBuffer,
+                     const int minParameterSliceSize)
         : node (n),
           processor (n->getProcessor()),
           audioChannelsToUse (audioChannelsUsed),
           totalChans (jmax (1, totalNumChans)),
-          midiBufferToUse (midiBuffer)
+          midiBufferToUse (midiBuffer),
+          minimumSliceSize (minParameterSliceSize)
     {
         audioChannels.floatVersion. calloc ((size_t) totalChans);
         audioChannels.doubleVersion.calloc ((size_t) totalChans);
 
+        sliceMidiIn.ensureSize (2048);
+        sliceMidiOut.ensureSize (2048);
+
         while (audioChannelsToUse.size() < totalChans)
             audioChannelsToUse.add (0);
     }
@@ -267,15 +272,53 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
         if (processor->isSuspended())
         {
             buffer.clear();
+
+            ParameterEventBuffer& events = processor->getParameterEvents();
+            events.applyAllEvents (*processor);
+            events.clear();
         }
         else
         {
             ScopedLock lock (processor->getCallbackLock());
 
-            callProcess (buffer, *sharedMidiBuffers.getUnchecked (midiBufferToUse));
+            ParameterEventBuffer& events = processor->getParameterEvents();
+            MidiBuffer& midiMessages = *sharedMidiBuffers.getUnchecked (midiBufferToUse);
+
+            if (events.isEmpty() || processor->wantsSampleAccurateParameterEvents())
+                callProcess (buffer, midiMessages);
+            else
+                processInSlices (channels.getData(), events, midiMessages, numSamples);
+
+            events.clear();
         }
     }
 
+    // Renders a processor that doesn't handle parameter events itself, by splitting
+    // the block at each event and applying the changes with setParameter().
+    template <typename FloatType>
+    void processInSlices (FloatType* const* channels, const ParameterEventBuffer& events,
+                          MidiBuffer& midiMessages, const int numSamples)
+    {
+        ParameterEventBuffer::SliceIterator slices (events, numSamples, minimumSliceSize);
+        int sliceStart, sliceLength;
+
+        sliceMidiOut.clear();
+
+        while (slices.getNextSlice (*processor, sliceStart, sliceLength))
+        {
+            AudioBuffer<FloatType> slice (channels, totalChans, sliceStart, sliceLength);
+
+            sliceMidiIn.clear();
+            sliceMidiIn.addEvents (midiMessages, sliceStart, sliceLength, -sliceStart);
+
+            callProcess (slice, sliceMidiIn);
+
+            sliceMidiOut.addEvents (sliceMidiIn, 0, sliceLength, sliceStart);
+        }
+
+        midiMessages.swapWith (sliceMidiOut);
+    }
+
     void callProcess (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
     {
         processor->processBlock (buffer, midiMessages);
@@ -306,8 +349,10 @@ private:
     Array<int> audioChannelsToUse;
     FloatAndDoubleComposition<HeapBlock<FloatPlaceholder*> > audioChannels;
     AudioBuffer<float> tempBuffer;
+    MidiBuffer sliceMidiIn, sliceMidiOut;
     const int totalChans;
     const int midiBufferToUse;
+    const int minimumSliceSize;
 
     JUCE_DECLARE_NON_COPYABLE (ProcessBufferOp)
 };
@@ -682,7 +727,8 @@ private:
             totalLatency = maxLatency;
 
         renderingOps.add (new ProcessBufferOp (&node, audioChannelsToUse,
-                                               totalChans, midiBufferToUse));
+                                               totalChans, midiBufferToUse,
+                                               graph.getMinimumParameterSliceSize()));
     }
 
     //==============================================================================
@@ -1037,7 +1083,7 @@ struct AudioProcessorGraph::AudioProcessorGraphBufferHelpers
 //==============================================================================
 AudioProcessorGraph::AudioProcessorGraph()
     : lastNodeId (0), audioBuffers (new AudioProcessorGraphBufferHelpers),
-      currentMidiInputBuffer (nullptr), isPrepared (false)
+      currentMidiInputBuffer (nullptr), minimumParameterSliceSize (16), isPrepared (false)
 {
 }
 
@@ -1295,6 +1341,17 @@ bool AudioProcessorGraph::removeIllegalConnections()
     return doneAnything;
 }
 
+void AudioProcessorGraph::setMinimumParameterSliceSize (const int numSamples)
+{
+    jassert (numSamples > 0);
+
+    if (minimumParameterSliceSize != numSamples)
+    {
+        minimumParameterSliceSize = jmax (1, numSamples);
+        triggerAsyncUpdate();
+    }
+}
+
 //==============================================================================
 static void deleteRenderOpArray (Array<void*>& ops)
 {
@@ -1469,11 +1526,14 @@ void AudioProcessorGraph::processAudio (AudioBuffer<FloatType>& buffer, MidiBuff
     currentMidiInputBuffer = &midiMessages;
     currentMidiOutputBuffer.clear();
 
+    JUCE_TRACE_SCOPE_IN ("audio", "AudioProcessorGraph::processBlock");
+
     for (int i = 0; i < renderingOps.size(); ++i)
     {
         GraphRenderingOps::AudioGraphRenderingOpBase* const op
             = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
 
+        JUCE_TRACE_SCOPE_IN ("audio", "AudioProcessorGraph rendering op");
         op->perform (renderingBuffers, midiBuffers, numSamples);
     }
 
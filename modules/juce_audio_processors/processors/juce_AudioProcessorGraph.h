@@ -256,6 +256,21 @@ public:
     */
     static const int midiChannelIndex;
 
+    //==============================================================================
+    /** Sets the smallest chunk size that the graph will use when splitting a block to
+        apply parameter events.
+
+        If a node's processor has events in its AudioProcessor::getParameterEvents() buffer
+        but doesn't handle them itself (see AudioProcessor::wantsSampleAccurateParameterEvents()),
+        the graph will split that node's processing into chunks at the event positions,
+        calling setParameter() before each one. Events that are closer together than this
+        size are applied together at the start of a chunk.
+    */
+    void setMinimumParameterSliceSize (int numSamples);
+
+    /** Returns the value set by setMinimumParameterSliceSize(). */
+    int getMinimumParameterSliceSize() const noexcept               { return minimumParameterSliceSize; }
+
 
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
@@ -392,6 +407,7 @@ private:
     MidiBuffer* currentMidiInputBuffer;
     MidiBuffer currentMidiOutputBuffer;
 
+    int minimumParameterSliceSize;
     bool isPrepared;
 
     void handleAsyncUpdate() override;
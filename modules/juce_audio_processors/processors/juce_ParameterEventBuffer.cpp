@@ -0,0 +1,330 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+ParameterEventBuffer::ParameterEventBuffer (int initialCapacity)
+    : numEvents (0), capacity (0)
+{
+    ensureCapacity (initialCapacity);
+}
+
+ParameterEventBuffer::~ParameterEventBuffer() {}
+
+void ParameterEventBuffer::ensureCapacity (int minNumEvents)
+{
+    if (minNumEvents > capacity)
+    {
+        events.realloc ((size_t) minNumEvents);
+        capacity = minNumEvents;
+    }
+}
+
+bool ParameterEventBuffer::addEvent (int samplePosition, int parameterIndex, float value) noexcept
+{
+    if (numEvents >= capacity)
+    {
+        // The buffer is full! Call ensureCapacity() with a bigger size before processing starts.
+        jassertfalse;
+        return false;
+    }
+
+    int insertIndex = numEvents;
+
+    while (insertIndex > 0 && events[insertIndex - 1].samplePosition > samplePosition)
+        --insertIndex;
+
+    if (insertIndex < numEvents)
+        memmove (events + insertIndex + 1, events + insertIndex, sizeof (Event) * (size_t) (numEvents - insertIndex));
+
+    Event& e = events[insertIndex];
+    e.samplePosition = samplePosition;
+    e.parameterIndex = parameterIndex;
+    e.value = value;
+
+    ++numEvents;
+    return true;
+}
+
+void ParameterEventBuffer::applyAllEvents (AudioProcessor& processor) const
+{
+    for (const Event* e = begin(); e != end(); ++e)
+        processor.setParameter (e->parameterIndex, e->value);
+}
+
+//==============================================================================
+ParameterEventBuffer::SliceIterator::SliceIterator (const ParameterEventBuffer& b, int numSamplesInBlock,
+                                                    int minimumSliceSize) noexcept
+    : buffer (b), numSamples (numSamplesInBlock), minSliceSize (jmax (1, minimumSliceSize)),
+      position (0), nextEvent (0)
+{
+}
+
+bool ParameterEventBuffer::SliceIterator::getNextSlice (int& sliceStart, int& sliceLength,
+                                                        int& firstEventIndex, int& numEventsToApply) noexcept
+{
+    if (position >= numSamples)
+        return false;
+
+    const int numEvents = buffer.getNumEvents();
+    const int earliestEnd = jmin (numSamples, position + minSliceSize);
+
+    firstEventIndex = nextEvent;
+
+    while (nextEvent < numEvents && buffer.getEvent (nextEvent).samplePosition < earliestEnd)
+        ++nextEvent;
+
+    int end = numSamples;
+
+    if (nextEvent < numEvents)
+        end = jmin (numSamples, buffer.getEvent (nextEvent).samplePosition);
+
+    // events that lie beyond the end of the block are applied in the last slice
+    if (end >= numSamples)
+        nextEvent = numEvents;
+
+    numEventsToApply = nextEvent - firstEventIndex;
+    sliceStart = position;
+    sliceLength = end - position;
+    position = end;
+    return true;
+}
+
+bool ParameterEventBuffer::SliceIterator::getNextSlice (AudioProcessor& processor, int& sliceStart, int& sliceLength)
+{
+    int firstEvent, numEventsToApply;
+
+    if (! getNextSlice (sliceStart, sliceLength, firstEvent, numEventsToApply))
+        return false;
+
+    for (int i = firstEvent; i < firstEvent + numEventsToApply; ++i)
+    {
+        const Event& e = buffer.getEvent (i);
+        processor.setParameter (e.parameterIndex, e.value);
+    }
+
+    return true;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParameterEventBufferTests  : public UnitTest
+{
+public:
+    ParameterEventBufferTests() : UnitTest ("ParameterEventBuffer") {}
+
+    // Logs the parameter changes it receives, and what each call to processBlock() was given
+    struct RecordingProcessor  : public AudioProcessor
+    {
+        const String getName() const override                           { return "test"; }
+        void prepareToPlay (double, int) override                       {}
+        void releaseResources() override                                {}
+        double getTailLengthSeconds() const override                    { return 0; }
+        bool acceptsMidi() const override                               { return true; }
+        bool producesMidi() const override                              { return true; }
+        AudioProcessorEditor* createEditor() override                   { return nullptr; }
+        bool hasEditor() const override                                 { return false; }
+        int getNumPrograms() override                                   { return 1; }
+        int getCurrentProgram() override                                { return 0; }
+        void setCurrentProgram (int) override                           {}
+        const String getProgramName (int) override                      { return String(); }
+        void changeProgramName (int, const String&) override            {}
+        void getStateInformation (MemoryBlock&) override                {}
+        void setStateInformation (const void*, int) override            {}
+
+        int getNumParameters() override                                 { return 2; }
+        float getParameter (int index) override                         { return values[index]; }
+
+        void setParameter (int index, float newValue) override
+        {
+            values[index] = newValue;
+            changes.add (String (index) + "=" + String (newValue));
+        }
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer& midi) override
+        {
+            String s;
+            s << buffer.getNumSamples() << " [" << values[0] << " " << values[1] << "] midi:";
+
+            MidiBuffer::Iterator i (midi);
+            MidiMessage m;
+            int position;
+
+            while (i.getNextEvent (m, position))
+                s << " " << position;
+
+            blocks.add (s);
+        }
+
+        float values[2] = { 0.0f, 0.0f };
+        StringArray changes, blocks;
+    };
+
+    static String getSlices (const ParameterEventBuffer& events, int numSamples, int minimumSliceSize)
+    {
+        ParameterEventBuffer::SliceIterator slices (events, numSamples, minimumSliceSize);
+        int start, length, firstEvent, numEvents;
+        StringArray result;
+
+        while (slices.getNextSlice (start, length, firstEvent, numEvents))
+            result.add (String (start) + "+" + String (length) + ":" + String (numEvents));
+
+        return result.joinIntoString (" ");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Events are sorted");
+        {
+            ParameterEventBuffer events (8);
+            expect (events.isEmpty());
+            expect (events.addEvent (10, 0, 0.1f));
+            expect (events.addEvent (5, 0, 0.2f));
+            expect (events.addEvent (10, 1, 0.3f));
+            expect (events.addEvent (0, 1, 0.4f));
+            expect (events.addEvent (7, 0, 0.5f));
+            expectEquals (events.getNumEvents(), 5);
+
+            String s;
+
+            for (const ParameterEventBuffer::Event* e = events.begin(); e != events.end(); ++e)
+                s << e->samplePosition << ":" << e->parameterIndex << " ";
+
+            // (events at the same position stay in the order they were added)
+            expectEquals (s, String ("0:1 5:0 7:0 10:0 10:1 "));
+
+            events.clear();
+            expect (events.isEmpty());
+            expectEquals (events.getCapacity(), 8);
+        }
+
+        beginTest ("Slices");
+        {
+            ParameterEventBuffer events (16);
+            expectEquals (getSlices (events, 100, 16), String ("0+100:0"));
+
+            events.addEvent (0, 0, 0.0f);
+            events.addEvent (99, 0, 0.0f);
+            expectEquals (getSlices (events, 100, 1), String ("0+99:1 99+1:1"));
+
+            // the events at 5 and 10 are too close to the first one, and the one at 52 is too
+            // close to the one at 50, so they're applied at the start of those slices, and
+            // anything beyond the end of the block is applied in the last one
+            events.addEvent (5, 1, 0.0f);
+            events.addEvent (10, 1, 0.0f);
+            events.addEvent (50, 0, 0.0f);
+            events.addEvent (52, 1, 0.0f);
+            events.addEvent (150, 1, 0.0f);
+            expectEquals (getSlices (events, 100, 16), String ("0+50:3 50+49:2 99+1:2"));
+            expectEquals (getSlices (events, 100, 1),  String ("0+5:1 5+5:1 10+40:1 50+2:1 52+47:1 99+1:2"));
+            expectEquals (getSlices (events, 10, 16),  String ("0+10:7"));
+        }
+
+        beginTest ("Applying events");
+        {
+            RecordingProcessor processor;
+            ParameterEventBuffer events (4);
+            events.addEvent (20, 0, 0.75f);
+            events.addEvent (10, 1, 0.5f);
+            events.addEvent (30, 1, 0.25f);
+
+            events.applyAllEvents (processor);
+            expectEquals (processor.changes.joinIntoString (" "), String ("1=0.5 0=0.75 1=0.25"));
+
+            processor.changes.clear();
+            ParameterEventBuffer::SliceIterator slices (events, 25, 1);
+            int start, length;
+
+            expect (slices.getNextSlice (processor, start, length));
+            expect (start == 0 && length == 10 && processor.changes.isEmpty());
+            expect (slices.getNextSlice (processor, start, length));
+            expect (start == 10 && length == 10 && processor.changes.joinIntoString (" ") == "1=0.5");
+            expect (slices.getNextSlice (processor, start, length));
+            expect (start == 20 && length == 5 && processor.changes.joinIntoString (" ") == "1=0.5 0=0.75 1=0.25");
+            expect (! slices.getNextSlice (processor, start, length));
+        }
+
+        beginTest ("A graph splits blocks and their MIDI at the events");
+        {
+            typedef AudioProcessorGraph::AudioGraphIOProcessor IOProcessor;
+
+            AudioProcessorGraph graph;
+            RecordingProcessor* const processor = new RecordingProcessor();
+
+            const uint32 midiIn  = graph.addNode (new IOProcessor (IOProcessor::midiInputNode))->nodeId;
+            const uint32 midiOut = graph.addNode (new IOProcessor (IOProcessor::midiOutputNode))->nodeId;
+            const uint32 node    = graph.addNode (processor)->nodeId;
+
+            expect (graph.addConnection (midiIn, AudioProcessorGraph::midiChannelIndex, node, AudioProcessorGraph::midiChannelIndex));
+            expect (graph.addConnection (node, AudioProcessorGraph::midiChannelIndex, midiOut, AudioProcessorGraph::midiChannelIndex));
+
+            graph.setMinimumParameterSliceSize (16);
+            graph.setPlayConfigDetails (2, 2, 44100.0, 100);
+            graph.prepareToPlay (44100.0, 100);
+
+            AudioBuffer<float> buffer (2, 100);
+            buffer.clear();
+
+            MidiBuffer midi;
+            const int midiPositions[] = { 0, 20, 49, 50, 60, 99 };
+
+            for (int i = 0; i < numElementsInArray (midiPositions); ++i)
+                midi.addEvent (MidiMessage::noteOn (1, 60 + i, 1.0f), midiPositions[i]);
+
+            ParameterEventBuffer& events = processor->getParameterEvents();
+            events.ensureCapacity (4);
+            events.addEvent (0, 0, 0.25f);
+            events.addEvent (55, 1, 0.75f);
+            events.addEvent (50, 0, 0.5f);
+
+            graph.processBlock (buffer, midi);
+
+            expectEquals (processor->blocks.joinIntoString (" | "),
+                          String ("50 [0.25 0] midi: 0 20 49 | 50 [0.5 0.75] midi: 0 10 49"));
+            expect (events.isEmpty());
+
+            // the MIDI that the processor passed through comes out at its original positions
+            String output;
+            MidiBuffer::Iterator i (midi);
+            MidiMessage m;
+            int position;
+
+            while (i.getNextEvent (m, position))
+                output << position << ":" << m.getNoteNumber() << " ";
+
+            expectEquals (output, String ("0:60 20:61 49:62 50:63 60:64 99:65 "));
+
+            // and without any events, the block isn't split
+            processor->blocks.clear();
+            graph.processBlock (buffer, midi);
+            expectEquals (processor->blocks.joinIntoString (" | "), String ("100 [0.5 0.75] midi: 0 20 49 50 60 99"));
+
+            graph.releaseResources();
+        }
+    }
+};
+
+static ParameterEventBufferTests parameterEventBufferTests;
+
+#endif
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef JUCE_PARAMETEREVENTBUFFER_H_INCLUDED
+#define JUCE_PARAMETEREVENTBUFFER_H_INCLUDED
+
+class AudioProcessor;
+
+//==============================================================================
+/**
+    Holds a sequence of timestamped parameter changes for a single audio block.
+
+    Each AudioProcessor has one of these, which a host fills in before calling
+    processBlock() so that the processor can apply automation at the exact sample
+    position at which it was recorded, rather than once per block.
+
+    The buffer has a fixed capacity which is allocated up-front with ensureCapacity(),
+    so adding and reading events is realtime-safe. The events are always kept sorted
+    by their sample position.
+
+    @see AudioProcessor::getParameterEvents, AudioProcessor::wantsSampleAccurateParameterEvents
+*/
+class JUCE_API  ParameterEventBuffer
+{
+public:
+    //==============================================================================
+    /** A single parameter change. */
+    struct Event
+    {
+        int samplePosition;     /**< The position of the change, relative to the start of the block. */
+        int parameterIndex;     /**< The index of the parameter, as used by AudioProcessor::setParameter(). */
+        float value;            /**< The new normalised (0 to 1) value of the parameter. */
+    };
+
+    //==============================================================================
+    /** Creates a buffer with space for the given number of events. */
+    explicit ParameterEventBuffer (int initialCapacity = 0);
+
+    /** Destructor. */
+    ~ParameterEventBuffer();
+
+    //==============================================================================
+    /** Makes sure there's enough space allocated for the given number of events.
+        This may allocate memory, so don't call it from the audio thread.
+    */
+    void ensureCapacity (int minNumEvents);
+
+    /** Returns the number of events that can be stored without the buffer overflowing. */
+    int getCapacity() const noexcept                                { return capacity; }
+
+    /** Removes all events from the buffer. */
+    void clear() noexcept                                           { numEvents = 0; }
+
+    /** Returns true if the buffer contains no events. */
+    bool isEmpty() const noexcept                                   { return numEvents == 0; }
+
+    /** Returns the number of events in the buffer. */
+    int getNumEvents() const noexcept                               { return numEvents; }
+
+    /** Returns one of the events, which are in order of sample position. */
+    const Event& getEvent (int index) const noexcept                { jassert (isPositiveAndBelow (index, numEvents)); return events[index]; }
+
+    /** Adds an event to the buffer, keeping the events sorted by sample position.
+
+        Events with the same sample position are kept in the order they were added.
+        This never allocates: if the buffer is full, the event is dropped and the method
+        returns false.
+    */
+    bool addEvent (int samplePosition, int parameterIndex, float value) noexcept;
+
+    /** Immediately calls AudioProcessor::setParameter() for all the events in the buffer, in order.
+        This is handy when a block isn't going to be rendered, but the parameter changes
+        mustn't be lost.
+    */
+    void applyAllEvents (AudioProcessor& processorToUpdate) const;
+
+    //==============================================================================
+    /** Returns a pointer to the first event. */
+    const Event* begin() const noexcept                             { return events; }
+
+    /** Returns a pointer to the event following the last one. */
+    const Event* end() const noexcept                               { return events + numEvents; }
+
+    //==============================================================================
+    /**
+        Splits an audio block into slices at the positions of the events in a buffer.
+
+        Use this in a processBlock() method (or in a host) to render a block in chunks,
+        applying each parameter change at the start of the chunk in which it occurs.
+
+        To avoid the overhead of rendering lots of tiny chunks when automation is dense,
+        a minimum slice size can be given. Any events that fall within a slice that's
+        shorter than this will be applied at the start of the slice instead.
+
+        E.g.
+        @code
+        ParameterEventBuffer::SliceIterator slices (getParameterEvents(), buffer.getNumSamples(), 16);
+        int start, num;
+
+        while (slices.getNextSlice (*this, start, num))
+            renderSection (buffer, start, num);
+        @endcode
+    */
+    class JUCE_API  SliceIterator
+    {
+    public:
+        /** Creates an iterator for a block of the given length. */
+        SliceIterator (const ParameterEventBuffer& events, int numSamplesInBlock,
+                       int minimumSliceSize = 1) noexcept;
+
+        /** Finds the next slice, and the range of events which should be applied before rendering it.
+            @returns false when the whole block has been covered
+        */
+        bool getNextSlice (int& sliceStart, int& sliceLength,
+                           int& firstEventIndex, int& numEventsToApply) noexcept;
+
+        /** Finds the next slice, and calls AudioProcessor::setParameter() for each of the
+            events which should be applied before rendering it.
+            @returns false when the whole block has been covered
+        */
+        bool getNextSlice (AudioProcessor& processorToUpdate, int& sliceStart, int& sliceLength);
+
+    private:
+        const ParameterEventBuffer& buffer;
+        const int numSamples, minSliceSize;
+        int position, nextEvent;
+
+        JUCE_DECLARE_NON_COPYABLE (SliceIterator)
+    };
+
+private:
+    //==============================================================================
+    HeapBlock<Event> events;
+    int numEvents, capacity;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterEventBuffer)
+};
+
+
+#endif   // JUCE_PARAMETEREVENTBUFFER_H_INCLUDED
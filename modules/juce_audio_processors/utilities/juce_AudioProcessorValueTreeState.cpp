@@ -36,10 +36,9 @@ struct AudioProcessorValueTreeState::Parameter   : public AudioProcessorParamete
         : AudioProcessorParameterWithID (parameterID, paramName, labelText),
           owner (s), valueToTextFunction (valueToText), textToValueFunction (textToValue),
           range (r), value (defaultVal), defaultValue (defaultVal),
-          listenersNeedCalling (true)
+          publishedValue (defaultVal), listenersNeedCalling (true)
     {
         state.addListener (this);
-        needsUpdate.set (1);
     }
 
     ~Parameter()
@@ -78,11 +77,12 @@ struct AudioProcessorValueTreeState::Parameter   : public AudioProcessorParamete
         if (value != newValue || listenersNeedCalling)
         {
             value = newValue;
+            owner.publishValue (*this, newValue);
 
             listeners.call (&AudioProcessorValueTreeState::Listener::parameterChanged, paramID, value);
             listenersNeedCalling = false;
 
-            needsUpdate.set (1);
+            owner.markParameterDirty (getParameterIndex());
         }
     }
 
@@ -146,12 +146,12 @@ struct AudioProcessorValueTreeState::Parameter   : public AudioProcessorParamete
 
     AudioProcessorValueTreeState& owner;
     ValueTree state;
-    ListenerList<AudioProcessorValueTreeState::Listener> listeners;
+    RealtimeListenerList<AudioProcessorValueTreeState::Listener> listeners;
     std::function<String (float)> valueToTextFunction;
     std::function<float (const String&)> textToValueFunction;
     NormalisableRange<float> range;
     float value, defaultValue;
-    Atomic<int> needsUpdate;
+    Atomic<float> publishedValue;
     bool listenersNeedCalling;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Parameter)
@@ -164,7 +164,8 @@ AudioProcessorValueTreeState::AudioProcessorValueTreeState (AudioProcessor& p, U
       valueType ("PARAM"),
       valuePropertyID ("value"),
       idPropertyID ("id"),
-      updatingConnections (false)
+      updatingConnections (false),
+      numDirtyFlagWords (0)
 {
     startTimerHz (10);
     state.addListener (this);
@@ -184,6 +185,22 @@ AudioProcessorParameter* AudioProcessorValueTreeState::createAndAddParameter (co
     Parameter* p = new Parameter (*this, paramID, paramName, labelText, r,
                                   defaultVal, valueToTextFunction, textToValueFunction);
     processor.addParameter (p);
+
+    const int index = p->getParameterIndex();
+    const int numWordsNeeded = (index >> 5) + 1;
+
+    if (numWordsNeeded > numDirtyFlagWords)
+    {
+        HeapBlock<Atomic<int> > newFlags ((size_t) numWordsNeeded, true);
+
+        for (int i = 0; i < numDirtyFlagWords; ++i)
+            newFlags[i].set (dirtyParameterFlags[i].get());
+
+        dirtyParameterFlags.swapWith (newFlags);
+        numDirtyFlagWords = numWordsNeeded;
+    }
+
+    markParameterDirty (index);
     return p;
 }
 
@@ -228,6 +245,141 @@ float* AudioProcessorValueTreeState::getRawParameterValue (StringRef paramID) co
     return nullptr;
 }
 
+int AudioProcessorValueTreeState::getParameterIndex (StringRef paramID) const noexcept
+{
+    if (Parameter* p = Parameter::getParameterForID (processor, paramID))
+        return p->getParameterIndex();
+
+    return -1;
+}
+
+//==============================================================================
+AudioProcessorValueTreeState::ParameterSnapshot::ParameterSnapshot()  : generation (-1) {}
+AudioProcessorValueTreeState::ParameterSnapshot::~ParameterSnapshot() {}
+
+void AudioProcessorValueTreeState::prepareSnapshot (ParameterSnapshot& snapshot, double sampleRate,
+                                                    double smoothingTimeSeconds) const
+{
+    const OwnedArray<AudioProcessorParameter>& params = processor.getParameters();
+    const int numParams = params.size();
+
+    snapshot.values.resize (numParams);
+    snapshot.newValues.resize (numParams);
+    snapshot.smoothers.resize (numParams);
+    snapshot.generation = -1;
+
+    // (this isn't the audio thread, so it can afford to wait for a moment without any writers)
+    while (! copyPublishedValues (snapshot))
+        Thread::yield();
+
+    for (int i = 0; i < numParams; ++i)
+    {
+        LinearSmoothedValue<float>& smoother = snapshot.smoothers.getReference (i);
+        smoother = LinearSmoothedValue<float> (snapshot.values.getUnchecked (i));
+        smoother.reset (sampleRate, smoothingTimeSeconds);
+    }
+}
+
+bool AudioProcessorValueTreeState::updateSnapshot (ParameterSnapshot& snapshot) const noexcept
+{
+    // You need to call prepareSnapshot() after adding all your parameters!
+    jassert (snapshot.values.size() == processor.getParameters().size());
+
+    if (valueGeneration.get() == snapshot.generation || ! copyPublishedValues (snapshot))
+        return false;
+
+    for (int i = snapshot.values.size(); --i >= 0;)
+        snapshot.smoothers.getReference (i).setValue (snapshot.values.getUnchecked (i));
+
+    return true;
+}
+
+bool AudioProcessorValueTreeState::copyPublishedValues (ParameterSnapshot& snapshot) const noexcept
+{
+    const OwnedArray<AudioProcessorParameter>& params = processor.getParameters();
+    const int numParams = jmin (snapshot.newValues.size(), params.size());
+    float* const dest = snapshot.newValues.getRawDataPointer();
+
+    // This is the reading side of a sequence lock: the generation is odd while publishValue()
+    // is storing a value, so the copy is only kept if the generation was even before it started
+    // and is still the same afterwards. Rather than retrying, this gives up straight away, as
+    // a writer that's been pre-empted (or a host that's constantly automating things) could
+    // otherwise keep the audio thread waiting for as long as it likes.
+    const int startGeneration = valueGeneration.get();
+
+    if ((startGeneration & 1) != 0)
+        return false;
+
+    for (int i = 0; i < numParams; ++i)
+        dest[i] = static_cast<const Parameter*> (params.getUnchecked (i))->publishedValue.get();
+
+    if (valueGeneration.get() != startGeneration)
+        return false;
+
+    snapshot.values.swapWith (snapshot.newValues);
+    snapshot.generation = startGeneration;
+    return true;
+}
+
+//==============================================================================
+void AudioProcessorValueTreeState::publishValue (Parameter& p, float newValue) noexcept
+{
+    // The host and the message thread can both be setting values, so the writers take
+    // turns, and each one makes the generation odd for as long as its store is in progress.
+    const SpinLock::ScopedLockType sl (valueWriteLock);
+
+    ++valueGeneration;
+    p.publishedValue.set (newValue);
+    ++valueGeneration;
+}
+
+void AudioProcessorValueTreeState::markParameterDirty (int index) noexcept
+{
+    if (isPositiveAndBelow (index >> 5, numDirtyFlagWords))
+    {
+        Atomic<int>& flags = dirtyParameterFlags[index >> 5];
+        const int bit = 1 << (index & 31);
+
+        for (;;)
+        {
+            const int oldFlags = flags.get();
+
+            if ((oldFlags & bit) != 0 || flags.compareAndSetBool (oldFlags | bit, oldFlags))
+                break;
+        }
+    }
+}
+
+bool AudioProcessorValueTreeState::flushDirtyParameters()
+{
+    const OwnedArray<AudioProcessorParameter>& params = processor.getParameters();
+    bool anythingUpdated = false;
+
+    for (int word = 0; word < numDirtyFlagWords; ++word)
+    {
+        const int flags = dirtyParameterFlags[word].exchange (0);
+
+        if (flags == 0)
+            continue;
+
+        for (int bit = 0; bit < 32; ++bit)
+        {
+            if ((flags & (1 << bit)) != 0)
+            {
+                AudioProcessorParameter* const ap = params [(word << 5) + bit];
+                jassert (dynamic_cast<Parameter*> (ap) != nullptr);
+
+                if (ap != nullptr)
+                    static_cast<Parameter*> (ap)->copyValueToValueTree();
+            }
+        }
+
+        anythingUpdated = true;
+    }
+
+    return anythingUpdated;
+}
+
 ValueTree AudioProcessorValueTreeState::getOrCreateChildValueTree (const String& paramID)
 {
     ValueTree v (state.getChildWithProperty (idPropertyID, paramID));
@@ -290,25 +442,8 @@ void AudioProcessorValueTreeState::valueTreeParentChanged (ValueTree&) {}
 
 void AudioProcessorValueTreeState::timerCallback()
 {
-    const int numParams = processor.getParameters().size();
-    bool anythingUpdated = false;
-
-    for (int i = 0; i < numParams; ++i)
-    {
-        AudioProcessorParameter* const ap = processor.getParameters().getUnchecked(i);
-        jassert (dynamic_cast<Parameter*> (ap) != nullptr);
-
-        Parameter* p = static_cast<Parameter*> (ap);
-
-        if (p->needsUpdate.compareAndSetBool (0, 1))
-        {
-            p->copyValueToValueTree();
-            anythingUpdated = true;
-        }
-    }
-
-    startTimer (anythingUpdated ? 1000 / 50
-                                : jlimit (50, 500, getTimerInterval() + 20));
+    startTimer (flushDirtyParameters() ? 1000 / 50
+                                       : jlimit (50, 500, getTimerInterval() + 20));
 }
 
 AudioProcessorValueTreeState::Listener::Listener() {}
@@ -553,4 +688,176 @@ AudioProcessorValueTreeState::ButtonAttachment::ButtonAttachment (AudioProcessor
 
 AudioProcessorValueTreeState::ButtonAttachment::~ButtonAttachment() {}
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioProcessorValueTreeStateTests  : public UnitTest
+{
+public:
+    AudioProcessorValueTreeStateTests() : UnitTest ("AudioProcessorValueTreeState") {}
+
+    struct TestProcessor  : public AudioProcessor
+    {
+        const String getName() const override                           { return "test"; }
+        void prepareToPlay (double, int) override                       {}
+        void releaseResources() override                                {}
+        void processBlock (AudioBuffer<float>&, MidiBuffer&) override   {}
+        double getTailLengthSeconds() const override                    { return 0; }
+        bool acceptsMidi() const override                               { return false; }
+        bool producesMidi() const override                              { return false; }
+        AudioProcessorEditor* createEditor() override                   { return nullptr; }
+        bool hasEditor() const override                                 { return false; }
+        int getNumPrograms() override                                   { return 1; }
+        int getCurrentProgram() override                                { return 0; }
+        void setCurrentProgram (int) override                           {}
+        const String getProgramName (int) override                      { return String(); }
+        void changeProgramName (int, const String&) override            {}
+        void getStateInformation (MemoryBlock&) override                {}
+        void setStateInformation (const void*, int) override            {}
+    };
+
+    // Counts up by setting the last parameter and then the first one, so at any moment they're
+    // either equal or the last one is one step ahead. Every few steps, it waits until the reader
+    // has had a chance to take a snapshot without any interference.
+    struct WriterThread  : public Thread
+    {
+        WriterThread (AudioProcessor& p, Atomic<int>& attempts)
+            : Thread ("parameter writer"), processor (p), readerAttempts (attempts) {}
+
+        void run() override
+        {
+            const OwnedArray<AudioProcessorParameter>& params = processor.getParameters();
+
+            for (int round = 1; round <= numRounds && ! threadShouldExit(); ++round)
+            {
+                params.getLast()->setValue (round / (float) numRounds);
+                params.getFirst()->setValue (round / (float) numRounds);
+
+                if ((round & 15) == 0)
+                {
+                    const int target = readerAttempts.get() + 2;
+
+                    while (readerAttempts.get() < target && ! threadShouldExit())
+                        Thread::yield();
+                }
+            }
+        }
+
+        enum { numRounds = 4000 };
+
+        AudioProcessor& processor;
+        Atomic<int>& readerAttempts;
+    };
+
+    void runTest() override
+    {
+        const int numParams = 2000;
+        TestProcessor processor;
+        AudioProcessorValueTreeState state (processor, nullptr);
+
+        for (int i = 0; i < numParams; ++i)
+            state.createAndAddParameter ("p" + String (i), "Param " + String (i), String(),
+                                         NormalisableRange<float> (0.0f, (float) WriterThread::numRounds), 0.0f,
+                                         nullptr, nullptr);
+
+        state.state = ValueTree (Identifier ("test"));
+
+        beginTest ("Snapshots");
+        {
+            AudioProcessorValueTreeState::ParameterSnapshot snapshot;
+            state.getParameter ("p3")->setValue (0.5f);
+            state.prepareSnapshot (snapshot, 1000.0, 0.01);
+
+            expectEquals (snapshot.size(), numParams);
+            expectEquals (snapshot[3], WriterThread::numRounds * 0.5f);
+            expectEquals (snapshot[4], 0.0f);
+            expect (! state.updateSnapshot (snapshot));
+
+            state.getParameter ("p4")->setValue (1.0f);
+            expectEquals (snapshot[4], 0.0f);
+            expect (state.updateSnapshot (snapshot));
+            expectEquals (snapshot[4], (float) WriterThread::numRounds);
+            expect (! state.updateSnapshot (snapshot));
+
+            // the smoothed value ramps over 10 samples towards the new value
+            const int p4 = state.getParameterIndex ("p4");
+            expect (snapshot.isSmoothing (p4) && ! snapshot.isSmoothing (3));
+            expectEquals (snapshot.getNextSmoothedValue (p4), WriterThread::numRounds * 0.1f);
+
+            for (int i = 0; i < 9; ++i)
+                snapshot.getNextSmoothedValue (p4);
+
+            expect (! snapshot.isSmoothing (p4));
+            expectEquals (snapshot.getNextSmoothedValue (p4), (float) WriterThread::numRounds);
+        }
+
+        beginTest ("Concurrent writer");
+        {
+            AudioProcessorValueTreeState::ParameterSnapshot snapshot;
+            state.prepareSnapshot (snapshot, 1000.0, 0.01);
+
+            Atomic<int> attempts;
+            WriterThread writer (processor, attempts);
+            writer.startThread();
+
+            int numUpdates = 0, lastRound = 0;
+            bool allConsistent = true;
+
+            while (lastRound < WriterThread::numRounds && writer.isThreadRunning())
+            {
+                if (state.updateSnapshot (snapshot))
+                {
+                    ++numUpdates;
+
+                    // the first value is read long before the last one, so a torn copy would
+                    // usually have missed several steps between them
+                    const int first = roundToInt (snapshot[0]);
+                    lastRound = roundToInt (snapshot[numParams - 1]);
+
+                    if (lastRound != first && lastRound != first + 1)
+                        allConsistent = false;
+                }
+
+                ++attempts;
+            }
+
+            expect (writer.stopThread (5000));
+            expect (allConsistent);
+            expectEquals (lastRound, (int) WriterThread::numRounds);
+            expect (numUpdates >= WriterThread::numRounds / 16);
+        }
+
+       #if JUCE_MODAL_LOOPS_PERMITTED
+        beginTest ("Changed values are flushed to the ValueTree");
+        {
+            for (int i = 0; i < numParams; ++i)
+                state.getParameter ("p" + String (i))->setValue (0.0f);
+
+            MessageManager::getInstance()->runDispatchLoopUntil (600);
+            state.getParameter ("p7")->setValue (0.25f);
+            state.getParameter ("p42")->setValue (0.75f);
+
+            const ValueTree p7 (state.state.getChildWithProperty ("id", "p7"));
+            const ValueTree p42 (state.state.getChildWithProperty ("id", "p42"));
+            expectEquals ((float) p7["value"], 0.0f);
+
+            for (int i = 0; i < 20 && (float) p42["value"] == 0.0f; ++i)
+                MessageManager::getInstance()->runDispatchLoopUntil (50);
+
+            expectEquals ((float) p7["value"], WriterThread::numRounds * 0.25f);
+            expectEquals ((float) p42["value"], WriterThread::numRounds * 0.75f);
+            expectEquals ((float) state.state.getChildWithProperty ("id", "p8")["value"], 0.0f);
+
+            // and changes to the tree are sent back to the parameters
+            state.state.getChildWithProperty ("id", "p8").setProperty ("value", 100.0f, nullptr);
+            expectEquals (*state.getRawParameterValue ("p8"), 100.0f);
+        }
+       #endif
+    }
+};
+
+static AudioProcessorValueTreeStateTests audioProcessorValueTreeStateTests;
+
+#endif
+
 #endif
@@ -93,6 +93,80 @@ public:
     */
     float* getRawParameterValue (StringRef parameterID) const noexcept;
 
+    /** Returns the index of a parameter within the processor's parameter list, or -1
+        if the ID isn't found. This index can be used to look up values in a ParameterSnapshot.
+    */
+    int getParameterIndex (StringRef parameterID) const noexcept;
+
+    //==============================================================================
+    /** A block-consistent copy of all the parameter values, for use by the audio thread.
+
+        Reading parameters one-by-one through getRawParameterValue() can give you a mix of
+        old and new values if the host changes several of them while your processBlock()
+        is running. Instead, you can keep one of these objects in your processor, set it up
+        with prepareSnapshot() in prepareToPlay(), and call updateSnapshot() at the start of
+        each block. All the values you read from it during that block will then stay
+        consistent with each other.
+
+        Each value also has a LinearSmoothedValue attached to it, which is ramped towards
+        the latest snapshot value, so that you can get sample-accurate smoothing with
+        getNextSmoothedValue().
+
+        @see AudioProcessorValueTreeState::prepareSnapshot, AudioProcessorValueTreeState::updateSnapshot
+    */
+    class JUCE_API  ParameterSnapshot
+    {
+    public:
+        ParameterSnapshot();
+        ~ParameterSnapshot();
+
+        /** Returns the number of parameters in the snapshot. */
+        int size() const noexcept                                   { return values.size(); }
+
+        /** Returns the (non-normalised) value of a parameter, as it was when the snapshot was last updated. */
+        float operator[] (int parameterIndex) const noexcept        { return values[parameterIndex]; }
+
+        /** Returns the next value of the smoothed ramp for a parameter.
+            Call this once per sample to get a linearly interpolated value.
+        */
+        float getNextSmoothedValue (int parameterIndex) noexcept    { return smoothers.getReference (parameterIndex).getNextValue(); }
+
+        /** Returns true if the given parameter is still ramping towards its target value. */
+        bool isSmoothing (int parameterIndex) const noexcept        { return smoothers.getReference (parameterIndex).isSmoothing(); }
+
+    private:
+        friend class AudioProcessorValueTreeState;
+        Array<float> values, newValues;
+        Array<LinearSmoothedValue<float> > smoothers;
+        int generation;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterSnapshot)
+    };
+
+    /** Allocates space in a snapshot for all the current parameters and fills it with their values.
+
+        This will allocate memory, so must not be called on the audio thread - call it from
+        your prepareToPlay() method.
+
+        @param snapshot               the snapshot to initialise
+        @param sampleRate             the sample rate used to calculate the smoothing ramps
+        @param smoothingTimeSeconds   the length of the ramp used by ParameterSnapshot::getNextSmoothedValue()
+    */
+    void prepareSnapshot (ParameterSnapshot& snapshot, double sampleRate, double smoothingTimeSeconds) const;
+
+    /** Refreshes a snapshot with the latest parameter values.
+
+        This is wait-free and doesn't allocate, so it can be called at the start of each
+        processBlock(). If no parameters have changed since the last update, it returns
+        immediately without copying anything. If a parameter was being set on another thread
+        while the values were being copied, the snapshot keeps its previous values rather
+        than waiting, so that it never contains a mix of old and new ones - the new values
+        will be picked up by a later call.
+
+        @returns true if the snapshot was updated with some new values
+    */
+    bool updateSnapshot (ParameterSnapshot& snapshot) const noexcept;
+
     /** A listener class that can be attached to an AudioProcessorValueTreeState.
         Use AudioProcessorValueTreeState::addParameterListener() to register a callback.
     */
@@ -217,10 +291,19 @@ private:
     void valueTreeParentChanged (ValueTree&) override;
     void valueTreeRedirected (ValueTree&) override;
     void updateParameterConnectionsToChildTrees();
+    void publishValue (Parameter&, float newValue) noexcept;
+    bool copyPublishedValues (ParameterSnapshot&) const noexcept;
+    void markParameterDirty (int parameterIndex) noexcept;
+    bool flushDirtyParameters();
 
     Identifier valueType, valuePropertyID, idPropertyID;
     bool updatingConnections;
 
+    HeapBlock<Atomic<int> > dirtyParameterFlags;
+    int numDirtyFlagWords;
+    Atomic<int> valueGeneration;
+    SpinLock valueWriteLock;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorValueTreeState)
 };
 
@@ -392,26 +392,26 @@ public:
 
                 const MinMaxValue* cacheData = getData (channelNum, clip.getX() - area.getX());
 
-                RectangleList<float> waveform;
-                waveform.ensureStorageAllocated (clip.getWidth());
+                HeapBlock<Range<float> > waveform ((size_t) clip.getWidth());
 
-                float x = (float) clip.getX();
-
-                for (int w = clip.getWidth(); --w >= 0;)
+                for (int i = 0; i < clip.getWidth(); ++i)
                 {
                     if (cacheData->isNonZero())
                     {
                         const float top    = jmax (midY - cacheData->getMaxValue() * vscale - 0.3f, topY);
                         const float bottom = jmin (midY - cacheData->getMinValue() * vscale + 0.3f, bottomY);
 
-                        waveform.addWithoutMerging (Rectangle<float> (x, top, 1.0f, bottom - top));
+                        waveform[i] = Range<float> (top, jmax (top, bottom));
+                    }
+                    else
+                    {
+                        waveform[i] = Range<float>();
                     }
 
-                    x += 1.0f;
                     ++cacheData;
                 }
 
-                g.fillRectList (waveform);
+                g.fillVerticalSpans ((float) clip.getX(), 1.0f, waveform, clip.getWidth());
             }
         }
     }
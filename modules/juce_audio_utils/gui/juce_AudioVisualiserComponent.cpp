@@ -211,10 +211,19 @@ void AudioVisualiserComponent::getChannelAsPath (Path& path, const Range<float>*
 void AudioVisualiserComponent::paintChannel (Graphics& g, Rectangle<float> area,
                                              const Range<float>* levels, int numLevels, int nextSample)
 {
-    Path p;
-    getChannelAsPath (p, levels, numLevels, nextSample);
+    if (numLevels <= 0)
+        return;
 
-    g.fillPath (p, AffineTransform::fromTargetPoints (0.0f, -1.0f,               area.getX(), area.getY(),
-                                                      0.0f, 1.0f,                area.getX(), area.getBottom(),
-                                                      (float) numLevels, -1.0f,  area.getRight(), area.getY()));
+    const float centreY = area.getCentreY();
+    const float halfHeight = area.getHeight() * 0.5f;
+
+    HeapBlock<Range<float> > spans ((size_t) numLevels);
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+        const Range<float> level (levels[(nextSample + i) % numLevels]);
+        spans[i] = Range<float> (centreY - level.getEnd() * halfHeight, centreY - level.getStart() * halfHeight);
+    }
+
+    g.fillVerticalSpans (area.getX(), area.getWidth() / (float) numLevels, spans, numLevels);
 }
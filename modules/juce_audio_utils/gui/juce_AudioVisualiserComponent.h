@@ -100,8 +100,9 @@ public:
     void setRepaintRate (int frequencyInHz);
 
     /** Draws a channel of audio data in the given bounds.
-        The default implementation just calls getChannelAsPath() and fits this into the given
-        area. You may want to override this to draw things differently.
+        The default implementation draws each level as a column using Graphics::fillVerticalSpans(),
+        stretched to fit the given area. You may want to override this to draw things differently,
+        e.g. by using getChannelAsPath().
     */
     virtual void paintChannel (Graphics&, Rectangle<float> bounds,
                                const Range<float>* levels, int numLevels, int nextSample);
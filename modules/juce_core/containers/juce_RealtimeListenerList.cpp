@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#if JUCE_UNIT_TESTS
+
+class RealtimeListenerListTests  : public UnitTest
+{
+public:
+    RealtimeListenerListTests() : UnitTest ("RealtimeListenerList") {}
+
+    struct TestListener
+    {
+        TestListener (RealtimeListenerList<TestListener>& l)  : list (l) {}
+        virtual ~TestListener() {}
+
+        void changed (int amount)
+        {
+            total += amount;
+
+            if (listenerToRemove != nullptr)
+                list.remove (listenerToRemove);
+
+            if (listenerToAdd != nullptr)
+                list.add (listenerToAdd);
+        }
+
+        RealtimeListenerList<TestListener>& list;
+        TestListener* listenerToRemove = nullptr;
+        TestListener* listenerToAdd = nullptr;
+        Atomic<int> total;
+    };
+
+    struct CallerThread  : public Thread
+    {
+        CallerThread (RealtimeListenerList<TestListener>& l)  : Thread ("listener caller"), list (l) {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                list.call (&TestListener::changed, 1);
+                ++numCalls;
+            }
+        }
+
+        RealtimeListenerList<TestListener>& list;
+        Atomic<int> numCalls;
+    };
+
+    void runTest() override
+    {
+        RealtimeListenerList<TestListener> list;
+        TestListener a (list), b (list), c (list);
+
+        beginTest ("Add and remove");
+        expect (list.isEmpty());
+        list.add (&a);
+        list.add (&b);
+        list.add (&a);
+        expectEquals (list.size(), 2);
+        expect (list.contains (&a) && list.contains (&b) && ! list.contains (&c));
+        list.remove (&c);
+        list.remove (&a);
+        expectEquals (list.size(), 1);
+        expect (! list.contains (&a));
+        list.clear();
+        expect (list.isEmpty());
+
+        beginTest ("Call listeners");
+        list.add (&a);
+        list.add (&b);
+        list.call (&TestListener::changed, 2);
+        list.callExcluding (b, &TestListener::changed, 3);
+        expectEquals (a.total.get(), 5);
+        expectEquals (b.total.get(), 2);
+
+        beginTest ("Change list during call");
+        a.total = b.total = 0;
+        b.listenerToRemove = &a;   // b is called first
+        b.listenerToAdd = &c;
+        list.call (&TestListener::changed, 1);
+        expectEquals (a.total.get(), 0);
+        expectEquals (b.total.get(), 1);
+        expectEquals (c.total.get(), 0);
+        expect (list.contains (&c) && ! list.contains (&a));
+        b.listenerToRemove = b.listenerToAdd = nullptr;
+        list.call (&TestListener::changed, 1);
+        expectEquals (c.total.get(), 1);
+        list.clear();
+
+        beginTest ("Concurrent calls");
+        {
+            OwnedArray<TestListener> owned;
+
+            for (int i = 0; i < 8; ++i)
+                owned.add (new TestListener (list));
+
+            CallerThread caller1 (list), caller2 (list);
+            caller1.startThread();
+            caller2.startThread();
+
+            while (caller1.numCalls.get() == 0 || caller2.numCalls.get() == 0)
+                Thread::yield();
+
+            Random r;
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                TestListener* l = owned.getUnchecked (r.nextInt (owned.size()));
+
+                if (list.contains (l))
+                {
+                    list.remove (l);
+
+                    // Once removed, the listener mustn't be called again
+                    const int total = l->total.get();
+                    Thread::yield();
+                    expectEquals (l->total.get(), total);
+                }
+                else
+                {
+                    list.add (l);
+                }
+            }
+
+            caller1.stopThread (5000);
+            caller2.stopThread (5000);
+            list.clear();
+        }
+
+        beginTest ("Change list during call on another thread");
+        {
+            // the caller thread's listener keeps removing c while this thread changes the list,
+            // so each thread ends up waiting for the other's call or change to finish
+            TestListener remover (list), other (list);
+            remover.listenerToRemove = &c;
+            list.add (&remover);
+
+            CallerThread caller (list);
+            caller.startThread();
+
+            while (caller.numCalls.get() == 0)
+                Thread::yield();
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                list.add (&c);
+                list.add (&other);
+                list.remove (&other);
+            }
+
+            expect (caller.stopThread (5000));
+            list.clear();
+        }
+    }
+};
+
+static RealtimeListenerListTests realtimeListenerListTests;
+
+#endif
@@ -0,0 +1,468 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_REALTIMELISTENERLIST_H_INCLUDED
+#define JUCE_REALTIMELISTENERLIST_H_INCLUDED
+
+
+//==============================================================================
+/**
+    A version of ListenerList whose call() methods can safely be used on a real-time
+    thread, such as the audio thread, while other threads are adding and removing
+    listeners.
+
+    Calling the listeners never locks, allocates or waits: each call iterates an
+    immutable snapshot of the list. Adding or removing a listener copies the list,
+    publishes the new snapshot, and then waits for any calls that other threads are
+    still making with the old snapshot to finish before freeing it - so once remove()
+    has returned, that listener won't be called again by any thread, and it can be
+    safely deleted.
+
+    Because of that wait, add(), remove() and clear() should only be used from a
+    non-real-time thread, e.g. the message thread. They can be called from inside a
+    listener callback: the remainder of that callback's iteration will skip any
+    listeners that have been removed, and won't call any that were added. But if two
+    threads both change the list from inside callbacks at the same time, each would
+    wait forever for the other's callback to finish, so only one thread should ever
+    do that.
+
+    The list can be called by up to 16 threads at once (counting each nested call
+    as a separate one).
+
+    @see ListenerList
+*/
+template <class ListenerClass>
+class RealtimeListenerList
+{
+    // Horrible macros required to support VC7..
+    #ifndef DOXYGEN
+     #if JUCE_VC8_OR_EARLIER
+       #define LL_TEMPLATE(a)   typename P##a, typename Q##a
+       #define LL_PARAM(a)      Q##a& param##a
+     #else
+       #define LL_TEMPLATE(a)   typename P##a
+       #define LL_PARAM(a)      PARAMETER_TYPE(P##a) param##a
+     #endif
+    #endif
+
+public:
+    //==============================================================================
+    /** Creates an empty list. */
+    RealtimeListenerList()  : current (new Snapshot())
+    {
+    }
+
+    /** Destructor. */
+    ~RealtimeListenerList()
+    {
+        // The list mustn't be deleted while another thread is still calling it!
+        jassert (! isBeingCalledByAnotherThread());
+
+        delete current.get();
+    }
+
+    //==============================================================================
+    /** Adds a listener to the list.
+        A listener can only be added once, so if the listener is already in the list,
+        this method has no effect. This isn't real-time safe.
+        @see remove
+    */
+    void add (ListenerClass* const listenerToAdd)
+    {
+        // Listeners can't be null pointers!
+        jassert (listenerToAdd != nullptr);
+
+        if (listenerToAdd != nullptr)
+        {
+            const ScopedLock sl (writeLock);
+
+            if (! current.get()->listeners.contains (listenerToAdd))
+            {
+                Snapshot* const newSnapshot = new Snapshot (*current.get());
+                newSnapshot->listeners.add (listenerToAdd);
+                publish (newSnapshot);
+            }
+        }
+    }
+
+    /** Removes a listener from the list.
+        If the listener wasn't in the list, this has no effect. Once this returns, the
+        listener won't be called again by any thread. This isn't real-time safe.
+    */
+    void remove (ListenerClass* const listenerToRemove)
+    {
+        // Listeners can't be null pointers!
+        jassert (listenerToRemove != nullptr);
+
+        const ScopedLock sl (writeLock);
+
+        if (current.get()->listeners.contains (listenerToRemove))
+        {
+            Snapshot* const newSnapshot = new Snapshot (*current.get());
+            newSnapshot->listeners.removeFirstMatchingValue (listenerToRemove);
+            publish (newSnapshot);
+        }
+    }
+
+    /** Clears the list. This isn't real-time safe. */
+    void clear()
+    {
+        const ScopedLock sl (writeLock);
+
+        if (current.get()->listeners.size() > 0)
+            publish (new Snapshot());
+    }
+
+    /** Returns the number of registered listeners. */
+    int size() const noexcept
+    {
+        const ScopedCall c (*this);
+        return c.getNumListeners();
+    }
+
+    /** Returns true if any listeners are registered. */
+    bool isEmpty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /** Returns true if the specified listener has been added to the list. */
+    bool contains (ListenerClass* const listener) const noexcept
+    {
+        const ScopedCall c (*this);
+        return c.getSnapshot().listeners.contains (listener);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with no parameters. */
+    void call (void (ListenerClass::*callbackFunction) ())
+    {
+        for (ScopedCall c (*this); c.next();)
+            (c.getListener()->*callbackFunction) ();
+    }
+
+    /** Calls a member function on all but the specified listener in the list, with no parameters. */
+    void callExcluding (ListenerClass& listenerToExclude, void (ListenerClass::*callbackFunction) ())
+    {
+        for (ScopedCall c (*this); c.next();)
+            if (c.getListener() != &listenerToExclude)
+                (c.getListener()->*callbackFunction) ();
+    }
+
+    /** Calls a member function on each listener in the list, with 1 parameter. */
+    template <LL_TEMPLATE(1)>
+    void call (void (ListenerClass::*callbackFunction) (P1), LL_PARAM(1))
+    {
+        for (ScopedCall c (*this); c.next();)
+            (c.getListener()->*callbackFunction) (param1);
+    }
+
+    /** Calls a member function on all but the specified listener in the list, with 1 parameter. */
+    template <LL_TEMPLATE(1)>
+    void callExcluding (ListenerClass& listenerToExclude,
+                        void (ListenerClass::*callbackFunction) (P1), LL_PARAM(1))
+    {
+        for (ScopedCall c (*this); c.next();)
+            if (c.getListener() != &listenerToExclude)
+                (c.getListener()->*callbackFunction) (param1);
+    }
+
+    /** Calls a member function on each listener in the list, with 2 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2), LL_PARAM(1), LL_PARAM(2))
+    {
+        for (ScopedCall c (*this); c.next();)
+            (c.getListener()->*callbackFunction) (param1, param2);
+    }
+
+    /** Calls a member function on all but the specified listener in the list, with 2 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2)>
+    void callExcluding (ListenerClass& listenerToExclude,
+                        void (ListenerClass::*callbackFunction) (P1, P2), LL_PARAM(1), LL_PARAM(2))
+    {
+        for (ScopedCall c (*this); c.next();)
+            if (c.getListener() != &listenerToExclude)
+                (c.getListener()->*callbackFunction) (param1, param2);
+    }
+
+    /** Calls a member function on each listener in the list, with 3 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3), LL_PARAM(1), LL_PARAM(2), LL_PARAM(3))
+    {
+        for (ScopedCall c (*this); c.next();)
+            (c.getListener()->*callbackFunction) (param1, param2, param3);
+    }
+
+    /** Calls a member function on all but the specified listener in the list, with 3 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3)>
+    void callExcluding (ListenerClass& listenerToExclude,
+                        void (ListenerClass::*callbackFunction) (P1, P2, P3), LL_PARAM(1), LL_PARAM(2), LL_PARAM(3))
+    {
+        for (ScopedCall c (*this); c.next();)
+            if (c.getListener() != &listenerToExclude)
+                (c.getListener()->*callbackFunction) (param1, param2, param3);
+    }
+
+    /** Calls a member function on each listener in the list, with 4 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4), LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4))
+    {
+        for (ScopedCall c (*this); c.next();)
+            (c.getListener()->*callbackFunction) (param1, param2, param3, param4);
+    }
+
+    /** Calls a member function on all but the specified listener in the list, with 4 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4)>
+    void callExcluding (ListenerClass& listenerToExclude,
+                        void (ListenerClass::*callbackFunction) (P1, P2, P3, P4), LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4))
+    {
+        for (ScopedCall c (*this); c.next();)
+            if (c.getListener() != &listenerToExclude)
+                (c.getListener()->*callbackFunction) (param1, param2, param3, param4);
+    }
+
+    /** Calls a member function on each listener in the list, with 5 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4), LL_TEMPLATE(5)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5), LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5))
+    {
+        for (ScopedCall c (*this); c.next();)
+            (c.getListener()->*callbackFunction) (param1, param2, param3, param4, param5);
+    }
+
+    /** Calls a member function on all but the specified listener in the list, with 5 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4), LL_TEMPLATE(5)>
+    void callExcluding (ListenerClass& listenerToExclude,
+                        void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5), LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5))
+    {
+        for (ScopedCall c (*this); c.next();)
+            if (c.getListener() != &listenerToExclude)
+                (c.getListener()->*callbackFunction) (param1, param2, param3, param4, param5);
+    }
+
+    /** Calls a member function on each listener in the list, with 6 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4), LL_TEMPLATE(5), LL_TEMPLATE(6)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5, P6), LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5), LL_PARAM(6))
+    {
+        for (ScopedCall c (*this); c.next();)
+            (c.getListener()->*callbackFunction) (param1, param2, param3, param4, param5, param6);
+    }
+
+    /** Calls a member function on all but the specified listener in the list, with 6 parameters. */
+    template <LL_TEMPLATE(1), LL_TEMPLATE(2), LL_TEMPLATE(3), LL_TEMPLATE(4), LL_TEMPLATE(5), LL_TEMPLATE(6)>
+    void callExcluding (ListenerClass& listenerToExclude,
+                        void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5, P6), LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5), LL_PARAM(6))
+    {
+        for (ScopedCall c (*this); c.next();)
+            if (c.getListener() != &listenerToExclude)
+                (c.getListener()->*callbackFunction) (param1, param2, param3, param4, param5, param6);
+    }
+
+private:
+    //==============================================================================
+    struct Snapshot
+    {
+        Snapshot() noexcept {}
+        Snapshot (const Snapshot& other)  : listeners (other.listeners) {}
+
+        Array<ListenerClass*> listeners;
+        Atomic<int> isStale;
+    };
+
+    // Each thread that's calling the list holds one of these while it's iterating. The
+    // sequence number is odd while it's in use, so that writers can tell when it's moved on.
+    struct ReaderSlot
+    {
+        Atomic<Thread::ThreadID> thread;
+        Atomic<int> sequence;
+    };
+
+    enum { numReaderSlots = 16 };
+
+    Atomic<Snapshot*> current;
+    mutable ReaderSlot readerSlots [numReaderSlots];
+    CriticalSection writeLock;
+    OwnedArray<Snapshot> retiredSnapshots;
+    Atomic<int> numWritersInsideCalls;
+
+    //==============================================================================
+    class ScopedCall
+    {
+    public:
+        ScopedCall (const RealtimeListenerList& l) noexcept
+            : list (l), slot (l.claimReaderSlot()),
+              snapshot (l.current.get()), index (snapshot->listeners.size())
+        {
+        }
+
+        ~ScopedCall() noexcept
+        {
+            list.releaseReaderSlot (slot);
+        }
+
+        bool next() noexcept
+        {
+            while (--index >= 0)
+            {
+                // If the list has changed since this call began, make sure that the listener
+                // hasn't been removed. That's only possible if it was done on this thread, as
+                // other threads will wait for this call to finish before returning.
+                if (snapshot->isStale.get() == 0
+                     || list.current.get()->listeners.contains (snapshot->listeners.getUnchecked (index)))
+                    return true;
+            }
+
+            return false;
+        }
+
+        ListenerClass* getListener() const noexcept     { return snapshot->listeners.getUnchecked (index); }
+        const Snapshot& getSnapshot() const noexcept    { return *snapshot; }
+        int getNumListeners() const noexcept            { return snapshot->listeners.size(); }
+
+    private:
+        const RealtimeListenerList& list;
+        ReaderSlot& slot;
+        Snapshot* const snapshot;
+        int index;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedCall)
+    };
+
+    ReaderSlot& claimReaderSlot() const noexcept
+    {
+        const Thread::ThreadID thisThread = Thread::getCurrentThreadId();
+
+        for (;;)
+        {
+            for (int i = 0; i < numReaderSlots; ++i)
+            {
+                ReaderSlot& s = readerSlots[i];
+
+                if (s.thread.get() == nullptr && s.thread.compareAndSetBool (thisThread, nullptr))
+                {
+                    ++(s.sequence);
+                    return s;
+                }
+            }
+
+            // There are more simultaneous calls to this list than it has slots for!
+            jassertfalse;
+            Thread::yield();
+        }
+    }
+
+    static void releaseReaderSlot (ReaderSlot& s) noexcept
+    {
+        ++(s.sequence);
+        s.thread = nullptr;
+    }
+
+    // Called with the write lock held
+    void publish (Snapshot* const newSnapshot)
+    {
+        Snapshot* const oldSnapshot = current.exchange (newSnapshot);
+        oldSnapshot->isStale = 1;
+        retiredSnapshots.add (oldSnapshot);
+
+        const bool isInsideCall = isBeingCalledByThisThread();
+
+        {
+            // The lock mustn't be held while waiting, or a listener that changes the list
+            // would never return if another thread was waiting for it to finish.
+            const ScopedUnlock su (writeLock);
+
+            if (isInsideCall)
+            {
+                // Two threads are changing the list from inside their callbacks at the same
+                // time, so they'll each wait forever for the other one to finish its call!
+                const int numWriters = ++numWritersInsideCalls;
+                jassert (numWriters == 1);
+                ignoreUnused (numWriters);
+            }
+
+            waitForOtherThreadsToFinishCalling();
+
+            if (isInsideCall)
+                --numWritersInsideCalls;
+        }
+
+        // Every snapshot retired up to this point can now be deleted, as the calls that could
+        // have been using them have finished (unless they're further up this thread's stack).
+        // Another writer may already have deleted this one if it was waiting at the same time.
+        if (! isInsideCall)
+            retiredSnapshots.removeRange (0, retiredSnapshots.indexOf (oldSnapshot) + 1);
+    }
+
+    void waitForOtherThreadsToFinishCalling() const
+    {
+        const Thread::ThreadID thisThread = Thread::getCurrentThreadId();
+
+        for (int i = 0; i < numReaderSlots; ++i)
+        {
+            const ReaderSlot& s = readerSlots[i];
+            const int sequence = s.sequence.get();
+
+            if ((sequence & 1) != 0 && s.thread.get() != thisThread)
+                while (s.sequence.get() == sequence)
+                    Thread::yield();
+        }
+    }
+
+    bool isBeingCalledByThisThread() const noexcept
+    {
+        const Thread::ThreadID thisThread = Thread::getCurrentThreadId();
+
+        for (int i = 0; i < numReaderSlots; ++i)
+            if (readerSlots[i].thread.get() == thisThread)
+                return true;
+
+        return false;
+    }
+
+    bool isBeingCalledByAnotherThread() const noexcept
+    {
+        const Thread::ThreadID thisThread = Thread::getCurrentThreadId();
+
+        for (int i = 0; i < numReaderSlots; ++i)
+        {
+            const Thread::ThreadID t = readerSlots[i].thread.get();
+
+            if (t != nullptr && t != thisThread)
+                return true;
+        }
+
+        return false;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (RealtimeListenerList)
+
+    #undef LL_TEMPLATE
+    #undef LL_PARAM
+};
+
+
+#endif   // JUCE_REALTIMELISTENERLIST_H_INCLUDED
@@ -165,6 +165,16 @@
  #define JUCE_ALLOW_STATIC_NULL_VARIABLES 1
 #endif
 
+/** Config: JUCE_ENABLE_TRACING
+    Enables the JUCE_TRACE_SCOPE, JUCE_TRACE_COUNTER, etc. macros, which record events
+    with the Tracer class. When this is disabled, the macros (including the ones that
+    instrument the library's own audio, painting and message-dispatch code) compile
+    to nothing.
+*/
+#ifndef JUCE_ENABLE_TRACING
+ #define JUCE_ENABLE_TRACING 0
+#endif
+
 
 #ifndef JUCE_STRING_UTF_TYPE
  #define JUCE_STRING_UTF_TYPE 8
@@ -296,10 +306,12 @@ extern JUCE_API void JUCE_CALLTYPE logAssertion (const char* file, int line) noe
 #include "threads/juce_Thread.h"
 #include "threads/juce_ThreadLocalValue.h"
 #include "threads/juce_ThreadPool.h"
+#include "threads/juce_ParallelAlgorithms.h"
 #include "threads/juce_TimeSliceThread.h"
 #include "threads/juce_ReadWriteLock.h"
 #include "threads/juce_ScopedReadLock.h"
 #include "threads/juce_ScopedWriteLock.h"
+#include "containers/juce_RealtimeListenerList.h"
 #include "network/juce_IPAddress.h"
 #include "network/juce_MACAddress.h"
 #include "network/juce_NamedPipe.h"
@@ -307,9 +319,11 @@ extern JUCE_API void JUCE_CALLTYPE logAssertion (const char* file, int line) noe
 #include "network/juce_URL.h"
 #include "network/juce_WebInputStream.h"
 #include "time/juce_PerformanceCounter.h"
+#include "time/juce_Tracing.h"
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "xml/juce_XmlPullParser.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
@@ -211,6 +211,7 @@
 #elif JUCE_LINUX
  #include <sched.h>
  #include <pthread.h>
+ #include <sys/syscall.h>
  #include <sys/time.h>
  #include <errno.h>
  #include <sys/stat.h>
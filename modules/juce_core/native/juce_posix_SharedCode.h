@@ -1041,6 +1041,147 @@ void JUCE_CALLTYPE Thread::setCurrentThreadAffinityMask (const uint32 affinityMa
    #endif
 }
 
+//==============================================================================
+bool Thread::setThreadRealtimeOptions (void* handle, const RealtimeOptions& options)
+{
+   #if JUCE_ANDROID
+    if (handle != nullptr)
+        return false; // (on Android, the handle is a Java object, so a thread can only change itself)
+   #endif
+
+    const pthread_t thread = handle != nullptr ? (pthread_t) handle : pthread_self();
+    bool ok = true;
+
+    if (options.policy == RealtimeOptions::deadline)
+    {
+       #if JUCE_LINUX && defined (__NR_sched_setattr)
+        // glibc has no wrapper for sched_setattr, and it needs a kernel thread ID rather
+        // than a pthread, so this can only be done by the thread itself
+        struct SchedAttr
+        {
+            uint32 size, policy;
+            uint64 flags;
+            int32 nice;
+            uint32 priority;
+            uint64 runtime, deadline, period;
+        };
+
+        SchedAttr attr;
+        zerostruct (attr);
+        attr.size = sizeof (attr);
+        attr.policy = 6; // SCHED_DEADLINE, which older headers don't define
+        attr.runtime = (uint64) options.runtimeMicroseconds * 1000;
+        attr.deadline = attr.period = (uint64) options.periodMicroseconds * 1000;
+
+        ok = handle == nullptr && syscall (__NR_sched_setattr, 0, &attr, 0) == 0;
+       #else
+        ok = false;
+       #endif
+    }
+    else if (options.policy != RealtimeOptions::unchanged)
+    {
+        const int policy = options.policy == RealtimeOptions::firstInFirstOut ? SCHED_FIFO : SCHED_RR;
+        const int minPriority = sched_get_priority_min (policy);
+        const int maxPriority = sched_get_priority_max (policy);
+
+        struct sched_param param;
+        zerostruct (param);
+        param.sched_priority = ((maxPriority - minPriority) * jlimit (0, 10, options.priority)) / 10 + minPriority;
+
+        ok = pthread_setschedparam (thread, policy, &param) == 0;
+    }
+
+    if (options.affinityMask != 0)
+    {
+       #if SUPPORT_AFFINITIES
+        cpu_set_t affinity;
+        CPU_ZERO (&affinity);
+
+        for (int i = 0; i < 64; ++i)
+            if ((options.affinityMask & (((uint64) 1) << i)) != 0)
+                CPU_SET (i, &affinity);
+
+        #if (! JUCE_ANDROID) && ((! JUCE_LINUX) || ((__GLIBC__ * 1000 + __GLIBC_MINOR__) >= 2004))
+         ok = pthread_setaffinity_np (thread, sizeof (cpu_set_t), &affinity) == 0 && ok;
+        #else
+         ok = sched_setaffinity (0, sizeof (cpu_set_t), &affinity) == 0 && ok; // (0 means the calling thread)
+        #endif
+       #else
+        ok = false;
+       #endif
+    }
+
+    if (options.lockMemory)
+    {
+       #if JUCE_LINUX || JUCE_ANDROID
+        ok = mlockall (MCL_CURRENT | MCL_FUTURE) == 0 && ok;
+       #else
+        ok = false;
+       #endif
+    }
+
+    return ok;
+}
+
+String JUCE_CALLTYPE Thread::getCurrentThreadSchedulingDescription()
+{
+    String desc;
+    struct sched_param param;
+    zerostruct (param);
+
+   #if JUCE_LINUX || JUCE_ANDROID
+    // (asking the kernel directly means that policies which pthreads doesn't know about also show up)
+    const int policy = sched_getscheduler (0);
+    const bool gotParams = policy >= 0 && sched_getparam (0, &param) == 0;
+   #else
+    int policy = 0;
+    const bool gotParams = pthread_getschedparam (pthread_self(), &policy, &param) == 0;
+   #endif
+
+    if (gotParams)
+    {
+        switch (policy)
+        {
+            case SCHED_OTHER:   desc << "SCHED_OTHER"; break;
+            case SCHED_FIFO:    desc << "SCHED_FIFO"; break;
+            case SCHED_RR:      desc << "SCHED_RR"; break;
+           #if JUCE_LINUX
+            case 6:             desc << "SCHED_DEADLINE"; break;
+           #endif
+            default:            desc << "policy " << policy; break;
+        }
+
+        desc << ", priority " << param.sched_priority;
+    }
+
+   #if SUPPORT_AFFINITIES && (JUCE_LINUX || JUCE_ANDROID)
+    cpu_set_t affinity;
+    CPU_ZERO (&affinity);
+
+    if (sched_getaffinity (0, sizeof (cpu_set_t), &affinity) == 0)
+    {
+        StringArray cpus;
+
+        for (int i = 0; i < CPU_SETSIZE; ++i)
+            if (CPU_ISSET (i, &affinity))
+                cpus.add (String (i));
+
+        desc << ", CPUs " << cpus.joinIntoString (",");
+    }
+   #endif
+
+   #if JUCE_LINUX
+    StringArray status;
+    File ("/proc/self/status").readLines (status);
+
+    for (int i = 0; i < status.size(); ++i)
+        if (status[i].startsWith ("VmLck:"))
+            desc << ", locked memory " << status[i].fromFirstOccurrenceOf (":", false, false).trim();
+   #endif
+
+    return desc;
+}
+
 //==============================================================================
 bool DynamicLibrary::open (const String& name)
 {
@@ -159,6 +159,32 @@ void JUCE_CALLTYPE Thread::setCurrentThreadAffinityMask (const uint32 affinityMa
     SetThreadAffinityMask (GetCurrentThread(), affinityMask);
 }
 
+bool Thread::setThreadRealtimeOptions (void* handle, const RealtimeOptions& options)
+{
+    if (handle == 0)
+        handle = GetCurrentThread();
+
+    bool ok = true;
+
+    if (options.policy == RealtimeOptions::deadline)
+        ok = false;
+    else if (options.policy != RealtimeOptions::unchanged)
+        ok = setThreadPriority (handle, options.priority);
+
+    if (options.affinityMask != 0)
+        ok = SetThreadAffinityMask (handle, (DWORD_PTR) options.affinityMask) != 0 && ok;
+
+    if (options.lockMemory)
+        ok = false; // (there's no equivalent of mlockall on Windows)
+
+    return ok;
+}
+
+String JUCE_CALLTYPE Thread::getCurrentThreadSchedulingDescription()
+{
+    return "priority " + String (GetThreadPriority (GetCurrentThread()));
+}
+
 //==============================================================================
 struct SleepEvent
 {
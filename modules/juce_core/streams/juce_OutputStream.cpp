@@ -306,7 +306,11 @@ JUCE_API OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, const int
 
 JUCE_API OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, const double number)
 {
-    return stream << String (number);
+    char buffer [NumberToStringConverters::charsNeededForDouble];
+    size_t len;
+    const char* const start = NumberToStringConverters::doubleToString (buffer, numElementsInArray (buffer), number, 0, len);
+    stream.write (start, len);
+    return stream;
 }
 
 JUCE_API OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, const char character)
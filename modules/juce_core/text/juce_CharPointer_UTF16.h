@@ -271,6 +271,36 @@ public:
         return count;
     }
 
+    /** Returns the number of bytes that would be needed to represent the given
+        string in this encoding format.
+        The value returned does NOT include the terminating null character.
+    */
+    static size_t getBytesRequiredFor (CharPointer_UTF8 text) noexcept
+    {
+        const CharPointer_UTF8::CharType* const end = text.getAddress() + strlen (text.getAddress());
+        size_t count = 0;
+
+        for (;;)
+        {
+            const CharPointer_UTF8::CharType* const s = text.getAddress();
+            const size_t numAscii = CharPointer_UTF8::countAsciiBytes (s, (size_t) (end - s));
+            count += numAscii * sizeof (CharType);
+
+            if (s + numAscii >= end)
+                break;
+
+            text = CharPointer_UTF8 (s + numAscii);
+            const juce_wchar n = text.getAndAdvance();
+
+            if (n == 0)
+                break;
+
+            count += getBytesRequiredFor (n);
+        }
+
+        return count;
+    }
+
     /** Returns a pointer to the null character that terminates this string. */
     CharPointer_UTF16 findTerminatingNull() const noexcept
     {
@@ -289,6 +319,29 @@ public:
         CharacterFunctions::copyAll (*this, src);
     }
 
+    /** Copies a source string to this pointer, advancing this pointer as it goes. */
+    void writeAll (CharPointer_UTF8 src) noexcept
+    {
+        for (;;)
+        {
+            // plain ASCII runs can be widened directly, without decoding each character
+            const CharPointer_UTF8::CharType* s = src.getAddress();
+
+            while (((signed char) *s) > 0)
+                *data++ = (CharType) *s++;
+
+            src = CharPointer_UTF8 (s);
+            const juce_wchar c = src.getAndAdvance();
+
+            if (c == 0)
+                break;
+
+            write (c);
+        }
+
+        writeNull();
+    }
+
     /** Copies a source string to this pointer, advancing this pointer as it goes. */
     void writeAll (const CharPointer_UTF16 src) noexcept
     {
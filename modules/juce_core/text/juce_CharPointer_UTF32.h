@@ -219,6 +219,29 @@ public:
         CharacterFunctions::copyAll (*this, src);
     }
 
+    /** Copies a source string to this pointer, advancing this pointer as it goes. */
+    void writeAll (CharPointer_UTF8 src) noexcept
+    {
+        for (;;)
+        {
+            // plain ASCII runs can be widened directly, without decoding each character
+            const CharPointer_UTF8::CharType* s = src.getAddress();
+
+            while (((signed char) *s) > 0)
+                *data++ = (CharType) *s++;
+
+            src = CharPointer_UTF8 (s);
+            const juce_wchar c = src.getAndAdvance();
+
+            if (c == 0)
+                break;
+
+            write (c);
+        }
+
+        writeNull();
+    }
+
     /** Copies a source string to this pointer, advancing this pointer as it goes. */
     void writeAll (const CharPointer_UTF32 src) noexcept
     {
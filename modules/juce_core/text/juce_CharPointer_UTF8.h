@@ -202,8 +202,18 @@ public:
         }
         else
         {
-            while (--numToSkip >= 0)
-                ++*this;
+            while (numToSkip > 0)
+            {
+                const size_t numAscii = countAsciiBytes (data, (size_t) numToSkip);
+                data += numAscii;
+                numToSkip -= (int) numAscii;
+
+                if (numToSkip > 0)
+                {
+                    ++*this;
+                    --numToSkip;
+                }
+            }
         }
     }
 
@@ -241,20 +251,23 @@ public:
     size_t length() const noexcept
     {
         const CharType* d = data;
+        const CharType* const end = data + strlen (data);
         size_t count = 0;
 
         for (;;)
         {
-            const uint32 n = (uint32) (uint8) *d++;
+            const size_t numAscii = countAsciiBytes (d, (size_t) (end - d));
+            d += numAscii;
+            count += numAscii;
 
-            if ((n & 0x80) != 0)
-            {
-                while ((*d & 0xc0) == 0x80)
-                    ++d;
-            }
-            else if (n == 0)
+            if (d >= end)
                 break;
 
+            ++d;
+
+            while ((*d & 0xc0) == 0x80)
+                ++d;
+
             ++count;
         }
 
@@ -319,6 +332,64 @@ public:
         return count;
     }
 
+    /** Returns the number of bytes that would be needed to represent the given
+        string in this encoding format.
+        The value returned does NOT include the terminating null character.
+    */
+    static size_t getBytesRequiredFor (CharPointer_UTF8 text) noexcept
+    {
+        const CharType* const end = text.data + strlen (text.data);
+        size_t count = 0;
+
+        for (;;)
+        {
+            const size_t numAscii = countAsciiBytes (text.data, (size_t) (end - text.data));
+            text.data += numAscii;
+            count += numAscii;
+
+            if (text.data >= end)
+                break;
+
+            const juce_wchar n = text.getAndAdvance();
+
+            if (n == 0)
+                break;
+
+            count += getBytesRequiredFor (n);
+        }
+
+        return count;
+    }
+
+    /** Returns the number of bytes at the start of a block of data which are non-null,
+        7-bit ASCII characters, looking no further than the given number of bytes.
+
+        This checks a whole 64-bit word at a time, so is a quick way to skip over the
+        runs of plain ASCII text that make up most XML, JSON and source code, where each
+        byte is a complete character.
+    */
+    static size_t countAsciiBytes (const CharType* d, const size_t maxBytes) noexcept
+    {
+        const uint64 highBits = (uint64) 0x8080808080808080ULL;
+        const uint64 lowBits  = (uint64) 0x0101010101010101ULL;
+        size_t i = 0;
+
+        for (; i + sizeof (uint64) <= maxBytes; i += sizeof (uint64))
+        {
+            uint64 word;
+            memcpy (&word, d + i, sizeof (word));
+
+            // (stops if any byte has its top bit set or is zero)
+            if (((word | ((word - lowBits) & ~word)) & highBits) != 0)
+                break;
+        }
+
+        while (i < maxBytes && ((signed char) d[i]) > 0)
+            ++i;
+
+        return i;
+    }
+
     /** Returns a pointer to the null character that terminates this string. */
     CharPointer_UTF8 findTerminatingNull() const noexcept
     {
@@ -498,8 +569,22 @@ public:
     /** Returns true if this data contains a valid string in this encoding. */
     static bool isValidString (const CharType* dataToTest, int maxBytesToRead)
     {
-        while (--maxBytesToRead >= 0 && *dataToTest != 0)
+        if (maxBytesToRead <= 0)
+            return true;
+
+        // (memchr won't read past the terminator, so this gives us a safe range to scan quickly)
+        if (const void* const terminator = memchr (dataToTest, 0, (size_t) maxBytesToRead))
+            maxBytesToRead = (int) (static_cast<const CharType*> (terminator) - dataToTest);
+
+        for (;;)
         {
+            const int numAscii = (int) countAsciiBytes (dataToTest, (size_t) maxBytesToRead);
+            dataToTest += numAscii;
+            maxBytesToRead -= numAscii;
+
+            if (--maxBytesToRead < 0 || *dataToTest == 0)
+                break;
+
             const signed char byte = (signed char) *dataToTest++;
 
             if (byte < 0)
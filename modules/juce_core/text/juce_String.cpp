@@ -192,9 +192,16 @@ public:
             return newText;
         }
 
-        if (b->allocatedNumBytes >= numBytes && b->refCount.get() <= 0)
+        const bool isUnique = b->refCount.get() <= 0;
+
+        if (b->allocatedNumBytes >= numBytes && isUnique)
             return text;
 
+        // When a string that we own is being grown (e.g. by repeatedly appending to it),
+        // over-allocate so that the cost of the reallocations is amortised
+        if (isUnique)
+            numBytes = jmax (numBytes, b->allocatedNumBytes + b->allocatedNumBytes / 2);
+
         CharPointerType newText (createUninitialisedBytes (jmax (b->allocatedNumBytes, numBytes)));
         memcpy (newText.getAddress(), text.getAddress(), b->allocatedNumBytes);
         release (b);
@@ -387,17 +394,35 @@ namespace NumberToStringConverters
         charsNeededForDouble = 48
     };
 
+    static const char digitPairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
     template <typename Type>
     static char* printDigits (char* t, Type v) noexcept
     {
         *--t = 0;
 
-        do
+        // (converting two digits per division halves the number of slow divide operations)
+        while (v >= 100)
         {
-            *--t = '0' + (char) (v % 10);
-            v /= 10;
+            const char* const pair = digitPairs + 2 * (size_t) (v % 100);
+            v /= 100;
+            *--t = pair[1];
+            *--t = pair[0];
+        }
 
-        } while (v > 0);
+        if (v >= 10)
+        {
+            const char* const pair = digitPairs + 2 * (size_t) v;
+            *--t = pair[1];
+            *--t = pair[0];
+        }
+        else
+        {
+            *--t = '0' + (char) v;
+        }
 
         return t;
     }
@@ -474,6 +499,30 @@ namespace NumberToStringConverters
 
             return (size_t) (pptr() - pbase());
         }
+
+        // Tries increasing precisions until it finds one that parses back to the same value
+        size_t writeShortestRoundTripDouble (double n)
+        {
+            std::ostream o (this);
+            size_t len = 0;
+
+            for (int precision = 15; precision <= 17; ++precision)
+            {
+                setp (pbase(), epptr());
+                o.precision ((std::streamsize) precision);
+                o << n;
+
+                len = (size_t) (pptr() - pbase());
+                pbase()[len] = 0;
+
+                CharPointer_ASCII parsed (pbase());
+
+                if (CharacterFunctions::readDoubleValue (parsed) == n)
+                    break;
+            }
+
+            return len;
+        }
     };
 
     static char* doubleToString (char* buffer, const int numChars, double n, int numDecPlaces, size_t& len) noexcept
@@ -518,6 +567,14 @@ namespace NumberToStringConverters
         return StringHolder::createFromFixedLength (start, (size_t) (end - start - 1));
     }
 
+    static char* doubleToShortestString (char* buffer, double n, size_t& len) noexcept
+    {
+        StackArrayStream strm (buffer);
+        len = strm.writeShortestRoundTripDouble (n);
+        jassert (len < charsNeededForDouble);
+        return buffer;
+    }
+
     static String::CharPointerType createFromDouble (const double number, const int numberOfDecimalPlaces)
     {
         char buffer [charsNeededForDouble];
@@ -831,12 +888,30 @@ namespace StringHelpers
 
         return str;
     }
+
+    // Appends the same text as String (double) would create, but without the temporary string
+    inline String& appendDouble (String& str, const double number)
+    {
+        char buffer [NumberToStringConverters::charsNeededForDouble];
+        size_t len;
+        const char* const start = NumberToStringConverters::doubleToString (buffer, numElementsInArray (buffer), number, 0, len);
+        str.appendCharPointer (CharPointer_ASCII (start), len);
+        return str;
+    }
 }
 
 String& String::operator+= (const int number)          { return StringHelpers::operationAddAssign<int>          (*this, number); }
 String& String::operator+= (const int64 number)        { return StringHelpers::operationAddAssign<int64>        (*this, number); }
 String& String::operator+= (const uint64 number)       { return StringHelpers::operationAddAssign<uint64>       (*this, number); }
 
+String String::toShortestRoundTripString (const double number)
+{
+    char buffer [NumberToStringConverters::charsNeededForDouble];
+    size_t len;
+    const char* const start = NumberToStringConverters::doubleToShortestString (buffer, number, len);
+    return String (CharPointer_UTF8 (start), len);
+}
+
 //==============================================================================
 JUCE_API String JUCE_CALLTYPE operator+ (const char* const s1, const String& s2)    { String s (s1); return s += s2; }
 JUCE_API String JUCE_CALLTYPE operator+ (const wchar_t* const s1, const String& s2) { String s (s1); return s += s2; }
@@ -868,12 +943,12 @@ JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, StringRef s2)
 JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const int number)            { return s1 += number; }
 JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const short number)          { return s1 += (int) number; }
 JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const unsigned short number) { return s1 += (uint64) number; }
-JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const long number)           { return s1 += String (number); }
-JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const unsigned long number)  { return s1 += String (number); }
-JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const int64 number)          { return s1 += String (number); }
-JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const uint64 number)         { return s1 += String (number); }
-JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const float number)          { return s1 += String (number); }
-JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const double number)         { return s1 += String (number); }
+JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const long number)           { return StringHelpers::operationAddAssign<long>          (s1, number); }
+JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const unsigned long number)  { return StringHelpers::operationAddAssign<unsigned long> (s1, number); }
+JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const int64 number)          { return s1 += number; }
+JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const uint64 number)         { return s1 += number; }
+JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const float number)          { return StringHelpers::appendDouble (s1, (double) number); }
+JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const double number)         { return StringHelpers::appendDouble (s1, number); }
 
 JUCE_API OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, const String& text)
 {
@@ -2495,6 +2570,21 @@ public:
             expect (String::toHexString (0x1234abcd).equalsIgnoreCase ("1234abcd"));
             expect (String::toHexString ((int64) 0x1234abcd).equalsIgnoreCase ("1234abcd"));
             expect (String::toHexString ((short) 0x12ab).equalsIgnoreCase ("12ab"));
+            expect (String::toShortestRoundTripString (0.1) == "0.1");
+            expect (String::toShortestRoundTripString (-1234.5) == "-1234.5");
+            expect (String::toShortestRoundTripString (100.0) == "100");
+            expect (String::toShortestRoundTripString (0.3).getDoubleValue() == 0.3);
+            expect (String::toShortestRoundTripString (1.0 / 3.0).length() > String (1.0 / 3.0).length());
+
+            {
+                String appended;
+                appended << 12345 << ' ' << (int64) -9876543210LL << ' ' << (uint64) 42 << ' ' << 0.25 << ' ' << 1.5f;
+                expect (appended == "12345 -9876543210 42 0.25 1.5");
+
+                MemoryOutputStream mo;
+                mo << 0.25 << ' ' << -7 << ' ' << 3.0;
+                expect (mo.toString() == "0.25 -7 3");
+            }
 
             unsigned char data[] = { 1, 2, 3, 4, 0xa, 0xb, 0xc, 0xd };
             expect (String::toHexString (data, 8, 0).equalsIgnoreCase ("010203040a0b0c0d"));
@@ -2637,6 +2727,37 @@ public:
             TestUTFConversion <CharPointer_UTF32>::test (*this, r);
             TestUTFConversion <CharPointer_UTF8>::test (*this, r);
             TestUTFConversion <CharPointer_UTF16>::test (*this, r);
+
+            for (int i = 0; i < 50; ++i)
+            {
+                // long runs of ASCII broken up by multi-byte characters, to exercise the word-sized fast paths
+                Array<juce_wchar> chars;
+
+                for (int j = r.nextInt (10) + 1; --j >= 0;)
+                {
+                    for (int k = r.nextInt (40); --k >= 0;)
+                        chars.add ((juce_wchar) (32 + r.nextInt (95)));
+
+                    const juce_wchar wideChars[] = { 0xa9, 0x20ac, 0x1f600 };
+                    chars.add (wideChars [r.nextInt (3)]);
+                }
+
+                chars.add (0);
+
+                const String original (CharPointer_UTF32 (reinterpret_cast<const CharPointer_UTF32::CharType*> (chars.getRawDataPointer())));
+                const String utf8 (String::fromUTF8 (original.toRawUTF8()));
+
+                expectEquals ((int) CharPointer_UTF8 (original.toRawUTF8()).length(), chars.size() - 1);
+                expect (CharPointer_UTF8::isValidString (original.toRawUTF8(), (int) original.getNumBytesAsUTF8() + 10));
+                expect (String (original.toUTF16()) == utf8);
+                expect (String (original.toUTF32()) == utf8);
+                expect (original == utf8);
+
+                CharPointer_UTF8 p (original.toRawUTF8());
+                const int skip = r.nextInt (chars.size());
+                p += skip;
+                expect (*p == chars.getUnchecked (skip));
+            }
         }
 
         {
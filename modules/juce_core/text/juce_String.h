@@ -984,6 +984,16 @@ public:
     */
     String (double doubleValue, int numberOfDecimalPlaces);
 
+    /** Returns the shortest string which will parse back to exactly the same number.
+
+        Unlike String (double), which rounds the value to a handful of significant figures,
+        this keeps as many digits as are needed (up to 17) for the value to survive a round
+        trip through getDoubleValue(), so it's a good choice when serialising numbers.
+
+        @see getDoubleValue
+    */
+    static String toShortestRoundTripString (double doubleValue);
+
     /** Reads the value of the string as a decimal number (up to 32 bits in size).
 
         @returns the value of the string as a 32 bit signed base-10 integer.
@@ -0,0 +1,307 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_PARALLELALGORITHMS_H_INCLUDED
+#define JUCE_PARALLELALGORITHMS_H_INCLUDED
+
+#if JUCE_COMPILER_SUPPORTS_LAMBDAS || DOXYGEN
+
+#ifndef DOXYGEN
+/** This is an internal helper used by the parallel algorithms to share a number of
+    chunks of work between the calling thread and a ThreadPool.
+*/
+struct ParallelAlgorithmHelpers
+{
+    static int getGrainSize (ThreadPool& pool, int numItems, int grainSize) noexcept
+    {
+        if (grainSize > 0)
+            return grainSize;
+
+        // aim for a few chunks per thread, so that uneven work can still be balanced out
+        return jmax (1, numItems / (pool.getNumThreads() * 8));
+    }
+
+    template <typename ChunkFunction>
+    static void runChunks (ThreadPool& pool, const int numChunks, const ChunkFunction& chunkFunction)
+    {
+        if (numChunks <= 1)
+        {
+            if (numChunks == 1)
+                chunkFunction (0);
+
+            return;
+        }
+
+        Atomic<int> nextChunk;
+
+        const std::function<void()> worker = [&nextChunk, numChunks, &chunkFunction]
+        {
+            for (int chunk = (++nextChunk) - 1; chunk < numChunks; chunk = (++nextChunk) - 1)
+                chunkFunction (chunk);
+        };
+
+        ThreadPool::TaskGroup group (pool);
+
+        for (int i = jmin (numChunks - 1, pool.getNumThreads()); --i >= 0;)
+            group.addTask (worker);
+
+        // The calling thread does its share of the work too, and once all the chunks have been
+        // handed out, any helper tasks that haven't started yet have nothing to do, so they're
+        // cancelled rather than waited for. If this is called from inside another task, waiting
+        // for the group will run other tasks, so nested calls can't deadlock the pool.
+        worker();
+        group.cancel();
+        group.wait();
+    }
+};
+#endif
+
+//==============================================================================
+/**
+    Calls a function for a set of sub-ranges of the range [start, end), using the
+    threads in a ThreadPool as well as the calling thread.
+
+    The function must have the signature: void (int rangeStart, int rangeEnd), and will
+    be called concurrently from several threads, each time with a different, non-overlapping
+    part of the range.
+
+    @param pool             the pool whose threads should be used
+    @param start            the first index to process
+    @param end              the index after the last one to process
+    @param rangeFunction    the function to call for each sub-range
+    @param grainSize        the maximum number of items to pass to each call of the
+                            function. If this is zero, a size is chosen to give each
+                            thread a few ranges to work on.
+
+    It's safe to call this (or any of the other parallel algorithms) from inside a
+    task that's running on the same pool.
+
+    @see parallelFor, parallelReduce
+*/
+template <typename FunctionType>
+void parallelForRange (ThreadPool& pool, const int start, const int end,
+                       const FunctionType& rangeFunction, int grainSize = 0)
+{
+    const int numItems = end - start;
+
+    if (numItems <= 0)
+        return;
+
+    grainSize = ParallelAlgorithmHelpers::getGrainSize (pool, numItems, grainSize);
+
+    ParallelAlgorithmHelpers::runChunks (pool, (numItems + grainSize - 1) / grainSize,
+                                         [&rangeFunction, start, end, grainSize] (int chunk)
+                                         {
+                                             const int chunkStart = start + chunk * grainSize;
+                                             rangeFunction (chunkStart, jmin (end, chunkStart + grainSize));
+                                         });
+}
+
+/**
+    Calls a function once for each index in the range [start, end), using the threads
+    in a ThreadPool as well as the calling thread.
+
+    The function must have the signature: void (int index), and will be called
+    concurrently from several threads.
+
+    @see parallelForRange
+*/
+template <typename FunctionType>
+void parallelFor (ThreadPool& pool, const int start, const int end,
+                  const FunctionType& function, int grainSize = 0)
+{
+    parallelForRange (pool, start, end,
+                      [&function] (int rangeStart, int rangeEnd)
+                      {
+                          for (int i = rangeStart; i < rangeEnd; ++i)
+                              function (i);
+                      },
+                      grainSize);
+}
+
+/**
+    Splits the range [start, end) into sub-ranges, calculates a value for each of
+    them in parallel, and then combines these values.
+
+    @param pool             the pool whose threads should be used
+    @param start            the first index to process
+    @param end              the index after the last one to process
+    @param identity         the initial value for each sub-range, e.g. 0 for a sum
+    @param rangeFunction    a function with the signature
+                            ValueType (int rangeStart, int rangeEnd, ValueType initialValue),
+                            which calculates the value for a sub-range
+    @param combineFunction  a function with the signature ValueType (ValueType, ValueType),
+                            which combines the results of two sub-ranges
+    @param grainSize        the maximum number of items in each sub-range, or zero to
+                            choose a suitable size automatically
+
+    The sub-range results are always combined in order, from left to right, so the
+    combine function needs to be associative but doesn't need to be commutative, and the
+    result will be the same for a given grain size, regardless of how the work was shared.
+*/
+template <typename ValueType, typename RangeFunctionType, typename CombineFunctionType>
+ValueType parallelReduce (ThreadPool& pool, const int start, const int end, const ValueType& identity,
+                          const RangeFunctionType& rangeFunction, const CombineFunctionType& combineFunction,
+                          int grainSize = 0)
+{
+    const int numItems = end - start;
+
+    if (numItems <= 0)
+        return identity;
+
+    grainSize = ParallelAlgorithmHelpers::getGrainSize (pool, numItems, grainSize);
+    const int numChunks = (numItems + grainSize - 1) / grainSize;
+
+    // Every chunk is always run, so each result is constructed in place by the chunk that
+    // calculates it, which means that ValueType doesn't need to be default-constructible
+    // or safe to move around with memcpy.
+    HeapBlock<char> storage ((size_t) numChunks * sizeof (ValueType));
+    ValueType* const resultData = reinterpret_cast<ValueType*> (storage.getData());
+
+    ParallelAlgorithmHelpers::runChunks (pool, numChunks,
+                                         [&rangeFunction, &identity, resultData, start, end, grainSize] (int chunk)
+                                         {
+                                             const int chunkStart = start + chunk * grainSize;
+                                             new (resultData + chunk) ValueType (rangeFunction (chunkStart, jmin (end, chunkStart + grainSize), identity));
+                                         });
+
+    ValueType result (resultData[0]);
+
+    for (int i = 1; i < numChunks; ++i)
+        result = combineFunction (result, resultData[i]);
+
+    for (int i = 0; i < numChunks; ++i)
+        resultData[i].~ValueType();
+
+    return result;
+}
+
+//==============================================================================
+/**
+    Sorts a range of elements in an array, using the threads in a ThreadPool.
+
+    This works in the same way as sortArray(), but splits the range into blocks which
+    are sorted in parallel, and then merged together, also in parallel.
+
+    The comparator's compareElements() method will be called from several threads at
+    once, so it must be thread-safe.
+
+    @param pool             the pool whose threads should be used
+    @param comparator       an object which defines a compareElements() method
+    @param array            the array to sort
+    @param firstElement     the index of the first element of the range to be sorted
+    @param lastElement      the index of the last element in the range that needs
+                            sorting (this is inclusive)
+    @param retainOrderOfEquivalentItems     if true, the order of items that the
+                            comparator deems the same will be maintained
+    @param minimumBlockSize ranges smaller than this won't be split up any further
+
+    @see sortArray, parallelSort
+*/
+template <class ElementType, class ElementComparator>
+void parallelSortArray (ThreadPool& pool,
+                        ElementComparator& comparator,
+                        ElementType* const array,
+                        const int firstElement,
+                        const int lastElement,
+                        const bool retainOrderOfEquivalentItems,
+                        const int minimumBlockSize = 4096)
+{
+    const int numItems = lastElement - firstElement + 1;
+    const int numBlocks = jmin (pool.getNumThreads() + 1, numItems / jmax (2, minimumBlockSize));
+
+    if (numBlocks < 2)
+    {
+        sortArray (comparator, array, firstElement, lastElement, retainOrderOfEquivalentItems);
+        return;
+    }
+
+    HeapBlock<int> blockStarts ((size_t) numBlocks + 1);
+
+    for (int i = 0; i <= numBlocks; ++i)
+        blockStarts[i] = firstElement + (int) ((numItems * (int64) i) / numBlocks);
+
+    ParallelAlgorithmHelpers::runChunks (pool, numBlocks,
+                                         [&comparator, array, &blockStarts, retainOrderOfEquivalentItems] (int block)
+                                         {
+                                             sortArray (comparator, array, blockStarts[block], blockStarts[block + 1] - 1,
+                                                        retainOrderOfEquivalentItems);
+                                         });
+
+    // merge neighbouring pairs of sorted blocks, doubling the block size each time round..
+    // (std::inplace_merge is stable, so this keeps equivalent items in order if needed)
+    for (int width = 1; width < numBlocks; width *= 2)
+    {
+        const int numMerges = (numBlocks - width + (2 * width - 1)) / (2 * width);
+
+        ParallelAlgorithmHelpers::runChunks (pool, numMerges,
+                                             [&comparator, array, &blockStarts, numBlocks, width] (int merge)
+                                             {
+                                                 const int left = merge * 2 * width;
+                                                 SortFunctionConverter<ElementComparator> converter (comparator);
+
+                                                 std::inplace_merge (array + blockStarts[left],
+                                                                     array + blockStarts[left + width],
+                                                                     array + blockStarts[jmin (numBlocks, left + 2 * width)],
+                                                                     converter);
+                                             });
+    }
+}
+
+/**
+    Sorts the elements of an Array, using the threads in a ThreadPool.
+    The comparator must be thread-safe. See Array::sort() for details of the comparator.
+    @see parallelSortArray
+*/
+template <typename ElementType, typename TypeOfCriticalSectionToUse, int minimumAllocatedSize, class ElementComparator>
+void parallelSort (ThreadPool& pool,
+                   Array<ElementType, TypeOfCriticalSectionToUse, minimumAllocatedSize>& array,
+                   ElementComparator& comparator,
+                   const bool retainOrderOfEquivalentItems = false)
+{
+    const typename TypeOfCriticalSectionToUse::ScopedLockType lock (array.getLock());
+    parallelSortArray (pool, comparator, array.getRawDataPointer(), 0, array.size() - 1, retainOrderOfEquivalentItems);
+}
+
+/**
+    Sorts the objects in an OwnedArray, using the threads in a ThreadPool.
+    The comparator must be thread-safe. See OwnedArray::sort() for details of the comparator.
+    @see parallelSortArray
+*/
+template <class ObjectClass, class TypeOfCriticalSectionToUse, class ElementComparator>
+void parallelSort (ThreadPool& pool,
+                   OwnedArray<ObjectClass, TypeOfCriticalSectionToUse>& array,
+                   ElementComparator& comparator,
+                   const bool retainOrderOfEquivalentItems = false)
+{
+    const typename TypeOfCriticalSectionToUse::ScopedLockType lock (array.getLock());
+    parallelSortArray (pool, comparator, array.getRawDataPointer(), 0, array.size() - 1, retainOrderOfEquivalentItems);
+}
+
+#endif
+#endif   // JUCE_PARALLELALGORITHMS_H_INCLUDED
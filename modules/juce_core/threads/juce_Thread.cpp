@@ -33,6 +33,7 @@ Thread::Thread (const String& threadName_, const size_t stackSize)
       threadPriority (5),
       threadStackSize (stackSize),
       affinityMask (0),
+      hasRealtimeOptions (false),
       shouldExit (false)
 {
 }
@@ -97,6 +98,9 @@ void Thread::threadEntryPoint()
         if (affinityMask != 0)
             setCurrentThreadAffinityMask (affinityMask);
 
+        if (hasRealtimeOptions)
+            setCurrentThreadRealtimeOptions (realtimeOptions);
+
         try
         {
             run();
@@ -252,6 +256,60 @@ void Thread::setAffinityMask (const uint32 newAffinityMask)
     affinityMask = newAffinityMask;
 }
 
+//==============================================================================
+Thread::RealtimeOptions::RealtimeOptions() noexcept
+    : policy (roundRobin),
+      priority (9),
+      affinityMask (0),
+      periodMicroseconds (0),
+      runtimeMicroseconds (0),
+      stackBytesToPrefault (0),
+      lockMemory (false)
+{
+}
+
+bool Thread::setRealtimeOptions (const RealtimeOptions& newOptions)
+{
+    // as with setPriority(), the thread mustn't take the lock when it's changing itself
+    if (getCurrentThreadId() == getThreadId())
+    {
+        realtimeOptions = newOptions;
+        hasRealtimeOptions = true;
+        return setThreadRealtimeOptions (nullptr, newOptions);
+    }
+
+    const ScopedLock sl (startStopLock);
+
+    realtimeOptions = newOptions;
+    hasRealtimeOptions = true;
+
+    return (! isThreadRunning()) || setThreadRealtimeOptions (threadHandle, newOptions);
+}
+
+namespace ThreadHelpers
+{
+    // Each level of recursion dirties one more page of the stack. The page is touched again after
+    // the recursive call so that the compiler can't turn this into a loop that re-uses one frame.
+    static int prefaultStackPages (size_t numBytes) noexcept
+    {
+        volatile char page[4096];
+        page[0] = 1;
+
+        if (numBytes > sizeof (page))
+            page[1] = (char) prefaultStackPages (numBytes - sizeof (page));
+
+        return page[0];
+    }
+}
+
+bool JUCE_CALLTYPE Thread::setCurrentThreadRealtimeOptions (const RealtimeOptions& options)
+{
+    if (options.stackBytesToPrefault > 0)
+        ThreadHelpers::prefaultStackPages (options.stackBytesToPrefault);
+
+    return setThreadRealtimeOptions (nullptr, options);
+}
+
 //==============================================================================
 bool Thread::wait (const int timeOutMilliseconds) const
 {
@@ -204,6 +204,61 @@ public:
     */
     static void JUCE_CALLTYPE setCurrentThreadAffinityMask (uint32 affinityMask);
 
+    //==============================================================================
+    /** Describes how a thread that does time-critical work, such as audio processing,
+        should be scheduled by the OS.
+
+        On most systems, asking for a real-time policy or for locked memory needs
+        special privileges (e.g. an rtprio and memlock entry in limits.conf on Linux).
+
+        @see setRealtimeOptions, setCurrentThreadRealtimeOptions
+    */
+    struct JUCE_API  RealtimeOptions
+    {
+        /** Creates a set of options for a round-robin thread at priority 9. */
+        RealtimeOptions() noexcept;
+
+        /** The scheduling policies that can be requested. */
+        enum Policy
+        {
+            unchanged,          /**< Leaves the thread's existing policy and priority alone. */
+            roundRobin,         /**< Time-sliced against other real-time threads of the same priority (SCHED_RR). */
+            firstInFirstOut,    /**< Runs until it blocks or yields, or a higher-priority thread wants the CPU (SCHED_FIFO). */
+            deadline            /**< Guaranteed a slice of CPU time in each period (SCHED_DEADLINE - Linux only). */
+        };
+
+        Policy policy;
+        int priority;                   /**< 0 to 10, mapped onto the policy's range in the same way as setPriority(). */
+        uint64 affinityMask;            /**< One bit for each CPU that the thread may run on, or 0 to leave it unchanged. */
+        int periodMicroseconds;         /**< For the deadline policy, the length of each period. */
+        int runtimeMicroseconds;        /**< For the deadline policy, the CPU time needed in each period. */
+        size_t stackBytesToPrefault;    /**< This much of the thread's stack gets touched up-front, so it won't page-fault later. */
+        bool lockMemory;                /**< If true, all of the process's memory gets locked into RAM with mlockall(). */
+    };
+
+    /** Sets the real-time scheduling options for this thread.
+
+        If the thread is running, its policy, priority and affinity are changed straight
+        away, where the OS allows that to be done from another thread. Everything, including
+        the stack prefaulting, will be applied each time the thread is (re)started, taking
+        precedence over the priority that was passed to startThread().
+
+        @returns false if the options couldn't be applied to the running thread
+    */
+    bool setRealtimeOptions (const RealtimeOptions& options);
+
+    /** Applies a set of real-time options to the caller thread.
+        @returns true if all of the options could be applied
+        @see setRealtimeOptions
+    */
+    static bool JUCE_CALLTYPE setCurrentThreadRealtimeOptions (const RealtimeOptions& options);
+
+    /** Returns a description of the scheduling policy, priority and CPU affinity that the
+        caller thread has actually ended up with, which is handy for checking whether a
+        real-time configuration has really been granted by the OS.
+    */
+    static String JUCE_CALLTYPE getCurrentThreadSchedulingDescription();
+
     //==============================================================================
     // this can be called from any thread that needs to pause..
     static void JUCE_CALLTYPE sleep (int milliseconds);
@@ -286,6 +341,8 @@ private:
     int threadPriority;
     size_t threadStackSize;
     uint32 affinityMask;
+    RealtimeOptions realtimeOptions;
+    bool hasRealtimeOptions;
     bool volatile shouldExit;
 
    #ifndef DOXYGEN
@@ -297,6 +354,7 @@ private:
     void killThread();
     void threadEntryPoint();
     static bool setThreadPriority (void*, int);
+    static bool setThreadRealtimeOptions (void*, const RealtimeOptions&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Thread)
 };
@@ -26,6 +26,92 @@
   ==============================================================================
 */
 
+#if JUCE_COMPILER_SUPPORTS_LAMBDAS
+/*  A fixed-size work-stealing deque (after Chase & Lev). The owning thread pushes
+    and pops tasks at the bottom without taking any locks, while other threads can
+    steal the oldest tasks from the top.
+*/
+class ThreadPool::WorkQueue
+{
+public:
+    WorkQueue() noexcept
+    {
+        for (int i = 0; i < capacity; ++i)
+            slots[i] = nullptr;
+    }
+
+    // must only be called by the owning thread
+    bool push (TaskBase* const task) noexcept
+    {
+        const int64 b = bottom.get();
+
+        if (b - top.get() >= capacity)
+            return false;
+
+        slots [b & (capacity - 1)] = task;
+        Atomic<int64>::memoryBarrier();
+        bottom.set (b + 1);
+        return true;
+    }
+
+    // must only be called by the owning thread
+    TaskBase* pop() noexcept
+    {
+        const int64 b = bottom.get() - 1;
+        bottom.set (b);
+        Atomic<int64>::memoryBarrier();
+        const int64 t = top.get();
+
+        if (t > b)
+        {
+            bottom.set (b + 1);
+            return nullptr;
+        }
+
+        TaskBase* task = slots [b & (capacity - 1)];
+
+        if (t == b)
+        {
+            // this is the last item, so we need to race any thieves for it..
+            if (! top.compareAndSetBool (t + 1, t))
+                task = nullptr;
+
+            bottom.set (b + 1);
+        }
+
+        return task;
+    }
+
+    // can be called by any thread
+    TaskBase* steal() noexcept
+    {
+        const int64 t = top.get();
+        Atomic<int64>::memoryBarrier();
+        const int64 b = bottom.get();
+
+        if (t >= b)
+            return nullptr;
+
+        TaskBase* const task = slots [t & (capacity - 1)];
+        return top.compareAndSetBool (t + 1, t) ? task : nullptr;
+    }
+
+    bool isEmpty() const noexcept
+    {
+        return bottom.get() <= top.get();
+    }
+
+private:
+    enum { capacity = 1024 };
+
+    Atomic<int64> top, bottom;
+    TaskBase* volatile slots [capacity];
+
+    JUCE_DECLARE_NON_COPYABLE (WorkQueue)
+};
+#endif
+
+//==============================================================================
 class ThreadPool::ThreadPoolThread  : public Thread
 {
 public:
@@ -37,20 +123,25 @@ public:
     void run() override
     {
         while (! threadShouldExit())
-            if (! pool.runNextJob (*this))
-                wait (500);
+            if (! pool.runNextJob (*this) && pool.prepareToSleep (*this))
+                wait (-1);
     }
 
     ThreadPoolJob* volatile currentJob;
     ThreadPool& pool;
 
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    WorkQueue tasks;
+    Random random;
+   #endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
 
 //==============================================================================
 ThreadPoolJob::ThreadPoolJob (const String& name)
     : jobName (name), pool (nullptr),
-      shouldStop (false), isActive (false), shouldBeDeleted (false)
+      shouldStop (false), isActive (false), shouldBeDeleted (false), poolIndex (-1)
 {
 }
 
@@ -86,6 +177,10 @@ ThreadPoolJob* ThreadPoolJob::getCurrentThreadPoolJob()
 
 //==============================================================================
 ThreadPool::ThreadPool (const int numThreads, size_t threadStackSize)
+    : firstPendingJob (0)
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    , firstInjectedTask (0)
+   #endif
 {
     jassert (numThreads > 0); // not much point having a pool without any threads!
 
@@ -93,6 +188,10 @@ ThreadPool::ThreadPool (const int numThreads, size_t threadStackSize)
 }
 
 ThreadPool::ThreadPool()
+    : firstPendingJob (0)
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    , firstInjectedTask (0)
+   #endif
 {
     createThreads (SystemStats::getNumCpus());
 }
@@ -101,6 +200,10 @@ ThreadPool::~ThreadPool()
 {
     removeAllJobs (true, 5000);
     stopThreads();
+
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    cancelQueuedTasks();
+   #endif
 }
 
 void ThreadPool::createThreads (int numThreads, size_t threadStackSize)
@@ -115,7 +218,10 @@ void ThreadPool::createThreads (int numThreads, size_t threadStackSize)
 void ThreadPool::stopThreads()
 {
     for (int i = threads.size(); --i >= 0;)
+    {
         threads.getUnchecked(i)->signalThreadShouldExit();
+        threads.getUnchecked(i)->notify();
+    }
 
     for (int i = threads.size(); --i >= 0;)
         threads.getUnchecked(i)->stopThread (500);
@@ -135,11 +241,12 @@ void ThreadPool::addJob (ThreadPoolJob* const job, const bool deleteJobWhenFinis
 
         {
             const ScopedLock sl (lock);
+            job->poolIndex = jobs.size();
             jobs.add (job);
+            pendingJobs.add (job);
         }
 
-        for (int i = threads.size(); --i >= 0;)
-            threads.getUnchecked(i)->notify();
+        wakeIdleThread();
     }
 }
 
@@ -211,7 +318,8 @@ bool ThreadPool::removeJob (ThreadPoolJob* const job,
             }
             else
             {
-                jobs.removeFirstMatchingValue (job);
+                pendingJobs.set (pendingJobs.indexOf (job), nullptr);
+                removeFromJobList (job);
                 addToDeleteList (deletionList, job);
             }
         }
@@ -230,6 +338,7 @@ bool ThreadPool::removeAllJobs (const bool interruptRunningJobs, const int timeO
 
         {
             const ScopedLock sl (lock);
+            bool anyJobsRemoved = false;
 
             for (int i = jobs.size(); --i >= 0;)
             {
@@ -246,11 +355,28 @@ bool ThreadPool::removeAllJobs (const bool interruptRunningJobs, const int timeO
                     }
                     else
                     {
-                        jobs.remove (i);
+                        removeFromJobList (job);
                         addToDeleteList (deletionList, job);
+                        anyJobsRemoved = true;
                     }
                 }
             }
+
+            if (anyJobsRemoved)
+            {
+                // clear out the queue entries for any jobs that have just been removed
+                int numLeft = firstPendingJob;
+
+                for (int i = firstPendingJob; i < pendingJobs.size(); ++i)
+                {
+                    ThreadPoolJob* const job = pendingJobs.getUnchecked (i);
+
+                    if (job != nullptr && job->pool == this)
+                        pendingJobs.set (numLeft++, job);
+                }
+
+                pendingJobs.removeRange (numLeft, pendingJobs.size() - numLeft);
+            }
         }
     }
 
@@ -304,6 +430,43 @@ bool ThreadPool::setThreadPriorities (const int newPriority)
     return ok;
 }
 
+bool ThreadPool::setThreadRealtimeOptions (const Thread::RealtimeOptions& options)
+{
+    bool ok = true;
+
+    for (int i = threads.size(); --i >= 0;)
+        if (! threads.getUnchecked(i)->setRealtimeOptions (options))
+            ok = false;
+
+    return ok;
+}
+
+bool ThreadPool::isPoolThread() const
+{
+    return getCurrentPoolThread() != nullptr;
+}
+
+ThreadPool::ThreadPoolThread* ThreadPool::getCurrentPoolThread() const
+{
+    ThreadPoolThread* const t = dynamic_cast<ThreadPoolThread*> (Thread::getCurrentThread());
+    return (t != nullptr && &(t->pool) == this) ? t : nullptr;
+}
+
+//==============================================================================
+void ThreadPool::removeFromJobList (ThreadPoolJob* const job)
+{
+    // (the job list isn't kept in any particular order, so we can just swap the last one into this slot)
+    const int index = job->poolIndex;
+    jassert (jobs [index] == job);
+
+    ThreadPoolJob* const last = jobs.getLast();
+    jobs.set (index, last);
+    last->poolIndex = index;
+    jobs.removeLast();
+
+    job->poolIndex = -1;
+}
+
 ThreadPoolJob* ThreadPool::pickNextJobToRun()
 {
     OwnedArray<ThreadPoolJob> deletionList;
@@ -311,17 +474,25 @@ ThreadPoolJob* ThreadPool::pickNextJobToRun()
     {
         const ScopedLock sl (lock);
 
-        for (int i = 0; i < jobs.size(); ++i)
+        while (firstPendingJob < pendingJobs.size())
         {
-            ThreadPoolJob* job = jobs[i];
+            ThreadPoolJob* const job = pendingJobs.getUnchecked (firstPendingJob);
+            pendingJobs.set (firstPendingJob++, nullptr);
+
+            if (firstPendingJob > 64 && firstPendingJob * 2 > pendingJobs.size())
+            {
+                pendingJobs.removeRange (0, firstPendingJob);
+                firstPendingJob = 0;
+            }
 
-            if (job != nullptr && ! job->isActive)
+            if (job != nullptr)
             {
+                jassert (job->pool == this && ! job->isActive);
+
                 if (job->shouldStop)
                 {
-                    jobs.remove (i);
+                    removeFromJobList (job);
                     addToDeleteList (deletionList, job);
-                    --i;
                     continue;
                 }
 
@@ -336,6 +507,11 @@ ThreadPoolJob* ThreadPool::pickNextJobToRun()
 
 bool ThreadPool::runNextJob (ThreadPoolThread& thread)
 {
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    if (runNextTask (thread))
+        return true;
+   #endif
+
     if (ThreadPoolJob* const job = pickNextJobToRun())
     {
         ThreadPoolJob::JobStatus result = ThreadPoolJob::jobHasFinished;
@@ -343,6 +519,7 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
 
         try
         {
+            JUCE_TRACE_SCOPE_IN ("threadpool", "ThreadPoolJob::runJob");
             result = job->runJob();
         }
         catch (...)
@@ -357,13 +534,13 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
         {
             const ScopedLock sl (lock);
 
-            if (jobs.contains (job))
+            if (job->pool == this)
             {
                 job->isActive = false;
 
                 if (result != ThreadPoolJob::jobNeedsRunningAgain || job->shouldStop)
                 {
-                    jobs.removeFirstMatchingValue (job);
+                    removeFromJobList (job);
                     addToDeleteList (deletionList, job);
 
                     jobFinishedSignal.signal();
@@ -371,7 +548,7 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
                 else
                 {
                     // move the job to the end of the queue if it wants another go
-                    jobs.move (jobs.indexOf (job), -1);
+                    pendingJobs.add (job);
                 }
             }
         }
@@ -390,3 +567,543 @@ void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, Threa
     if (job->shouldBeDeleted)
         deletionList.add (job);
 }
+
+//==============================================================================
+bool ThreadPool::isWorkAvailable() const
+{
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    if (numInjectedTasks.get() > 0)
+        return true;
+
+    for (int i = threads.size(); --i >= 0;)
+        if (! threads.getUnchecked(i)->tasks.isEmpty())
+            return true;
+   #endif
+
+    const ScopedLock sl (lock);
+    return firstPendingJob < pendingJobs.size();
+}
+
+bool ThreadPool::prepareToSleep (ThreadPoolThread& thread)
+{
+    {
+        const ScopedLock sl (idleLock);
+        idleThreads.add (&thread);
+        ++numIdleThreads;
+    }
+
+    // check again, in case some work arrived just before we were added to the idle list..
+    if (! (isWorkAvailable() || thread.threadShouldExit()))
+        return true;
+
+    const ScopedLock sl (idleLock);
+    const int index = idleThreads.indexOf (&thread);
+
+    if (index >= 0)
+    {
+        idleThreads.remove (index);
+        --numIdleThreads;
+    }
+
+    return false;
+}
+
+void ThreadPool::wakeIdleThread()
+{
+    if (numIdleThreads.get() > 0)
+    {
+        ThreadPoolThread* thread = nullptr;
+
+        {
+            const ScopedLock sl (idleLock);
+
+            if (idleThreads.size() > 0)
+            {
+                thread = idleThreads.removeAndReturn (idleThreads.size() - 1);
+                --numIdleThreads;
+            }
+        }
+
+        if (thread != nullptr)
+            thread->notify();
+    }
+}
+
+//==============================================================================
+#if JUCE_COMPILER_SUPPORTS_LAMBDAS
+ThreadPool::TaskBase::TaskBase()  : group (nullptr), finishedEvent (true) {}
+ThreadPool::TaskBase::~TaskBase() {}
+
+void ThreadPool::addTaskInternal (TaskBase* const task, TaskGroup* const group)
+{
+    task->group = group;
+    task->incReferenceCount(); // (this reference belongs to whichever queue the task is in)
+
+    if (group != nullptr)
+        group->taskAdded();
+
+    ThreadPoolThread* const currentThread = getCurrentPoolThread();
+
+    if (currentThread == nullptr || ! currentThread->tasks.push (task))
+    {
+        const ScopedLock sl (injectedTaskLock);
+        injectedTasks.add (task);
+        ++numInjectedTasks;
+    }
+
+    wakeIdleThread();
+}
+
+ThreadPool::TaskBase* ThreadPool::popInjectedTask()
+{
+    if (numInjectedTasks.get() == 0)
+        return nullptr;
+
+    const ScopedLock sl (injectedTaskLock);
+
+    if (firstInjectedTask >= injectedTasks.size())
+        return nullptr;
+
+    TaskBase* const task = injectedTasks.getUnchecked (firstInjectedTask++);
+    --numInjectedTasks;
+
+    if (firstInjectedTask >= injectedTasks.size())
+    {
+        injectedTasks.clearQuick();
+        firstInjectedTask = 0;
+    }
+    else if (firstInjectedTask > 64 && firstInjectedTask * 2 > injectedTasks.size())
+    {
+        injectedTasks.removeRange (0, firstInjectedTask);
+        firstInjectedTask = 0;
+    }
+
+    return task;
+}
+
+ThreadPool::TaskBase* ThreadPool::findTaskToRun (ThreadPoolThread& thread)
+{
+    if (TaskBase* const task = thread.tasks.pop())
+        return task;
+
+    if (TaskBase* const task = popInjectedTask())
+        return task;
+
+    // nothing left locally, so try to steal from another thread, starting at a random one..
+    const int numThreads = threads.size();
+
+    if (numThreads > 1)
+    {
+        int victim = thread.random.nextInt (numThreads);
+
+        for (int i = numThreads; --i >= 0;)
+        {
+            ThreadPoolThread* const other = threads.getUnchecked (victim);
+
+            if (other != &thread)
+                if (TaskBase* const task = other->tasks.steal())
+                    return task;
+
+            if (++victim >= numThreads)
+                victim = 0;
+        }
+    }
+
+    return nullptr;
+}
+
+bool ThreadPool::runNextTask (ThreadPoolThread& thread)
+{
+    if (TaskBase* const task = findTaskToRun (thread))
+    {
+        runTask (task);
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::runTask (TaskBase* const task)
+{
+    if (task->group != nullptr && task->group->isCancelled())
+    {
+        if (task->state.compareAndSetBool (TaskBase::taskCancelled, TaskBase::taskPending))
+            finishTask (task, TaskBase::taskCancelled);
+    }
+    else if (task->state.compareAndSetBool (TaskBase::taskRunning, TaskBase::taskPending))
+    {
+        try
+        {
+            JUCE_TRACE_SCOPE_IN ("threadpool", "ThreadPool task");
+            task->run();
+        }
+        catch (...)
+        {
+            jassertfalse; // Your task mustn't throw any exceptions!
+        }
+
+        finishTask (task, TaskBase::taskFinished);
+    }
+
+    task->decReferenceCount();
+}
+
+void ThreadPool::finishTask (TaskBase* const task, const int newState)
+{
+    TaskGroup* const group = task->group;
+
+    task->state.set (newState);
+    task->finishedEvent.signal();
+
+    if (group != nullptr)
+        group->taskFinished();
+}
+
+bool ThreadPool::waitWhileHelping (const WaitableEvent& event, const int timeOutMs)
+{
+    ThreadPoolThread* const currentThread = getCurrentPoolThread();
+
+    if (currentThread == nullptr)
+        return event.wait (timeOutMs);
+
+    // If we're one of the pool's threads, then blocking here could deadlock if the thing we're
+    // waiting for is still in a queue, so we keep running other tasks until it's done.
+    const uint32 start = Time::getMillisecondCounter();
+
+    while (! event.wait (0))
+    {
+        if (timeOutMs >= 0 && Time::getMillisecondCounter() >= start + (uint32) timeOutMs)
+            return false;
+
+        if (! runNextTask (*currentThread))
+            event.wait (1);
+    }
+
+    return true;
+}
+
+void ThreadPool::cancelQueuedTasks()
+{
+    // (only called once the threads have all stopped, so it's safe to pop from their queues)
+    for (;;)
+    {
+        TaskBase* task = popInjectedTask();
+
+        for (int i = threads.size(); --i >= 0 && task == nullptr;)
+            task = threads.getUnchecked(i)->tasks.pop();
+
+        if (task == nullptr)
+            break;
+
+        if (task->state.compareAndSetBool (TaskBase::taskCancelled, TaskBase::taskPending))
+            finishTask (task, TaskBase::taskCancelled);
+
+        task->decReferenceCount();
+    }
+}
+
+//==============================================================================
+ThreadPool::TaskGroup::TaskGroup (ThreadPool& p)
+    : pool (p), finishedEvent (true)
+{
+    finishedEvent.signal();
+}
+
+ThreadPool::TaskGroup::~TaskGroup()
+{
+    wait();
+
+    // (make sure the last task to finish has let go of the lock before we delete it)
+    const ScopedLock sl (signalLock);
+}
+
+void ThreadPool::TaskGroup::addTask (const std::function<void()>& function)
+{
+    pool.addTaskInternal (new ResultTask<void> (function), this);
+}
+
+bool ThreadPool::TaskGroup::wait (const int timeOutMilliseconds)
+{
+    return pool.waitWhileHelping (finishedEvent, timeOutMilliseconds);
+}
+
+void ThreadPool::TaskGroup::cancel() noexcept
+{
+    cancelled.set (1);
+}
+
+void ThreadPool::TaskGroup::taskAdded()
+{
+    if (++numOutstanding == 1)
+    {
+        const ScopedLock sl (signalLock);
+
+        if (numOutstanding.get() > 0)
+            finishedEvent.reset();
+    }
+}
+
+void ThreadPool::TaskGroup::taskFinished()
+{
+    if (--numOutstanding == 0)
+    {
+        const ScopedLock sl (signalLock);
+
+        if (numOutstanding.get() == 0)
+            finishedEvent.signal();
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ThreadPoolTests  : public UnitTest
+{
+public:
+    ThreadPoolTests() : UnitTest ("ThreadPool") {}
+
+    struct CountingJob  : public ThreadPoolJob
+    {
+        CountingJob (Atomic<int>& c, int runs)  : ThreadPoolJob ("counter"), counter (c), runsLeft (runs) {}
+
+        JobStatus runJob() override
+        {
+            ++counter;
+            return --runsLeft > 0 ? jobNeedsRunningAgain : jobHasFinished;
+        }
+
+        Atomic<int>& counter;
+        int runsLeft;
+    };
+
+    static int fibonacci (ThreadPool& pool, int n)
+    {
+        if (n < 12)
+            return n < 2 ? n : fibonacci (pool, n - 1) + fibonacci (pool, n - 2);
+
+        ThreadPool::Future<int> a = pool.addTask ([&pool, n] { return fibonacci (pool, n - 1); });
+        const int b = fibonacci (pool, n - 2);
+        return a.get() + b;
+    }
+
+    void runTest() override
+    {
+        beginTest ("Jobs");
+
+        {
+            ThreadPool pool (4);
+            Atomic<int> counter;
+
+            for (int i = 0; i < 1000; ++i)
+                pool.addJob (new CountingJob (counter, 1 + (i % 3)), true);
+
+            for (int i = 0; i < 1000 && pool.getNumJobs() > 0; ++i)
+                Thread::sleep (5);
+
+            expectEquals (pool.getNumJobs(), 0);
+            expectEquals (counter.get(), 333 * 6 + 1);
+
+            CountingJob job (counter, std::numeric_limits<int>::max());
+            pool.addJob (&job, false);
+            expect (pool.contains (&job));
+            expect (pool.removeJob (&job, true, 5000));
+            expect (! pool.contains (&job));
+        }
+
+        beginTest ("Tasks");
+
+        {
+            ThreadPool pool (4);
+
+            ThreadPool::Future<int> results[1000];
+
+            for (int i = 0; i < numElementsInArray (results); ++i)
+                results[i] = pool.addTask ([i] { return i * i; });
+
+            for (int i = 0; i < numElementsInArray (results); ++i)
+                expectEquals (results[i].get(), i * i);
+
+            expectEquals (pool.addTask ([&pool] { return fibonacci (pool, 22); }).get(), 17711);
+
+            Atomic<int> counter;
+            ThreadPool::Future<void> f = pool.addTask ([&counter] { ++counter; });
+            expect (f.wait (5000));
+            expect (f.isFinished() && ! f.wasCancelled());
+            expectEquals (counter.get(), 1);
+        }
+
+        beginTest ("Task groups");
+
+        {
+            ThreadPool pool (4);
+            Atomic<int> counter;
+
+            {
+                ThreadPool::TaskGroup group (pool);
+
+                for (int i = 0; i < 5000; ++i)
+                    group.addTask ([&counter, &group, &pool]
+                                   {
+                                       ++counter;
+
+                                       if (counter.get() % 100 == 0)
+                                           group.addTask ([&counter] { ++counter; });
+                                   });
+
+                expect (group.wait (10000));
+                expectEquals (group.getNumOutstandingTasks(), 0);
+            }
+
+            expect (counter.get() >= 5000);
+
+            WaitableEvent blocker;
+            ThreadPool::TaskGroup group (pool);
+            counter.set (0);
+
+            for (int i = 0; i < 4; ++i)
+                group.addTask ([&blocker] { blocker.wait (5000); });
+
+            for (int i = 0; i < 100; ++i)
+                group.addTask ([&counter] { ++counter; });
+
+            group.cancel();
+
+            for (int i = 0; i < 4; ++i)
+                blocker.signal();
+
+            expect (group.wait (10000));
+            expect (counter.get() < 100);
+        }
+    }
+};
+
+static ThreadPoolTests threadPoolTests;
+
+//==============================================================================
+class ParallelAlgorithmTests  : public UnitTest
+{
+public:
+    ParallelAlgorithmTests() : UnitTest ("Parallel algorithms") {}
+
+    struct KeyAndIndex
+    {
+        int key, index;
+    };
+
+    struct KeyComparator
+    {
+        static int compareElements (const KeyAndIndex& a, const KeyAndIndex& b) noexcept    { return a.key - b.key; }
+    };
+
+    void runTest() override
+    {
+        ThreadPool pool (4);
+        Random r = getRandom();
+
+        beginTest ("parallelFor");
+
+        {
+            Array<int> values;
+            values.insertMultiple (0, 0, 100000);
+            int* const data = values.getRawDataPointer();
+
+            parallelFor (pool, 0, values.size(), [data] (int i) { data[i] += i * 2; });
+
+            bool allOk = true;
+
+            for (int i = 0; i < values.size(); ++i)
+                allOk = allOk && values.getUnchecked (i) == i * 2;
+
+            expect (allOk);
+
+            // nested calls from inside tasks mustn't deadlock
+            Atomic<int> total;
+
+            parallelFor (pool, 0, 16, [&pool, &total] (int)
+            {
+                parallelFor (pool, 0, 1000, [&total] (int) { ++total; }, 10);
+            }, 1);
+
+            expectEquals (total.get(), 16000);
+        }
+
+        beginTest ("parallelReduce");
+
+        {
+            const int64 sum = parallelReduce (pool, 0, 1000001, (int64) 0,
+                                              [] (int start, int end, int64 initial)
+                                              {
+                                                  for (int i = start; i < end; ++i)
+                                                      initial += i;
+
+                                                  return initial;
+                                              },
+                                              [] (int64 a, int64 b) { return a + b; });
+
+            expect (sum == (int64) 500000500000LL);
+
+            const String joined = parallelReduce (pool, 0, 26, String(),
+                                                  [] (int start, int end, String s)
+                                                  {
+                                                      for (int i = start; i < end; ++i)
+                                                          s += (juce_wchar) ('a' + i);
+
+                                                      return s;
+                                                  },
+                                                  [] (const String& a, const String& b) { return a + b; },
+                                                  3);
+
+            expectEquals (joined, String ("abcdefghijklmnopqrstuvwxyz"));
+        }
+
+        beginTest ("parallelSort");
+
+        {
+            Array<int> values, sorted;
+
+            for (int i = 0; i < 200000; ++i)
+                values.add (r.nextInt());
+
+            sorted = values;
+            DefaultElementComparator<int> comparator;
+
+            const double t1 = Time::getMillisecondCounterHiRes();
+            sorted.sort (comparator);
+            const double t2 = Time::getMillisecondCounterHiRes();
+            parallelSort (pool, values, comparator);
+            const double t3 = Time::getMillisecondCounterHiRes();
+
+            logMessage ("Sorting 200000 ints: " + String (t2 - t1, 1) + "ms serial, "
+                          + String (t3 - t2, 1) + "ms with " + String (pool.getNumThreads()) + " threads");
+
+            expect (values == sorted);
+
+            Array<KeyAndIndex> items;
+
+            for (int i = 0; i < 50000; ++i)
+            {
+                const KeyAndIndex item = { r.nextInt (100), i };
+                items.add (item);
+            }
+
+            KeyComparator keyComparator;
+            parallelSort (pool, items, keyComparator, true);
+
+            bool stable = true;
+
+            for (int i = 1; i < items.size(); ++i)
+            {
+                const KeyAndIndex& a = items.getReference (i - 1);
+                const KeyAndIndex& b = items.getReference (i);
+                stable = stable && (a.key < b.key || (a.key == b.key && a.index < b.index));
+            }
+
+            expect (stable);
+        }
+    }
+};
+
+static ParallelAlgorithmTests parallelAlgorithmTests;
+
+#endif
+#endif
@@ -132,6 +132,7 @@ private:
     String jobName;
     ThreadPool* pool;
     bool shouldStop, isActive, shouldBeDeleted;
+    int poolIndex;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolJob)
 };
@@ -144,6 +145,12 @@ private:
     When a ThreadPoolJob object is added to the ThreadPool's list, its runJob() method
     will be called by the next pooled thread that becomes free.
 
+    As well as ThreadPoolJob objects, the pool can run lightweight tasks, which are
+    just functions or lambdas - see addTask() and TaskGroup. Each thread keeps its own
+    queue of tasks, and threads that run out of work will steal tasks from the others,
+    so a task that adds more tasks doesn't need to touch any shared locks. Idle threads
+    sleep until some new work arrives.
+
     @see ThreadPoolJob, Thread
 */
 class JUCE_API  ThreadPool
@@ -296,26 +303,108 @@ public:
     */
     bool setThreadPriorities (int newPriority);
 
+    /** Applies a set of real-time scheduling options to all the threads.
+
+        This will call Thread::setRealtimeOptions() for each thread in the pool.
+        May return false if for some reason the options can't be applied.
+    */
+    bool setThreadRealtimeOptions (const Thread::RealtimeOptions& options);
+
+    //==============================================================================
+    /** Returns true if the calling thread is one of this pool's threads. */
+    bool isPoolThread() const;
+
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    //==============================================================================
+    template <typename ResultType> class Future;
+    class TaskGroup;
+
+    /** The base class for the tasks that are run by addTask() and TaskGroup.
+        You shouldn't need to use this directly.
+    */
+    struct JUCE_API  TaskBase  : public ReferenceCountedObject
+    {
+        TaskBase();
+        virtual ~TaskBase();
+        virtual void run() = 0;
+
+        enum State { taskPending, taskRunning, taskFinished, taskCancelled };
+
+        Atomic<int> state;
+        TaskGroup* group;
+        WaitableEvent finishedEvent;
+
+        JUCE_DECLARE_NON_COPYABLE (TaskBase)
+    };
+
+    /** Adds a function to be run by one of the pool's threads, and returns a Future
+        that can be used to wait for it to complete and to retrieve its return value.
+
+        This is much cheaper than creating a ThreadPoolJob, so it's suitable for
+        huge numbers of short tasks. When called from one of the pool's own threads,
+        the task is pushed onto that thread's queue, and may be stolen by another thread
+        if that one is busy.
+
+        The function's return type must be void, or a copyable type with a default constructor.
+        If you don't need the result, you can just ignore the Future that is returned.
+
+        e.g.
+        @code
+        ThreadPool::Future<int> f = pool.addTask ([] { return calculateSomething(); });
+        ...
+        int result = f.get();
+        @endcode
+    */
+    template <typename FunctionType>
+    auto addTask (FunctionType function) -> Future<decltype (function())>;
+   #endif
 
 private:
     //==============================================================================
-    Array <ThreadPoolJob*> jobs;
+    Array<ThreadPoolJob*> jobs, pendingJobs;
+    int firstPendingJob;
 
     class ThreadPoolThread;
+    class WorkQueue;
     friend class ThreadPoolJob;
     friend class ThreadPoolThread;
     friend struct ContainerDeletePolicy<ThreadPoolThread>;
     OwnedArray<ThreadPoolThread> threads;
 
-    CriticalSection lock;
+    CriticalSection lock, idleLock;
     WaitableEvent jobFinishedSignal;
+    Array<ThreadPoolThread*> idleThreads;
+    Atomic<int> numIdleThreads;
 
     bool runNextJob (ThreadPoolThread&);
+    bool isWorkAvailable() const;
+    bool prepareToSleep (ThreadPoolThread&);
+    void wakeIdleThread();
+    ThreadPoolThread* getCurrentPoolThread() const;
     ThreadPoolJob* pickNextJobToRun();
+    void removeFromJobList (ThreadPoolJob*);
     void addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
     void createThreads (int numThreads, size_t threadStackSize = 0);
     void stopThreads();
 
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    template <typename ResultType> struct ResultTask;
+
+    CriticalSection injectedTaskLock;
+    Array<TaskBase*> injectedTasks;
+    int firstInjectedTask;
+    Atomic<int> numInjectedTasks;
+
+    void addTaskInternal (TaskBase*, TaskGroup*);
+    TaskBase* popInjectedTask();
+    TaskBase* findTaskToRun (ThreadPoolThread&);
+    bool runNextTask (ThreadPoolThread&);
+    void runTask (TaskBase*);
+    void finishTask (TaskBase*, int newState);
+    bool waitWhileHelping (const WaitableEvent&, int timeOutMilliseconds);
+    void cancelQueuedTasks();
+   #endif
+
     // Note that this method has changed, and no longer has a parameter to indicate
     // whether the jobs should be deleted - see the new method for details.
     void removeAllJobs (bool, int, bool);
@@ -323,5 +412,178 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPool)
 };
 
+#if JUCE_COMPILER_SUPPORTS_LAMBDAS
+//==============================================================================
+/** @internal */
+template <typename ResultType>
+struct ThreadPool::ResultTask  : public ThreadPool::TaskBase
+{
+    ResultTask (const std::function<ResultType()>& f) : function (f), result() {}
+    void run() override                 { result = function(); }
+    ResultType getResult() const        { return result; }
+
+    std::function<ResultType()> function;
+    ResultType result;
+};
+
+/** @internal */
+template <>
+struct ThreadPool::ResultTask<void>  : public ThreadPool::TaskBase
+{
+    ResultTask (const std::function<void()>& f) : function (f) {}
+    void run() override                 { function(); }
+    void getResult() const              {}
+
+    std::function<void()> function;
+};
+
+//==============================================================================
+/**
+    A handle to a task that was started with ThreadPool::addTask().
+
+    This lets you find out whether the task has finished, wait for it, cancel it if
+    it hasn't started yet, and get hold of the value that it returned.
+
+    Futures are cheap to copy, and it's safe to let them go out of scope before the
+    task has finished.
+
+    @see ThreadPool::addTask
+*/
+template <typename ResultType>
+class ThreadPool::Future
+{
+public:
+    /** Creates an invalid Future which doesn't refer to any task. */
+    Future() noexcept  : pool (nullptr) {}
+
+    /** Returns true if this refers to a task. */
+    bool isValid() const noexcept           { return task != nullptr; }
+
+    /** Returns true if the task has either been run or cancelled. */
+    bool isFinished() const noexcept        { return task == nullptr || task->state.get() >= TaskBase::taskFinished; }
+
+    /** Returns true if the task was cancelled before it could run. */
+    bool wasCancelled() const noexcept      { return task != nullptr && task->state.get() == TaskBase::taskCancelled; }
+
+    /** Waits for the task to finish.
+
+        If called from one of the pool's threads, this will run other tasks while
+        it waits, so it's safe to wait for tasks from inside other tasks.
+
+        @returns true if the task finished, or false if the timeout expired first
+    */
+    bool wait (int timeOutMilliseconds = -1) const
+    {
+        return task == nullptr || pool->waitWhileHelping (task->finishedEvent, timeOutMilliseconds);
+    }
+
+    /** Tries to stop the task from running.
+        @returns true if the task hadn't started and has now been cancelled, or false
+                 if it's already running or finished.
+    */
+    bool cancel()
+    {
+        if (task != nullptr && task->state.compareAndSetBool (TaskBase::taskCancelled, TaskBase::taskPending))
+        {
+            pool->finishTask (task, TaskBase::taskCancelled);
+            return true;
+        }
+
+        return false;
+    }
+
+    /** Waits for the task to finish, and returns the value that it returned.
+        If the task was cancelled, this returns a default-constructed value.
+    */
+    ResultType get() const
+    {
+        jassert (isValid());
+        wait();
+        return task->getResult();
+    }
+
+private:
+    friend class ThreadPool;
+    ThreadPool* pool;
+    ReferenceCountedObjectPtr<ResultTask<ResultType> > task;
+};
+
+//==============================================================================
+/**
+    A set of tasks that can be waited for or cancelled together.
+
+    e.g.
+    @code
+    ThreadPool::TaskGroup group (pool);
+
+    for (int i = 0; i < files.size(); ++i)
+        group.addTask ([&files, i] { createThumbnail (files.getReference (i)); });
+
+    group.wait();
+    @endcode
+
+    The group's destructor will wait for any of its tasks that are still outstanding.
+
+    @see ThreadPool::addTask
+*/
+class JUCE_API  ThreadPool::TaskGroup
+{
+public:
+    /** Creates an empty group which will run its tasks on the given pool. */
+    explicit TaskGroup (ThreadPool& pool);
+
+    /** Destructor. This will wait for any outstanding tasks to finish. */
+    ~TaskGroup();
+
+    /** Adds a function to be run as part of this group. */
+    void addTask (const std::function<void()>& function);
+
+    /** Waits for all the tasks in the group to finish.
+
+        If called from one of the pool's threads, this will run other tasks while
+        it waits, so it's safe to wait for a group from inside another task.
+
+        @returns true if all the tasks finished, or false if the timeout expired first
+    */
+    bool wait (int timeOutMilliseconds = -1);
+
+    /** Stops any tasks in the group which haven't yet started from being run.
+        Tasks that are already running will carry on, but can call isCancelled()
+        to find out that they should give up early.
+    */
+    void cancel() noexcept;
+
+    /** Returns true if cancel() has been called. */
+    bool isCancelled() const noexcept               { return cancelled.get() != 0; }
+
+    /** Returns the number of tasks that have been added but not yet finished. */
+    int getNumOutstandingTasks() const noexcept     { return numOutstanding.get(); }
+
+private:
+    friend class ThreadPool;
+    ThreadPool& pool;
+    Atomic<int> numOutstanding, cancelled;
+    CriticalSection signalLock;
+    WaitableEvent finishedEvent;
+
+    void taskAdded();
+    void taskFinished();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TaskGroup)
+};
+
+template <typename FunctionType>
+auto ThreadPool::addTask (FunctionType function) -> Future<decltype (function())>
+{
+    typedef decltype (function()) ResultType;
+
+    Future<ResultType> f;
+    f.pool = this;
+    f.task = new ResultTask<ResultType> (function);
+    addTaskInternal (f.task, nullptr);
+    return f;
+}
+#endif
+
 
 #endif   // JUCE_THREADPOOL_H_INCLUDED
@@ -0,0 +1,563 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+namespace TracerEventTypes
+{
+    enum
+    {
+        zoneBeginEvent,
+        zoneEndEvent,
+        instantEvent,
+        counterEvent,
+        flowBeginEvent,
+        flowStepEvent,
+        flowEndEvent
+    };
+}
+
+namespace TracerHelpers
+{
+    // This is done with the native call rather than through Thread::getCurrentThread(),
+    // which can lock and allocate when it's called by a thread that juce didn't create.
+    static void getCurrentThreadName (char* dest, size_t maxBytes) noexcept
+    {
+       #if (JUCE_LINUX && (__GLIBC__ * 1000 + __GLIBC_MINOR__) >= 2012) || JUCE_MAC || JUCE_IOS
+        if (pthread_getname_np (pthread_self(), dest, maxBytes) == 0)
+            return;
+       #else
+        ignoreUnused (maxBytes);
+       #endif
+
+        dest[0] = 0;
+    }
+}
+
+struct Tracer::ThreadBuffer
+{
+    ThreadBuffer (int index)  : mask (0), threadIndex (index)
+    {
+        threadName[0] = 0;
+    }
+
+    // Called by startRecording(), once nothing can be writing to the buffer
+    void reset (int maxEvents)
+    {
+        const int newMask = nextPowerOfTwo (jmax (16, maxEvents)) - 1;
+
+        if (newMask != mask || events == nullptr)
+        {
+            mask = newMask;
+            events.malloc ((size_t) mask + 1);
+        }
+
+        numWritten = 0;
+        owner = nullptr;
+    }
+
+    // Called by a thread the first time it records something in each session. The first
+    // event is often recorded by an audio thread, so this mustn't lock or allocate.
+    bool claim (Thread::ThreadID thread) noexcept
+    {
+        if (! owner.compareAndSetBool (thread, nullptr))
+            return false;
+
+        // (thread IDs can get re-used, so this may not be the thread that used the buffer last time)
+        TracerHelpers::getCurrentThreadName (threadName, sizeof (threadName));
+        return true;
+    }
+
+    String getThreadName() const
+    {
+        return threadName[0] != 0 ? String::fromUTF8 (threadName)
+                                  : "Thread " + String (threadIndex);
+    }
+
+    struct Event
+    {
+        int64 time;
+        const char* name;
+        const char* category;
+        double value;
+        uint64 flowID;
+        int type;
+    };
+
+    HeapBlock<Event> events;
+    Atomic<int64> numWritten;   // only ever incremented by the thread that owns this buffer
+    Atomic<Thread::ThreadID> owner;
+    Atomic<int> numWriters;
+    int mask;
+    const int threadIndex;
+    char threadName[64];
+
+    JUCE_DECLARE_NON_COPYABLE (ThreadBuffer)
+};
+
+struct Tracer::SharedState
+{
+    SharedState() : maxEventsPerThread (65536), startTime (Time::getHighResolutionTicks()) {}
+
+    ~SharedState()
+    {
+        for (int i = numBuffers.get(); --i >= 0;)
+            delete buffers[i];
+    }
+
+    static SharedState& getInstance()
+    {
+        static SharedState state;
+        return state;
+    }
+
+    ThreadBuffer* getBufferForCurrentThread (Thread::ThreadID thisThread) noexcept
+    {
+        const int num = numBuffers.get();
+
+        for (int i = 0; i < num; ++i)
+            if (buffers[i]->owner.get() == thisThread)
+                return buffers[i];
+
+        // This thread hasn't recorded anything since recording started, so it takes over
+        // one of the spare buffers. If there aren't any left, its events get dropped.
+        for (int i = 0; i < num; ++i)
+            if (buffers[i]->claim (thisThread))
+                return buffers[i];
+
+        return nullptr;
+    }
+
+    enum { maxNumBuffers = 256 };
+
+    Atomic<int> recording, numBuffers, numEventsDropped;
+    int maxEventsPerThread;
+    int64 startTime;
+    CriticalSection lock;
+    ThreadBuffer* buffers[maxNumBuffers]; // (only deleted at shutdown, as other threads may be looking at them)
+};
+
+//==============================================================================
+void JUCE_CALLTYPE Tracer::startRecording (int maxEventsPerThread, int numSpareThreadBuffers)
+{
+    SharedState& s = SharedState::getInstance();
+    stopRecording();
+
+    const ScopedLock sl (s.lock);
+    const int numExisting = s.numBuffers.get();
+    int numInUse = 0;
+
+    // All the buffers get allocated here, rather than when each thread first needs one,
+    // so that recording an event never has to lock or allocate anything.
+    for (int i = 0; i < numExisting; ++i)
+    {
+        ThreadBuffer& b = *s.buffers[i];
+
+        // (a thread may have checked the recording flag just before it was cleared)
+        while (b.numWriters.get() != 0)
+            Thread::yield();
+
+        if (b.owner.get() != nullptr)
+            ++numInUse;
+
+        b.reset (maxEventsPerThread);
+    }
+
+    const int numNeeded = jmin ((int) SharedState::maxNumBuffers, numInUse + jmax (0, numSpareThreadBuffers));
+
+    for (int i = numExisting; i < numNeeded; ++i)
+    {
+        ThreadBuffer* const b = new ThreadBuffer (i + 1);
+        b->reset (maxEventsPerThread);
+        s.buffers[i] = b;
+        s.numBuffers = i + 1;
+    }
+
+    s.maxEventsPerThread = maxEventsPerThread;
+    s.startTime = Time::getHighResolutionTicks();
+    s.numEventsDropped = 0;
+    s.recording = 1;
+}
+
+void JUCE_CALLTYPE Tracer::stopRecording() noexcept
+{
+    SharedState::getInstance().recording = 0;
+}
+
+bool JUCE_CALLTYPE Tracer::isRecording() noexcept
+{
+    return SharedState::getInstance().recording.get() != 0;
+}
+
+void JUCE_CALLTYPE Tracer::clear()
+{
+    SharedState& s = SharedState::getInstance();
+    const ScopedLock sl (s.lock);
+
+    for (int i = 0; i < s.numBuffers.get(); ++i)
+        s.buffers[i]->numWritten = 0;
+
+    s.numEventsDropped = 0;
+}
+
+int JUCE_CALLTYPE Tracer::getNumEventsRecorded()
+{
+    SharedState& s = SharedState::getInstance();
+    const ScopedLock sl (s.lock);
+    int64 total = 0;
+
+    for (int i = 0; i < s.numBuffers.get(); ++i)
+    {
+        const ThreadBuffer& b = *s.buffers[i];
+
+        if (b.owner.get() != nullptr)
+            total += jmin (b.numWritten.get(), (int64) b.mask + 1);
+    }
+
+    return (int) total;
+}
+
+int JUCE_CALLTYPE Tracer::getNumEventsDropped() noexcept
+{
+    return SharedState::getInstance().numEventsDropped.get();
+}
+
+//==============================================================================
+void Tracer::record (int type, const char* name, const char* category, double value, uint64 flowID) noexcept
+{
+    SharedState& s = SharedState::getInstance();
+
+    if (s.recording.get() == 0)
+        return;
+
+    const Thread::ThreadID thisThread = Thread::getCurrentThreadId();
+    ThreadBuffer* const b = s.getBufferForCurrentThread (thisThread);
+
+    if (b == nullptr)
+    {
+        ++s.numEventsDropped;
+        return;
+    }
+
+    // startRecording() clears the recording flag and then waits for the writer count to drop
+    // before it resets a buffer, so after bumping the count, the flag and owner need checking
+    // again in case startRecording() has run since we found this buffer
+    ++(b->numWriters);
+
+    if (s.recording.get() != 0 && b->owner.get() == thisThread)
+    {
+        const int64 index = b->numWritten.get();
+
+        ThreadBuffer::Event& e = b->events[(int) (index & b->mask)];
+        e.time = Time::getHighResolutionTicks();
+        e.name = name;
+        e.category = category;
+        e.value = value;
+        e.flowID = flowID;
+        e.type = type;
+
+        b->numWritten = index + 1;
+    }
+
+    --(b->numWriters);
+}
+
+void JUCE_CALLTYPE Tracer::beginZone (const char* name, const char* category) noexcept   { record (TracerEventTypes::zoneBeginEvent, name, category, 0, 0); }
+void JUCE_CALLTYPE Tracer::endZone() noexcept                                          { record (TracerEventTypes::zoneEndEvent, nullptr, nullptr, 0, 0); }
+void JUCE_CALLTYPE Tracer::instant (const char* name, const char* category) noexcept     { record (TracerEventTypes::instantEvent, name, category, 0, 0); }
+void JUCE_CALLTYPE Tracer::counter (const char* name, double value) noexcept            { record (TracerEventTypes::counterEvent, name, "counter", value, 0); }
+void JUCE_CALLTYPE Tracer::flowBegin (const char* name, uint64 flowID) noexcept         { record (TracerEventTypes::flowBeginEvent, name, "flow", 0, flowID); }
+void JUCE_CALLTYPE Tracer::flowStep (const char* name, uint64 flowID) noexcept          { record (TracerEventTypes::flowStepEvent, name, "flow", 0, flowID); }
+void JUCE_CALLTYPE Tracer::flowEnd (const char* name, uint64 flowID) noexcept           { record (TracerEventTypes::flowEndEvent, name, "flow", 0, flowID); }
+
+//==============================================================================
+namespace TracerHelpers
+{
+    static void writeEventStart (OutputStream& out, bool& isFirst, const char* phase,
+                                 const char* name, const char* category, int threadIndex)
+    {
+        out << (isFirst ? "\n" : ",\n") << "{\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << threadIndex;
+        isFirst = false;
+
+        if (name != nullptr)
+            out << ",\"name\":\"" << JSON::escapeString (name) << '"';
+
+        if (category != nullptr)
+            out << ",\"cat\":\"" << JSON::escapeString (category) << '"';
+    }
+}
+
+bool JUCE_CALLTYPE Tracer::writeChromeTrace (OutputStream& out)
+{
+    using namespace TracerEventTypes;
+
+    SharedState& s = SharedState::getInstance();
+    const ScopedLock sl (s.lock);
+
+    const double microsecondsPerTick = 1.0e6 / (double) Time::getHighResolutionTicksPerSecond();
+    bool isFirst = true;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    for (int i = 0; i < s.numBuffers.get(); ++i)
+    {
+        const ThreadBuffer& b = *s.buffers[i];
+
+        if (b.owner.get() == nullptr)
+            continue; // (no thread has recorded anything into this one since recording last started)
+
+        TracerHelpers::writeEventStart (out, isFirst, "M", "thread_name", nullptr, b.threadIndex);
+        out << ",\"args\":{\"name\":" << JSON::toString (b.getThreadName()) << "}}";
+
+        const int64 end = b.numWritten.get();
+        const int64 start = jmax ((int64) 0, end - (b.mask + 1));
+
+        // if the oldest events have been overwritten, some of the zone ends
+        // may have lost their begins, so those need to be skipped
+        int numUnmatchedEnds = 0, depth = 0;
+
+        for (int64 n = start; n < end; ++n)
+        {
+            const ThreadBuffer::Event& e = b.events[(int) (n & b.mask)];
+
+            if (e.type == zoneBeginEvent)
+                ++depth;
+            else if (e.type == zoneEndEvent && --depth < 0)
+            {
+                ++numUnmatchedEnds;
+                depth = 0;
+            }
+        }
+
+        for (int64 n = start; n < end; ++n)
+        {
+            const ThreadBuffer::Event& e = b.events[(int) (n & b.mask)];
+            static const char* const phases[] = { "B", "E", "i", "C", "s", "t", "f" };
+
+            if (e.type == zoneEndEvent && numUnmatchedEnds > 0)
+            {
+                --numUnmatchedEnds;
+                continue;
+            }
+
+            TracerHelpers::writeEventStart (out, isFirst, phases[e.type], e.name, e.category, b.threadIndex);
+            out << ",\"ts\":" << String ((double) (e.time - s.startTime) * microsecondsPerTick, 3);
+
+            switch (e.type)
+            {
+                case instantEvent:    out << ",\"s\":\"t\""; break;
+                case counterEvent:    out << ",\"args\":{\"value\":" << String (e.value) << '}'; break;
+                case flowBeginEvent:
+                case flowStepEvent:   out << ",\"id\":" << String ((int64) e.flowID); break;
+                case flowEndEvent:    out << ",\"id\":" << String ((int64) e.flowID) << ",\"bp\":\"e\""; break;
+                default:         break;
+            }
+
+            out << '}';
+        }
+    }
+
+    out << "\n]}\n";
+    return true;
+}
+
+bool JUCE_CALLTYPE Tracer::writeChromeTrace (const File& file)
+{
+    TemporaryFile temp (file);
+
+    {
+        FileOutputStream out (temp.getFile());
+
+        if (out.failedToOpen() || ! writeChromeTrace (out))
+            return false;
+
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TracerTests  : public UnitTest
+{
+public:
+    TracerTests() : UnitTest ("Tracer") {}
+
+    struct TracingThread  : public Thread
+    {
+        TracingThread() : Thread ("Tracing thread") {}
+
+        void run() override
+        {
+            const Tracer::ScopedZone zone ("worker", "test");
+            Tracer::flowBegin ("handover", 42);
+            Tracer::counter ("level", 0.5);
+        }
+    };
+
+    struct OverflowingThread  : public Thread
+    {
+        OverflowingThread() : Thread ("Overflowing thread") {}
+
+        void run() override
+        {
+            const Tracer::ScopedZone outer ("outer", "test");
+
+            for (int i = 0; i < 100; ++i)
+                const Tracer::ScopedZone inner ("inner", "test");
+        }
+    };
+
+    struct WaitingThread  : public Thread
+    {
+        WaitingThread (WaitableEvent& e) : Thread ("Waiting thread"), event (e) {}
+
+        void run() override
+        {
+            event.wait (-1);
+            Tracer::instant ("woken", "test");
+        }
+
+        WaitableEvent& event;
+    };
+
+    static int recordFromManyThreads (int numThreads)
+    {
+        WaitableEvent event (true);
+        OwnedArray<WaitingThread> threads;
+
+        // (these all need to be alive at the same time, so that none of them re-use another's ID)
+        for (int i = 0; i < numThreads; ++i)
+            threads.add (new WaitingThread (event))->startThread();
+
+        event.signal();
+
+        for (int i = 0; i < numThreads; ++i)
+            threads.getUnchecked (i)->waitForThreadToExit (-1);
+
+        return numThreads;
+    }
+
+    static var parseTrace()
+    {
+        MemoryOutputStream out;
+        Tracer::writeChromeTrace (out);
+        return JSON::parse (out.toString());
+    }
+
+    static int countPhases (const var& trace, const char* phase)
+    {
+        int num = 0;
+
+        if (const Array<var>* events = trace["traceEvents"].getArray())
+            for (int i = 0; i < events->size(); ++i)
+                if ((*events)[i]["ph"].toString() == phase)
+                    ++num;
+
+        return num;
+    }
+
+    void runTest() override
+    {
+        beginTest ("Recording");
+        {
+            Tracer::startRecording (256);
+
+            {
+                const Tracer::ScopedZone outer ("outer", "test");
+                const Tracer::ScopedZone inner ("inner", "test");
+                Tracer::instant ("tick", "test");
+
+                TracingThread thread;
+                thread.startThread();
+                thread.waitForThreadToExit (-1);
+
+                Tracer::flowEnd ("handover", 42);
+            }
+
+            Tracer::stopRecording();
+            Tracer::instant ("ignored", "test");
+
+            expectEquals (Tracer::getNumEventsRecorded(), 10);
+            expectEquals (Tracer::getNumEventsDropped(), 0);
+
+            const var trace (parseTrace());
+            expect (trace["traceEvents"].isArray());
+            expectEquals (countPhases (trace, "B"), 3);
+            expectEquals (countPhases (trace, "E"), 3);
+            expectEquals (countPhases (trace, "i"), 1);
+            expectEquals (countPhases (trace, "C"), 1);
+            expectEquals (countPhases (trace, "s"), 1);
+            expectEquals (countPhases (trace, "f"), 1);
+            expect (countPhases (trace, "M") >= 2);
+        }
+
+        beginTest ("Ring buffer overflow");
+        {
+            Tracer::startRecording (16);
+
+            OverflowingThread thread;
+            thread.startThread();
+            thread.waitForThreadToExit (-1);
+
+            Tracer::stopRecording();
+            expectEquals (Tracer::getNumEventsRecorded(), 16);
+
+            const var trace (parseTrace());
+            expect (countPhases (trace, "B") <= countPhases (trace, "E"));
+            expect (countPhases (trace, "E") <= 8);
+
+            Tracer::clear();
+            expectEquals (Tracer::getNumEventsRecorded(), 0);
+        }
+
+        beginTest ("Running out of thread buffers");
+        {
+            Tracer::startRecording (16, 0);
+            const int numThreads = recordFromManyThreads (300);
+            Tracer::stopRecording();
+
+            expect (Tracer::getNumEventsDropped() > 0);
+            expectEquals (Tracer::getNumEventsRecorded() + Tracer::getNumEventsDropped(), numThreads);
+
+            Tracer::startRecording (16, 20);
+            recordFromManyThreads (20);
+            Tracer::stopRecording();
+
+            expectEquals (Tracer::getNumEventsDropped(), 0);
+            expectEquals (Tracer::getNumEventsRecorded(), 20);
+        }
+    }
+};
+
+static TracerTests tracerTests;
+
+#endif
@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_TRACING_H_INCLUDED
+#define JUCE_TRACING_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Records timestamped events from any number of threads, and writes them out in
+    the Chrome trace-event format, which can be loaded into chrome://tracing or
+    the Perfetto UI to see what every thread was doing over time.
+
+    Each thread records into its own ring buffer, so adding an event doesn't take
+    any locks or allocate any memory, and once a buffer is full the oldest events get
+    overwritten. Nothing is recorded unless startRecording() has been called, so when
+    tracing isn't in use, each event just costs a flag check.
+
+    The event names and categories aren't copied, so they must be string literals
+    (or at least live for as long as the trace does).
+
+    Rather than calling these methods directly, you'll normally use the
+    JUCE_TRACE_SCOPE, JUCE_TRACE_COUNTER, etc. macros, which vanish completely
+    unless JUCE_ENABLE_TRACING is turned on. The library itself uses them to
+    instrument its audio callbacks, graph rendering, painting, thread-pool jobs and
+    message dispatching.
+
+    e.g. @code
+    Tracer::startRecording();
+    ...
+    Tracer::stopRecording();
+    Tracer::writeChromeTrace (File ("~/trace.json"));
+    @endcode
+
+    @see PerformanceCounter
+*/
+class JUCE_API  Tracer
+{
+public:
+    //==============================================================================
+    /** Clears any previously-recorded events and starts recording.
+
+        All the ring buffers are allocated here, so that recording an event is safe on a
+        real-time thread. There's one for each thread that recorded something last time,
+        plus some spares for threads that haven't recorded anything yet. If more new threads
+        than that start recording, their events are dropped (see getNumEventsDropped()),
+        and the next call to startRecording() will allocate more buffers.
+
+        @param maxEventsPerThread       the size of each thread's ring buffer
+        @param numSpareThreadBuffers    the number of buffers to allocate for new threads
+    */
+    static void JUCE_CALLTYPE startRecording (int maxEventsPerThread = 65536,
+                                              int numSpareThreadBuffers = 8);
+
+    /** Stops recording. The events that have been captured are kept until the next
+        time startRecording() or clear() is called.
+    */
+    static void JUCE_CALLTYPE stopRecording() noexcept;
+
+    /** Returns true if events are currently being recorded. */
+    static bool JUCE_CALLTYPE isRecording() noexcept;
+
+    /** Discards all the events that have been recorded.
+        This shouldn't be called while recording is in progress.
+    */
+    static void JUCE_CALLTYPE clear();
+
+    /** Returns the number of events that are currently held in all the threads' buffers. */
+    static int JUCE_CALLTYPE getNumEventsRecorded();
+
+    /** Returns the number of events that were thrown away since recording started because
+        there was no buffer left for the thread that recorded them.
+        @see startRecording
+    */
+    static int JUCE_CALLTYPE getNumEventsDropped() noexcept;
+
+    //==============================================================================
+    /** Marks the start of a timed zone on the calling thread. Each call must be
+        matched by a call to endZone() on the same thread - see ScopedZone.
+    */
+    static void JUCE_CALLTYPE beginZone (const char* name, const char* category) noexcept;
+
+    /** Marks the end of the zone most recently started on the calling thread. */
+    static void JUCE_CALLTYPE endZone() noexcept;
+
+    /** Records a single point in time on the calling thread. */
+    static void JUCE_CALLTYPE instant (const char* name, const char* category) noexcept;
+
+    /** Records the value of a named counter, which gets drawn as a graph. */
+    static void JUCE_CALLTYPE counter (const char* name, double value) noexcept;
+
+    /** Starts a flow, which draws an arrow linking zones that may be on different
+        threads, e.g. to show a message being posted and then delivered. The flow is
+        attached to the zone that encloses this call.
+    */
+    static void JUCE_CALLTYPE flowBegin (const char* name, uint64 flowID) noexcept;
+
+    /** Adds an intermediate step to a flow that was started with flowBegin(). */
+    static void JUCE_CALLTYPE flowStep (const char* name, uint64 flowID) noexcept;
+
+    /** Finishes a flow that was started with flowBegin(). */
+    static void JUCE_CALLTYPE flowEnd (const char* name, uint64 flowID) noexcept;
+
+    //==============================================================================
+    /** Writes all the recorded events to a stream as Chrome trace-event JSON.
+        For an accurate result, recording should be stopped before calling this.
+    */
+    static bool JUCE_CALLTYPE writeChromeTrace (OutputStream& output);
+
+    /** Writes all the recorded events to a file as Chrome trace-event JSON. */
+    static bool JUCE_CALLTYPE writeChromeTrace (const File& file);
+
+    //==============================================================================
+    /** Begins a zone in its constructor, and ends it in its destructor. */
+    struct ScopedZone
+    {
+        ScopedZone (const char* name, const char* category) noexcept
+            : active (isRecording())
+        {
+            if (active)
+                beginZone (name, category);
+        }
+
+        ~ScopedZone() noexcept
+        {
+            if (active)
+                endZone();
+        }
+
+    private:
+        const bool active; // (so that a zone can't be left unbalanced if recording starts half-way through it)
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedZone)
+    };
+
+private:
+    struct ThreadBuffer;
+    struct SharedState;
+    static void record (int type, const char* name, const char* category, double value, uint64 flowID) noexcept;
+
+    Tracer() JUCE_DELETED_FUNCTION;
+    JUCE_DECLARE_NON_COPYABLE (Tracer)
+};
+
+//==============================================================================
+#if JUCE_ENABLE_TRACING || DOXYGEN
+ /** Times the rest of the enclosing scope as a zone with the given name. */
+ #define JUCE_TRACE_SCOPE(name)                      const juce::Tracer::ScopedZone JUCE_JOIN_MACRO (juceTraceZone_, __LINE__) (name, "app");
+
+ /** Times the rest of the enclosing scope as a zone with the given category and name. */
+ #define JUCE_TRACE_SCOPE_IN(category, name)         const juce::Tracer::ScopedZone JUCE_JOIN_MACRO (juceTraceZone_, __LINE__) (name, category);
+
+ /** Records a point in time. */
+ #define JUCE_TRACE_INSTANT(name)                    juce::Tracer::instant (name, "app");
+
+ /** Records the value of a counter. */
+ #define JUCE_TRACE_COUNTER(name, value)             juce::Tracer::counter (name, (double) (value));
+
+ /** Begins, continues or ends a flow between zones. */
+ #define JUCE_TRACE_FLOW_BEGIN(name, flowID)         juce::Tracer::flowBegin (name, (juce::uint64) (flowID));
+ #define JUCE_TRACE_FLOW_STEP(name, flowID)          juce::Tracer::flowStep (name, (juce::uint64) (flowID));
+ #define JUCE_TRACE_FLOW_END(name, flowID)           juce::Tracer::flowEnd (name, (juce::uint64) (flowID));
+#else
+ #define JUCE_TRACE_SCOPE(name)
+ #define JUCE_TRACE_SCOPE_IN(category, name)
+ #define JUCE_TRACE_INSTANT(name)
+ #define JUCE_TRACE_COUNTER(name, value)
+ #define JUCE_TRACE_FLOW_BEGIN(name, flowID)
+ #define JUCE_TRACE_FLOW_STEP(name, flowID)
+ #define JUCE_TRACE_FLOW_END(name, flowID)
+#endif
+
+#endif   // JUCE_TRACING_H_INCLUDED
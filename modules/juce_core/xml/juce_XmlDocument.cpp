@@ -109,6 +109,39 @@ namespace XmlIdentifierChars
 
         return p;
     }
+
+    static uint32 hashToken (String::CharPointerType p, const String::CharPointerType end) noexcept
+    {
+        uint32 hash = 0;
+
+        while (p != end)
+            hash = hash * 31 + (uint32) *p++;
+
+        return hash;
+    }
+
+    static bool tokenMatches (String::CharPointerType p, const String::CharPointerType end,
+                              String::CharPointerType name) noexcept
+    {
+        while (p != end)
+            if (*p++ != name.getAndAdvance())
+                return false;
+
+        return name.isEmpty();
+    }
+}
+
+Identifier XmlDocument::getIdentifierFor (String::CharPointerType start, String::CharPointerType end)
+{
+    // Tag and attribute names repeat endlessly in most documents, so rather than
+    // going to the global string pool (which involves a lock) for every one of
+    // them, we keep a small direct-mapped cache of the names we've already seen.
+    Identifier& cached = nameCache[XmlIdentifierChars::hashToken (start, end) & (numElementsInArray (nameCache) - 1)];
+
+    if (! (cached.isValid() && XmlIdentifierChars::tokenMatches (start, end, cached.getCharPointer())))
+        cached = Identifier (start, end);
+
+    return cached;
 }
 
 XmlElement* XmlDocument::getDocumentElement (const bool onlyReadOuterDocumentElement)
@@ -408,7 +441,7 @@ XmlElement* XmlDocument::readNextElement (const bool alsoParseSubElements)
             }
         }
 
-        node = new XmlElement (input, endOfToken);
+        node = new XmlElement (getIdentifierFor (input, endOfToken));
         input = endOfToken;
         LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (node->attributes);
 
@@ -458,7 +491,7 @@ XmlElement* XmlDocument::readNextElement (const bool alsoParseSubElements)
                         if (nextChar == '"' || nextChar == '\'')
                         {
                             XmlElement::XmlAttributeNode* const newAtt
-                                = new XmlElement::XmlAttributeNode (attNameStart, attNameEnd);
+                                = new XmlElement::XmlAttributeNode (getIdentifierFor (attNameStart, attNameEnd), String());
 
                             readQuotedString (newAtt->value);
                             attributeAppender.append (newAtt);
@@ -555,7 +588,7 @@ void XmlDocument::readChildElements (XmlElement& parent)
         else  // must be a character block
         {
             input = preWhitespaceInput; // roll back to include the leading whitespace
-            MemoryOutputStream textElementContent;
+            String textElementContent;
             bool contentShouldBeUsed = ! ignoreEmptyTextElements;
 
             for (;;)
@@ -617,36 +650,43 @@ void XmlDocument::readChildElements (XmlElement& parent)
                 }
                 else
                 {
+                    // copy the text across in runs, only stopping for the characters that need special treatment
+                    String::CharPointerType runStart (input);
+
                     for (;; ++input)
                     {
-                        juce_wchar nextChar = *input;
+                        const juce_wchar nextChar = *input;
 
-                        if (nextChar == '\r')
+                        if (nextChar == '<' || nextChar == '&' || nextChar == '\r' || nextChar == 0)
                         {
-                            nextChar = '\n';
+                            textElementContent.appendCharPointer (runStart, input);
+
+                            if (nextChar == '\r')
+                            {
+                                if (input[1] != '\n')
+                                    textElementContent += '\n';
 
-                            if (input[1] == '\n')
+                                runStart = input + 1;
                                 continue;
-                        }
+                            }
 
-                        if (nextChar == '<' || nextChar == '&')
-                            break;
+                            if (nextChar == 0)
+                            {
+                                setLastError ("unmatched tags", false);
+                                outOfData = true;
+                                return;
+                            }
 
-                        if (nextChar == 0)
-                        {
-                            setLastError ("unmatched tags", false);
-                            outOfData = true;
-                            return;
+                            break;
                         }
 
-                        textElementContent.appendUTF8Char (nextChar);
                         contentShouldBeUsed = contentShouldBeUsed || ! CharacterFunctions::isWhitespace (nextChar);
                     }
                 }
             }
 
             if (contentShouldBeUsed)
-                childAppender.append (XmlElement::createTextElement (textElementContent.toUTF8()));
+                childAppender.append (XmlElement::createTextElement (textElementContent));
         }
     }
 }
@@ -157,6 +157,7 @@ private:
     StringArray tokenisedDTD;
     bool needToLoadDTD, ignoreEmptyTextElements;
     ScopedPointer<InputSource> inputSource;
+    Identifier nameCache[256];
 
     XmlElement* parseDocumentElement (String::CharPointerType, bool outer);
     void setLastError (const String&, bool carryOn);
@@ -168,6 +169,7 @@ private:
     void readChildElements (XmlElement&);
     void readQuotedString (String&);
     void readEntity (String&);
+    Identifier getIdentifierFor (String::CharPointerType, String::CharPointerType);
 
     String getFileContents (const String&) const;
     String expandEntity (const String&);
@@ -218,42 +218,54 @@ namespace XmlOutputFunctions
                  && (legalChars [c >> 3] & (1 << (c & 7))) != 0;
     }
 
+    static void writeLegalXmlChars (OutputStream& outputStream, String::CharPointerType start, const String::CharPointerType end)
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        // all the legal characters are plain ascii, so the run can be written as a single block
+        outputStream.write (start.getAddress(), (size_t) (end.getAddress() - start.getAddress()));
+       #else
+        while (start != end)
+            outputStream << (char) start.getAndAdvance();
+       #endif
+    }
+
     static void escapeIllegalXmlChars (OutputStream& outputStream, const String& text, const bool changeNewLines)
     {
         String::CharPointerType t (text.getCharPointer());
 
         for (;;)
         {
+            const String::CharPointerType runStart (t);
+
+            while (isLegalXmlChar ((uint32) *t))
+                ++t;
+
+            if (t != runStart)
+                writeLegalXmlChars (outputStream, runStart, t);
+
             const uint32 character = (uint32) t.getAndAdvance();
 
             if (character == 0)
                 break;
 
-            if (isLegalXmlChar (character))
-            {
-                outputStream << (char) character;
-            }
-            else
+            switch (character)
             {
-                switch (character)
+            case '&':   outputStream << "&amp;"; break;
+            case '"':   outputStream << "&quot;"; break;
+            case '>':   outputStream << "&gt;"; break;
+            case '<':   outputStream << "&lt;"; break;
+
+            case '\n':
+            case '\r':
+                if (! changeNewLines)
                 {
-                case '&':   outputStream << "&amp;"; break;
-                case '"':   outputStream << "&quot;"; break;
-                case '>':   outputStream << "&gt;"; break;
-                case '<':   outputStream << "&lt;"; break;
-
-                case '\n':
-                case '\r':
-                    if (! changeNewLines)
-                    {
-                        outputStream << (char) character;
-                        break;
-                    }
-                    // Note: deliberate fall-through here!
-                default:
-                    outputStream << "&#" << ((int) character) << ';';
+                    outputStream << (char) character;
                     break;
                 }
+                // Note: deliberate fall-through here!
+            default:
+                outputStream << "&#" << ((int) character) << ';';
+                break;
             }
         }
     }
@@ -0,0 +1,745 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+namespace XmlPullParserHelpers
+{
+    static bool isNameChar (const char c) noexcept
+    {
+        return CharacterFunctions::isLetterOrDigit (c)
+                 || c == '_' || c == '-' || c == ':' || c == '.'
+                 || (uint8) c >= 0x80;
+    }
+
+    static bool isSpace (const char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    static const char* skipSpaces (const char* p, const char* const end) noexcept
+    {
+        while (p < end && isSpace (*p))
+            ++p;
+
+        return p;
+    }
+
+    static const char* findEndOfName (const char* p, const char* const end) noexcept
+    {
+        while (p < end && isNameChar (*p))
+            ++p;
+
+        return p;
+    }
+
+    static bool containsNonWhitespace (const char* p, const char* const end) noexcept
+    {
+        return skipSpaces (p, end) < end;
+    }
+}
+
+//==============================================================================
+XmlPullParser::XmlPullParser (InputStream* const sourceStream, const bool deleteSourceWhenDestroyed)
+    : source (sourceStream, deleteSourceWhenDestroyed)
+{
+    initialise();
+}
+
+XmlPullParser::XmlPullParser (InputStream& sourceStream)
+    : source (&sourceStream, false)
+{
+    initialise();
+}
+
+XmlPullParser::~XmlPullParser()
+{
+}
+
+void XmlPullParser::initialise()
+{
+    jassert (source != nullptr);
+
+    bufferSize = 32768;
+    bufferPos = 0;
+    bufferEnd = 0;
+    buffer.malloc ((size_t) bufferSize + 1);
+    buffer[0] = 0;
+
+    sourceExhausted = (source == nullptr);
+    pendingEndOfEmptyElement = false;
+    ignoreEmptyTextElements = true;
+    currentEvent = endOfDocument;
+
+    // skip any byte-order-mark..
+    if (ensureAvailable (3) && CharPointer_UTF8::isByteOrderMark (buffer))
+        bufferPos = 3;
+}
+
+void XmlPullParser::setEmptyTextElementsIgnored (const bool shouldBeIgnored) noexcept
+{
+    ignoreEmptyTextElements = shouldBeIgnored;
+}
+
+String XmlPullParser::getStringAttribute (StringRef attributeName, const String& defaultReturnValue) const
+{
+    for (int i = 0; i < attributeNames.size(); ++i)
+        if (attributeNames.getReference (i) == attributeName)
+            return attributeValues.getReference (i);
+
+    return defaultReturnValue;
+}
+
+//==============================================================================
+bool XmlPullParser::fillBuffer()
+{
+    if (sourceExhausted)
+        return false;
+
+    // move the unread data down to the start of the buffer, and make some more room if needed..
+    if (bufferPos > 0)
+    {
+        bufferEnd -= bufferPos;
+        memmove (buffer, buffer + bufferPos, (size_t) bufferEnd);
+        bufferPos = 0;
+    }
+
+    if (bufferEnd > bufferSize / 2)
+    {
+        bufferSize *= 2;
+        buffer.realloc ((size_t) bufferSize + 1);
+    }
+
+    const int numRead = source->read (buffer + bufferEnd, bufferSize - bufferEnd);
+
+    if (numRead <= 0)
+    {
+        sourceExhausted = true;
+        buffer[bufferEnd] = 0;
+        return false;
+    }
+
+    bufferEnd += numRead;
+    buffer[bufferEnd] = 0;
+    return true;
+}
+
+bool XmlPullParser::ensureAvailable (const int numBytes)
+{
+    while (bufferEnd - bufferPos < numBytes)
+        if (! fillBuffer())
+            return false;
+
+    return true;
+}
+
+int XmlPullParser::findSequence (const char* const sequence, int startOffset)
+{
+    const int sequenceLength = (int) strlen (sequence);
+
+    for (;;)
+    {
+        const int available = bufferEnd - bufferPos;
+
+        if (startOffset + sequenceLength <= available)
+        {
+            const char* const start = buffer + bufferPos;
+            const char* p = start + startOffset;
+            const char* const lastPossible = start + available - sequenceLength;
+
+            while (p <= lastPossible)
+            {
+                p = static_cast<const char*> (memchr (p, sequence[0], (size_t) (lastPossible - p) + 1));
+
+                if (p == nullptr)
+                    break;
+
+                if (memcmp (p, sequence, (size_t) sequenceLength) == 0)
+                    return (int) (p - start);
+
+                ++p;
+            }
+
+            startOffset = available - sequenceLength + 1;
+        }
+
+        if (! fillBuffer())
+            return -1;
+    }
+}
+
+int XmlPullParser::findEndOfTag()
+{
+    char quote = 0;
+
+    for (int i = 1;; ++i)
+    {
+        if (bufferPos + i >= bufferEnd && ! ensureAvailable (i + 1))
+            return -1;
+
+        const char c = buffer[bufferPos + i];
+
+        if (quote != 0)
+        {
+            if (c == quote)
+                quote = 0;
+        }
+        else if (c == '"' || c == '\'')
+        {
+            quote = c;
+        }
+        else if (c == '>')
+        {
+            return i;
+        }
+    }
+}
+
+XmlPullParser::EventType XmlPullParser::setError (const String& message)
+{
+    lastError = message;
+    return currentEvent = parseError;
+}
+
+const String& XmlPullParser::getName (const char* const start, const char* const end)
+{
+    // names tend to be repeated over and over, so this keeps the most recent ones
+    // to avoid allocating a new string for each tag
+    uint32 hash = 0;
+
+    for (const char* p = start; p < end; ++p)
+        hash = hash * 31 + (uint32) (uint8) *p;
+
+    String& cached = nameCache[hash & (numElementsInArray (nameCache) - 1)];
+    const size_t length = (size_t) (end - start);
+
+    if (cached.getNumBytesAsUTF8() != length || memcmp (cached.toRawUTF8(), start, length) != 0)
+        cached = String (CharPointer_UTF8 (start), CharPointer_UTF8 (end));
+
+    return cached;
+}
+
+void XmlPullParser::appendDecoded (String& dest, const char* p, const char* const end, const bool normaliseNewLines)
+{
+    const char* runStart = p;
+
+    while (p < end)
+    {
+        const char c = *p;
+
+        if (c == '&')
+        {
+            dest.appendCharPointer (CharPointer_UTF8 (runStart), CharPointer_UTF8 (p));
+
+            const char* const semiColon = static_cast<const char*> (memchr (p, ';', (size_t) (end - p)));
+            const char* const entity = p + 1;
+            juce_wchar decoded = 0;
+
+            if (semiColon != nullptr)
+            {
+                const size_t len = (size_t) (semiColon - entity);
+
+                if      (len == 3 && memcmp (entity, "amp", 3) == 0)    decoded = '&';
+                else if (len == 2 && memcmp (entity, "lt", 2) == 0)     decoded = '<';
+                else if (len == 2 && memcmp (entity, "gt", 2) == 0)     decoded = '>';
+                else if (len == 4 && memcmp (entity, "quot", 4) == 0)   decoded = '"';
+                else if (len == 4 && memcmp (entity, "apos", 4) == 0)   decoded = '\'';
+                else if (len > 1 && *entity == '#')
+                {
+                    const String number (CharPointer_UTF8 (entity + 1), CharPointer_UTF8 (semiColon));
+
+                    decoded = (number[0] == 'x' || number[0] == 'X') ? (juce_wchar) number.substring (1).getHexValue32()
+                                                                     : (juce_wchar) number.getIntValue();
+                }
+            }
+
+            if (decoded != 0)
+            {
+                dest += decoded;
+                p = semiColon + 1;
+                runStart = p;
+            }
+            else
+            {
+                // unknown entities are left in the text untouched
+                runStart = p++;
+            }
+        }
+        else if (c == '\r' && normaliseNewLines)
+        {
+            dest.appendCharPointer (CharPointer_UTF8 (runStart), CharPointer_UTF8 (p));
+
+            if (p + 1 >= end || p[1] != '\n')
+                dest += '\n';
+
+            runStart = ++p;
+        }
+        else
+        {
+            ++p;
+        }
+    }
+
+    dest.appendCharPointer (CharPointer_UTF8 (runStart), CharPointer_UTF8 (end));
+}
+
+//==============================================================================
+XmlPullParser::EventType XmlPullParser::readNext()
+{
+    if (currentEvent == parseError)
+        return currentEvent;
+
+    attributeNames.clearQuick();
+    attributeValues.clearQuick();
+
+    if (pendingEndOfEmptyElement)
+    {
+        pendingEndOfEmptyElement = false;
+        tagName = openElements[openElements.size() - 1];
+        openElements.remove (openElements.size() - 1);
+        return currentEvent = endElement;
+    }
+
+    if (currentEvent == endElement && openElements.size() == 0)
+    {
+        // the document element has been closed, so ignore anything that follows it
+        sourceExhausted = true;
+        bufferPos = bufferEnd;
+    }
+
+    for (;;)
+    {
+        if (! ensureAvailable (1))
+        {
+            if (openElements.size() > 0)
+                return setError ("unmatched tags");
+
+            tagName.clear();
+            return currentEvent = endOfDocument;
+        }
+
+        if (buffer[bufferPos] != '<')
+        {
+            int textLength = findSequence ("<", 0);
+
+            if (textLength < 0)
+                textLength = bufferEnd - bufferPos;
+
+            const char* const textStart = buffer + bufferPos;
+
+            if (openElements.size() == 0)
+            {
+                if (XmlPullParserHelpers::containsNonWhitespace (textStart, textStart + textLength))
+                    return setError ("text found outside the document element");
+
+                bufferPos += textLength;
+                continue;
+            }
+
+            if (ignoreEmptyTextElements && ! XmlPullParserHelpers::containsNonWhitespace (textStart, textStart + textLength))
+            {
+                bufferPos += textLength;
+                continue;
+            }
+
+            return readText (textLength);
+        }
+
+        if (! ensureAvailable (2))
+            return setError ("unexpected end of input");
+
+        const char c = buffer[bufferPos + 1];
+
+        if (c == '/')
+            return readEndTag();
+
+        if (c == '?')
+        {
+            const int end = findSequence ("?>", 2);
+
+            if (end < 0)
+                return setError ("unterminated processing instruction");
+
+            bufferPos += end + 2;
+            continue;
+        }
+
+        if (c == '!')
+        {
+            if (ensureAvailable (4) && memcmp (buffer + bufferPos, "<!--", 4) == 0)
+            {
+                const int end = findSequence ("-->", 4);
+
+                if (end < 0)
+                    return setError ("unterminated comment");
+
+                bufferPos += end + 3;
+                continue;
+            }
+
+            if (ensureAvailable (9) && memcmp (buffer + bufferPos, "<![CDATA[", 9) == 0)
+            {
+                if (openElements.size() == 0)
+                    return setError ("text found outside the document element");
+
+                return readCData();
+            }
+
+            // skip a DOCTYPE or other declaration, including any internal subset
+            for (int depth = 0, i = 1;; ++i)
+            {
+                if (! ensureAvailable (i + 1))
+                    return setError ("malformed DTD");
+
+                const char dc = buffer[bufferPos + i];
+
+                if (dc == '<')
+                {
+                    ++depth;
+                }
+                else if (dc == '>' && --depth < 0)
+                {
+                    bufferPos += i + 1;
+                    break;
+                }
+            }
+
+            continue;
+        }
+
+        return readStartTag();
+    }
+}
+
+XmlPullParser::EventType XmlPullParser::readText (const int numBytes)
+{
+    const char* const start = buffer + bufferPos;
+
+    textContent.clear();
+    appendDecoded (textContent, start, start + numBytes, true);
+    bufferPos += numBytes;
+
+    return currentEvent = text;
+}
+
+XmlPullParser::EventType XmlPullParser::readCData()
+{
+    const int end = findSequence ("]]>", 9);
+
+    if (end < 0)
+        return setError ("unterminated CDATA section");
+
+    const char* const start = buffer + bufferPos;
+    textContent = String (CharPointer_UTF8 (start + 9), CharPointer_UTF8 (start + end));
+    bufferPos += end + 3;
+
+    return currentEvent = text;
+}
+
+XmlPullParser::EventType XmlPullParser::readStartTag()
+{
+    using namespace XmlPullParserHelpers;
+
+    const int tagLength = findEndOfTag();
+
+    if (tagLength < 0)
+        return setError ("unterminated tag");
+
+    const char* p = buffer + bufferPos + 1;
+    const char* end = buffer + bufferPos + tagLength;
+    bufferPos += tagLength + 1;
+
+    const bool isEmptyElement = (end > p && end[-1] == '/');
+
+    if (isEmptyElement)
+        --end;
+
+    p = skipSpaces (p, end);
+    const char* const nameEnd = findEndOfName (p, end);
+
+    if (nameEnd == p)
+        return setError ("tag name missing");
+
+    tagName = getName (p, nameEnd);
+    p = nameEnd;
+
+    for (;;)
+    {
+        const char* const attributeStart = skipSpaces (p, end);
+
+        if (attributeStart >= end)
+            break;
+
+        if (attributeStart == p)
+            return setError ("illegal character found in " + tagName + ": '" + String::charToString ((juce_wchar) (uint8) *p) + "'");
+
+        const char* const attributeNameEnd = findEndOfName (attributeStart, end);
+
+        if (attributeNameEnd == attributeStart)
+            return setError ("illegal character found in " + tagName + ": '" + String::charToString ((juce_wchar) (uint8) *attributeStart) + "'");
+
+        p = skipSpaces (attributeNameEnd, end);
+
+        if (p >= end || *p != '=')
+            return setError ("expected '=' after attribute '" + String (CharPointer_UTF8 (attributeStart), CharPointer_UTF8 (attributeNameEnd)) + "'");
+
+        p = skipSpaces (p + 1, end);
+
+        if (p >= end || (*p != '"' && *p != '\''))
+            return setError ("unquoted attribute value");
+
+        const char* const valueEnd = static_cast<const char*> (memchr (p + 1, *p, (size_t) (end - p - 1)));
+
+        if (valueEnd == nullptr)
+            return setError ("unmatched quotes");
+
+        attributeNames.add (getName (attributeStart, attributeNameEnd));
+        attributeValues.add (String());
+        appendDecoded (attributeValues.getReference (attributeValues.size() - 1), p + 1, valueEnd, false);
+
+        p = valueEnd + 1;
+    }
+
+    openElements.add (tagName);
+    pendingEndOfEmptyElement = isEmptyElement;
+    return currentEvent = startElement;
+}
+
+XmlPullParser::EventType XmlPullParser::readEndTag()
+{
+    using namespace XmlPullParserHelpers;
+
+    const int tagLength = findSequence (">", 2);
+
+    if (tagLength < 0)
+        return setError ("unterminated tag");
+
+    const char* const start = buffer + bufferPos + 2;
+    const char* const nameEnd = findEndOfName (start, buffer + bufferPos + tagLength);
+    bufferPos += tagLength + 1;
+
+    if (openElements.size() == 0)
+        return setError ("unmatched tags");
+
+    tagName = openElements[openElements.size() - 1];
+
+    if (tagName.getNumBytesAsUTF8() != (size_t) (nameEnd - start)
+         || memcmp (tagName.toRawUTF8(), start, (size_t) (nameEnd - start)) != 0)
+        return setError ("unmatched tags");
+
+    openElements.remove (openElements.size() - 1);
+    return currentEvent = endElement;
+}
+
+//==============================================================================
+XmlElement* XmlPullParser::readElement()
+{
+    if (currentEvent != startElement)
+    {
+        jassertfalse; // this can only be called when the parser is positioned at the start of an element
+        return nullptr;
+    }
+
+    const int startDepth = openElements.size();
+    ScopedPointer<XmlElement> root;
+    Array<LinkedListPointer<XmlElement>*> childListEnds;
+
+    for (;;)
+    {
+        switch (currentEvent)
+        {
+            case startElement:
+            {
+                XmlElement* const e = new XmlElement (tagName);
+                LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (e->attributes);
+
+                for (int i = 0; i < attributeNames.size(); ++i)
+                    attributeAppender.append (new XmlElement::XmlAttributeNode (attributeNames.getReference (i),
+                                                                                attributeValues.getReference (i)));
+
+                if (root == nullptr)
+                {
+                    root = e;
+                }
+                else
+                {
+                    LinkedListPointer<XmlElement>*& listEnd = childListEnds.getReference (childListEnds.size() - 1);
+                    *listEnd = e;
+                    listEnd = &(e->nextListItem);
+                }
+
+                childListEnds.add (&(e->firstChildElement));
+                break;
+            }
+
+            case text:
+            {
+                XmlElement* const e = XmlElement::createTextElement (textContent);
+                LinkedListPointer<XmlElement>*& listEnd = childListEnds.getReference (childListEnds.size() - 1);
+                *listEnd = e;
+                listEnd = &(e->nextListItem);
+                break;
+            }
+
+            case endElement:
+                childListEnds.removeLast();
+
+                if (openElements.size() < startDepth)
+                    return root.release();
+
+                break;
+
+            default:
+                return nullptr;
+        }
+
+        readNext();
+    }
+}
+
+bool XmlPullParser::skipElement()
+{
+    if (currentEvent != startElement)
+    {
+        jassertfalse; // this can only be called when the parser is positioned at the start of an element
+        return false;
+    }
+
+    const int startDepth = openElements.size();
+
+    for (;;)
+    {
+        const EventType e = readNext();
+
+        if (e == endElement && openElements.size() < startDepth)
+            return true;
+
+        if (e == parseError || e == endOfDocument)
+            return false;
+    }
+}
+
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlPullParserTests  : public UnitTest
+{
+public:
+    XmlPullParserTests() : UnitTest ("XmlPullParser") {}
+
+    static String parseToEventString (const String& xml)
+    {
+        MemoryInputStream in (xml.toRawUTF8(), xml.getNumBytesAsUTF8(), false);
+        XmlPullParser parser (in);
+        String result;
+
+        for (;;)
+        {
+            switch (parser.readNext())
+            {
+                case XmlPullParser::startElement:
+                    result << "<" << parser.getTagName();
+
+                    for (int i = 0; i < parser.getNumAttributes(); ++i)
+                        result << " " << parser.getAttributeName (i) << "=" << parser.getAttributeValue (i);
+
+                    result << ">";
+                    break;
+
+                case XmlPullParser::endElement:     result << "</" << parser.getTagName() << ">"; break;
+                case XmlPullParser::text:           result << "[" << parser.getText() << "]"; break;
+                case XmlPullParser::endOfDocument:  return result;
+                case XmlPullParser::parseError:     return result + "!" + parser.getLastParseError();
+                default:                            jassertfalse; return result;
+            }
+        }
+    }
+
+    void runTest() override
+    {
+        beginTest ("Events");
+
+        expectEquals (parseToEventString ("<?xml version=\"1.0\"?><!DOCTYPE a [ <!ENTITY x \"y\"> ]>\r\n"
+                                          "<a x=\"1 &amp; 2\" y='&lt;'><!-- comment --><b/> hello &#65;&#x42; <c>"
+                                          "<![CDATA[<raw>]]></c>\r\n</a>"),
+                      String ("<a x=1 & 2 y=<><b></b>[ hello AB ]<c>[<raw>]</c></a>"));
+
+        expectEquals (parseToEventString ("<a><b></a>"), String ("<a><b>!unmatched tags"));
+        expectEquals (parseToEventString ("<a x=1/>"), String ("!unquoted attribute value"));
+        expectEquals (parseToEventString ("<a>"), String ("<a>!unmatched tags"));
+
+        beginTest ("Large documents");
+
+        Random r = getRandom();
+        XmlElement original ("ROOT");
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            XmlElement* const child = original.createNewChildElement ("ITEM");
+            child->setAttribute ("index", i);
+            child->setAttribute ("value", String (r.nextDouble()) + " <&> \"\xc2\xa9\"");
+
+            if (r.nextBool())
+                child->addTextElement ("text " + String::repeatedString ("x", r.nextInt (200)));
+        }
+
+        const String document (original.createDocument (String()));
+
+        MemoryInputStream in (document.toRawUTF8(), document.getNumBytesAsUTF8(), false);
+        XmlPullParser parser (in);
+        expect (parser.readNext() == XmlPullParser::startElement);
+        expectEquals (parser.getTagName(), String ("ROOT"));
+
+        int numItems = 0;
+
+        while (parser.readNext() == XmlPullParser::startElement)
+        {
+            if ((numItems & 1) == 0)
+            {
+                ScopedPointer<XmlElement> item (parser.readElement());
+                expect (item != nullptr && item->isEquivalentTo (original.getChildElement (numItems), false));
+            }
+            else
+            {
+                expect (parser.skipElement());
+            }
+
+            ++numItems;
+        }
+
+        expectEquals (numItems, 2000);
+        expect (parser.getEventType() == XmlPullParser::endElement);
+        expect (parser.readNext() == XmlPullParser::endOfDocument);
+
+        ScopedPointer<XmlElement> reparsed (XmlDocument::parse (document));
+        expect (reparsed != nullptr && reparsed->isEquivalentTo (&original, false));
+    }
+};
+
+static XmlPullParserTests xmlPullParserTests;
+
+#endif
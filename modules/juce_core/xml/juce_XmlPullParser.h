@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_XMLPULLPARSER_H_INCLUDED
+#define JUCE_XMLPULLPARSER_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Reads an XML document from a stream as a sequence of events, without building
+    a tree of XmlElement objects for the whole thing.
+
+    XmlDocument needs the entire document in memory, plus an XmlElement for every node,
+    which is fine for settings files but gets very expensive for huge files such as
+    large preset banks. This class only ever holds the tag that it's currently looking
+    at, so you can step through a document of any size, and use readElement() to pull
+    out just the sections that you're interested in as normal XmlElements.
+
+    e.g.
+    @code
+    XmlPullParser parser (new FileInputStream (myFile), true);
+
+    while (parser.readNext() == XmlPullParser::startElement)
+    {
+        if (parser.getTagName() == "PRESET")
+        {
+            ScopedPointer<XmlElement> preset (parser.readElement());
+            ...
+        }
+    }
+
+    if (parser.getEventType() == XmlPullParser::parseError)
+        DBG (parser.getLastParseError());
+    @endcode
+
+    Note that readNext() returns every event, so in practice you'll usually want to
+    switch on its result rather than using a simple loop like the one above.
+
+    The stream must contain UTF-8 text. Unlike XmlDocument, DTDs are skipped rather than
+    parsed, so only the standard entities and numeric character references are expanded -
+    any others are left in the text exactly as they appear in the document.
+
+    @see XmlDocument, XmlElement
+*/
+class JUCE_API  XmlPullParser
+{
+public:
+    //==============================================================================
+    /** Creates a parser that will read from the given stream.
+
+        @param sourceStream                 the stream to read from
+        @param deleteSourceWhenDestroyed    if true, the stream will be deleted by this object
+                                            when it is no longer needed
+    */
+    XmlPullParser (InputStream* sourceStream, bool deleteSourceWhenDestroyed);
+
+    /** Creates a parser that will read from the given stream.
+        The stream must remain valid for the lifetime of the parser.
+    */
+    XmlPullParser (InputStream& sourceStream);
+
+    /** Destructor. */
+    ~XmlPullParser();
+
+    //==============================================================================
+    /** The different kinds of event that the parser can return. */
+    enum EventType
+    {
+        startElement,   /**< An opening tag - use getTagName() and the attribute methods to find out about it. */
+        endElement,     /**< A closing tag - an empty tag such as <foo/> produces a startElement followed by an endElement. */
+        text,           /**< A block of text or CDATA inside an element - use getText() to retrieve it. */
+        endOfDocument,  /**< The outermost element has been closed, or there's no more input. */
+        parseError      /**< The document is malformed - see getLastParseError() for details. */
+    };
+
+    /** Moves on to the next event in the document and returns its type.
+        Once the parser has returned endOfDocument or parseError, it will continue
+        to return the same value.
+    */
+    EventType readNext();
+
+    /** Returns the type of the event that the last call to readNext() returned. */
+    EventType getEventType() const noexcept                         { return currentEvent; }
+
+    /** Returns the number of elements that currently enclose the parser's position.
+        After a startElement, this includes the element that has just been opened.
+    */
+    int getDepth() const noexcept                                   { return openElements.size(); }
+
+    //==============================================================================
+    /** Returns the tag name for a startElement or endElement event. */
+    const String& getTagName() const noexcept                       { return tagName; }
+
+    /** Returns the number of attributes that the current startElement has. */
+    int getNumAttributes() const noexcept                           { return attributeNames.size(); }
+
+    /** Returns the name of one of the current element's attributes. */
+    const String& getAttributeName (int index) const noexcept       { return attributeNames.getReference (index); }
+
+    /** Returns the value of one of the current element's attributes, with any entities expanded. */
+    const String& getAttributeValue (int index) const noexcept      { return attributeValues.getReference (index); }
+
+    /** Returns the value of the current element's attribute with the given name,
+        or a default value if there's no such attribute.
+    */
+    String getStringAttribute (StringRef attributeName, const String& defaultReturnValue = String()) const;
+
+    /** Returns the content of a text event, with any entities expanded. */
+    const String& getText() const noexcept                          { return textContent; }
+
+    /** Returns a description of the problem when readNext() has returned parseError. */
+    const String& getLastParseError() const noexcept                { return lastError; }
+
+    //==============================================================================
+    /** When positioned at a startElement, this reads the whole of that element,
+        including all its children, and returns it as an XmlElement.
+
+        After this returns, the parser will be positioned at the element's endElement
+        event. The caller is responsible for deleting the object that is returned.
+        Returns nullptr if the parser isn't at a startElement, or if the element is
+        malformed.
+    */
+    XmlElement* readElement();
+
+    /** When positioned at a startElement, this skips over the rest of that element,
+        leaving the parser at its endElement event.
+        @returns false if the end of the element couldn't be found
+    */
+    bool skipElement();
+
+    /** Sets a flag to change the treatment of empty text elements.
+        If this is true (the default state), then any text that contains only whitespace
+        will be skipped rather than being returned as a text event.
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<InputStream> source;
+    HeapBlock<char> buffer;
+    int bufferSize, bufferPos, bufferEnd;
+    bool sourceExhausted, pendingEndOfEmptyElement, ignoreEmptyTextElements;
+    EventType currentEvent;
+    String tagName, textContent, lastError;
+    Array<String> attributeNames, attributeValues;
+    String nameCache[64];
+    StringArray openElements;
+
+    void initialise();
+    bool fillBuffer();
+    bool ensureAvailable (int numBytes);
+    int findSequence (const char* sequence, int startOffset);
+    int findEndOfTag();
+    EventType setError (const String&);
+    EventType readText (int numBytes);
+    EventType readCData();
+    EventType readStartTag();
+    EventType readEndTag();
+    const String& getName (const char* start, const char* end);
+    static void appendDecoded (String& dest, const char* start, const char* end, bool normaliseNewLines);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlPullParser)
+};
+
+
+#endif   // JUCE_XMLPULLPARSER_H_INCLUDED
@@ -22,23 +22,219 @@
   ==============================================================================
 */
 
-class AsyncUpdater::AsyncUpdaterMessage  : public CallbackMessage
+class AsyncUpdater::AsyncUpdaterMessage  : public ReferenceCountedObject
 {
 public:
-    AsyncUpdaterMessage (AsyncUpdater& au)  : owner (au) {}
+    AsyncUpdaterMessage (AsyncUpdater& au)  : owner (au), nextInQueue (nullptr), timeQueued (0) {}
 
-    void messageCallback() override
+    void deliver()
     {
         if (shouldDeliver.compareAndSetBool (0, 1))
             owner.handleAsyncUpdate();
     }
 
     AsyncUpdater& owner;
-    Atomic<int> shouldDeliver;
+    Atomic<int> shouldDeliver, isQueued;
+    AsyncUpdaterMessage* nextInQueue;
+    int64 timeQueued;
+
+    typedef ReferenceCountedObjectPtr<AsyncUpdaterMessage> Ptr;
 
     JUCE_DECLARE_NON_COPYABLE (AsyncUpdaterMessage)
 };
 
+//==============================================================================
+/*  Rather than each AsyncUpdater posting its own message, triggered updaters are pushed
+    onto a shared lock-free list, and a single message then delivers everything that's on
+    it in one pass. In frame-aligned mode, that message gets posted by a free-running
+    high-resolution timer instead of by whoever first adds something to the list. (This
+    can't use a normal Timer, because the Timer class relies on an AsyncUpdater itself). The list holds a reference to each
+    updater's message, so an updater that gets deleted while it's queued is just skipped.
+*/
+class AsyncUpdater::PendingUpdateQueue  : private HighResolutionTimer
+{
+public:
+    PendingUpdateQueue()  : flushMessage (new FlushMessage (*this)), frameIntervalMs (0) {}
+
+    ~PendingUpdateQueue()
+    {
+        stopTimer();
+        discardAll();
+    }
+
+    static PendingUpdateQueue& getInstance()
+    {
+        static PendingUpdateQueue queue;
+        return queue;
+    }
+
+    void add (AsyncUpdaterMessage* const m)
+    {
+        if (! m->isQueued.compareAndSetBool (1, 0))
+            return; // already waiting on the list, so this trigger will be seen when it's flushed
+
+        m->incReferenceCount();
+        m->timeQueued = Time::getHighResolutionTicks();
+
+        AsyncUpdaterMessage* head;
+
+        do
+        {
+            head = firstPending.get();
+            m->nextInQueue = head;
+        }
+        while (! firstPending.compareAndSetBool (m, head));
+
+        ++statistics.numUpdatesQueued;
+
+        if (head == nullptr && frameIntervalMs <= 0)
+            postFlushMessage();
+    }
+
+    void setFrameInterval (const int intervalMs)
+    {
+        frameIntervalMs = intervalMs;
+
+        if (intervalMs > 0)
+        {
+            startTimer (intervalMs);
+        }
+        else
+        {
+            stopTimer();
+
+            if (firstPending.get() != nullptr)
+                postFlushMessage();
+        }
+    }
+
+    void flush()
+    {
+        JUCE_TRACE_SCOPE_IN ("messages", "AsyncUpdater flush");
+        flushMessagePending = 0;
+
+        AsyncUpdaterMessage* m = firstPending.exchange (nullptr);
+
+        if (m == nullptr)
+            return;
+
+        // the list holds the most recent trigger first, so reverse it to get trigger order
+        AsyncUpdaterMessage* batch = nullptr;
+        int numInBatch = 0;
+
+        while (m != nullptr)
+        {
+            AsyncUpdaterMessage* const next = m->nextInQueue;
+            m->nextInQueue = batch;
+            batch = m;
+            m = next;
+            ++numInBatch;
+        }
+
+        ++statistics.numFlushes;
+
+        if (numInBatch > statistics.maxQueueDepth.get())
+            statistics.maxQueueDepth = numInBatch;
+
+        while (batch != nullptr)
+        {
+            const AsyncUpdaterMessage::Ptr current (batch);
+            batch->decReferenceCount(); // (the list's reference, now owned by 'current')
+            batch = batch->nextInQueue;
+
+            // must be cleared before delivering, so that a callback which re-triggers
+            // itself gets put back onto the list for the next flush
+            current->isQueued = 0;
+
+            const int64 latency = Time::getHighResolutionTicks() - current->timeQueued;
+            statistics.totalLatencyTicks += latency;
+
+            if (latency > statistics.maxLatencyTicks.get())
+                statistics.maxLatencyTicks = latency;
+
+            JUCE_TRY
+            {
+                current->deliver();
+            }
+            JUCE_CATCH_EXCEPTION
+        }
+    }
+
+    DeliveryStatistics getStatistics() const noexcept
+    {
+        DeliveryStatistics s;
+        s.numUpdatesQueued = statistics.numUpdatesQueued.get();
+        s.numFlushes       = statistics.numFlushes.get();
+        s.maxQueueDepth    = (int) statistics.maxQueueDepth.get();
+
+        const double msPerTick = 1000.0 * Time::highResolutionTicksToSeconds (1);
+        s.averageLatencyMs = s.numUpdatesQueued > 0 ? statistics.totalLatencyTicks.get() * msPerTick / (double) s.numUpdatesQueued : 0.0;
+        s.maxLatencyMs = statistics.maxLatencyTicks.get() * msPerTick;
+        return s;
+    }
+
+    void resetStatistics() noexcept
+    {
+        statistics.numUpdatesQueued = 0;
+        statistics.numFlushes = 0;
+        statistics.maxQueueDepth = 0;
+        statistics.totalLatencyTicks = 0;
+        statistics.maxLatencyTicks = 0;
+    }
+
+private:
+    struct FlushMessage  : public CallbackMessage
+    {
+        FlushMessage (PendingUpdateQueue& q) noexcept : owner (q) {}
+        void messageCallback() override   { owner.flush(); }
+
+        PendingUpdateQueue& owner;
+    };
+
+    struct Statistics
+    {
+        Atomic<int64> numUpdatesQueued, numFlushes, maxQueueDepth, totalLatencyTicks, maxLatencyTicks;
+    };
+
+    Atomic<AsyncUpdaterMessage*> firstPending;
+    const MessageManager::MessageBase::Ptr flushMessage;
+    Atomic<int> flushMessagePending;
+    volatile int frameIntervalMs;
+    Statistics statistics;
+
+    void postFlushMessage()
+    {
+        flushMessagePending = 1;
+
+        if (! flushMessage->post())
+        {
+            flushMessagePending = 0;
+            discardAll(); // if the message queue fails, this avoids getting
+        }                 // trapped waiting for the message to arrive
+    }
+
+    void hiResTimerCallback() override
+    {
+        // (avoids piling up more flush messages if the message thread is falling behind)
+        if (firstPending.get() != nullptr && flushMessagePending.get() == 0)
+            postFlushMessage();
+    }
+
+    void discardAll()
+    {
+        for (AsyncUpdaterMessage* m = firstPending.exchange (nullptr); m != nullptr;)
+        {
+            AsyncUpdaterMessage* const next = m->nextInQueue;
+            m->shouldDeliver = 0;
+            m->isQueued = 0;
+            m->decReferenceCount();
+            m = next;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (PendingUpdateQueue)
+};
+
 //==============================================================================
 AsyncUpdater::AsyncUpdater()
 {
@@ -65,12 +261,7 @@ void AsyncUpdater::triggerAsyncUpdate()
     jassert (MessageManager::getInstanceWithoutCreating() != nullptr);
 
     if (activeMessage->shouldDeliver.compareAndSetBool (1, 0))
-    {
-        if (!activeMessage->post())
-        {
-            cancelPendingUpdate();  // if the message queue fails, this avoids getting
-        }
-    }                               // trapped waiting for the message to arrive
+        PendingUpdateQueue::getInstance().add (activeMessage);
 }
 
 void AsyncUpdater::cancelPendingUpdate() noexcept
@@ -91,3 +282,147 @@ bool AsyncUpdater::isUpdatePending() const noexcept
 {
     return activeMessage->shouldDeliver.value != 0;
 }
+
+//==============================================================================
+void JUCE_CALLTYPE AsyncUpdater::setFrameAlignedDelivery (const int framesPerSecond)
+{
+    PendingUpdateQueue::getInstance().setFrameInterval (framesPerSecond > 0 ? jmax (1, 1000 / framesPerSecond) : 0);
+}
+
+AsyncUpdater::DeliveryStatistics JUCE_CALLTYPE AsyncUpdater::getDeliveryStatistics() noexcept
+{
+    return PendingUpdateQueue::getInstance().getStatistics();
+}
+
+void JUCE_CALLTYPE AsyncUpdater::resetDeliveryStatistics() noexcept
+{
+    PendingUpdateQueue::getInstance().resetStatistics();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS && JUCE_MODAL_LOOPS_PERMITTED
+
+class AsyncUpdaterTests  : public UnitTest
+{
+public:
+    AsyncUpdaterTests() : UnitTest ("AsyncUpdater") {}
+
+    struct TestUpdater  : public AsyncUpdater
+    {
+        TestUpdater (const String& updaterName, String& logToUse)
+            : name (updaterName), log (logToUse), numCallbacks (0), numRetriggers (0), updaterToTrigger (nullptr)
+        {
+        }
+
+        void handleAsyncUpdate() override
+        {
+            log << name;
+            ++numCallbacks;
+
+            // (all the updaters that are delivered in the same pass will see the same count)
+            flushNumbers.add (getDeliveryStatistics().numFlushes);
+
+            if (numRetriggers > 0)
+            {
+                --numRetriggers;
+                triggerAsyncUpdate();
+            }
+
+            if (updaterToTrigger != nullptr)
+            {
+                updaterToTrigger->triggerAsyncUpdate();
+                updaterToTrigger = nullptr;
+            }
+        }
+
+        const String name;
+        String& log;
+        int numCallbacks, numRetriggers;
+        AsyncUpdater* updaterToTrigger;
+        Array<int64> flushNumbers;
+    };
+
+    void runTest() override
+    {
+        String log;
+
+        beginTest ("Repeated triggers before delivery give a single callback");
+        {
+            TestUpdater a ("a", log);
+
+            for (int i = 0; i < 10; ++i)
+                a.triggerAsyncUpdate();
+
+            expect (a.isUpdatePending());
+            runDispatchLoopUntilCalled (a, 1);
+
+            expectEquals (a.numCallbacks, 1);
+            expect (! a.isUpdatePending());
+        }
+
+        beginTest ("A cancelled update is taken out of a pending batch");
+        {
+            log = String();
+            TestUpdater a ("a", log), b ("b", log), c ("c", log);
+
+            a.triggerAsyncUpdate();
+            b.triggerAsyncUpdate();
+            c.triggerAsyncUpdate();
+            b.cancelPendingUpdate();
+            expect (! b.isUpdatePending());
+
+            runDispatchLoopUntilCalled (c, 1);
+            expectEquals (log, String ("ac"));
+            expectEquals (b.numCallbacks, 0);
+        }
+
+        beginTest ("An updater that's deleted while it's queued isn't called");
+        {
+            log = String();
+            TestUpdater a ("a", log), c ("c", log);
+            ScopedPointer<TestUpdater> b (new TestUpdater ("b", log));
+
+            a.triggerAsyncUpdate();
+            b->triggerAsyncUpdate();
+            c.triggerAsyncUpdate();
+            b = nullptr;
+
+            runDispatchLoopUntilCalled (c, 1);
+            expectEquals (log, String ("ac"));
+        }
+
+        beginTest ("Triggers from inside a callback are delivered in the next batch");
+        {
+            log = String();
+            TestUpdater a ("a", log), b ("b", log), c ("c", log);
+            a.numRetriggers = 1;
+            a.updaterToTrigger = &b;
+
+            a.triggerAsyncUpdate();
+            c.triggerAsyncUpdate();
+
+            runDispatchLoopUntilCalled (a, 2);
+            runDispatchLoopUntilCalled (b, 1);
+
+            expectEquals (log, String ("acab"));
+            expectEquals (c.flushNumbers[0], a.flushNumbers[0]);
+            expect (a.flushNumbers[1] > a.flushNumbers[0]);
+            expectEquals (b.flushNumbers[0], a.flushNumbers[1]);
+        }
+    }
+
+private:
+    // runs the message loop until the updater has been called enough, and then for a bit
+    // longer, to make sure that nothing else arrives
+    static void runDispatchLoopUntilCalled (const TestUpdater& updater, int numCallbacks)
+    {
+        for (int i = 0; i < 100 && updater.numCallbacks < numCallbacks; ++i)
+            MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+        MessageManager::getInstance()->runDispatchLoopUntil (50);
+    }
+};
+
+static AsyncUpdaterTests asyncUpdaterTests;
+
+#endif
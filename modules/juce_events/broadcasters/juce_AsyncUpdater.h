@@ -96,9 +96,42 @@ public:
     */
     virtual void handleAsyncUpdate() = 0;
 
+    //==============================================================================
+    /** Makes all pending updates get delivered together at a fixed rate, rather than
+        as soon as the message thread is free.
+
+        Normally, the updaters that have been triggered are all delivered in a single
+        pass on the next iteration of the message loop. If you set a frame rate here,
+        they'll instead be held back and flushed in one go at (roughly) that rate, which
+        can be handy for stopping a flood of triggers from other threads from keeping
+        the message thread continuously busy. Pass 0 to go back to the default behaviour.
+    */
+    static void JUCE_CALLTYPE setFrameAlignedDelivery (int framesPerSecond);
+
+    /** Some figures about the updates that have been delivered.
+        @see getDeliveryStatistics
+    */
+    struct DeliveryStatistics
+    {
+        int64 numUpdatesQueued;     /**< The number of updaters that have been queued for delivery. */
+        int64 numFlushes;           /**< The number of passes that have been made to deliver the queue. */
+        int maxQueueDepth;          /**< The largest number of updaters delivered by a single pass. */
+        double averageLatencyMs;    /**< The mean time between an updater being queued and its callback starting. */
+        double maxLatencyMs;        /**< The longest time an updater has waited for its callback. */
+    };
+
+    /** Returns statistics gathered across all AsyncUpdaters since the app started, or
+        since resetDeliveryStatistics() was called.
+    */
+    static DeliveryStatistics JUCE_CALLTYPE getDeliveryStatistics() noexcept;
+
+    /** Clears the counters returned by getDeliveryStatistics(). */
+    static void JUCE_CALLTYPE resetDeliveryStatistics() noexcept;
+
 private:
     //==============================================================================
     class AsyncUpdaterMessage;
+    class PendingUpdateQueue;
     friend class ReferenceCountedObjectPtr<AsyncUpdaterMessage>;
     ReferenceCountedObjectPtr<AsyncUpdaterMessage> activeMessage;
 
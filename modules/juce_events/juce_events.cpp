@@ -52,6 +52,8 @@
  #include <X11/Xutil.h>
  #undef KeyPress
  #include <unistd.h>
+ #include <sys/eventfd.h>
+ #include <sys/epoll.h>
 #endif
 
 //==============================================================================
@@ -164,6 +164,29 @@ public:
     /** Deregisters a broadcast listener. */
     void deregisterBroadcastListener (ActionListener* listener);
 
+   #if JUCE_LINUX || DOXYGEN
+    //==============================================================================
+    /** Counters describing the traffic that has passed through the native message queue.
+        @see getQueueStatistics
+    */
+    struct QueueStatistics
+    {
+        int64 numMessagesPosted;        /**< The number of messages that have been posted to the queue. */
+        int64 numMessagesDispatched;    /**< The number of messages that the message thread has delivered. */
+        int64 numWakeups;               /**< How many times a posting thread had to wake up the message thread. */
+        int64 numBatches;               /**< How many batches of messages the message thread has collected. */
+        int maxBatchSize;               /**< The largest number of messages collected in a single batch. */
+        double averageLatencyMs;        /**< The mean time between a message being posted and it being collected. */
+        double maxLatencyMs;            /**< The longest time any message has waited before being collected. */
+    };
+
+    /** Returns some statistics about the message queue, which can help to diagnose
+        a message thread that's struggling to keep up with the messages being posted.
+        (Currently only available on Linux).
+    */
+    static QueueStatistics getQueueStatistics();
+   #endif
+
     //==============================================================================
     /** Internal class used as the base class for all message objects.
         You shouldn't need to use this directly - see the CallbackMessage or Message
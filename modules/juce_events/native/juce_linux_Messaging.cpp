@@ -41,21 +41,32 @@ ScopedXLock::ScopedXLock()       { if (display != nullptr) XLockDisplay (display
 ScopedXLock::~ScopedXLock()      { if (display != nullptr) XUnlockDisplay (display); }
 
 //==============================================================================
+/*  Messages get pushed onto a lock-free stack by any number of posting threads, and the
+    message thread takes the whole stack in one go and delivers it as a batch. The eventfd
+    only gets written when a message lands on an empty stack, so however many messages are
+    posted between two dispatch passes, the message thread only gets woken once.
+*/
 class InternalMessageQueue
 {
 public:
     InternalMessageQueue()
-        : bytesInSocket (0),
+        : wakeupFd (eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC)),
+          epollFd (epoll_create1 (EPOLL_CLOEXEC)),
+          displayFd (-1),
+          currentBatch (nullptr),
           totalEventCount (0)
     {
-        int ret = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, fd);
-        ignoreUnused (ret); jassert (ret == 0);
+        jassert (wakeupFd >= 0 && epollFd >= 0);
+        addToEpoll (wakeupFd);
     }
 
     ~InternalMessageQueue()
     {
-        close (fd[0]);
-        close (fd[1]);
+        deleteMessageList (currentBatch);
+        deleteMessageList (pendingMessages.exchange (nullptr));
+
+        close (epollFd);
+        close (wakeupFd);
 
         clearSingletonInstance();
     }
@@ -63,26 +74,28 @@ public:
     //==============================================================================
     void postMessage (MessageManager::MessageBase* const msg)
     {
-        const int maxBytesInSocketQueue = 128;
-
-        ScopedLock sl (lock);
-        queue.add (msg);
+        QueuedMessage* const m = new QueuedMessage (msg);
 
-        if (bytesInSocket < maxBytesInSocketQueue)
+        for (;;)
         {
-            ++bytesInSocket;
+            QueuedMessage* const head = pendingMessages.get();
+            m->next = head;
+
+            if (pendingMessages.compareAndSetBool (m, head))
+            {
+                ++statistics.numMessagesPosted;
+
+                if (head == nullptr)
+                    signalMessageThread();
 
-            ScopedUnlock ul (lock);
-            const unsigned char x = 0xff;
-            ssize_t bytesWritten = write (fd[0], &x, 1);
-            ignoreUnused (bytesWritten);
+                break;
+            }
         }
     }
 
-    bool isEmpty() const
+    bool isEmpty() const noexcept
     {
-        ScopedLock sl (lock);
-        return queue.size() == 0;
+        return currentBatch == nullptr && pendingMessages.get() == nullptr;
     }
 
     bool dispatchNextEvent()
@@ -90,9 +103,9 @@ public:
         // This alternates between giving priority to XEvents or internal messages,
         // to keep everything running smoothly..
         if ((++totalEventCount & 1) != 0)
-            return dispatchNextXEvent() || dispatchNextInternalMessage();
+            return dispatchNextXEvent() || dispatchNextInternalMessages();
 
-        return dispatchNextInternalMessage() || dispatchNextXEvent();
+        return dispatchNextInternalMessages() || dispatchNextXEvent();
     }
 
     // Wait for an event (either XEvent, or an internal Message)
@@ -106,50 +119,91 @@ public:
             ScopedXLock xlock;
             if (XPending (display))
                 return true;
-        }
-
-        struct timeval tv;
-        tv.tv_sec = 0;
-        tv.tv_usec = timeoutMs * 1000;
-        int fd0 = getWaitHandle();
-        int fdmax = fd0;
 
-        fd_set readset;
-        FD_ZERO (&readset);
-        FD_SET (fd0, &readset);
-
-        if (display != nullptr)
-        {
-            ScopedXLock xlock;
-            int fd1 = XConnectionNumber (display);
-            FD_SET (fd1, &readset);
-            fdmax = jmax (fd0, fd1);
+            if (displayFd < 0)
+            {
+                displayFd = XConnectionNumber (display);
+                addToEpoll (displayFd);
+            }
         }
 
-        const int ret = select (fdmax + 1, &readset, 0, 0, &tv);
+        struct epoll_event events[2];
+        const int ret = epoll_wait (epollFd, events, numElementsInArray (events), timeoutMs);
         return (ret > 0); // ret <= 0 if error or timeout
     }
 
+    MessageManager::QueueStatistics getStatistics() const noexcept
+    {
+        MessageManager::QueueStatistics s;
+        s.numMessagesPosted     = statistics.numMessagesPosted.get();
+        s.numMessagesDispatched = statistics.numMessagesDispatched.get();
+        s.numWakeups            = statistics.numWakeups.get();
+        s.numBatches            = statistics.numBatches.get();
+        s.maxBatchSize          = (int) statistics.maxBatchSize.get();
+
+        const double msPerTick = 1000.0 * Time::highResolutionTicksToSeconds (1);
+        s.averageLatencyMs = s.numMessagesDispatched > 0 ? statistics.totalLatencyTicks.get() * msPerTick / (double) s.numMessagesDispatched : 0.0;
+        s.maxLatencyMs = statistics.maxLatencyTicks.get() * msPerTick;
+        return s;
+    }
+
     //==============================================================================
     juce_DeclareSingleton_SingleThreaded_Minimal (InternalMessageQueue)
 
 private:
-    CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
-    int fd[2];
-    int bytesInSocket;
+    struct QueuedMessage
+    {
+        QueuedMessage (MessageManager::MessageBase* m) noexcept
+            : message (m), next (nullptr), timePosted (Time::getHighResolutionTicks())
+        {
+        }
+
+        MessageManager::MessageBase::Ptr message;
+        QueuedMessage* next;
+        const int64 timePosted;
+    };
+
+    struct Statistics
+    {
+        Atomic<int64> numMessagesPosted, numMessagesDispatched, numWakeups, numBatches,
+                      maxBatchSize, totalLatencyTicks, maxLatencyTicks;
+    };
+
+    Atomic<QueuedMessage*> pendingMessages;
+    const int wakeupFd, epollFd;
+    int displayFd;
+    QueuedMessage* currentBatch; // only touched by the message thread
     int totalEventCount;
+    Statistics statistics;
 
-    int getWaitHandle() const noexcept      { return fd[1]; }
+    void addToEpoll (const int fdToWatch) noexcept
+    {
+        struct epoll_event ev;
+        zerostruct (ev);
+        ev.events = EPOLLIN;
+        ev.data.fd = fdToWatch;
 
-    static bool setNonBlocking (int handle)
+        const int ret = epoll_ctl (epollFd, EPOLL_CTL_ADD, fdToWatch, &ev);
+        ignoreUnused (ret); jassert (ret == 0);
+    }
+
+    void signalMessageThread() noexcept
     {
-        int socketFlags = fcntl (handle, F_GETFL, 0);
-        if (socketFlags == -1)
-            return false;
+        ++statistics.numWakeups;
 
-        socketFlags |= O_NONBLOCK;
-        return fcntl (handle, F_SETFL, socketFlags) == 0;
+        const uint64 x = 1;
+        ssize_t bytesWritten = write (wakeupFd, &x, sizeof (x));
+        ignoreUnused (bytesWritten);
+    }
+
+    static void deleteMessageList (QueuedMessage* m) noexcept
+    {
+        while (m != nullptr)
+        {
+            QueuedMessage* const next = m->next;
+            delete m;
+            m = next;
+        }
     }
 
     static bool dispatchNextXEvent()
@@ -171,41 +225,78 @@ private:
               && handleSelectionRequest != nullptr)
             handleSelectionRequest (evt.xselectionrequest);
         else if (evt.xany.window != juce_messageWindowHandle && dispatchWindowMessage != nullptr)
+        {
+            JUCE_TRACE_SCOPE_IN ("messages", "XEvent");
             dispatchWindowMessage (evt);
+        }
 
         return true;
     }
 
-    MessageManager::MessageBase::Ptr popNextMessage()
+    bool fetchNextBatch() noexcept
     {
-        const ScopedLock sl (lock);
+        // the eventfd must be cleared before grabbing the stack, so that anything posted
+        // after this point is guaranteed to leave it signalled again
+        uint64 x;
+        ssize_t numBytes = read (wakeupFd, &x, sizeof (x));
+        ignoreUnused (numBytes);
 
-        if (bytesInSocket > 0)
-        {
-            --bytesInSocket;
+        QueuedMessage* m = pendingMessages.exchange (nullptr);
+
+        if (m == nullptr)
+            return false;
+
+        // the stack holds the newest message first, so reverse it to get posting order
+        QueuedMessage* batch = nullptr;
+        int64 batchSize = 0, totalLatency = 0, maxLatency = 0;
+        const int64 now = Time::getHighResolutionTicks();
 
-            const ScopedUnlock ul (lock);
-            unsigned char x;
-            ssize_t numBytes = read (fd[1], &x, 1);
-            ignoreUnused (numBytes);
+        while (m != nullptr)
+        {
+            QueuedMessage* const next = m->next;
+            m->next = batch;
+            batch = m;
+            m = next;
+
+            const int64 latency = now - batch->timePosted;
+            totalLatency += latency;
+            maxLatency = jmax (maxLatency, latency);
+            ++batchSize;
         }
 
-        return queue.removeAndReturn (0);
+        currentBatch = batch;
+
+        ++statistics.numBatches;
+        statistics.totalLatencyTicks += totalLatency;
+
+        if (batchSize > statistics.maxBatchSize.get())       statistics.maxBatchSize = batchSize;
+        if (maxLatency > statistics.maxLatencyTicks.get())   statistics.maxLatencyTicks = maxLatency;
+
+        return true;
     }
 
-    bool dispatchNextInternalMessage()
+    bool dispatchNextInternalMessages()
     {
-        if (const MessageManager::MessageBase::Ptr msg = popNextMessage())
+        if (currentBatch == nullptr && ! fetchNextBatch())
+            return false;
+
+        // deliver everything that was waiting when the batch was taken - anything posted
+        // by these callbacks will be picked up by the next pass
+        while (currentBatch != nullptr)
         {
+            const ScopedPointer<QueuedMessage> m (currentBatch);
+            currentBatch = m->next;
+            ++statistics.numMessagesDispatched;
+
             JUCE_TRY
             {
-                msg->messageCallback();
-                return true;
+                JUCE_TRACE_SCOPE_IN ("messages", "MessageBase::messageCallback");
+                m->message->messageCallback();
             }
             JUCE_CATCH_EXCEPTION
         }
 
-        return false;
+        return true;
     }
 };
 
@@ -368,6 +459,16 @@ bool MessageManager::postMessageToSystemQueue (MessageManager::MessageBase* cons
     return false;
 }
 
+MessageManager::QueueStatistics MessageManager::getQueueStatistics()
+{
+    if (InternalMessageQueue* queue = InternalMessageQueue::getInstanceWithoutCreating())
+        return queue->getStatistics();
+
+    QueueStatistics s;
+    zerostruct (s);
+    return s;
+}
+
 void MessageManager::broadcastMessage (const String& /* value */)
 {
     /* TODO */
@@ -402,3 +503,120 @@ bool MessageManager::dispatchNextMessageOnSystemQueue (bool returnIfNoPendingMes
 
     return false;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS && JUCE_MODAL_LOOPS_PERMITTED
+
+class LinuxMessageQueueTests  : public UnitTest
+{
+public:
+    LinuxMessageQueueTests() : UnitTest ("Linux message queue") {}
+
+    enum { numThreads = 4, numMessagesPerThread = 5000 };
+
+    // Only touched by the message thread, and kept alive by the messages themselves in
+    // case any of them are still queued if the test times out.
+    struct Receiver  : public ReferenceCountedObject
+    {
+        Receiver() : numDelivered (0), numOutOfOrder (0)
+        {
+            for (int i = 0; i < numThreads; ++i)
+                lastSequenceNumbers[i] = -1;
+        }
+
+        void messageArrived (int threadIndex, int sequenceNumber) noexcept
+        {
+            ++numDelivered;
+
+            // each thread's messages must arrive exactly once, in the order they were posted
+            if (sequenceNumber != lastSequenceNumbers[threadIndex] + 1)
+                ++numOutOfOrder;
+
+            lastSequenceNumbers[threadIndex] = sequenceNumber;
+        }
+
+        int lastSequenceNumbers[numThreads];
+        int numDelivered, numOutOfOrder;
+    };
+
+    struct TestMessage  : public MessageManager::MessageBase
+    {
+        TestMessage (Receiver* r, int thread, int sequence) noexcept
+            : receiver (r), threadIndex (thread), sequenceNumber (sequence)
+        {
+        }
+
+        void messageCallback() override
+        {
+            receiver->messageArrived (threadIndex, sequenceNumber);
+        }
+
+        const ReferenceCountedObjectPtr<Receiver> receiver;
+        const int threadIndex, sequenceNumber;
+    };
+
+    struct PostingThread  : public Thread
+    {
+        PostingThread (Receiver* r, int index, WaitableEvent& start)
+            : Thread ("Message posting thread"), receiver (r), threadIndex (index), startEvent (start)
+        {
+        }
+
+        void run() override
+        {
+            startEvent.wait();
+
+            for (int i = 0; i < numMessagesPerThread; ++i)
+            {
+                (new TestMessage (receiver, threadIndex, i))->post();
+
+                if ((i & 63) == 0)
+                    Thread::yield();
+            }
+        }
+
+        Receiver* const receiver;
+        const int threadIndex;
+        WaitableEvent& startEvent;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Messages from several threads are each delivered once, in order");
+
+        const ReferenceCountedObjectPtr<Receiver> receiver (new Receiver());
+        const MessageManager::QueueStatistics statsBefore (MessageManager::getQueueStatistics());
+        const int totalMessages = numThreads * numMessagesPerThread;
+
+        {
+            WaitableEvent start (true);
+            OwnedArray<PostingThread> threads;
+
+            for (int i = 0; i < numThreads; ++i)
+                threads.add (new PostingThread (receiver, i, start))->startThread();
+
+            start.signal();
+
+            // the message thread keeps collecting batches while the others are still posting
+            for (int i = 0; i < 500 && receiver->numDelivered < totalMessages; ++i)
+                MessageManager::getInstance()->runDispatchLoopUntil (20);
+
+            for (int i = 0; i < threads.size(); ++i)
+                threads.getUnchecked (i)->stopThread (5000);
+        }
+
+        expectEquals (receiver->numDelivered, totalMessages);
+        expectEquals (receiver->numOutOfOrder, 0);
+
+        for (int i = 0; i < numThreads; ++i)
+            expectEquals (receiver->lastSequenceNumbers[i], (int) numMessagesPerThread - 1);
+
+        const MessageManager::QueueStatistics statsAfter (MessageManager::getQueueStatistics());
+        expect (statsAfter.numMessagesPosted - statsBefore.numMessagesPosted >= totalMessages);
+        expect (statsAfter.numMessagesDispatched - statsBefore.numMessagesDispatched >= totalMessages);
+    }
+};
+
+static LinuxMessageQueueTests linuxMessageQueueTests;
+
+#endif
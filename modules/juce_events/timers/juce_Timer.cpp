@@ -22,6 +22,269 @@
   ==============================================================================
 */
 
+/*  Active timers are kept in a hierarchical timing wheel, indexed by the absolute
+    millisecond counter value at which they're due. Each level has 64 slots, and each
+    slot on a level covers 64 times as many milliseconds as one on the level below, so
+    starting, stopping or resetting a timer is just a matter of linking it into (or out
+    of) the intrusive list for one slot. As time advances, the slots on the upper levels
+    get cascaded down into finer ones, and when a slot on the bottom level expires, its
+    timers are moved onto the due-list, which the message thread then empties in a
+    single pass each time a CallTimersMessage arrives.
+
+    The wheel doesn't own or lock anything, and only deals with the times that it's
+    given. It reaches the intrusive list fields of its items through the static functions
+    of the ItemLinks class: slot(), dueTime(), previous() and next(), which each take an
+    item and return a reference to that field.
+*/
+template <typename ItemType, typename ItemLinks>
+class TimingWheel
+{
+public:
+    enum { notScheduled = -1 };
+
+    explicit TimingWheel (uint32 startTime) noexcept
+        : currentTime (startTime), firstDueItem (nullptr), lastDueItem (nullptr)
+    {
+        zeromem (slots, sizeof (slots));
+        zeromem (occupiedSlots, sizeof (occupiedSlots));
+    }
+
+    /** Adds an item, which must not already be in the wheel, at its due time. If that time
+        has already been reached, it goes straight onto the end of the due-list.
+    */
+    void add (ItemType* const t) noexcept
+    {
+        // trying to add a timer that's already here - shouldn't get to this point,
+        // so if you get this assertion, let me know!
+        jassert (ItemLinks::slot (*t) == notScheduled);
+        schedule (t, false);
+    }
+
+    /** Takes an item out of the wheel or the due-list. */
+    void remove (ItemType* const t) noexcept
+    {
+        // trying to remove a timer that's not here - shouldn't get to this point,
+        // so if you get this assertion, let me know!
+        jassert (ItemLinks::slot (*t) != notScheduled);
+        unlink (t);
+    }
+
+    /** Returns the first item on the due-list, or nullptr if there aren't any. */
+    ItemType* getFirstDueItem() const noexcept      { return firstDueItem; }
+
+    /** Moves the wheel forward to the given time, and returns the number of
+        milliseconds until it next needs to be advanced.
+    */
+    int advanceTo (const uint32 now) noexcept
+    {
+        const int32 elapsed = (int32) (now - currentTime);
+
+        if (elapsed > 0)
+        {
+            if (isWheelEmpty())
+                currentTime = now;
+            else if (elapsed > (1 << (slotBits * 2)))
+                rebuild (now); // after a long stall, it's quicker to re-sort everything than to tick through it
+            else
+                while (currentTime != now)
+                    processTick (++currentTime);
+        }
+
+        return getTimeUntilNextTick();
+    }
+
+private:
+    enum
+    {
+        slotBits        = 6,
+        slotsPerLevel   = 1 << slotBits,
+        slotMask        = slotsPerLevel - 1,
+        numLevels       = 4,
+        numSlots        = numLevels * slotsPerLevel,
+        dueListSlot     = numSlots
+    };
+
+    uint32 currentTime;  // the millisecond counter value up to which the wheel has been advanced
+    ItemType* slots[numSlots];
+    uint64 occupiedSlots[numLevels];
+    ItemType* firstDueItem;
+    ItemType* lastDueItem;
+
+    //==============================================================================
+    /** Puts an item into the slot that matches its due time. When cascading, an item
+        that's due on the current tick goes into the bottom-level slot that's about
+        to expire; otherwise it's already late, so goes straight onto the due-list.
+    */
+    void schedule (ItemType* const t, const bool isCascading) noexcept
+    {
+        const int32 delta = (int32) (ItemLinks::dueTime (*t) - currentTime);
+
+        if (delta < 0 || (delta == 0 && ! isCascading))
+        {
+            appendToDueList (t);
+            return;
+        }
+
+        uint32 dueTime = ItemLinks::dueTime (*t);
+        int level = 0;
+
+        if (delta >= (1 << (slotBits * numLevels)))
+        {
+            // too far away for the wheel - park it in the furthest slot, and it'll
+            // get re-scheduled from its real due time when that slot gets cascaded
+            dueTime = currentTime + (uint32) ((1 << (slotBits * numLevels)) - 1);
+            level = numLevels - 1;
+        }
+        else
+        {
+            while (delta >= (1 << (slotBits * (level + 1))))
+                ++level;
+        }
+
+        link (t, level * slotsPerLevel + (int) ((dueTime >> (slotBits * level)) & slotMask));
+    }
+
+    void link (ItemType* const t, const int slot) noexcept
+    {
+        ItemLinks::slot (*t) = slot;
+        ItemLinks::previous (*t) = nullptr;
+        ItemLinks::next (*t) = slots[slot];
+
+        if (slots[slot] != nullptr)
+            ItemLinks::previous (*slots[slot]) = t;
+
+        slots[slot] = t;
+        occupiedSlots[slot >> slotBits] |= ((uint64) 1) << (slot & slotMask);
+    }
+
+    void appendToDueList (ItemType* const t) noexcept
+    {
+        ItemLinks::slot (*t) = dueListSlot;
+        ItemLinks::next (*t) = nullptr;
+        ItemLinks::previous (*t) = lastDueItem;
+
+        if (lastDueItem != nullptr)
+            ItemLinks::next (*lastDueItem) = t;
+        else
+            firstDueItem = t;
+
+        lastDueItem = t;
+    }
+
+    void unlink (ItemType* const t) noexcept
+    {
+        const int slot = ItemLinks::slot (*t);
+        ItemType* const previous = ItemLinks::previous (*t);
+        ItemType* const next = ItemLinks::next (*t);
+
+        if (previous != nullptr)
+            ItemLinks::next (*previous) = next;
+        else if (slot == dueListSlot)
+            firstDueItem = next;
+        else
+            slots[slot] = next;
+
+        if (next != nullptr)
+            ItemLinks::previous (*next) = previous;
+        else if (slot == dueListSlot)
+            lastDueItem = previous;
+
+        if (slot != dueListSlot && slots[slot] == nullptr)
+            occupiedSlots[slot >> slotBits] &= ~(((uint64) 1) << (slot & slotMask));
+
+        ItemLinks::next (*t) = nullptr;
+        ItemLinks::previous (*t) = nullptr;
+        ItemLinks::slot (*t) = notScheduled;
+    }
+
+    ItemType* detachSlot (const int slot) noexcept
+    {
+        ItemType* const first = slots[slot];
+        slots[slot] = nullptr;
+        occupiedSlots[slot >> slotBits] &= ~(((uint64) 1) << (slot & slotMask));
+        return first;
+    }
+
+    bool isWheelEmpty() const noexcept
+    {
+        for (int i = 0; i < numLevels; ++i)
+            if (occupiedSlots[i] != 0)
+                return false;
+
+        return true;
+    }
+
+    //==============================================================================
+    void processTick (const uint32 tick) noexcept
+    {
+        // when a level wraps around, the next slot from the level above gets redistributed
+        // into it - the higher levels have to be done first so their items can trickle down
+        int numLevelsToCascade = 0;
+
+        while (numLevelsToCascade < numLevels - 1
+                && ((tick >> (slotBits * numLevelsToCascade)) & slotMask) == 0)
+            ++numLevelsToCascade;
+
+        for (int level = numLevelsToCascade; level > 0; --level)
+        {
+            ItemType* t = detachSlot (level * slotsPerLevel + (int) ((tick >> (slotBits * level)) & slotMask));
+
+            while (t != nullptr)
+            {
+                ItemType* const next = ItemLinks::next (*t);
+                schedule (t, true);
+                t = next;
+            }
+        }
+
+        for (ItemType* t = detachSlot ((int) (tick & slotMask)); t != nullptr;)
+        {
+            ItemType* const next = ItemLinks::next (*t);
+            appendToDueList (t);
+            t = next;
+        }
+    }
+
+    void rebuild (const uint32 now)
+    {
+        Array<ItemType*> items;
+
+        for (int slot = 0; slot < numSlots; ++slot)
+            for (ItemType* t = detachSlot (slot); t != nullptr; t = ItemLinks::next (*t))
+                items.add (t);
+
+        currentTime = now;
+
+        for (int i = 0; i < items.size(); ++i)
+            schedule (items.getUnchecked (i), false);
+    }
+
+    int getTimeUntilNextTick() const noexcept
+    {
+        if (firstDueItem != nullptr)
+            return 0;
+
+        const bool upperLevelsOccupied = (occupiedSlots[1] | occupiedSlots[2] | occupiedSlots[3]) != 0;
+
+        if (occupiedSlots[0] == 0 && ! upperLevelsOccupied)
+            return 1000;
+
+        for (int i = 1; i < slotsPerLevel; ++i)
+        {
+            const int slot = (int) ((currentTime + (uint32) i) & slotMask);
+
+            if ((occupiedSlots[0] & (((uint64) 1) << slot)) != 0
+                 || (slot == 0 && upperLevelsOccupied))
+                return i;
+        }
+
+        return slotsPerLevel;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (TimingWheel)
+};
+
+//==============================================================================
 class Timer::TimerThread  : private Thread,
                             private DeletedAtShutdown,
                             private AsyncUpdater
@@ -31,7 +294,7 @@ public:
 
     TimerThread()
         : Thread ("Juce Timer"),
-          firstTimer (nullptr)
+          wheel (Time::getMillisecondCounter())
     {
         triggerAsyncUpdate();
     }
@@ -49,20 +312,13 @@ public:
 
     void run() override
     {
-        uint32 lastTime = Time::getMillisecondCounter();
         MessageManager::MessageBase::Ptr messageToSend (new CallTimersMessage());
 
         while (! threadShouldExit())
         {
-            const uint32 now = Time::getMillisecondCounter();
-
-            const int elapsed = (int) (now >= lastTime ? (now - lastTime)
-                                                       : (std::numeric_limits<uint32>::max() - (lastTime - now)));
-            lastTime = now;
+            const int timeUntilNextTimer = advanceTo (Time::getMillisecondCounter());
 
-            const int timeUntilFirstTimer = getTimeUntilFirstTimer (elapsed);
-
-            if (timeUntilFirstTimer <= 0)
+            if (timeUntilNextTimer <= 0)
             {
                 if (callbackArrived.wait (0))
                 {
@@ -86,7 +342,7 @@ public:
 
             // don't wait for too long because running this loop also helps keep the
             // Time::getApproximateMillisecondTimer value stay up-to-date
-            wait (jlimit (1, 100, timeUntilFirstTimer));
+            wait (jlimit (1, 100, timeUntilNextTimer));
         }
     }
 
@@ -97,18 +353,20 @@ public:
 
         const LockType::ScopedLockType sl (lock);
 
-        while (firstTimer != nullptr && firstTimer->timerCountdownMs <= 0)
+        while (Timer* const t = wheel.getFirstDueItem())
         {
-            Timer* const t = firstTimer;
-            t->timerCountdownMs = t->timerPeriodMs;
+            const uint32 now = Time::getMillisecondCounter();
+            updateStatistics (*t, (int) (int32) (now - t->timerDueTimeMs));
 
-            removeTimer (t);
-            addTimer (t);
+            wheel.remove (t);
+            t->timerDueTimeMs = now + (uint32) t->timerPeriodMs;
+            wheel.add (t);
 
             const LockType::ScopedUnlockType ul (lock);
 
             JUCE_TRY
             {
+                JUCE_TRACE_SCOPE_IN ("messages", "Timer::timerCallback");
                 t->timerCallback();
             }
             JUCE_CATCH_EXCEPTION
@@ -130,6 +388,7 @@ public:
             triggerAsyncUpdate();
         }
 
+        advanceTo (Time::getMillisecondCounter());
         callTimers();
     }
 
@@ -144,30 +403,34 @@ public:
     static inline void remove (Timer* const tim) noexcept
     {
         if (instance != nullptr)
-            instance->removeTimer (tim);
+            instance->wheel.remove (tim);
     }
 
     static inline void resetCounter (Timer* const tim, const int newCounter) noexcept
     {
         if (instance != nullptr)
         {
-            tim->timerCountdownMs = newCounter;
-            tim->timerPeriodMs = newCounter;
-
-            if ((tim->nextTimer != nullptr && tim->nextTimer->timerCountdownMs < tim->timerCountdownMs)
-                 || (tim->previousTimer != nullptr && tim->previousTimer->timerCountdownMs > tim->timerCountdownMs))
-            {
-                instance->removeTimer (tim);
-                instance->addTimer (tim);
-            }
+            tim->timerPeriodMs = jmax (1, newCounter);
+            instance->wheel.remove (tim);
+            instance->addTimer (tim);
         }
     }
 
+    /** Gives the wheel access to a Timer's list fields. */
+    struct TimerLinks
+    {
+        static int& slot (Timer& t) noexcept            { return t.timerWheelSlot; }
+        static uint32& dueTime (Timer& t) noexcept      { return t.timerDueTimeMs; }
+        static Timer*& previous (Timer& t) noexcept     { return t.previousTimer; }
+        static Timer*& next (Timer& t) noexcept         { return t.nextTimer; }
+    };
+
     static TimerThread* instance;
     static LockType lock;
+    static TimerStatistics statistics;
 
 private:
-    Timer* volatile firstTimer;
+    TimingWheel<Timer, TimerLinks> wheel;
     WaitableEvent callbackArrived;
 
     struct CallTimersMessage  : public MessageManager::MessageBase
@@ -184,74 +447,28 @@ private:
     //==============================================================================
     void addTimer (Timer* const t) noexcept
     {
-       #if JUCE_DEBUG
-        // trying to add a timer that's already here - shouldn't get to this point,
-        // so if you get this assertion, let me know!
-        jassert (! timerExists (t));
-       #endif
-
-        Timer* i = firstTimer;
-
-        if (i == nullptr || i->timerCountdownMs > t->timerCountdownMs)
-        {
-            t->nextTimer = firstTimer;
-            firstTimer = t;
-        }
-        else
-        {
-            while (i->nextTimer != nullptr && i->nextTimer->timerCountdownMs <= t->timerCountdownMs)
-                i = i->nextTimer;
-
-            jassert (i != nullptr);
-
-            t->nextTimer = i->nextTimer;
-            t->previousTimer = i;
-            i->nextTimer = t;
-        }
-
-        if (t->nextTimer != nullptr)
-            t->nextTimer->previousTimer = t;
-
-        jassert ((t->nextTimer == nullptr || t->nextTimer->timerCountdownMs >= t->timerCountdownMs)
-                  && (t->previousTimer == nullptr || t->previousTimer->timerCountdownMs <= t->timerCountdownMs));
-
+        t->timerDueTimeMs = Time::getMillisecondCounter() + (uint32) t->timerPeriodMs;
+        wheel.add (t);
         notify();
     }
 
-    void removeTimer (Timer* const t) noexcept
+    int advanceTo (const uint32 now) noexcept
     {
-       #if JUCE_DEBUG
-        // trying to remove a timer that's not here - shouldn't get to this point,
-        // so if you get this assertion, let me know!
-        jassert (timerExists (t));
-       #endif
-
-        if (t->previousTimer != nullptr)
-        {
-            jassert (firstTimer != t);
-            t->previousTimer->nextTimer = t->nextTimer;
-        }
-        else
-        {
-            jassert (firstTimer == t);
-            firstTimer = t->nextTimer;
-        }
-
-        if (t->nextTimer != nullptr)
-            t->nextTimer->previousTimer = t->previousTimer;
-
-        t->nextTimer = nullptr;
-        t->previousTimer = nullptr;
+        const LockType::ScopedLockType sl (lock);
+        return wheel.advanceTo (now);
     }
 
-    int getTimeUntilFirstTimer (const int numMillisecsElapsed) const
+    //==============================================================================
+    static void updateStatistics (const Timer& t, const int latenessMs) noexcept
     {
-        const LockType::ScopedLockType sl (lock);
+        ++statistics.numCallbacks;
 
-        for (Timer* t = firstTimer; t != nullptr; t = t->nextTimer)
-            t->timerCountdownMs -= numMillisecsElapsed;
-
-        return firstTimer != nullptr ? firstTimer->timerCountdownMs : 1000;
+        if (latenessMs > t.timerPeriodMs / 2)
+        {
+            ++statistics.numLateCallbacks;
+            statistics.numSkippedCallbacks += latenessMs / t.timerPeriodMs;
+            statistics.maxLatenessMs = jmax (statistics.maxLatenessMs, latenessMs);
+        }
     }
 
     void handleAsyncUpdate() override
@@ -259,35 +476,27 @@ private:
         startThread (7);
     }
 
-   #if JUCE_DEBUG
-    bool timerExists (Timer* const t) const noexcept
-    {
-        for (Timer* tt = firstTimer; tt != nullptr; tt = tt->nextTimer)
-            if (tt == t)
-                return true;
-
-        return false;
-    }
-   #endif
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimerThread)
 };
 
 Timer::TimerThread* Timer::TimerThread::instance = nullptr;
 Timer::TimerThread::LockType Timer::TimerThread::lock;
+Timer::TimerStatistics Timer::TimerThread::statistics = { 0, 0, 0, 0 };
 
 //==============================================================================
 Timer::Timer() noexcept
-   : timerCountdownMs (0),
-     timerPeriodMs (0),
+   : timerPeriodMs (0),
+     timerWheelSlot (-1),
+     timerDueTimeMs (0),
      previousTimer (nullptr),
      nextTimer (nullptr)
 {
 }
 
 Timer::Timer (const Timer&) noexcept
-   : timerCountdownMs (0),
-     timerPeriodMs (0),
+   : timerPeriodMs (0),
+     timerWheelSlot (-1),
+     timerDueTimeMs (0),
      previousTimer (nullptr),
      nextTimer (nullptr)
 {
@@ -308,7 +517,6 @@ void Timer::startTimer (const int interval) noexcept
 
     if (timerPeriodMs == 0)
     {
-        timerCountdownMs = interval;
         timerPeriodMs = jmax (1, interval);
         TimerThread::add (this);
     }
@@ -342,3 +550,236 @@ void JUCE_CALLTYPE Timer::callPendingTimersSynchronously()
     if (TimerThread::instance != nullptr)
         TimerThread::instance->callTimersSynchronously();
 }
+
+Timer::TimerStatistics JUCE_CALLTYPE Timer::getTimerStatistics() noexcept
+{
+    const TimerThread::LockType::ScopedLockType sl (TimerThread::lock);
+    return TimerThread::statistics;
+}
+
+void JUCE_CALLTYPE Timer::resetTimerStatistics() noexcept
+{
+    const TimerThread::LockType::ScopedLockType sl (TimerThread::lock);
+    zerostruct (TimerThread::statistics);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TimerTests  : public UnitTest
+{
+public:
+    TimerTests() : UnitTest ("Timer") {}
+
+    struct Item
+    {
+        int slot;
+        uint32 dueTime;
+        Item* previous;
+        Item* next;
+        bool wasRemoved;
+    };
+
+    struct ItemLinks
+    {
+        static int& slot (Item& i) noexcept           { return i.slot; }
+        static uint32& dueTime (Item& i) noexcept     { return i.dueTime; }
+        static Item*& previous (Item& i) noexcept     { return i.previous; }
+        static Item*& next (Item& i) noexcept         { return i.next; }
+    };
+
+    typedef TimingWheel<Item, ItemLinks> Wheel;
+
+    void runTest() override
+    {
+        Random r (getRandom());
+
+        // (the start time is close to the end of the counter's range, so that it wraps around)
+        const uint32 startTime = 0xffffffffu - 100000;
+
+        beginTest ("Items are due on time and in order, across slot and level cascades");
+        {
+            // advancing by as much as the wheel asks for each time, every item must come out on
+            // the exact tick when it's due, including those that cascaded down from upper levels
+            const int numItems = 500;
+            HeapBlock<Item> items ((size_t) numItems);
+            Wheel wheel (startTime);
+
+            for (int i = 0; i < numItems; ++i)
+                addItem (wheel, items[i], startTime + (uint32) (i == 0 ? 0 : 1 + r.nextInt (400000)));
+
+            int numDue = 0, numNotOnTime = 0, numOutOfOrder = 0;
+            uint32 lastDueTime = startTime;
+
+            for (uint32 now = startTime; numDue < numItems && (int32) (now - startTime) <= 400100;)
+            {
+                const int timeUntilNextTick = wheel.advanceTo (now);
+
+                while (Item* const item = wheel.getFirstDueItem())
+                {
+                    wheel.remove (item);
+                    ++numDue;
+
+                    if (item->dueTime != now)               ++numNotOnTime;
+                    if ((int32) (item->dueTime - lastDueTime) < 0)  ++numOutOfOrder;
+
+                    lastDueTime = item->dueTime;
+                }
+
+                now += (uint32) jlimit (1, 100, timeUntilNextTick);
+            }
+
+            expectEquals (numDue, numItems);
+            expectEquals (numNotOnTime, 0);
+            expectEquals (numOutOfOrder, 0);
+        }
+
+        beginTest ("Items with long intervals are rebuilt correctly after a stall");
+        {
+            // jumps of more than 4096ms make the wheel re-sort everything rather than ticking
+            // through, and some of these items are even further away than the wheel can reach
+            const int numItems = 300;
+            HeapBlock<Item> items ((size_t) numItems);
+            Wheel wheel (startTime);
+
+            for (int i = 0; i < numItems; ++i)
+                addItem (wheel, items[i], startTime + 1 + (uint32) r.nextInt (20000000));
+
+            int numDue = 0, numEarly = 0, numLate = 0;
+
+            for (uint32 now = startTime; numDue < numItems && (int32) (now - startTime) <= 20100000;)
+            {
+                const uint32 previousTime = now;
+                now += (uint32) (r.nextInt (3) == 0 ? 1 + r.nextInt (300) : 4097 + r.nextInt (50000));
+                wheel.advanceTo (now);
+
+                while (Item* const item = wheel.getFirstDueItem())
+                {
+                    wheel.remove (item);
+                    ++numDue;
+
+                    if ((int32) (item->dueTime - now) > 0)            ++numEarly;
+                    if ((int32) (item->dueTime - previousTime) <= 0)  ++numLate;
+                }
+            }
+
+            expectEquals (numDue, numItems);
+            expectEquals (numEarly, 0);
+            expectEquals (numLate, 0);
+        }
+
+        beginTest ("Removed items are never due");
+        {
+            const int numItems = 200;
+            HeapBlock<Item> items ((size_t) numItems);
+            Wheel wheel (startTime);
+
+            // the first few go straight onto the due-list
+            for (int i = 0; i < numItems; ++i)
+                addItem (wheel, items[i], startTime + (uint32) (i < 20 ? 0 : r.nextInt (100000)));
+
+            for (int i = 0; i < numItems; i += 2)
+            {
+                wheel.remove (items + i);
+                items[i].wasRemoved = true;
+            }
+
+            int numDue = 0, numRemovedButDue = 0;
+
+            for (uint32 now = startTime; (int32) (now - startTime) <= 100000; now += 50)
+            {
+                wheel.advanceTo (now);
+
+                while (Item* const item = wheel.getFirstDueItem())
+                {
+                    wheel.remove (item);
+                    ++numDue;
+
+                    if (item->wasRemoved)
+                        ++numRemovedButDue;
+                }
+            }
+
+            expectEquals (numDue, numItems / 2);
+            expectEquals (numRemovedButDue, 0);
+        }
+
+       #if JUCE_MODAL_LOOPS_PERMITTED
+        beginTest ("Restarting a running timer resets its countdown");
+        {
+            CountingTimer timer;
+            timer.startTimer (150);
+            MessageManager::getInstance()->runDispatchLoopUntil (100);
+            expectEquals (timer.numCallbacks, 0);
+
+            const uint32 restartTime = Time::getMillisecondCounter();
+            timer.startTimer (150);
+            runDispatchLoopUntilCalled (timer, 1);
+
+            expectEquals (timer.numCallbacks, 1);
+            expect ((int) (timer.lastCallbackTime - restartTime) >= 150);
+        }
+
+        beginTest ("Timers can be stopped and restarted from inside their callbacks");
+        {
+            CountingTimer timer;
+            timer.numCallbacksToRestartAfter = 1;
+            timer.numCallbacksToStopAfter = 3;
+            timer.startTimer (10);
+
+            runDispatchLoopUntilCalled (timer, 3);
+            MessageManager::getInstance()->runDispatchLoopUntil (150);
+
+            expectEquals (timer.numCallbacks, 3);
+            expect (! timer.isTimerRunning());
+        }
+       #endif
+    }
+
+private:
+    static void addItem (Wheel& wheel, Item& item, uint32 dueTime) noexcept
+    {
+        item.slot = Wheel::notScheduled;
+        item.dueTime = dueTime;
+        item.previous = item.next = nullptr;
+        item.wasRemoved = false;
+        wheel.add (&item);
+    }
+
+    struct CountingTimer  : public Timer
+    {
+        CountingTimer()
+            : numCallbacks (0), numCallbacksToRestartAfter (-1), numCallbacksToStopAfter (1), lastCallbackTime (0)
+        {
+        }
+
+        void timerCallback() override
+        {
+            lastCallbackTime = Time::getMillisecondCounter();
+            ++numCallbacks;
+
+            if (numCallbacks == numCallbacksToRestartAfter)
+            {
+                stopTimer();
+                startTimer (30);
+            }
+            else if (numCallbacks == numCallbacksToStopAfter)
+            {
+                stopTimer();
+            }
+        }
+
+        int numCallbacks, numCallbacksToRestartAfter, numCallbacksToStopAfter;
+        uint32 lastCallbackTime;
+    };
+
+    static void runDispatchLoopUntilCalled (const CountingTimer& timer, int numCallbacks)
+    {
+        for (int i = 0; i < 100 && timer.numCallbacks < numCallbacks; ++i)
+            MessageManager::getInstance()->runDispatchLoopUntil (20);
+    }
+};
+
+static TimerTests timerTests;
+
+#endif
@@ -123,11 +123,35 @@ public:
     */
     static void JUCE_CALLTYPE callPendingTimersSynchronously();
 
+    //==============================================================================
+    /** Some figures describing how punctually timer callbacks have been delivered.
+        @see getTimerStatistics
+    */
+    struct TimerStatistics
+    {
+        int64 numCallbacks;         /**< The total number of timer callbacks that have been made. */
+        int64 numLateCallbacks;     /**< The number of callbacks that arrived more than half an interval after they were due. */
+        int64 numSkippedCallbacks;  /**< The number of whole intervals that were missed by those late callbacks. */
+        int maxLatenessMs;          /**< The longest delay, in milliseconds, between a callback falling due and being made. */
+    };
+
+    /** Returns the statistics gathered for all timers since the app started, or
+        since resetTimerStatistics() was last called.
+
+        This can help to spot a message thread that's too busy to service its
+        timers properly.
+    */
+    static TimerStatistics JUCE_CALLTYPE getTimerStatistics() noexcept;
+
+    /** Clears the counters returned by getTimerStatistics(). */
+    static void JUCE_CALLTYPE resetTimerStatistics() noexcept;
+
 private:
     class TimerThread;
     friend class TimerThread;
-    int timerCountdownMs, timerPeriodMs; // NB: these member variable names are a little verbose
-    Timer* previousTimer, *nextTimer;    // to reduce risk of name-clashes with user subclasses
+    int timerPeriodMs, timerWheelSlot;  // NB: these member variable names are a little verbose
+    uint32 timerDueTimeMs;              // to reduce risk of name-clashes with user subclasses
+    Timer* previousTimer, *nextTimer;
 
     Timer& operator= (const Timer&) JUCE_DELETED_FUNCTION;
 };
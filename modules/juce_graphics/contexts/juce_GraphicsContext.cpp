@@ -44,6 +44,35 @@ namespace
 LowLevelGraphicsContext::LowLevelGraphicsContext() {}
 LowLevelGraphicsContext::~LowLevelGraphicsContext() {}
 
+void LowLevelGraphicsContext::drawPolyline (const Point<float>* points, int numPoints, float lineThickness)
+{
+    Path p;
+    p.preallocateSpace (numPoints * 3);
+    p.startNewSubPath (points[0]);
+
+    for (int i = 1; i < numPoints; ++i)
+        p.lineTo (points[i]);
+
+    Path stroke;
+    PathStrokeType (lineThickness, PathStrokeType::beveled, PathStrokeType::butt)
+        .createStrokedPath (stroke, p, AffineTransform(), getPhysicalPixelScaleFactor());
+
+    fillPath (stroke, AffineTransform());
+}
+
+void LowLevelGraphicsContext::fillVerticalSpans (float x, float columnWidth, const Range<float>* spans, int numSpans)
+{
+    RectangleList<float> rects;
+    rects.ensureStorageAllocated (numSpans);
+
+    for (int i = 0; i < numSpans; ++i)
+        if (! spans[i].isEmpty())
+            rects.addWithoutMerging (Rectangle<float> (x + (float) i * columnWidth, spans[i].getStart(),
+                                                       columnWidth, spans[i].getLength()));
+
+    fillRectList (rects);
+}
+
 //==============================================================================
 Graphics::Graphics (const Image& imageToDrawOnto)
     : context (*imageToDrawOnto.createLowLevelContext()),
@@ -369,6 +398,14 @@ void Graphics::fillRectList (const RectangleList<int>& rects) const
         context.fillRect (*r, false);
 }
 
+void Graphics::fillVerticalSpans (float x, float columnWidth, const Range<float>* spans, int numSpans) const
+{
+    jassert (columnWidth > 0);
+
+    if (numSpans > 0 && ! context.isClipEmpty())
+        context.fillVerticalSpans (x, columnWidth, spans, numSpans);
+}
+
 void Graphics::setPixel (int x, int y) const
 {
     context.fillRect (coordsToRectangle (x, y, 1, 1), false);
@@ -593,6 +630,12 @@ void Graphics::drawLine (const Line<float>& line, const float lineThickness) con
     fillPath (p);
 }
 
+void Graphics::drawPolyline (const Point<float>* points, int numPoints, float lineThickness) const
+{
+    if (numPoints > 1 && ! context.isClipEmpty())
+        context.drawPolyline (points, numPoints, lineThickness);
+}
+
 void Graphics::drawDashedLine (const Line<float>& line, const float* const dashLengths,
                                const int numDashLengths, const float lineThickness, int n) const
 {
@@ -288,6 +288,19 @@ public:
     */
     void fillRectList (const RectangleList<int>& rectangles) const;
 
+    /** Fills a row of adjacent vertical spans with the current colour or brush.
+
+        Each span is filled as a column that's columnWidth wide, with the first one starting
+        at x, and the next one starting where the previous one ended. The columns cover their
+        span's range vertically (with anti-aliased ends), and any empty spans are left blank.
+
+        This is designed for drawing things like min/max waveform overviews, and is much
+        faster than building a RectangleList or Path for the same shape.
+
+        @see drawPolyline
+    */
+    void fillVerticalSpans (float x, float columnWidth, const Range<float>* spans, int numSpans) const;
+
     /** Uses the current colour or brush to fill a rectangle with rounded corners.
         @see drawRoundedRectangle, Path::addRoundedRectangle
     */
@@ -400,6 +413,22 @@ public:
     */
     void drawLine (const Line<float>& line, float lineThickness) const;
 
+    /** Draws a series of connected lines through an array of points.
+
+        This is much faster than creating a Path from the points and stroking it, so it's a
+        good way to draw waveforms, spectra or plots that may have tens of thousands of points.
+        Each segment is drawn with flat ends and there's no mitring at the joints, so it's best
+        suited to thin lines - for thick lines with proper joints, use strokePath() instead.
+
+        When several consecutive points fall within the same pixel column, they're merged,
+        and that column is filled between the highest and lowest of them (plus half the line
+        thickness), rather than drawing each of the lines between them. For a dense trace this
+        looks the same, but any detail that's narrower than a pixel won't be visible.
+
+        @see fillVerticalSpans, strokePath
+    */
+    void drawPolyline (const Point<float>* points, int numPoints, float lineThickness = 1.0f) const;
+
     /** Draws a dashed line using a custom set of dash-lengths.
 
         @param line             the line to draw
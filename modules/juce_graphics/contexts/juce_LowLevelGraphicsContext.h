@@ -91,6 +91,14 @@ public:
     virtual void drawImage (const Image&, const AffineTransform&) = 0;
     virtual void drawLine (const Line<float>&) = 0;
 
+    /** The default implementation of this strokes a path, but renderers can override it
+        to draw the lines directly. */
+    virtual void drawPolyline (const Point<float>* points, int numPoints, float lineThickness);
+
+    /** The default implementation of this fills a list of rectangles, but renderers can
+        override it to rasterise the spans directly. */
+    virtual void fillVerticalSpans (float x, float columnWidth, const Range<float>* spans, int numSpans);
+
     virtual void setFont (const Font&) = 0;
     virtual const Font& getFont() = 0;
     virtual void drawGlyph (int glyphNumber, const AffineTransform&) = 0;
@@ -36,3 +36,191 @@ LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer (const Image&
 }
 
 LowLevelGraphicsSoftwareRenderer::~LowLevelGraphicsSoftwareRenderer() {}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class GlyphCacheTests  : public UnitTest
+{
+public:
+    GlyphCacheTests() : UnitTest ("GlyphCache") {}
+
+    // Stands in for a real glyph, so that the cache can be tested without any typefaces
+    struct TestGlyph  : public ReferenceCountedObject
+    {
+        TestGlyph() : glyph (0) {}
+
+        void generate (const Font& newFont, int glyphNumber)
+        {
+            font = newFont;
+            glyph = glyphNumber;
+        }
+
+        bool isFor (const Font& f, int glyphNumber) const noexcept
+        {
+            return glyph == glyphNumber && font == f;
+        }
+
+        Font font;
+        int glyph;
+    };
+
+    struct TestTarget {};
+
+    typedef RenderingHelpers::GlyphCache<TestGlyph, TestTarget> Cache;
+    typedef ReferenceCountedObjectPtr<TestGlyph> GlyphPtr;
+
+    void runTest() override
+    {
+        const Font font1 ("Test", 12.0f, Font::plain), font2 ("Test", 14.0f, Font::bold);
+
+        beginTest ("Repeated lookups are hits");
+        {
+            Cache cache;
+            const GlyphPtr g1 (cache.findOrCreateGlyph (font1, 65));
+            const GlyphPtr g2 (cache.findOrCreateGlyph (font2, 65));
+
+            expect (g1->isFor (font1, 65));
+            expect (g2->isFor (font2, 65));
+            expect (cache.findOrCreateGlyph (font1, 65) == g1);
+            expect (cache.findOrCreateGlyph (font2, 65) == g2);
+            expect (cache.findOrCreateGlyph (font1, 65) == g1);
+
+            Cache::Statistics stats (cache.getStatistics());
+            expectEquals (stats.hits, (int64) 3);
+            expectEquals (stats.misses, (int64) 2);
+            expectEquals (stats.numGlyphs, 8 * 16);
+
+            cache.reset();
+            stats = cache.getStatistics();
+            expectEquals (stats.hits + stats.misses, (int64) 0);
+        }
+
+        beginTest ("The least recently used glyphs are the ones that get reused");
+        {
+            Cache cache;
+            const GlyphPtr hot (cache.findOrCreateGlyph (font1, 0));
+            int numHotHits = 0;
+
+            for (int i = 1; i <= 2000; ++i)
+            {
+                cache.findOrCreateGlyph (font1, i);
+
+                if (cache.findOrCreateGlyph (font1, 0) == hot)
+                    ++numHotHits;
+            }
+
+            expectEquals (numHotHits, 2000);
+
+            // the cache can't have grown to hold all of them, so the oldest ones have gone
+            Cache::Statistics stats (cache.getStatistics());
+            expect (stats.numGlyphs < 2000);
+
+            cache.findOrCreateGlyph (font1, 1);
+            expectEquals (cache.getStatistics().misses, stats.misses + 1);
+        }
+
+        beginTest ("Glyphs that are still referenced aren't reused, so the cache grows and rehashes");
+        {
+            Cache cache;
+            ReferenceCountedArray<TestGlyph> held;
+
+            for (int i = 0; i < 1000; ++i)
+                held.add (cache.findOrCreateGlyph ((i & 1) != 0 ? font1 : font2, i));
+
+            const Cache::Statistics stats (cache.getStatistics());
+            expect (stats.numGlyphs >= 1000);
+            expectEquals (stats.numGlyphs % 4, 0);
+
+            int numChanged = 0, numNotFound = 0;
+
+            for (int i = 0; i < held.size(); ++i)
+            {
+                const Font& font = (i & 1) != 0 ? font1 : font2;
+
+                if (! held.getUnchecked (i)->isFor (font, i))
+                    ++numChanged;
+
+                if (cache.findOrCreateGlyph (font, i) != held.getUnchecked (i))
+                    ++numNotFound;
+            }
+
+            expectEquals (numChanged, 0);
+            expectEquals (numNotFound, 0);
+            expectEquals (cache.getStatistics().hits, (int64) held.size());
+
+            // once they're released, they can be recycled rather than growing any further
+            held.clear();
+
+            for (int i = 1000; i < 3000; ++i)
+                cache.findOrCreateGlyph (font1, i);
+
+            expectEquals (cache.getStatistics().numGlyphs, stats.numGlyphs);
+        }
+
+        beginTest ("Lookups from several threads");
+        {
+            Cache cache;
+            OwnedArray<LookupThread> threads;
+
+            for (int i = 0; i < 4; ++i)
+                threads.add (new LookupThread (cache, font1, font2, getRandom().nextInt()));
+
+            for (int i = 0; i < threads.size(); ++i)
+                threads.getUnchecked (i)->startThread();
+
+            int numWrongGlyphs = 0;
+
+            for (int i = 0; i < threads.size(); ++i)
+            {
+                threads.getUnchecked (i)->waitForThreadToExit (-1);
+                numWrongGlyphs += threads.getUnchecked (i)->numWrongGlyphs;
+            }
+
+            expectEquals (numWrongGlyphs, 0);
+
+            const Cache::Statistics stats (cache.getStatistics());
+            expectEquals (stats.hits + stats.misses, (int64) (threads.size() * LookupThread::numLookups));
+        }
+    }
+
+private:
+    struct LookupThread  : public Thread
+    {
+        LookupThread (Cache& c, const Font& f1, const Font& f2, int seed)
+            : Thread ("GlyphCache test"), cache (c), font1 (f1), font2 (f2), random (seed), numWrongGlyphs (0)
+        {
+        }
+
+        enum { numLookups = 20000 };
+
+        void run() override
+        {
+            for (int i = 0; i < numLookups; ++i)
+            {
+                const int glyphNumber = random.nextInt (300);
+                const Font& font = random.nextBool() ? font1 : font2;
+                const GlyphPtr glyph (cache.findOrCreateGlyph (font, glyphNumber));
+
+                if (! glyph->isFor (font, glyphNumber))
+                    ++numWrongGlyphs;
+
+                // while it's still being held, no other thread can recycle it
+                if ((i & 15) == 0)
+                    Thread::yield();
+
+                if (! glyph->isFor (font, glyphNumber))
+                    ++numWrongGlyphs;
+            }
+        }
+
+        Cache& cache;
+        const Font font1, font2;
+        Random random;
+        int numWrongGlyphs;
+    };
+};
+
+static GlyphCacheTests glyphCacheTests;
+
+#endif
@@ -0,0 +1,621 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#if JUCE_COMPILER_SUPPORTS_LAMBDAS
+
+struct LowLevelGraphicsTiledSoftwareRenderer::Operation
+{
+    enum Type
+    {
+        stateChange,
+        drawing,
+        blockStart,     // a saveState or beginTransparencyLayer
+        blockEnd        // the matching restoreState or endTransparencyLayer
+    };
+
+    Operation (int t, Rectangle<int> b) noexcept  : type (t), bounds (b), endOfBlock (-1) {}
+    virtual ~Operation() {}
+
+    virtual void perform (LowLevelGraphicsContext&) const = 0;
+
+    const int type;
+
+    // For a drawing operation, this is the device-space area that it might touch. For the start
+    // of a block, it's the area touched by everything inside the block, so that a tile which
+    // doesn't overlap it can skip straight to endOfBlock, without changing its state.
+    Rectangle<int> bounds;
+    int endOfBlock;
+
+    JUCE_DECLARE_NON_COPYABLE (Operation)
+};
+
+template <typename FunctionType>
+struct LowLevelGraphicsTiledSoftwareRenderer::OperationWithFunction  : public Operation
+{
+    OperationWithFunction (int t, Rectangle<int> b, const FunctionType& f)
+        : Operation (t, b), function (f)
+    {
+    }
+
+    void perform (LowLevelGraphicsContext& g) const override     { function (g); }
+
+    const FunctionType function;
+};
+
+// A copy of the points or spans passed to a drawing call, which the recorded operation can
+// share between all the tiles it gets replayed into.
+template <typename ElementType>
+struct TiledRendererArrayCopy  : public ReferenceCountedObject
+{
+    TiledRendererArrayCopy (const ElementType* source, int num)  : elements ((size_t) num), numElements (num)
+    {
+        for (int i = 0; i < num; ++i)
+            elements[i] = source[i];
+    }
+
+    typedef ReferenceCountedObjectPtr<TiledRendererArrayCopy> Ptr;
+
+    HeapBlock<ElementType> elements;
+    const int numElements;
+
+    JUCE_DECLARE_NON_COPYABLE (TiledRendererArrayCopy)
+};
+
+//==============================================================================
+// Tracks the transform and a device-space region which contains the real clip region,
+// so that the clip queries can be answered and the operations' bounds calculated.
+struct LowLevelGraphicsTiledSoftwareRenderer::State
+{
+    State (Point<int> o, const RectangleList<int>& c)  : transform (o), clip (c) {}
+
+    RenderingHelpers::TranslationOrTransform transform;
+    RectangleList<int> clip;
+    Font font;
+};
+
+//==============================================================================
+class LowLevelGraphicsTiledSoftwareRenderer::RenderThreads  : private DeletedAtShutdown
+{
+public:
+    RenderThreads()  : pool (jmax (1, SystemStats::getNumCpus() - 1)) {}
+    ~RenderThreads()  { clearSingletonInstance(); }
+
+    ThreadPool pool;
+
+    juce_DeclareSingleton (RenderThreads, false)
+};
+
+juce_ImplementSingleton (LowLevelGraphicsTiledSoftwareRenderer::RenderThreads)
+
+//==============================================================================
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& im, Point<int> o,
+                                                                              const RectangleList<int>& clip,
+                                                                              ThreadPool* poolToUse)
+    : image (im), origin (o), initialClip (clip),
+      pool (poolToUse != nullptr ? *poolToUse : getSharedThreadPool()),
+      state (new State (o, clip))
+{
+    operations.ensureStorageAllocated (256);
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::~LowLevelGraphicsTiledSoftwareRenderer()
+{
+    render();
+}
+
+ThreadPool& LowLevelGraphicsTiledSoftwareRenderer::getSharedThreadPool()
+{
+    return RenderThreads::getInstance()->pool;
+}
+
+//==============================================================================
+template <typename FunctionType>
+void LowLevelGraphicsTiledSoftwareRenderer::addOperation (int type, Rectangle<int> bounds, const FunctionType& f)
+{
+    operations.add (new OperationWithFunction<FunctionType> (type, bounds, f));
+}
+
+template <typename FunctionType>
+void LowLevelGraphicsTiledSoftwareRenderer::addStateChange (const FunctionType& f)
+{
+    addOperation (Operation::stateChange, Rectangle<int>(), f);
+}
+
+template <typename FunctionType>
+void LowLevelGraphicsTiledSoftwareRenderer::addDrawingOperation (Rectangle<float> deviceBounds, const FunctionType& f)
+{
+    // (expanded to allow for anti-aliasing and any rounding in the renderer)
+    const Rectangle<int> bounds (deviceBounds.getSmallestIntegerContainer().expanded (1)
+                                   .getIntersection (state->clip.getBounds()));
+
+    if (! bounds.isEmpty())
+    {
+        if (openBlocks.size() > 0)
+        {
+            Operation& block = *operations.getUnchecked (openBlocks.getLast());
+            block.bounds = block.bounds.getUnion (bounds);
+        }
+
+        addOperation (Operation::drawing, bounds, f);
+    }
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::openBlock()
+{
+    savedStates.add (new State (*state));
+    openBlocks.add (operations.size() - 1);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::closeBlock()
+{
+    state = savedStates.removeAndReturn (savedStates.size() - 1);
+
+    Operation& block = *operations.getUnchecked (openBlocks.removeAndReturn (openBlocks.size() - 1));
+    block.endOfBlock = operations.size() - 1;
+
+    if (openBlocks.size() > 0)
+    {
+        Operation& parent = *operations.getUnchecked (openBlocks.getLast());
+        parent.bounds = parent.bounds.getUnion (block.bounds);
+    }
+}
+
+Rectangle<float> LowLevelGraphicsTiledSoftwareRenderer::toDeviceSpace (Rectangle<float> r) const noexcept
+{
+    const RenderingHelpers::TranslationOrTransform& t = state->transform;
+
+    return t.isOnlyTranslated ? t.translated (r)
+                              : t.transformed (r);
+}
+
+//==============================================================================
+bool LowLevelGraphicsTiledSoftwareRenderer::isVectorDevice() const                 { return false; }
+float LowLevelGraphicsTiledSoftwareRenderer::getPhysicalPixelScaleFactor()         { return state->transform.getPhysicalPixelScaleFactor(); }
+bool LowLevelGraphicsTiledSoftwareRenderer::isClipEmpty() const                    { return state->clip.isEmpty(); }
+const Font& LowLevelGraphicsTiledSoftwareRenderer::getFont()                       { return state->font; }
+
+Rectangle<int> LowLevelGraphicsTiledSoftwareRenderer::getClipBounds() const
+{
+    return state->transform.deviceSpaceToUserSpace (state->clip.getBounds());
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipRegionIntersects (const Rectangle<int>& r)
+{
+    return state->clip.intersectsRectangle (toDeviceSpace (r.toFloat()).getSmallestIntegerContainer());
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOrigin (Point<int> o)
+{
+    state->transform.setOrigin (o);
+    addStateChange ([o] (LowLevelGraphicsContext& g) { g.setOrigin (o); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addTransform (const AffineTransform& t)
+{
+    state->transform.addTransform (t);
+    addStateChange ([t] (LowLevelGraphicsContext& g) { g.addTransform (t); });
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangle (const Rectangle<int>& r)
+{
+    addStateChange ([r] (LowLevelGraphicsContext& g) { g.clipToRectangle (r); });
+    return state->clip.clipTo (toDeviceSpace (r.toFloat()).getSmallestIntegerContainer());
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangleList (const RectangleList<int>& list)
+{
+    addStateChange ([list] (LowLevelGraphicsContext& g) { g.clipToRectangleList (list); });
+
+    RectangleList<int> deviceList;
+
+    for (const Rectangle<int>* r = list.begin(), * const e = list.end(); r != e; ++r)
+        deviceList.add (toDeviceSpace (r->toFloat()).getSmallestIntegerContainer());
+
+    return state->clip.clipTo (deviceList);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::excludeClipRectangle (const Rectangle<int>& r)
+{
+    addStateChange ([r] (LowLevelGraphicsContext& g) { g.excludeClipRectangle (r); });
+
+    // (a rotated rectangle isn't excluded from the tracked region, which only needs to contain the real one)
+    if (! state->transform.isRotated)
+        state->clip.subtract (RenderingHelpers::SoftwareRendererSavedState::getLargestIntegerWithin (toDeviceSpace (r.toFloat())));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToPath (const Path& path, const AffineTransform& t)
+{
+    addStateChange ([path, t] (LowLevelGraphicsContext& g) { g.clipToPath (path, t); });
+    state->clip.clipTo (path.getBoundsTransformed (state->transform.getTransformWith (t)).getSmallestIntegerContainer());
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToImageAlpha (const Image& im, const AffineTransform& t)
+{
+    addStateChange ([im, t] (LowLevelGraphicsContext& g) { g.clipToImageAlpha (im, t); });
+    state->clip.clipTo (im.getBounds().toFloat().transformedBy (state->transform.getTransformWith (t))
+                                                .getSmallestIntegerContainer());
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::saveState()
+{
+    addOperation (Operation::blockStart, Rectangle<int>(), [] (LowLevelGraphicsContext& g) { g.saveState(); });
+    openBlock();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::restoreState()
+{
+    if (savedStates.size() == 0)
+    {
+        jassertfalse; // trying to pop with an empty stack!
+        return;
+    }
+
+    addOperation (Operation::blockEnd, Rectangle<int>(), [] (LowLevelGraphicsContext& g) { g.restoreState(); });
+    closeBlock();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::beginTransparencyLayer (float opacity)
+{
+    addOperation (Operation::blockStart, Rectangle<int>(), [opacity] (LowLevelGraphicsContext& g) { g.beginTransparencyLayer (opacity); });
+    openBlock();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::endTransparencyLayer()
+{
+    if (savedStates.size() == 0)
+    {
+        jassertfalse; // trying to pop with an empty stack!
+        return;
+    }
+
+    addOperation (Operation::blockEnd, Rectangle<int>(), [] (LowLevelGraphicsContext& g) { g.endTransparencyLayer(); });
+    closeBlock();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFill (const FillType& fillType)
+{
+    addStateChange ([fillType] (LowLevelGraphicsContext& g) { g.setFill (fillType); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOpacity (float opacity)
+{
+    addStateChange ([opacity] (LowLevelGraphicsContext& g) { g.setOpacity (opacity); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    addStateChange ([quality] (LowLevelGraphicsContext& g) { g.setInterpolationQuality (quality); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFont (const Font& newFont)
+{
+    state->font = newFont;
+
+    // The typeface is looked up now, so that the rendering threads don't all try to do it at once
+    state->font.getTypeface();
+
+    const Font f (state->font);
+    addStateChange ([f] (LowLevelGraphicsContext& g) { g.setFont (f); });
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<int>& r, bool replaceExistingContents)
+{
+    addDrawingOperation (toDeviceSpace (r.toFloat()),
+                         [r, replaceExistingContents] (LowLevelGraphicsContext& g) { g.fillRect (r, replaceExistingContents); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<float>& r)
+{
+    addDrawingOperation (toDeviceSpace (r), [r] (LowLevelGraphicsContext& g) { g.fillRect (r); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRectList (const RectangleList<float>& list)
+{
+    addDrawingOperation (toDeviceSpace (list.getBounds()), [list] (LowLevelGraphicsContext& g) { g.fillRectList (list); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillPath (const Path& path, const AffineTransform& t)
+{
+    addDrawingOperation (path.getBoundsTransformed (state->transform.getTransformWith (t)),
+                         [path, t] (LowLevelGraphicsContext& g) { g.fillPath (path, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawImage (const Image& im, const AffineTransform& t)
+{
+    addDrawingOperation (im.getBounds().toFloat().transformedBy (state->transform.getTransformWith (t)),
+                         [im, t] (LowLevelGraphicsContext& g) { g.drawImage (im, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawLine (const Line<float>& line)
+{
+    addDrawingOperation (toDeviceSpace (Rectangle<float> (line.getStart(), line.getEnd())),
+                         [line] (LowLevelGraphicsContext& g) { g.drawLine (line); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawPolyline (const Point<float>* points, int numPoints, float lineThickness)
+{
+    const TiledRendererArrayCopy<Point<float> >::Ptr copiedPoints (new TiledRendererArrayCopy<Point<float> > (points, numPoints));
+    const Rectangle<float> area (Rectangle<float>::findAreaContainingPoints (points, numPoints).expanded (lineThickness));
+
+    addDrawingOperation (toDeviceSpace (area),
+                         [copiedPoints, lineThickness] (LowLevelGraphicsContext& g)
+                         {
+                             g.drawPolyline (copiedPoints->elements, copiedPoints->numElements, lineThickness);
+                         });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillVerticalSpans (float x, float columnWidth, const Range<float>* spans, int numSpans)
+{
+    Range<float> verticalRange;
+
+    for (int i = 0; i < numSpans; ++i)
+        if (! spans[i].isEmpty())
+            verticalRange = verticalRange.isEmpty() ? spans[i] : verticalRange.getUnionWith (spans[i]);
+
+    if (verticalRange.isEmpty())
+        return;
+
+    const Rectangle<float> area (x, verticalRange.getStart(), columnWidth * (float) numSpans, verticalRange.getLength());
+    const TiledRendererArrayCopy<Range<float> >::Ptr copiedSpans (new TiledRendererArrayCopy<Range<float> > (spans, numSpans));
+
+    addDrawingOperation (toDeviceSpace (area),
+                         [x, columnWidth, copiedSpans] (LowLevelGraphicsContext& g)
+                         {
+                             g.fillVerticalSpans (x, columnWidth, copiedSpans->elements, copiedSpans->numElements);
+                         });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawGlyph (int glyphNumber, const AffineTransform& t)
+{
+    // A glyph's outline isn't known until it's rendered, but it can't go outside the clip region
+    addDrawingOperation (state->clip.getBounds().toFloat(),
+                         [glyphNumber, t] (LowLevelGraphicsContext& g) { g.drawGlyph (glyphNumber, t); });
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::render()
+{
+    const Rectangle<int> totalArea (initialClip.getBounds());
+
+    if (operations.size() == 0 || totalArea.isEmpty())
+        return;
+
+    Array<Rectangle<int> > tiles;
+
+    for (int y = totalArea.getY(); y < totalArea.getBottom(); y += tileHeight)
+    {
+        const Rectangle<int> tile (totalArea.getX(), y, totalArea.getWidth(), tileHeight);
+
+        if (initialClip.intersectsRectangle (tile))
+            tiles.add (tile);
+    }
+
+    // Make sure the glyph cache exists before several threads try to use it
+    RenderingHelpers::SoftwareRendererSavedState::GlyphCacheType::getInstance();
+
+    parallelFor (pool, 0, tiles.size(),
+                 [this, &tiles] (int i) { renderTile (tiles.getReference (i)); }, 1);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::renderTile (const Rectangle<int>& tile) const
+{
+    RectangleList<int> tileClip (initialClip);
+
+    if (! tileClip.clipTo (tile))
+        return;
+
+    LowLevelGraphicsSoftwareRenderer g (image, origin, tileClip);
+
+    for (int i = 0; i < operations.size();)
+    {
+        const Operation& op = *operations.getUnchecked (i);
+
+        if (op.type == Operation::drawing)
+        {
+            if (op.bounds.intersects (tile))
+                op.perform (g);
+        }
+        else if (op.type == Operation::blockStart && op.endOfBlock > i && ! op.bounds.intersects (tile))
+        {
+            i = op.endOfBlock + 1;
+            continue;
+        }
+        else
+        {
+            op.perform (g);
+        }
+
+        ++i;
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LowLevelGraphicsTiledSoftwareRendererTests  : public UnitTest
+{
+public:
+    LowLevelGraphicsTiledSoftwareRendererTests() : UnitTest ("LowLevelGraphicsTiledSoftwareRenderer") {}
+
+    void runTest() override
+    {
+        ThreadPool pool (3);
+
+        beginTest ("Matches the software renderer");
+        {
+            const Difference d (render (drawScene, nullptr), render (drawScene, &pool));
+            expectEquals (d.numPixels, 0);
+        }
+
+        beginTest ("Transformed transparency layers stay within tolerance");
+        {
+            Random r (getRandom());
+
+            for (int i = 0; i < 10; ++i)
+            {
+                const AffineTransform t (AffineTransform::rotation (r.nextBool() ? r.nextFloat() * 6.0f : 0.0f)
+                                                         .scaled (0.5f + r.nextFloat())
+                                                         .translated (r.nextFloat() * 300.0f - 50.0f, r.nextFloat() * 200.0f - 50.0f));
+
+                const std::function<void (Graphics&)> drawFunction ([t] (Graphics& g) { drawSceneInLayer (g, t); });
+                const Difference d (render (drawFunction, nullptr), render (drawFunction, &pool));
+
+                expect (d.maxLevel <= maxLevelDifferenceInTransformedLayers);
+                expect (d.numPixels <= d.totalPixels / 50);
+            }
+        }
+    }
+
+private:
+    // Each tile's layer image has a different origin, which changes the rounding of the
+    // layer's transform, so some anti-aliased or resampled pixels come out slightly differently.
+    // (In practice, less than 1% of the pixels differ, by no more than 8 levels)
+    enum { maxLevelDifferenceInTransformedLayers = 16 };
+
+    static Image render (const std::function<void (Graphics&)>& drawFunction, ThreadPool* pool)
+    {
+        Image image (Image::ARGB, 300, 230, true);
+
+        {
+            ScopedPointer<LowLevelGraphicsContext> context;
+
+            if (pool != nullptr)
+                context = new LowLevelGraphicsTiledSoftwareRenderer (image, Point<int>(), RectangleList<int> (image.getBounds()), pool);
+            else
+                context = new LowLevelGraphicsSoftwareRenderer (image);
+
+            Graphics g (*context);
+            drawFunction (g);
+        }
+
+        return image;
+    }
+
+    static void drawShapes (Graphics& g)
+    {
+        g.setColour (Colours::orange.withAlpha (0.6f));
+        g.fillRect (3, 4, 150, 60);
+        g.fillEllipse (40.5f, 30.2f, 120.0f, 90.0f);
+
+        g.setGradientFill (ColourGradient (Colours::yellow, 10.0f, 10.0f, Colours::transparentBlack, 200.0f, 140.0f, false));
+        g.fillRoundedRectangle (20.0f, 60.0f, 180.0f, 50.0f, 8.0f);
+
+        g.setColour (Colours::white);
+        g.drawLine (0.0f, 150.0f, 290.0f, 5.0f, 3.5f);
+
+        Path star;
+        star.addStar (Point<float> (220.0f, 120.0f), 7, 20.0f, 60.0f, 0.2f);
+        g.setColour (Colours::green.withAlpha (0.8f));
+        g.strokePath (star, PathStrokeType (2.5f));
+    }
+
+    static void drawScene (Graphics& g)
+    {
+        g.fillAll (Colour (0xff336699));
+        drawShapes (g);
+
+        {
+            Graphics::ScopedSaveState ss (g);
+            g.reduceClipRegion (Rectangle<int> (30, 50, 200, 150));
+            g.excludeClipRegion (Rectangle<int> (100, 100, 30, 30));
+            g.addTransform (AffineTransform::scale (1.3f).translated (10.5f, 40.25f));
+            drawShapes (g);
+        }
+
+        g.beginTransparencyLayer (0.6f);
+        g.setOrigin (17, 71);
+        drawShapes (g);
+        g.endTransparencyLayer();
+
+        Image source (Image::ARGB, 64, 48, true);
+
+        {
+            Graphics sg (source);
+            sg.setGradientFill (ColourGradient (Colours::red, 0.0f, 0.0f, Colours::blue.withAlpha (0.5f), 64.0f, 48.0f, false));
+            sg.fillEllipse (0.0f, 0.0f, 64.0f, 48.0f);
+        }
+
+        g.drawImageAt (source, 5, 160);
+        g.drawImageTransformed (source, AffineTransform::rotation (0.3f).translated (150.0f, 150.0f));
+
+        Point<float> points[200];
+        Range<float> spans[200];
+
+        for (int i = 0; i < numElementsInArray (points); ++i)
+        {
+            const float y = 180.0f + 30.0f * std::sin (i * 0.2f);
+            points[i] = Point<float> (50.0f + i * 1.2f, y);
+            spans[i] = Range<float> (y - 5.0f - (float) (i % 7), y + 5.0f + (float) (i % 5));
+        }
+
+        g.setColour (Colours::black.withAlpha (0.7f));
+        g.fillVerticalSpans (50.0f, 1.2f, spans, numElementsInArray (spans));
+        g.setColour (Colours::yellow);
+        g.drawPolyline (points, numElementsInArray (points), 1.5f);
+    }
+
+    static void drawSceneInLayer (Graphics& g, const AffineTransform& transform)
+    {
+        g.fillAll (Colours::white);
+        g.addTransform (transform);
+        g.beginTransparencyLayer (0.7f);
+        drawScene (g);
+        g.endTransparencyLayer();
+    }
+
+    struct Difference
+    {
+        Difference (const Image& a, const Image& b)
+            : maxLevel (0), numPixels (0), totalPixels (a.getWidth() * a.getHeight())
+        {
+            for (int y = 0; y < a.getHeight(); ++y)
+            {
+                for (int x = 0; x < a.getWidth(); ++x)
+                {
+                    const Colour ca (a.getPixelAt (x, y)), cb (b.getPixelAt (x, y));
+
+                    if (ca != cb)
+                    {
+                        ++numPixels;
+                        maxLevel = jmax (maxLevel,
+                                         std::abs (ca.getAlpha() - cb.getAlpha()),
+                                         std::abs (ca.getRed()   - cb.getRed()),
+                                         jmax (std::abs (ca.getGreen() - cb.getGreen()),
+                                               std::abs (ca.getBlue()  - cb.getBlue())));
+                    }
+                }
+            }
+        }
+
+        int maxLevel, numPixels;
+        const int totalPixels;
+    };
+};
+
+static LowLevelGraphicsTiledSoftwareRendererTests lowLevelGraphicsTiledSoftwareRendererTests;
+
+#endif
+
+#endif
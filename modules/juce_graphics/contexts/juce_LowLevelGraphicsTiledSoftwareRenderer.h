@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_LOWLEVELGRAPHICSTILEDSOFTWARERENDERER_H_INCLUDED
+#define JUCE_LOWLEVELGRAPHICSTILEDSOFTWARERENDERER_H_INCLUDED
+
+#if JUCE_COMPILER_SUPPORTS_LAMBDAS || DOXYGEN
+
+//==============================================================================
+/**
+    A LowLevelGraphicsContext that records everything that's drawn into it, and then
+    rasterises it into an image using several threads.
+
+    While painting, the drawing operations are just kept in a list. When the context is
+    deleted, the area being drawn is split into tiles, and these are rendered in parallel,
+    each one by a LowLevelGraphicsSoftwareRenderer which replays only the operations that
+    can affect that tile. The tiles are bands that span the whole width of the area, so
+    that no anti-aliased run of pixels is ever split between them, and the result matches
+    what a LowLevelGraphicsSoftwareRenderer would draw - but large repaints can finish much
+    sooner on a machine with several cores.
+
+    The one exception is inside a transparency layer that was started while the context
+    had a rotated or scaled transform. Each tile gets its own layer image, and the layer's
+    transform gets rounded slightly differently for each one, so a small fraction of the
+    anti-aliased edge and resampled image pixels may end up a few levels different.
+
+    The clip region is only tracked approximately while recording, so getClipBounds() and
+    clipRegionIntersects() may report an area that's bigger than the real clip region (but
+    never smaller), which is fine when they're used to skip drawing that won't be visible.
+
+    To use it for painting a window, you can return one from your LookAndFeel, e.g.
+    @code
+    LowLevelGraphicsContext* createGraphicsContext (const Image& imageToRenderOn,
+                                                    const Point<int>& origin,
+                                                    const RectangleList<int>& initialClip) override
+    {
+        return new LowLevelGraphicsTiledSoftwareRenderer (imageToRenderOn, origin, initialClip);
+    }
+    @endcode
+
+    Because the rendering happens after the paint calls have returned, any images that are
+    drawn mustn't be modified until the context has been deleted.
+
+    @see LowLevelGraphicsSoftwareRenderer
+*/
+class JUCE_API  LowLevelGraphicsTiledSoftwareRenderer    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates a context to render into a clipped subsection of an image.
+
+        If no ThreadPool is supplied, a shared pool with one thread per CPU core (minus
+        one for the calling thread) is used.
+    */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, Point<int> origin,
+                                           const RectangleList<int>& initialClip,
+                                           ThreadPool* poolToUse = nullptr);
+
+    /** Destructor.
+        This is where the recorded operations are actually rendered.
+    */
+    ~LowLevelGraphicsTiledSoftwareRenderer();
+
+    /** Returns the pool that's used when no other one is given to the constructor.
+        Other image operations that can be split between threads (e.g. ImageBlur) share it too.
+    */
+    static ThreadPool& getSharedThreadPool();
+
+    //==============================================================================
+    bool isVectorDevice() const override;
+    void setOrigin (Point<int>) override;
+    void addTransform (const AffineTransform&) override;
+    float getPhysicalPixelScaleFactor() override;
+    bool clipToRectangle (const Rectangle<int>&) override;
+    bool clipToRectangleList (const RectangleList<int>&) override;
+    void excludeClipRectangle (const Rectangle<int>&) override;
+    void clipToPath (const Path&, const AffineTransform&) override;
+    void clipToImageAlpha (const Image&, const AffineTransform&) override;
+    bool clipRegionIntersects (const Rectangle<int>&) override;
+    Rectangle<int> getClipBounds() const override;
+    bool isClipEmpty() const override;
+    void saveState() override;
+    void restoreState() override;
+    void beginTransparencyLayer (float opacity) override;
+    void endTransparencyLayer() override;
+    void setFill (const FillType&) override;
+    void setOpacity (float) override;
+    void setInterpolationQuality (Graphics::ResamplingQuality) override;
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents) override;
+    void fillRect (const Rectangle<float>&) override;
+    void fillRectList (const RectangleList<float>&) override;
+    void fillPath (const Path&, const AffineTransform&) override;
+    void drawImage (const Image&, const AffineTransform&) override;
+    void drawLine (const Line<float>&) override;
+    void drawPolyline (const Point<float>*, int numPoints, float lineThickness) override;
+    void fillVerticalSpans (float x, float columnWidth, const Range<float>*, int numSpans) override;
+    void setFont (const Font&) override;
+    const Font& getFont() override;
+    void drawGlyph (int glyphNumber, const AffineTransform&) override;
+
+private:
+    //==============================================================================
+    struct Operation;
+    template <typename FunctionType> struct OperationWithFunction;
+    struct State;
+    class RenderThreads;
+    friend struct ContainerDeletePolicy<State>;
+
+    Image image;
+    const Point<int> origin;
+    const RectangleList<int> initialClip;
+    ThreadPool& pool;
+
+    enum { tileHeight = 32 };
+
+    OwnedArray<Operation> operations;
+    Array<int> openBlocks;
+    ScopedPointer<State> state;
+    OwnedArray<State> savedStates;
+
+    template <typename FunctionType>
+    void addOperation (int type, Rectangle<int> bounds, const FunctionType&);
+    template <typename FunctionType>
+    void addStateChange (const FunctionType&);
+    template <typename FunctionType>
+    void addDrawingOperation (Rectangle<float> deviceBounds, const FunctionType&);
+
+    void openBlock();
+    void closeBlock();
+    Rectangle<float> toDeviceSpace (Rectangle<float>) const noexcept;
+    void render();
+    void renderTile (const Rectangle<int>&) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsTiledSoftwareRenderer)
+};
+
+#endif
+#endif   // JUCE_LOWLEVELGRAPHICSTILEDSOFTWARERENDERER_H_INCLUDED
@@ -22,44 +22,11 @@
   ==============================================================================
 */
 
-static inline void blurDataTriplets (uint8* d, int num, const int delta) noexcept
-{
-    uint32 last = d[0];
-    d[0] = (uint8) ((d[0] + d[delta] + 1) / 3);
-    d += delta;
-
-    num -= 2;
-
-    do
-    {
-        const uint32 newLast = d[0];
-        d[0] = (uint8) ((last + d[0] + d[delta] + 1) / 3);
-        d += delta;
-        last = newLast;
-    }
-    while (--num > 0);
-
-    d[0] = (uint8) ((last + d[0] + 1) / 3);
-}
-
-static void blurSingleChannelImage (uint8* const data, const int width, const int height,
-                                    const int lineStride, const int repetitions) noexcept
-{
-    jassert (width > 2 && height > 2);
-
-    for (int y = 0; y < height; ++y)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + lineStride * y, width, 1);
-
-    for (int x = 0; x < width; ++x)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + x, height, lineStride);
-}
-
+// A shadow's radius is the number of times that a 3-pixel box blur is applied in each direction,
+// divided by two. Repeated box blurs add up to a gaussian, and the variance of each one is 2/3.
 static void blurSingleChannelImage (Image& image, int radius)
 {
-    const Image::BitmapData bm (image, Image::BitmapData::readWrite);
-    blurSingleChannelImage (bm.data, bm.width, bm.height, bm.lineStride, 2 * radius);
+    ImageBlur::applyGaussianBlur (image, image.getBounds(), std::sqrt (radius * 4.0f / 3.0f));
 }
 
 //==============================================================================
@@ -90,29 +57,108 @@ void DropShadow::drawForImage (Graphics& g, const Image& srcImage) const
     }
 }
 
+static Image createPathShadow (const Path& path, int radius, Point<int> offset, const Rectangle<int>& area)
+{
+    Image renderedPath (Image::SingleChannel, area.getWidth(), area.getHeight(), true);
+
+    {
+        Graphics g (renderedPath);
+        g.setColour (Colours::white);
+        g.fillPath (path, AffineTransform::translation ((float) (offset.x - area.getX()),
+                                                        (float) (offset.y - area.getY())));
+    }
+
+    blurSingleChannelImage (renderedPath, radius);
+    return renderedPath;
+}
+
+//==============================================================================
+// Things like tabs and buttons tend to draw the same shadowed shapes over and over again, so
+// the most recent path shadows are kept. (Their colour is applied when they're drawn, so it
+// doesn't have to match).
+class PathShadowCache  : private DeletedAtShutdown
+{
+public:
+    PathShadowCache() {}
+    ~PathShadowCache()  { clearSingletonInstance(); }
+
+    juce_DeclareSingleton (PathShadowCache, false)
+
+    enum { maxPixelsPerShadow = 256 * 256 };
+
+    Image getShadow (const Path& path, int radius, Point<int> offset, const Rectangle<int>& area)
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = 0; i < shadows.size(); ++i)
+        {
+            CachedShadow* const s = shadows.getUnchecked (i);
+
+            if (s->radius == radius && s->offset == offset && s->path == path)
+            {
+                shadows.move (i, 0);
+                return s->image;
+            }
+        }
+
+        CachedShadow* const s = new CachedShadow();
+        s->path = path;
+        s->radius = radius;
+        s->offset = offset;
+        s->image = createPathShadow (path, radius, offset, area);
+
+        shadows.insert (0, s);
+
+        if (shadows.size() > maxNumShadows)
+            shadows.removeLast();
+
+        return s->image;
+    }
+
+private:
+    struct CachedShadow
+    {
+        Path path;
+        int radius;
+        Point<int> offset;
+        Image image;
+    };
+
+    OwnedArray<CachedShadow> shadows;
+    CriticalSection lock;
+
+    enum { maxNumShadows = 16 };
+
+    JUCE_DECLARE_NON_COPYABLE (PathShadowCache)
+};
+
+juce_ImplementSingleton (PathShadowCache)
+
 void DropShadow::drawForPath (Graphics& g, const Path& path) const
 {
     jassert (radius > 0);
 
-    const Rectangle<int> area ((path.getBounds().getSmallestIntegerContainer() + offset)
-                                   .expanded (radius + 1)
-                                   .getIntersection (g.getClipBounds().expanded (radius + 1)));
+    const Rectangle<int> shadowArea ((path.getBounds().getSmallestIntegerContainer() + offset).expanded (radius + 1));
 
-    if (area.getWidth() > 2 && area.getHeight() > 2)
+    if (shadowArea.getWidth() * shadowArea.getHeight() <= PathShadowCache::maxPixelsPerShadow)
     {
-        Image renderedPath (Image::SingleChannel, area.getWidth(), area.getHeight(), true);
-
+        if (g.clipRegionIntersects (shadowArea))
         {
-            Graphics g2 (renderedPath);
-            g2.setColour (Colours::white);
-            g2.fillPath (path, AffineTransform::translation ((float) (offset.x - area.getX()),
-                                                             (float) (offset.y - area.getY())));
+            g.setColour (colour);
+            g.drawImageAt (PathShadowCache::getInstance()->getShadow (path, radius, offset, shadowArea),
+                           shadowArea.getX(), shadowArea.getY(), true);
         }
 
-        blurSingleChannelImage (renderedPath, radius);
+        return;
+    }
 
+    // A large shadow is only rendered where it's going to be seen, and isn't cached
+    const Rectangle<int> area (shadowArea.getIntersection (g.getClipBounds().expanded (radius + 1)));
+
+    if (! area.isEmpty())
+    {
         g.setColour (colour);
-        g.drawImageAt (renderedPath, area.getX(), area.getY(), true);
+        g.drawImageAt (createPathShadow (path, radius, offset, area), area.getX(), area.getY(), true);
     }
 }
 
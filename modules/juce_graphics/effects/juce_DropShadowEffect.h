@@ -41,7 +41,9 @@ struct JUCE_API  DropShadow
     /** Renders a drop-shadow based on the alpha-channel of the given image. */
     void drawForImage (Graphics& g, const Image& srcImage) const;
 
-    /** Renders a drop-shadow based on the shape of a path. */
+    /** Renders a drop-shadow based on the shape of a path.
+        The shadows of small paths are cached, so redrawing the same shape is quick.
+    */
     void drawForPath (Graphics& g, const Path& path) const;
 
     /** Renders a drop-shadow for a rectangle.
@@ -72,9 +74,8 @@ struct JUCE_API  DropShadow
     shadow based on what gets drawn inside it. The shadow will also
     be applied to the component's children.
 
-    For speed, this doesn't use a proper gaussian blur, but cheats by
-    using a simple bilinear filter. If you need a really high-quality
-    shadow, check out ImageConvolutionKernel::createGaussianBlur()
+    The shadow is made by blurring the image's alpha-channel with a gaussian blur,
+    using ImageBlur::applyGaussianBlur().
 
     @see Component::setComponentEffect
 */
@@ -24,6 +24,415 @@
 
 const int juce_edgeTableDefaultEdgesPerLine = 32;
 
+//==============================================================================
+namespace EdgeTableHelpers
+{
+    // Roughly how many points the sampled method will add for the visible part of an edge:
+    // up to 256 per line, depending on its slope.
+    inline float getSampledEdgeCost (float x1, float y1, float x2, float y2, float top, float bottom) noexcept
+    {
+        const float visibleHeight = jmin (bottom, jmax (y1, y2)) - jmax (top, jmin (y1, y2));
+
+        return visibleHeight > 0 ? visibleHeight * jmin (256.0f, 1.0f + std::abs ((x2 - x1) / (y2 - y1))) + 1.0f
+                                 : 0.0f;
+    }
+
+    // Simple shapes are quicker to sample, but once the average line would need more than a hundred
+    // or so points to be sorted, accumulating the coverage wins by a growing margin.
+    const double maxSampledPointsPerLine = 128.0;
+
+    // A flat list of line segments, stored as x1, y1, x2, y2
+    struct SegmentList
+    {
+        SegmentList() noexcept : numSegments (0), numAllocated (0) {}
+
+        void add (float x1, float y1, float x2, float y2)
+        {
+            if (numSegments >= numAllocated)
+            {
+                numAllocated = jmax (64, numAllocated * 2);
+                data.realloc ((size_t) numAllocated * 4);
+            }
+
+            float* const s = data + numSegments++ * 4;
+            s[0] = x1;
+            s[1] = y1;
+            s[2] = x2;
+            s[3] = y2;
+        }
+
+        // Adds the outline of a convex quadrilateral, unless it lies entirely outside the given area.
+        // Horizontal edges are skipped, as they don't affect the coverage.
+        void addQuad (Point<float> a, Point<float> b, Point<float> c, Point<float> d, const Rectangle<float>& area)
+        {
+            if (jmax (a.y, b.y, jmax (c.y, d.y)) <= area.getY() || jmin (a.y, b.y, jmin (c.y, d.y)) >= area.getBottom()
+                 || jmax (a.x, b.x, jmax (c.x, d.x)) <= area.getX() || jmin (a.x, b.x, jmin (c.x, d.x)) >= area.getRight())
+                return;
+
+            if (a.y != b.y)  add (a.x, a.y, b.x, b.y);
+            if (b.y != c.y)  add (b.x, b.y, c.x, c.y);
+            if (c.y != d.y)  add (c.x, c.y, d.x, d.y);
+            if (d.y != a.y)  add (d.x, d.y, a.x, a.y);
+        }
+
+        // Adds the outline of a thick polyline with flat ends and bevelled joints. Where the direction
+        // only changes slightly, the two sides just meet half-way rather than having a bevel, which
+        // keeps the number of edges down for smooth curves.
+        void addPolylineOutline (const Point<float>* points, int numPoints, float halfThickness, const Rectangle<float>& area)
+        {
+            if (numPoints < 2)
+                return;
+
+            HeapBlock<Point<float> > starts ((size_t) numPoints), offsets ((size_t) numPoints);
+            int numSegments = 0;
+
+            for (int i = 0; i < numPoints - 1; ++i)
+            {
+                const Point<float> delta (points[i + 1] - points[i]);
+                const float length = delta.getDistanceFromOrigin();
+
+                if (length > 0)
+                {
+                    starts[numSegments] = points[i];
+                    offsets[numSegments] = Point<float> (-delta.y * (halfThickness / length), delta.x * (halfThickness / length));
+                    ++numSegments;
+                }
+            }
+
+            if (numSegments == 0)
+                return;
+
+            const Point<float> end (points[numPoints - 1]);
+            const float minDotProductToMerge = 0.99f * halfThickness * halfThickness;
+
+            HeapBlock<Point<float> > side1 ((size_t) numSegments * 2), side2 ((size_t) numSegments * 2);
+            int numOnEachSide = 0;
+
+            side1[0] = starts[0] + offsets[0];
+            side2[0] = starts[0] - offsets[0];
+            numOnEachSide = 1;
+
+            for (int i = 1; i < numSegments; ++i)
+            {
+                const Point<float> previous (offsets[i - 1]), next (offsets[i]);
+
+                if (previous.getDotProduct (next) > minDotProductToMerge)
+                {
+                    const Point<float> average ((previous + next) * 0.5f);
+                    side1[numOnEachSide] = starts[i] + average;
+                    side2[numOnEachSide] = starts[i] - average;
+                    ++numOnEachSide;
+                }
+                else
+                {
+                    side1[numOnEachSide]     = starts[i] + previous;
+                    side1[numOnEachSide + 1] = starts[i] + next;
+                    side2[numOnEachSide]     = starts[i] - previous;
+                    side2[numOnEachSide + 1] = starts[i] - next;
+                    numOnEachSide += 2;
+                }
+            }
+
+            side1[numOnEachSide] = end + offsets[numSegments - 1];
+            side2[numOnEachSide] = end - offsets[numSegments - 1];
+
+            // go forwards along one side and back along the other
+            for (int i = 0; i < numOnEachSide; ++i)
+            {
+                addIfVisible (side1[i], side1[i + 1], area);
+                addIfVisible (side2[i + 1], side2[i], area);
+            }
+
+            addIfVisible (side1[numOnEachSide], side2[numOnEachSide], area);
+            addIfVisible (side2[0], side1[0], area);
+        }
+
+        // Edges that are entirely above, below or to the right of the area can't change the coverage
+        // inside it. Those to the left have to be kept, as they still affect the winding.
+        void addIfVisible (Point<float> start, Point<float> end, const Rectangle<float>& area)
+        {
+            if (start.y != end.y
+                 && jmax (start.y, end.y) > area.getY() && jmin (start.y, end.y) < area.getBottom()
+                 && jmin (start.x, end.x) < area.getRight())
+                add (start.x, start.y, end.x, end.y);
+        }
+
+        HeapBlock<float> data;
+        int numSegments, numAllocated;
+
+        JUCE_DECLARE_NON_COPYABLE (SegmentList)
+    };
+
+    //==============================================================================
+    enum { bandHeight = 16 };
+
+    struct Band
+    {
+        Band (int tableWidth)
+            : width (tableWidth),
+              rowStride ((tableWidth + 5) & ~3),   // room for the two overflow cells, rounded up for the SIMD loop
+              cells ((size_t) (rowStride * bandHeight), true),
+              top (0)
+        {
+            for (int i = 0; i < bandHeight; ++i)
+                resetRowExtent (i);
+        }
+
+        void resetRowExtent (int row) noexcept
+        {
+            firstCell[row] = rowStride;
+            lastCell[row] = -1;
+        }
+
+        // Adds the signed area that a line covers to each of the cells it passes through. The line
+        // must already have been clipped horizontally so that 0 <= x <= width.
+        void addLine (float x1, float y1, float x2, float y2) noexcept
+        {
+            float direction = 1.0f;
+
+            if (y1 > y2)
+            {
+                std::swap (x1, x2);
+                std::swap (y1, y2);
+                direction = -1.0f;
+            }
+
+            const int bottom = top + bandHeight;
+
+            if (y2 <= (float) top || y1 >= (float) bottom)
+                return;
+
+            const float dxdy = (x2 - x1) / (y2 - y1);
+            float startY = y1, x = x1;
+
+            if (startY < (float) top)
+            {
+                x += dxdy * ((float) top - startY);
+                startY = (float) top;
+            }
+
+            const int endRow = jmin (bottom, (int) std::ceil (y2));
+
+            for (int y = (int) std::floor (startY); y < endRow; ++y)
+            {
+                const float dy = jmin ((float) (y + 1), y2) - jmax ((float) y, startY);
+                const float xNext = x + dxdy * dy;
+                const float d = dy * direction;
+
+                const float xLeft  = jlimit (0.0f, (float) width, jmin (x, xNext));
+                const float xRight = jlimit (0.0f, (float) width, jmax (x, xNext));
+
+                // (both values are positive here, so truncation can be used instead of floor and ceil)
+                const int row = y - top;
+                float* const c = cells + row * rowStride;
+                const int cell1 = (int) xLeft;
+                const float leftFloor = (float) cell1;
+                const int cell2 = ((float) (int) xRight < xRight) ? (int) xRight + 1 : (int) xRight;
+
+                if (cell2 <= cell1 + 1)
+                {
+                    // the line stays within a single pixel
+                    const float midX = 0.5f * (xLeft + xRight) - leftFloor;
+                    c[cell1]     += d - d * midX;
+                    c[cell1 + 1] += d * midX;
+                    firstCell[row] = jmin (firstCell[row], cell1);
+                    lastCell[row]  = jmax (lastCell[row], cell1 + 1);
+                }
+                else
+                {
+                    const float invWidth = 1.0f / (xRight - xLeft);
+                    const float leftFraction = xLeft - leftFloor;
+                    const float rightFraction = xRight - (float) cell2 + 1.0f;
+                    const float leftArea  = 0.5f * invWidth * (1.0f - leftFraction) * (1.0f - leftFraction);
+                    const float rightArea = 0.5f * invWidth * rightFraction * rightFraction;
+
+                    c[cell1] += d * leftArea;
+
+                    if (cell2 == cell1 + 2)
+                    {
+                        c[cell1 + 1] += d * (1.0f - leftArea - rightArea);
+                    }
+                    else
+                    {
+                        const float firstArea = invWidth * (1.5f - leftFraction);
+                        c[cell1 + 1] += d * (firstArea - leftArea);
+
+                        const float step = d * invWidth;
+
+                        for (int i = cell1 + 2; i < cell2 - 1; ++i)
+                            c[i] += step;
+
+                        const float lastArea = firstArea + (float) (cell2 - cell1 - 3) * invWidth;
+                        c[cell2 - 1] += d * (1.0f - lastArea - rightArea);
+                    }
+
+                    c[cell2] += d * rightArea;
+                    firstCell[row] = jmin (firstCell[row], cell1);
+                    lastCell[row]  = jmax (lastCell[row], cell2);
+                }
+
+                x = xNext;
+            }
+        }
+
+        // Anything to the left of the table is added as a vertical edge along its left-hand side, so that it
+        // still contributes its winding to the rest of the line. Anything to the right can't affect any
+        // visible pixels, so is skipped.
+        void addClippedLine (float x1, float y1, float x2, float y2) noexcept
+        {
+            const float right = (float) width;
+
+            if (x1 >= right && x2 >= right)
+                return;
+
+            if ((x1 > right) != (x2 > right))
+            {
+                const float yMid = y1 + (y2 - y1) * ((right - x1) / (x2 - x1));
+
+                if (x1 > right)  { x1 = right; y1 = yMid; }
+                else             { x2 = right; y2 = yMid; }
+            }
+
+            if (x1 < 0 && x2 < 0)
+            {
+                addLine (0, y1, 0, y2);
+            }
+            else if ((x1 < 0) != (x2 < 0))
+            {
+                const float yMid = y1 + (y2 - y1) * (-x1 / (x2 - x1));
+
+                if (x1 < 0)
+                {
+                    addLine (0, y1, 0, yMid);
+                    addLine (0, yMid, x2, y2);
+                }
+                else
+                {
+                    addLine (x1, y1, 0, yMid);
+                    addLine (0, yMid, 0, y2);
+                }
+            }
+            else
+            {
+                addLine (x1, y1, x2, y2);
+            }
+        }
+
+        static forcedinline int getLevel (float sum, bool useNonZeroWinding) noexcept
+        {
+            float a = std::abs (sum);
+
+            if (useNonZeroWinding)
+            {
+                a = jmin (1.0f, a);
+            }
+            else
+            {
+                a -= 2.0f * (float) (int) (a * 0.5f);
+                a = jmin (a, 2.0f - a);
+            }
+
+            return (int) (a * 255.0f + 0.5f);
+        }
+
+        // Integrates the cells along a row, clearing them ready for the next band, and writes out a
+        // point wherever the alpha level changes. Where the cells are empty, the level can't change,
+        // so the SIMD loop skips over those blocks without doing the conversion.
+        static int integrateRow (float* c, int numCells, int numVisible, int leftEdge, int rightEdge,
+                                 int* points, bool useNonZeroWinding) noexcept
+        {
+            int i = 0, numPoints = 0, lastLevel = 0;
+            float sum = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS
+            const __m128 absMask = _mm_castsi128_ps (_mm_set1_epi32 (0x7fffffff));
+            const __m128 one = _mm_set1_ps (1.0f), two = _mm_set1_ps (2.0f), half = _mm_set1_ps (0.5f);
+            const __m128 scale = _mm_set1_ps (255.0f);
+            const __m128 zero = _mm_setzero_ps();
+            __m128 carry = zero;
+
+            for (; i < numCells - 3; i += 4)
+            {
+                __m128 v = _mm_loadu_ps (c + i);
+
+                if (_mm_movemask_ps (_mm_cmpneq_ps (v, zero)) == 0)
+                    continue;
+
+                _mm_storeu_ps (c + i, zero);
+
+                v = _mm_add_ps (v, _mm_castsi128_ps (_mm_slli_si128 (_mm_castps_si128 (v), 4)));
+                v = _mm_add_ps (v, _mm_castsi128_ps (_mm_slli_si128 (_mm_castps_si128 (v), 8)));
+                v = _mm_add_ps (v, carry);
+                carry = _mm_shuffle_ps (v, v, _MM_SHUFFLE (3, 3, 3, 3));
+
+                __m128 a = _mm_and_ps (v, absMask);
+
+                if (useNonZeroWinding)
+                {
+                    a = _mm_min_ps (a, one);
+                }
+                else
+                {
+                    a = _mm_sub_ps (a, _mm_mul_ps (two, _mm_cvtepi32_ps (_mm_cvttps_epi32 (_mm_mul_ps (a, half)))));
+                    a = _mm_min_ps (a, _mm_sub_ps (two, a));
+                }
+
+                int levels[4];
+                _mm_storeu_si128 ((__m128i*) levels, _mm_cvttps_epi32 (_mm_add_ps (_mm_mul_ps (a, scale), half)));
+
+                for (int j = 0; j < 4 && i + j < numVisible; ++j)
+                {
+                    if (levels[j] != lastLevel)
+                    {
+                        lastLevel = levels[j];
+                        points[numPoints * 2]     = (leftEdge + i + j) << 8;
+                        points[numPoints * 2 + 1] = lastLevel;
+                        ++numPoints;
+                    }
+                }
+            }
+
+            sum = _mm_cvtss_f32 (carry);
+           #endif
+
+            for (; i < numCells; ++i)
+            {
+                if (c[i] == 0)
+                    continue;
+
+                sum += c[i];
+                c[i] = 0;
+
+                const int level = getLevel (sum, useNonZeroWinding);
+
+                if (level != lastLevel && i < numVisible)
+                {
+                    lastLevel = level;
+                    points[numPoints * 2]     = (leftEdge + i) << 8;
+                    points[numPoints * 2 + 1] = lastLevel;
+                    ++numPoints;
+                }
+            }
+
+            // beyond the last cell that was touched, the level stays the same up to the edge of the table
+            if (lastLevel != 0)
+            {
+                points[numPoints * 2]     = rightEdge << 8;
+                points[numPoints * 2 + 1] = 0;
+                ++numPoints;
+            }
+
+            return numPoints;
+        }
+
+        const int width, rowStride;
+        HeapBlock<float> cells;
+        int top, firstCell[bandHeight], lastCell[bandHeight];
+
+        JUCE_DECLARE_NON_COPYABLE (Band)
+    };
+}
+
 //==============================================================================
 EdgeTable::EdgeTable (const Rectangle<int>& area,
                       const Path& path, const AffineTransform& transform)
@@ -31,75 +440,346 @@ EdgeTable::EdgeTable (const Rectangle<int>& area,
      maxEdgesPerLine (juce_edgeTableDefaultEdgesPerLine),
      lineStrideElements (juce_edgeTableDefaultEdgesPerLine * 2 + 1),
      needToCheckEmptiness (true)
+{
+    addPath (path, transform, automaticRasterisation);
+}
+
+EdgeTable::EdgeTable (const Rectangle<int>& area, const Path& path,
+                      const AffineTransform& transform, PathRasterisationMethod method)
+   : bounds (area),
+     maxEdgesPerLine (juce_edgeTableDefaultEdgesPerLine),
+     lineStrideElements (juce_edgeTableDefaultEdgesPerLine * 2 + 1),
+     needToCheckEmptiness (true)
+{
+    addPath (path, transform, method);
+}
+
+void EdgeTable::addPath (const Path& path, const AffineTransform& transform, PathRasterisationMethod method)
 {
     allocate();
-    int* t = table;
+    clearLineSizes();
 
-    for (int i = bounds.getHeight(); --i >= 0;)
+    // Segments that are entirely above or below the table can't affect either method's output.
+    const float top = (float) bounds.getY();
+    const float bottom = (float) bounds.getBottom();
+
+    if (method != analyticCoverageRasterisation)
     {
-        *t = 0;
-        t += lineStrideElements;
+        // Most paths are simple enough to be sampled, so their edges get added as they're flattened,
+        // without being stored anywhere. If the automatic choice finds that a path is too complex
+        // for that, the edges added so far are thrown away and it's handed over to the analytic method.
+        const double maxSampledPoints = (method == automaticRasterisation) ? EdgeTableHelpers::maxSampledPointsPerLine * bounds.getHeight()
+                                                                           : std::numeric_limits<double>::max();
+        double estimatedSampledPoints = 0;
+
+        PathFlatteningIterator iter (path, transform);
+
+        while (iter.next())
+        {
+            if (iter.y1 != iter.y2 && jmax (iter.y1, iter.y2) > top && jmin (iter.y1, iter.y2) < bottom)
+            {
+                estimatedSampledPoints += EdgeTableHelpers::getSampledEdgeCost (iter.x1, iter.y1, iter.x2, iter.y2, top, bottom);
+
+                if (estimatedSampledPoints > maxSampledPoints)
+                    break;
+
+                addSampledEdge (iter.x1, iter.y1, iter.x2, iter.y2);
+            }
+        }
+
+        if (estimatedSampledPoints <= maxSampledPoints)
+        {
+            sanitiseLevels (path.isUsingNonZeroWinding());
+            return;
+        }
+
+        clearLineSizes();
+    }
+
+    // The analytic method needs to see all the segments before it can start.
+    EdgeTableHelpers::SegmentList segments;
+    PathFlatteningIterator iter (path, transform);
+
+    while (iter.next())
+        if (iter.y1 != iter.y2 && jmax (iter.y1, iter.y2) > top && jmin (iter.y1, iter.y2) < bottom)
+            segments.add (iter.x1, iter.y1, iter.x2, iter.y2);
+
+    addAnalyticCoverage (segments.data, segments.numSegments, path.isUsingNonZeroWinding());
+}
+
+void EdgeTable::addSegments (const float* segments, int numSegments, bool useNonZeroWinding, PathRasterisationMethod method)
+{
+    if (method == automaticRasterisation)
+    {
+        const float top = (float) bounds.getY();
+        const float bottom = (float) bounds.getBottom();
+        double estimatedSampledPoints = 0;
+
+        for (const float* s = segments, * const end = segments + numSegments * 4; s < end; s += 4)
+            estimatedSampledPoints += EdgeTableHelpers::getSampledEdgeCost (s[0], s[1], s[2], s[3], top, bottom);
+
+        method = (estimatedSampledPoints > EdgeTableHelpers::maxSampledPointsPerLine * bounds.getHeight())
+                    ? analyticCoverageRasterisation : sampledEdgeRasterisation;
+    }
+
+    if (method == analyticCoverageRasterisation)
+    {
+        addAnalyticCoverage (segments, numSegments, useNonZeroWinding);
     }
+    else
+    {
+        addSampledEdges (segments, numSegments);
+        sanitiseLevels (useNonZeroWinding);
+    }
+}
 
+void EdgeTable::addSampledEdges (const float* segment, int numSegments)
+{
+    for (; --numSegments >= 0; segment += 4)
+        addSampledEdge (segment[0], segment[1], segment[2], segment[3]);
+}
+
+void EdgeTable::addSampledEdge (const float sx1, const float sy1, const float sx2, const float sy2)
+{
     const int leftLimit   = bounds.getX() << 8;
     const int topLimit    = bounds.getY() << 8;
     const int rightLimit  = bounds.getRight() << 8;
     const int heightLimit = bounds.getHeight() << 8;
 
-    PathFlatteningIterator iter (path, transform);
+    int y1 = roundToInt (sy1 * 256.0f);
+    int y2 = roundToInt (sy2 * 256.0f);
 
-    while (iter.next())
+    if (y1 != y2)
     {
-        int y1 = roundToInt (iter.y1 * 256.0f);
-        int y2 = roundToInt (iter.y2 * 256.0f);
+        y1 -= topLimit;
+        y2 -= topLimit;
+
+        const int startY = y1;
+        int direction = -1;
 
-        if (y1 != y2)
+        if (y1 > y2)
         {
-            y1 -= topLimit;
-            y2 -= topLimit;
+            std::swap (y1, y2);
+            direction = 1;
+        }
 
-            const int startY = y1;
-            int direction = -1;
+        if (y1 < 0)
+            y1 = 0;
 
-            if (y1 > y2)
+        if (y2 > heightLimit)
+            y2 = heightLimit;
+
+        if (y1 < y2)
+        {
+            const double startX = 256.0f * sx1;
+            const double multiplier = (sx2 - sx1) / (sy2 - sy1);
+            const int stepSize = jlimit (1, 256, 256 / (1 + (int) std::abs (multiplier)));
+
+            do
             {
-                std::swap (y1, y2);
-                direction = 1;
+                const int step = jmin (stepSize, y2 - y1, 256 - (y1 & 255));
+                int x = roundToInt (startX + multiplier * ((y1 + (step >> 1)) - startY));
+
+                if (x < leftLimit)
+                    x = leftLimit;
+                else if (x >= rightLimit)
+                    x = rightLimit - 1;
+
+                addEdgePoint (x, y1 >> 8, direction * step);
+                y1 += step;
             }
+            while (y1 < y2);
+        }
+    }
+}
 
-            if (y1 < 0)
-                y1 = 0;
+void EdgeTable::addAnalyticCoverage (const float* segments, const int numSegments, const bool useNonZeroWinding)
+{
+    using namespace EdgeTableHelpers;
 
-            if (y2 > heightLimit)
-                y2 = heightLimit;
+    const int width = bounds.getWidth();
+    const int height = bounds.getHeight();
 
-            if (y1 < y2)
-            {
-                const double startX = 256.0f * iter.x1;
-                const double multiplier = (iter.x2 - iter.x1) / (iter.y2 - iter.y1);
-                const int stepSize = jlimit (1, 256, 256 / (1 + (int) std::abs (multiplier)));
+    if (width <= 0 || height <= 0 || numSegments <= 0)
+        return;
 
-                do
-                {
-                    const int step = jmin (stepSize, y2 - y1, 256 - (y1 & 255));
-                    int x = roundToInt (startX + multiplier * ((y1 + (step >> 1)) - startY));
+    const float left = (float) bounds.getX();
+    const float top = (float) bounds.getY();
+    const int numBands = (height + bandHeight - 1) / bandHeight;
 
-                    if (x < leftLimit)
-                        x = leftLimit;
-                    else if (x >= rightLimit)
-                        x = rightLimit - 1;
+    // Sort the segments by the band in which they start, so that each band only needs
+    // to look at the ones which are actually active in it.
+    HeapBlock<int> bandStart ((size_t) numBands + 1, true), order ((size_t) numSegments);
 
-                    addEdgePoint (x, y1 >> 8, direction * step);
-                    y1 += step;
-                }
-                while (y1 < y2);
+    for (int i = 0; i < numSegments; ++i)
+    {
+        const float* const s = segments + i * 4;
+        ++bandStart [jlimit (0, numBands - 1, (int) ((jmin (s[1], s[3]) - top) / (float) bandHeight)) + 1];
+    }
+
+    for (int i = 0; i < numBands; ++i)
+        bandStart[i + 1] += bandStart[i];
+
+    {
+        HeapBlock<int> insertPos ((size_t) numBands);
+        memcpy (insertPos, bandStart, sizeof (int) * (size_t) numBands);
+
+        for (int i = 0; i < numSegments; ++i)
+        {
+            const float* const s = segments + i * 4;
+            order [insertPos [jlimit (0, numBands - 1, (int) ((jmin (s[1], s[3]) - top) / (float) bandHeight))]++] = i;
+        }
+    }
+
+    Band band (width);
+    HeapBlock<int> points ((size_t) (width + 2) * 2);
+    Array<int> active;
+
+    for (int bandIndex = 0; bandIndex < numBands; ++bandIndex)
+    {
+        band.top = bandIndex * bandHeight;
+        const int bandBottom = jmin (height, band.top + bandHeight);
+
+        for (int i = bandStart[bandIndex]; i < bandStart[bandIndex + 1]; ++i)
+            active.add (order[i]);
+
+        for (int i = active.size(); --i >= 0;)
+        {
+            const float* const s = segments + active.getUnchecked (i) * 4;
+            band.addClippedLine (s[0] - left, s[1] - top, s[2] - left, s[3] - top);
+
+            if (jmax (s[1], s[3]) - top <= (float) bandBottom)
+            {
+                // the order doesn't matter, so the last one can just be moved into its place
+                active.setUnchecked (i, active.getLast());
+                active.removeLast();
             }
         }
+
+        for (int y = band.top; y < bandBottom; ++y)
+        {
+            const int row = y - band.top;
+            const int first = band.firstCell[row];
+            const int last = band.lastCell[row];
+
+            if (last < first)
+                continue;
+
+            band.resetRowExtent (row);
+
+            const int numPoints = Band::integrateRow (band.cells + row * band.rowStride + first, last + 1 - first,
+                                                      width - first, bounds.getX() + first, bounds.getRight(),
+                                                      points, useNonZeroWinding);
+
+            if (numPoints >= maxEdgesPerLine)
+                remapTableForNumEdges (jmax (numPoints + 1, maxEdgesPerLine * 2));
+
+            int* const line = table + lineStrideElements * y;
+            line[0] = numPoints;
+            memcpy (line + 1, points, sizeof (int) * 2 * (size_t) numPoints);
+        }
     }
+}
+
+//==============================================================================
+EdgeTable::EdgeTable (const Rectangle<int>& area, const Point<float>* points, int numPoints,
+                      float lineThickness, const AffineTransform& transform)
+   : bounds (area),
+     maxEdgesPerLine (juce_edgeTableDefaultEdgesPerLine),
+     lineStrideElements (juce_edgeTableDefaultEdgesPerLine * 2 + 1),
+     needToCheckEmptiness (true)
+{
+    allocate();
+    clearLineSizes();
+
+    if (numPoints < 2)
+        return;
+
+    HeapBlock<Point<float> > transformed ((size_t) numPoints);
+
+    for (int i = 0; i < numPoints; ++i)
+        transformed[i] = points[i].transformedBy (transform);
+
+    // When a trace has a run of several points within the same pixel column, the line must cover
+    // everything between their highest and lowest points there, so the whole run is replaced by a
+    // single vertical span - for a long waveform this cuts the work down from one shape per point
+    // to about one per column. The stretches in between are added as outlines.
+    EdgeTableHelpers::SegmentList segments;
+    const Rectangle<float> areaAsFloat (bounds.toFloat());
+    const float halfThickness = 0.5f * lineThickness * transform.getScaleFactor();
+    const int minPointsToMerge = 4;
+    int stretchStart = 0;
+
+    for (int i = 0; i < numPoints - 1;)
+    {
+        const float column = std::floor (transformed[i].x);
+        float top = transformed[i].y, bottom = top;
+        int end = i;
+
+        while (end < numPoints - 1 && std::floor (transformed[end + 1].x) == column)
+        {
+            ++end;
+            top = jmin (top, transformed[end].y);
+            bottom = jmax (bottom, transformed[end].y);
+        }
+
+        if (end - i >= minPointsToMerge - 1)
+        {
+            segments.addPolylineOutline (transformed + stretchStart, i + 1 - stretchStart, halfThickness, areaAsFloat);
+
+            // the span is as wide as the line, so thin lines stay light and thick ones spill
+            // into the neighbouring columns, just like the zig-zags that it replaces
+            const float left  = column + 0.5f - halfThickness;
+            const float right = column + 0.5f + halfThickness;
+
+            segments.addQuad (Point<float> (left,  bottom + halfThickness),
+                              Point<float> (right, bottom + halfThickness),
+                              Point<float> (right, top - halfThickness),
+                              Point<float> (left,  top - halfThickness), areaAsFloat);
+            stretchStart = end;
+        }
 
-    sanitiseLevels (path.isUsingNonZeroWinding());
+        i = jmax (i + 1, end);
+    }
+
+    segments.addPolylineOutline (transformed + stretchStart, numPoints - stretchStart, halfThickness, areaAsFloat);
+
+    addSegments (segments.data, segments.numSegments, true, automaticRasterisation);
 }
 
+EdgeTable::EdgeTable (const Rectangle<int>& area, float x, float columnWidth,
+                      const Range<float>* spans, int numSpans, const AffineTransform& transform)
+   : bounds (area),
+     maxEdgesPerLine (juce_edgeTableDefaultEdgesPerLine),
+     lineStrideElements (juce_edgeTableDefaultEdgesPerLine * 2 + 1),
+     needToCheckEmptiness (true)
+{
+    allocate();
+    clearLineSizes();
+
+    EdgeTableHelpers::SegmentList segments;
+    const Rectangle<float> areaAsFloat (bounds.toFloat());
+
+    for (int i = 0; i < numSpans; ++i)
+    {
+        const Range<float> span (spans[i]);
+
+        if (! span.isEmpty())
+        {
+            const float x1 = x + (float) i * columnWidth;
+            const float x2 = x1 + columnWidth;
+
+            segments.addQuad (Point<float> (x1, span.getEnd())  .transformedBy (transform),
+                              Point<float> (x1, span.getStart()).transformedBy (transform),
+                              Point<float> (x2, span.getStart()).transformedBy (transform),
+                              Point<float> (x2, span.getEnd())  .transformedBy (transform), areaAsFloat);
+        }
+    }
+
+    addSegments (segments.data, segments.numSegments, true, automaticRasterisation);
+}
+
+//==============================================================================
 EdgeTable::EdgeTable (const Rectangle<int>& rectangleToAdd)
    : bounds (rectangleToAdd),
      maxEdgesPerLine (juce_edgeTableDefaultEdgesPerLine),
@@ -420,7 +1100,7 @@ void EdgeTable::addEdgePoint (const int x, const int y, const int winding)
 
     if (numPoints >= maxEdgesPerLine)
     {
-        remapTableForNumEdges (maxEdgesPerLine + juce_edgeTableDefaultEdgesPerLine);
+        remapTableForNumEdges (maxEdgesPerLine + jmax (juce_edgeTableDefaultEdgesPerLine, maxEdgesPerLine / 2));
         jassert (numPoints < maxEdgesPerLine);
         line = table + lineStrideElements * y;
     }
@@ -440,7 +1120,7 @@ void EdgeTable::addEdgePointPair (int x1, int x2, int y, int winding)
 
     if (numPoints + 1 >= maxEdgesPerLine)
     {
-        remapTableForNumEdges (maxEdgesPerLine + juce_edgeTableDefaultEdgesPerLine);
+        remapTableForNumEdges (maxEdgesPerLine + jmax (juce_edgeTableDefaultEdgesPerLine, maxEdgesPerLine / 2));
         jassert (numPoints < maxEdgesPerLine);
         line = table + lineStrideElements * y;
     }
@@ -829,3 +1509,274 @@ bool EdgeTable::isEmpty() noexcept
 
     return bounds.getHeight() == 0;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class EdgeTableTests  : public UnitTest
+{
+public:
+    EdgeTableTests() : UnitTest ("EdgeTable") {}
+
+    void runTest() override
+    {
+        const Rectangle<int> area (3, 5, 300, 200);
+
+        beginTest ("Analytic coverage is exact for pixel-aligned shapes");
+        {
+            Path p;
+            p.addRectangle (10.0f, 10.0f, 100.0f, 50.0f);
+            p.addRectangle (-20.0f, 100.0f, 250.0f, 30.0f);
+            p.addRectangle (150.0f, 20.0f, 20.0f, 300.0f);
+
+            expectIdentical (area, p);
+
+            p.setUsingNonZeroWinding (false);
+            expectIdentical (area, p);
+        }
+
+        beginTest ("Analytic coverage matches sampled edges");
+        {
+            Random r (getRandom());
+
+            for (int i = 0; i < 20; ++i)
+            {
+                Path p;
+
+                for (int j = 1 + r.nextInt (4); --j >= 0;)
+                {
+                    const Rectangle<float> shape (r.nextFloat() * 400.0f - 50.0f, r.nextFloat() * 300.0f - 50.0f,
+                                                  1.0f + r.nextFloat() * 200.0f, 1.0f + r.nextFloat() * 200.0f);
+
+                    switch (r.nextInt (3))
+                    {
+                        case 0:  p.addEllipse (shape); break;
+                        case 1:  p.addRoundedRectangle (shape, r.nextFloat() * 20.0f); break;
+                        default: p.addStar (shape.getCentre(), 3 + r.nextInt (10), shape.getWidth() * 0.2f, shape.getWidth() * 0.5f,
+                                            r.nextFloat() * float_Pi); break;
+                    }
+                }
+
+                p.setUsingNonZeroWinding (r.nextBool());
+                expectSimilar (area, p);
+
+                // shapes like these are simple enough to be sampled as they're flattened
+                expect (getCoverage (EdgeTable (area, p, AffineTransform()))
+                         == getCoverage (EdgeTable (area, p, AffineTransform(), EdgeTable::sampledEdgeRasterisation)));
+            }
+        }
+
+        beginTest ("Dense paths use analytic coverage");
+        {
+            Random r (getRandom());
+            Path p;
+            p.startNewSubPath (0.0f, 100.0f);
+
+            for (int i = 0; i < 5000; ++i)
+                p.lineTo (i * 0.06f, 100.0f + r.nextFloat() * 180.0f - 90.0f);
+
+            p.closeSubPath();
+
+            // with this many edges per pixel, the sampled version loses a little more precision
+            expectSimilar (area, p, 2);
+            expect (getCoverage (EdgeTable (area, p, AffineTransform()))
+                     == getCoverage (EdgeTable (area, p, AffineTransform(), EdgeTable::analyticCoverageRasterisation)));
+        }
+
+        beginTest ("Polylines match stroked paths");
+        {
+            Random r (getRandom());
+
+            for (int i = 0; i < 10; ++i)
+            {
+                // (this is sparse enough for every segment to be drawn as an outline)
+                const int numPoints = 50;
+                HeapBlock<Point<float> > points ((size_t) numPoints);
+                Path p;
+
+                for (int j = 0; j < numPoints; ++j)
+                {
+                    const Point<float> point (j * 320.0f / numPoints, 100.0f + 80.0f * std::sin (j * 0.1f) + r.nextFloat() * 10.0f);
+                    points[j] = point;
+
+                    if (j == 0)
+                        p.startNewSubPath (point);
+                    else
+                        p.lineTo (point);
+                }
+
+                const float thickness = 0.5f + r.nextFloat() * 2.0f;
+
+                Path stroke;
+                PathStrokeType (thickness, PathStrokeType::beveled, PathStrokeType::butt).createStrokedPath (stroke, p);
+
+                expectSimilar (getCoverage (EdgeTable (area, stroke, AffineTransform())),
+                               getCoverage (EdgeTable (area, points, numPoints, thickness, AffineTransform())), 3, 2);
+            }
+        }
+
+        beginTest ("Dense polylines fill each column between its extremes");
+        {
+            Random r (getRandom());
+
+            for (int i = 0; i < 5; ++i)
+            {
+                // Each column's points start and end on the same baseline, so the joins between the
+                // columns stay within that baseline's row, and the coverage of each column is only
+                // determined by its merged span. The lines are thin enough not to spill into the
+                // neighbouring columns.
+                const float thickness = 0.2f + r.nextFloat() * 0.8f;
+                const float halfThickness = thickness * 0.5f;
+                const float baseline = 100.5f;
+                const int firstColumn = 10, numColumns = 280, maxPointsPerColumn = 12;
+
+                HeapBlock<Point<float> > points ((size_t) (numColumns * maxPointsPerColumn));
+                int numPoints = 0;
+                Range<float> extents[numColumns];
+
+                for (int column = 0; column < numColumns; ++column)
+                {
+                    const int numPointsInColumn = 4 + r.nextInt (maxPointsPerColumn - 3);
+                    extents[column] = Range<float> (baseline, baseline);
+
+                    for (int j = 0; j < numPointsInColumn; ++j)
+                    {
+                        const bool isOnBaseline = (j == 0 || j == numPointsInColumn - 1);
+                        const float y = isOnBaseline ? baseline : baseline + (r.nextFloat() * 2.0f - 1.0f) * r.nextFloat() * 80.0f;
+
+                        points[numPoints++] = Point<float> (firstColumn + column + (j + 0.5f) / numPointsInColumn, y);
+                        extents[column] = extents[column].getUnionWith (y);
+                    }
+                }
+
+                const CoverageMap coverage (getCoverage (EdgeTable (area, points, numPoints, thickness, AffineTransform()), area));
+                const int expectedLevel = roundToInt (thickness * 255.0f);
+                int numLeaking = 0, numMissing = 0, numWrongLevel = 0;
+
+                for (int column = 0; column < numColumns; ++column)
+                {
+                    const float top    = extents[column].getStart() - halfThickness;
+                    const float bottom = extents[column].getEnd()   + halfThickness;
+
+                    for (int y = area.getY(); y < area.getBottom(); ++y)
+                    {
+                        const int level = coverage.levels [(y - area.getY()) * area.getWidth() + firstColumn + column - area.getX()];
+
+                        if (y + 1 <= top || y >= bottom)
+                        {
+                            if (level != 0)
+                                ++numLeaking;
+                        }
+                        else if (y >= top && y + 1 <= bottom)
+                        {
+                            if (level == 0)
+                                ++numMissing;
+                            else if (std::abs (y + 0.5f - baseline) > 1.0f && std::abs (level - expectedLevel) > 2)
+                                ++numWrongLevel;
+                        }
+                    }
+                }
+
+                expectEquals (numLeaking, 0);
+                expectEquals (numMissing, 0);
+                expectEquals (numWrongLevel, 0);
+            }
+        }
+
+        beginTest ("Vertical spans match rectangles");
+        {
+            Random r (getRandom());
+            Range<float> spans[180];
+            RectangleList<float> rects;
+
+            for (int i = 0; i < numElementsInArray (spans); ++i)
+            {
+                const float start = 10.0f + r.nextFloat() * 140.0f;
+                spans[i] = Range<float> (start, start + r.nextFloat() * 50.0f);
+
+                if (! spans[i].isEmpty())
+                    rects.addWithoutMerging (Rectangle<float> (10.0f + i * 1.5f, start, 1.5f, spans[i].getLength()));
+            }
+
+            expectSimilar (getCoverage (EdgeTable (rects), area),
+                           getCoverage (EdgeTable (area, 10.0f, 1.5f, spans, numElementsInArray (spans), AffineTransform())), 1);
+        }
+    }
+
+private:
+    struct CoverageMap
+    {
+        CoverageMap (const Rectangle<int>& r)  : area (r), levels ((size_t) (r.getWidth() * r.getHeight()), true), y (0) {}
+
+        void setEdgeTableYPos (int newY) noexcept                     { y = newY - area.getY(); }
+        void handleEdgeTablePixel (int x, int level) noexcept         { levels [y * area.getWidth() + x - area.getX()] = (uint8) level; }
+        void handleEdgeTablePixelFull (int x) noexcept                { handleEdgeTablePixel (x, 255); }
+        void handleEdgeTableLine (int x, int width, int level) noexcept  { while (--width >= 0) handleEdgeTablePixel (x++, level); }
+        void handleEdgeTableLineFull (int x, int width) noexcept      { handleEdgeTableLine (x, width, 255); }
+
+        bool operator== (const CoverageMap& other) const noexcept
+        {
+            return memcmp (levels, other.levels, (size_t) (area.getWidth() * area.getHeight())) == 0;
+        }
+
+        Rectangle<int> area;
+        HeapBlock<uint8> levels;
+        int y;
+    };
+
+    static CoverageMap getCoverage (const EdgeTable& et)
+    {
+        return getCoverage (et, et.getMaximumBounds());
+    }
+
+    static CoverageMap getCoverage (const EdgeTable& et, const Rectangle<int>& area)
+    {
+        jassert (area.contains (et.getMaximumBounds()));
+
+        CoverageMap map (area);
+        et.iterate (map);
+        return map;
+    }
+
+    void expectIdentical (const Rectangle<int>& area, const Path& p)
+    {
+        expect (getCoverage (EdgeTable (area, p, AffineTransform(), EdgeTable::sampledEdgeRasterisation))
+                 == getCoverage (EdgeTable (area, p, AffineTransform(), EdgeTable::analyticCoverageRasterisation)));
+    }
+
+    // The two methods only differ in how they anti-alias the edges, so the total coverage should
+    // be almost the same, and the pixels should only differ slightly on average (allowing for a
+    // few where a very thin spike gets sampled differently).
+    void expectSimilar (const Rectangle<int>& area, const Path& p, int maxTotalDifferencePercent = 1)
+    {
+        expectSimilar (getCoverage (EdgeTable (area, p, AffineTransform(), EdgeTable::sampledEdgeRasterisation)),
+                       getCoverage (EdgeTable (area, p, AffineTransform(), EdgeTable::analyticCoverageRasterisation)),
+                       3, maxTotalDifferencePercent);
+    }
+
+    void expectSimilar (const CoverageMap& map1, const CoverageMap& map2,
+                        int maxAverageDifference, int maxTotalDifferencePercent = 1)
+    {
+        expect (map1.area == map2.area);
+
+        int64 total1 = 0, total2 = 0, totalDifference = 0, numTouched = 0;
+
+        for (int i = map1.area.getWidth() * map1.area.getHeight(); --i >= 0;)
+        {
+            const int l1 = map1.levels[i], l2 = map2.levels[i];
+            total1 += l1;
+            total2 += l2;
+            totalDifference += std::abs (l1 - l2);
+
+            if (l1 != 0 || l2 != 0)
+                ++numTouched;
+        }
+
+        expect (std::abs (total1 - total2) <= 255 + total1 * maxTotalDifferencePercent / 100);
+        expect (totalDifference <= numTouched * maxAverageDifference + 255 * 4);
+    }
+};
+
+static EdgeTableTests edgeTableTests;
+
+#endif
@@ -36,6 +36,17 @@ class JUCE_API  EdgeTable
 {
 public:
     //==============================================================================
+    /** The algorithms that can be used to turn a path into an edge table. */
+    enum PathRasterisationMethod
+    {
+        automaticRasterisation,     /**< Picks whichever of the other methods should be quicker for the path. */
+        sampledEdgeRasterisation,   /**< Samples each edge at sub-pixel intervals down the table and sorts the
+                                         resulting crossings - this is fastest for paths with few edges per line. */
+        analyticCoverageRasterisation  /**< Accumulates the exact area that each edge covers in every pixel, and
+                                            then integrates each line - this is much quicker for complex paths
+                                            such as dense waveforms, where each line crosses hundreds of edges. */
+    };
+
     /** Creates an edge table containing a path.
 
         A table is created with a fixed vertical range, and only sections of the path
@@ -49,6 +60,43 @@ public:
                const Path& pathToAdd,
                const AffineTransform& transform);
 
+    /** Creates an edge table containing a path, using a specific rasterisation method.
+
+        The two methods produce slightly different anti-aliasing levels along the edges
+        of a shape, so you'd normally just use the other constructor and let it pick.
+
+        @see PathRasterisationMethod
+    */
+    EdgeTable (const Rectangle<int>& clipLimits,
+               const Path& pathToAdd,
+               const AffineTransform& transform,
+               PathRasterisationMethod method);
+
+    /** Creates an edge table containing a series of connected straight lines.
+
+        This rasterises the lines directly, so it's much quicker than stroking a path for
+        things like waveforms or plots that have thousands of points. Each segment is drawn
+        with flat ends and there's no mitring at the joints, so it's intended for thin lines,
+        where this isn't noticeable. The thickness is scaled by the transform's scale factor.
+
+        Where four or more consecutive points fall within the same pixel column, they're merged,
+        and the column is filled between the highest and lowest of them, extended by half the
+        line thickness, rather than following each of the lines between them.
+    */
+    EdgeTable (const Rectangle<int>& clipLimits,
+               const Point<float>* points, int numPoints,
+               float lineThickness, const AffineTransform& transform);
+
+    /** Creates an edge table containing a row of adjacent vertical spans.
+
+        Each span is drawn as a column which is columnWidth wide, starting at x for the first
+        one, and covering the span's range vertically. Empty spans are skipped.
+    */
+    EdgeTable (const Rectangle<int>& clipLimits,
+               float x, float columnWidth,
+               const Range<float>* spans, int numSpans,
+               const AffineTransform& transform);
+
     /** Creates an edge table containing a rectangle. */
     explicit EdgeTable (const Rectangle<int>& rectangleToAdd);
 
@@ -205,6 +253,11 @@ private:
 
     void allocate();
     void clearLineSizes() noexcept;
+    void addPath (const Path&, const AffineTransform&, PathRasterisationMethod);
+    void addSegments (const float* segments, int numSegments, bool useNonZeroWinding, PathRasterisationMethod);
+    void addSampledEdges (const float* segments, int numSegments);
+    void addSampledEdge (float x1, float y1, float x2, float y2);
+    void addAnalyticCoverage (const float* segments, int numSegments, bool useNonZeroWinding);
     void addEdgePoint (int x, int y, int winding);
     void addEdgePointPair (int x1, int x2, int y, int winding);
     void remapTableForNumEdges (int newNumEdgesPerLine);
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#if JUCE_UNIT_TESTS
+
+class RectangleListTests  : public UnitTest
+{
+public:
+    RectangleListTests() : UnitTest ("RectangleList") {}
+
+    void runTest() override
+    {
+        beginTest ("coalesce");
+
+        {
+            RectangleList<int> list;
+            list.add (0, 0, 100, 10);
+            list.add (0, 12, 100, 10);
+            list.coalesce (16, 64 * 64);
+
+            expectEquals (list.getNumRectangles(), 1);
+            expect (list.getRectangle (0) == Rectangle<int> (0, 0, 100, 22));
+        }
+
+        {
+            RectangleList<int> list;
+            list.add (0, 0, 10, 10);
+            list.add (500, 500, 10, 10);
+            list.coalesce (16, 64 * 64);
+
+            expectEquals (list.getNumRectangles(), 2);
+        }
+
+        {
+            RectangleList<int> original;
+
+            for (int i = 0; i < 20; ++i)
+                original.add (i * 1000, 0, 10, 10);
+
+            RectangleList<int> list (original);
+            list.coalesce (16, 64 * 64);
+
+            expectEquals (list.getNumRectangles(), 16);
+            expectCoversWithoutOverlaps (list, original);
+        }
+
+        beginTest ("coalesce random regions");
+
+        Random r = getRandom();
+
+        for (int i = 0; i < 200; ++i)
+        {
+            RectangleList<int> original;
+            const int numRects = 1 + r.nextInt (i < 100 ? 30 : 300);
+
+            for (int j = 0; j < numRects; ++j)
+                original.add (r.nextInt (1000), r.nextInt (1000), 1 + r.nextInt (60), 1 + r.nextInt (60));
+
+            const int maxNumRectangles = 1 + r.nextInt (20);
+
+            RectangleList<int> list (original);
+            list.coalesce (maxNumRectangles, 64 * 64);
+
+            expect (list.getNumRectangles() <= maxNumRectangles);
+            expectCoversWithoutOverlaps (list, original);
+        }
+    }
+
+    void expectCoversWithoutOverlaps (const RectangleList<int>& list, const RectangleList<int>& original)
+    {
+        RectangleList<int> uncovered (original);
+        uncovered.subtract (list);
+        expect (uncovered.isEmpty());
+
+        for (int i = 0; i < list.getNumRectangles(); ++i)
+            for (int j = i + 1; j < list.getNumRectangles(); ++j)
+                expect (! list.getRectangle (i).intersects (list.getRectangle (j)));
+    }
+};
+
+static RectangleListTests rectangleListTests;
+
+#endif
@@ -593,6 +593,75 @@ public:
         }
     }
 
+    /** Merges some of the rectangles together, so that there are fewer of them, at the
+        expense of covering some extra area.
+
+        Each step replaces the pair of rectangles whose bounding box adds the least extra area
+        with that bounding box, and this carries on until there are no more than maxNumRectangles
+        left, and no pair could be merged without adding more than maxExtraAreaPerMerge. The
+        list will still cover all of its original area, and the rectangles won't overlap.
+
+        This is handy for something like a repaint region, where every separate rectangle has a
+        cost of its own, and painting a few extra pixels can be the cheaper option. To keep the
+        search quick, when there are more than 64 rectangles (or maxNumRectangles, if that's
+        larger), neighbouring ones are paired up first.
+
+        @see consolidate
+    */
+    void coalesce (int maxNumRectangles, ValueType maxExtraAreaPerMerge)
+    {
+        jassert (maxNumRectangles > 0);
+        const int maxRectanglesToSearch = jmax (64, maxNumRectangles);
+
+        if (rects.size() > maxRectanglesToSearch)
+        {
+            PositionComparator comparator;
+            rects.sort (comparator);
+
+            while (rects.size() > maxRectanglesToSearch)
+            {
+                for (int i = 0; i + 1 < rects.size(); ++i)
+                {
+                    rects.getReference (i) = rects.getReference (i).getUnion (rects.getReference (i + 1));
+                    rects.remove (i + 1);
+                }
+            }
+        }
+
+        while (rects.size() > 1)
+        {
+            ValueType lowestCost = std::numeric_limits<ValueType>::max();
+            int index1 = 0, index2 = 1;
+
+            for (int i = 0; i < rects.size(); ++i)
+            {
+                const RectangleType& r1 = rects.getReference (i);
+
+                for (int j = i + 1; j < rects.size(); ++j)
+                {
+                    const RectangleType& r2 = rects.getReference (j);
+
+                    // (bounding boxes from earlier merges can overlap, and these always have to go)
+                    const ValueType cost = r1.intersects (r2) ? -std::numeric_limits<ValueType>::max()
+                                                              : getArea (r1.getUnion (r2)) - getArea (r1) - getArea (r2);
+
+                    if (cost < lowestCost)
+                    {
+                        lowestCost = cost;
+                        index1 = i;
+                        index2 = j;
+                    }
+                }
+            }
+
+            if (lowestCost > maxExtraAreaPerMerge && rects.size() <= maxNumRectangles)
+                break;
+
+            rects.getReference (index1) = rects.getReference (index1).getUnion (rects.getReference (index2));
+            rects.remove (index2);
+        }
+    }
+
     /** Adds an x and y value to all the coordinates. */
     void offsetAll (Point<ValueType> offset) noexcept
     {
@@ -656,6 +725,19 @@ public:
 private:
     //==============================================================================
     Array<RectangleType> rects;
+
+    static ValueType getArea (const RectangleType& r) noexcept    { return r.getWidth() * r.getHeight(); }
+
+    struct PositionComparator
+    {
+        static int compareElements (const RectangleType& r1, const RectangleType& r2) noexcept
+        {
+            if (r1.getY() != r2.getY())
+                return r1.getY() < r2.getY() ? -1 : 1;
+
+            return r1.getX() < r2.getX() ? -1 : (r1.getX() > r2.getX() ? 1 : 0);
+        }
+    };
 };
 
 
@@ -263,6 +263,12 @@ namespace pnglibNamespace
   #include "pnglib/png.h"
   #include "pnglib/pngconf.h"
 
+ #if JUCE_USE_SSE_INTRINSICS
+  // This lets us replace libpng's byte-by-byte code for reversing the row filters
+  // with the vectorised versions below.
+  #define PNG_FILTER_OPTIMIZATIONS  juce_installPNGFilterFunctions
+ #endif
+
   #define PNG_NO_EXTERN
   #include "pnglib/png.c"
   #include "pnglib/pngerror.c"
@@ -280,6 +286,119 @@ namespace pnglibNamespace
   #include "pnglib/pngwtran.c"
   #include "pnglib/pngwutil.c"
 
+ #if JUCE_USE_SSE_INTRINSICS
+  // These handle 24 and 32-bit rows, which is what most images use. The sub, average and
+  // paeth filters all depend on the previous pixel in the row, so each pixel still has
+  // to be done in turn, but all of its bytes can be done at once.
+  struct PNGFilterFunctions
+  {
+      template <int bytesPerPixel>
+      static forcedinline __m128i load (const png_byte* p) noexcept
+      {
+          // (a 3-byte memcpy would go via the stack, which is very slow when the bytes have just been written)
+          if (bytesPerPixel == 3)
+              return _mm_cvtsi32_si128 (p[0] | (p[1] << 8) | (p[2] << 16));
+
+          uint32 v;
+          memcpy (&v, p, 4);
+          return _mm_cvtsi32_si128 ((int) v);
+      }
+
+      template <int bytesPerPixel>
+      static forcedinline void store (png_byte* p, __m128i v) noexcept
+      {
+          const uint32 n = (uint32) _mm_cvtsi128_si32 (v);
+          memcpy (p, &n, bytesPerPixel);
+      }
+
+      static forcedinline __m128i abs16 (__m128i v) noexcept
+      {
+          return _mm_max_epi16 (v, _mm_sub_epi16 (_mm_setzero_si128(), v));
+      }
+
+      static forcedinline __m128i select (__m128i mask, __m128i ifTrue, __m128i ifFalse) noexcept
+      {
+          return _mm_or_si128 (_mm_and_si128 (mask, ifTrue), _mm_andnot_si128 (mask, ifFalse));
+      }
+
+      template <int bytesPerPixel>
+      static void sub (png_row_infop rowInfo, png_bytep row, png_const_bytep)
+      {
+          __m128i a = _mm_setzero_si128();
+
+          for (const png_bytep end = row + rowInfo->rowbytes; row < end; row += bytesPerPixel)
+          {
+              a = _mm_add_epi8 (a, load<bytesPerPixel> (row));
+              store<bytesPerPixel> (row, a);
+          }
+      }
+
+      template <int bytesPerPixel>
+      static void average (png_row_infop rowInfo, png_bytep row, png_const_bytep prevRow)
+      {
+          const __m128i one = _mm_set1_epi8 (1);
+          __m128i a = _mm_setzero_si128();
+
+          for (const png_bytep end = row + rowInfo->rowbytes; row < end; row += bytesPerPixel, prevRow += bytesPerPixel)
+          {
+              const __m128i b = load<bytesPerPixel> (prevRow);
+
+              // (_mm_avg_epu8 rounds upwards, but the filter needs to round down)
+              const __m128i average = _mm_sub_epi8 (_mm_avg_epu8 (a, b), _mm_and_si128 (_mm_xor_si128 (a, b), one));
+
+              a = _mm_add_epi8 (load<bytesPerPixel> (row), average);
+              store<bytesPerPixel> (row, a);
+          }
+      }
+
+      template <int bytesPerPixel>
+      static void paeth (png_row_infop rowInfo, png_bytep row, png_const_bytep prevRow)
+      {
+          const __m128i zero = _mm_setzero_si128();
+          __m128i a = zero, c = zero;
+
+          for (const png_bytep end = row + rowInfo->rowbytes; row < end; row += bytesPerPixel, prevRow += bytesPerPixel)
+          {
+              const __m128i b = _mm_unpacklo_epi8 (load<bytesPerPixel> (prevRow), zero);
+
+              // The estimate is p = a + b - c, so |p - a| = |b - c|, |p - b| = |a - c|
+              // and |p - c| = |(b - c) + (a - c)|
+              const __m128i bMinusC = _mm_sub_epi16 (b, c);
+              const __m128i aMinusC = _mm_sub_epi16 (a, c);
+              const __m128i pa = abs16 (bMinusC);
+              const __m128i pb = abs16 (aMinusC);
+              const __m128i pc = abs16 (_mm_add_epi16 (bMinusC, aMinusC));
+              const __m128i smallest = _mm_min_epi16 (pc, _mm_min_epi16 (pa, pb));
+
+              // Ties are resolved in the order a, b, c
+              const __m128i predictor = select (_mm_cmpeq_epi16 (pa, smallest), a,
+                                                select (_mm_cmpeq_epi16 (pb, smallest), b, c));
+
+              const __m128i result = _mm_add_epi8 (load<bytesPerPixel> (row), _mm_packus_epi16 (predictor, predictor));
+              store<bytesPerPixel> (row, result);
+
+              a = _mm_unpacklo_epi8 (result, zero);
+              c = b;
+          }
+      }
+
+      template <int bytesPerPixel>
+      static void install (png_structp png) noexcept
+      {
+          png->read_filter[PNG_FILTER_VALUE_SUB - 1]   = sub<bytesPerPixel>;
+          png->read_filter[PNG_FILTER_VALUE_AVG - 1]   = average<bytesPerPixel>;
+          png->read_filter[PNG_FILTER_VALUE_PAETH - 1] = paeth<bytesPerPixel>;
+      }
+  };
+
+  void juce_installPNGFilterFunctions (png_structp png, unsigned int bytesPerPixel)
+  {
+      // (the up filter doesn't need replacing, as the compiler can vectorise it already)
+      if (bytesPerPixel == 3)      PNGFilterFunctions::install<3> (png);
+      else if (bytesPerPixel == 4) PNGFilterFunctions::install<4> (png);
+  }
+ #endif
+
   #if JUCE_CLANG
    #pragma clang diagnostic pop
   #endif
@@ -384,6 +503,40 @@ namespace PNGHelpers
     #pragma warning (pop)
    #endif
 
+   #if JUCE_USE_SSE_INTRINSICS && ! JUCE_ANDROID
+    static forcedinline __m128i premultiplyTwoPixels (__m128i rgba) noexcept
+    {
+        const __m128i bgra  = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (rgba, _MM_SHUFFLE (3, 0, 1, 2)), _MM_SHUFFLE (3, 0, 1, 2));
+        const __m128i alpha = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (rgba, _MM_SHUFFLE (3, 3, 3, 3)), _MM_SHUFFLE (3, 3, 3, 3));
+        const __m128i scaled = _mm_srli_epi16 (_mm_add_epi16 (_mm_mullo_epi16 (bgra, alpha), _mm_set1_epi16 (0x7f)), 8);
+
+        // Like PixelARGB::premultiply(), this leaves the alpha channel and any opaque pixels alone
+        const __m128i unchanged = _mm_or_si128 (_mm_set_epi16 (-1, 0, 0, 0, -1, 0, 0, 0),
+                                                _mm_cmpeq_epi16 (alpha, _mm_set1_epi16 (0xff)));
+
+        return _mm_or_si128 (_mm_and_si128 (unchanged, bgra), _mm_andnot_si128 (unchanged, scaled));
+    }
+
+    // Converts as many RGBA pixels as it can to premultiplied PixelARGBs, four at a time,
+    // and returns the number that it did.
+    static int convertToPremultipliedARGB (PixelARGB* dest, const uint8* src, int numPixels) noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+        int i = 0;
+
+        for (; i + 4 <= numPixels; i += 4)
+        {
+            const __m128i rgba = _mm_loadu_si128 ((const __m128i*) (src + i * 4));
+
+            _mm_storeu_si128 ((__m128i*) (dest + i),
+                              _mm_packus_epi16 (premultiplyTwoPixels (_mm_unpacklo_epi8 (rgba, zero)),
+                                                premultiplyTwoPixels (_mm_unpackhi_epi8 (rgba, zero))));
+        }
+
+        return i;
+    }
+   #endif
+
     static Image createImageFromData (bool hasAlphaChan, int width, int height, png_bytepp rows)
     {
         // now convert the data to a juce image format..
@@ -401,7 +554,18 @@ namespace PNGHelpers
 
             if (hasAlphaChan)
             {
-                for (int i = (int) width; --i >= 0;)
+                int numDone = 0;
+
+               #if JUCE_USE_SSE_INTRINSICS && ! JUCE_ANDROID
+                if (destData.pixelStride == 4)
+                {
+                    numDone = convertToPremultipliedARGB ((PixelARGB*) dest, src, width);
+                    dest += numDone * 4;
+                    src += numDone * 4;
+                }
+               #endif
+
+                for (int i = (int) width - numDone; --i >= 0;)
                 {
                     ((PixelARGB*) dest)->setARGB (src[3], src[0], src[1], src[2]);
                     ((PixelARGB*) dest)->premultiply();
@@ -584,3 +748,130 @@ bool PNGImageFormat::writeImageToStream (const Image& image, OutputStream& out)
 
     return true;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS && ! JUCE_USING_COREIMAGE_LOADER
+
+class PNGImageFormatTests  : public UnitTest
+{
+public:
+    PNGImageFormatTests() : UnitTest ("PNGImageFormat") {}
+
+    void runTest() override
+    {
+        beginTest ("Reading and writing ARGB images");
+        {
+            for (int i = 0; i < 10; ++i)
+            {
+                const Image original (createTestImage (Image::ARGB, 1 + getRandom().nextInt (70), 1 + getRandom().nextInt (40)));
+                const Image loaded (writeAndReadBack (original));
+
+                expect (loaded.getFormat() == Image::ARGB && loaded.getBounds() == original.getBounds());
+                expectPixelsMatch (original, loaded);
+            }
+        }
+
+        beginTest ("Reading and writing RGB images");
+        {
+            for (int i = 0; i < 10; ++i)
+            {
+                const Image original (createTestImage (Image::RGB, 1 + getRandom().nextInt (70), 1 + getRandom().nextInt (40)));
+                const Image loaded (writeAndReadBack (original));
+
+                expect (loaded.getFormat() == Image::RGB && loaded.getBounds() == original.getBounds());
+                expectPixelsMatch (original, loaded);
+            }
+        }
+    }
+
+private:
+    // Each row is either a gradient, a blend of the pixels above and to the left, or noise,
+    // so that the writer ends up using all the different row filters.
+    Image createTestImage (Image::PixelFormat format, int w, int h)
+    {
+        Random r (getRandom().nextInt64());
+        HeapBlock<uint8> values ((size_t) (w * h * 4));
+
+        for (int y = 0; y < h; ++y)
+        {
+            const int rowType = r.nextInt (3);
+
+            for (int i = y * w * 4; i < (y + 1) * w * 4; ++i)
+            {
+                const int x = (i / 4) % w, channel = i % 4;
+
+                if (rowType == 0)       values[i] = (uint8) (x * (channel + 2) + y * (5 - channel));
+                else if (rowType == 1)  values[i] = (uint8) (((x > 0 ? values[i - 4] : 0) + (y > 0 ? values[i - w * 4] : 0)) / 2 + r.nextInt (3));
+                else                    values[i] = (uint8) r.nextInt (256);
+            }
+        }
+
+        Image image (format, w, h, false);
+        const Image::BitmapData data (image, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                const uint8* const v = values + (y * w + x) * 4;
+                const uint8 alpha = format != Image::ARGB ? 255 : (v[3] < 32 ? 0 : (v[3] >= 224 ? 255 : v[3]));
+
+                PixelARGB p (alpha, v[0], v[1], v[2]);
+                p.premultiply();
+
+                if (format == Image::ARGB)
+                    ((PixelARGB*) data.getPixelPointer (x, y))->set (p);
+                else
+                    ((PixelRGB*) data.getPixelPointer (x, y))->set (p);
+            }
+        }
+
+        return image;
+    }
+
+    static Image writeAndReadBack (const Image& image)
+    {
+        MemoryOutputStream out;
+        PNGImageFormat png;
+        png.writeImageToStream (image, out);
+
+        MemoryInputStream in (out.getData(), out.getDataSize(), false);
+        return png.decodeImage (in);
+    }
+
+    void expectPixelsMatch (const Image& original, const Image& loaded)
+    {
+        const Image::BitmapData originalData (original, Image::BitmapData::readOnly);
+        const Image::BitmapData loadedData (loaded, Image::BitmapData::readOnly);
+        int numMismatches = 0;
+
+        for (int y = 0; y < original.getHeight(); ++y)
+        {
+            for (int x = 0; x < original.getWidth(); ++x)
+            {
+                // (the writer has to unpremultiply the pixels, and the reader premultiplies them again)
+                PixelARGB expected (getPixel (originalData, x, y));
+                expected.unpremultiply();
+                expected.premultiply();
+
+                if (getPixel (loadedData, x, y).getNativeARGB() != expected.getNativeARGB())
+                    ++numMismatches;
+            }
+        }
+
+        expectEquals (numMismatches, 0);
+    }
+
+    static PixelARGB getPixel (const Image::BitmapData& data, int x, int y) noexcept
+    {
+        if (data.pixelFormat == Image::ARGB)
+            return *(const PixelARGB*) data.getPixelPointer (x, y);
+
+        const PixelRGB* const p = (const PixelRGB*) data.getPixelPointer (x, y);
+        return PixelARGB (255, p->getRed(), p->getGreen(), p->getBlue());
+    }
+};
+
+static PNGImageFormatTests pngImageFormatTests;
+
+#endif
@@ -0,0 +1,566 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace ImageBlurHelpers
+{
+    //==============================================================================
+    // All the filtering is done on rows of floats, treating the channels of each pixel as
+    // separate values, so these are the only operations that need to be vectorised.
+    static void addScaled (float* dest, const float* src, const float multiplier, const int num) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const __m128 m = _mm_set1_ps (multiplier);
+
+        for (; i <= num - 4; i += 4)
+            _mm_storeu_ps (dest + i, _mm_add_ps (_mm_loadu_ps (dest + i), _mm_mul_ps (_mm_loadu_ps (src + i), m)));
+       #elif JUCE_USE_ARM_NEON
+        const float32x4_t m = vdupq_n_f32 (multiplier);
+
+        for (; i <= num - 4; i += 4)
+            vst1q_f32 (dest + i, vmlaq_f32 (vld1q_f32 (dest + i), vld1q_f32 (src + i), m));
+       #endif
+
+        for (; i < num; ++i)
+            dest[i] += src[i] * multiplier;
+    }
+
+    static void copyBytesToFloats (float* dest, const uint8* src, const int num) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; i <= num - 16; i += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128 ((const __m128i*) (src + i));
+            const __m128i lo = _mm_unpacklo_epi8 (bytes, zero);
+            const __m128i hi = _mm_unpackhi_epi8 (bytes, zero);
+
+            _mm_storeu_ps (dest + i,      _mm_cvtepi32_ps (_mm_unpacklo_epi16 (lo, zero)));
+            _mm_storeu_ps (dest + i + 4,  _mm_cvtepi32_ps (_mm_unpackhi_epi16 (lo, zero)));
+            _mm_storeu_ps (dest + i + 8,  _mm_cvtepi32_ps (_mm_unpacklo_epi16 (hi, zero)));
+            _mm_storeu_ps (dest + i + 12, _mm_cvtepi32_ps (_mm_unpackhi_epi16 (hi, zero)));
+        }
+       #endif
+
+        for (; i < num; ++i)
+            dest[i] = (float) src[i];
+    }
+
+    static void copyFloatsToBytes (uint8* dest, const float* src, const float multiplier, const int num) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const __m128 m = _mm_set1_ps (multiplier);
+
+        for (; i <= num - 16; i += 16)
+        {
+            // (the packing instructions clip the values to 0-255)
+            const __m128i lo = _mm_packs_epi32 (_mm_cvtps_epi32 (_mm_mul_ps (_mm_loadu_ps (src + i),      m)),
+                                                _mm_cvtps_epi32 (_mm_mul_ps (_mm_loadu_ps (src + i + 4),  m)));
+            const __m128i hi = _mm_packs_epi32 (_mm_cvtps_epi32 (_mm_mul_ps (_mm_loadu_ps (src + i + 8),  m)),
+                                                _mm_cvtps_epi32 (_mm_mul_ps (_mm_loadu_ps (src + i + 12), m)));
+
+            _mm_storeu_si128 ((__m128i*) (dest + i), _mm_packus_epi16 (lo, hi));
+        }
+       #endif
+
+        for (; i < num; ++i)
+            dest[i] = (uint8) jlimit (0, 255, roundToInt (src[i] * multiplier));
+    }
+
+    //==============================================================================
+    // Below this many values, it's not worth the overhead of sharing out the work.
+    enum { minValuesToShareBetweenThreads = 32768 };
+
+    template <typename FunctionType>
+    static void runForRange (ThreadPool* pool, int numItems, int64 numValuesToProcess, const FunctionType& function)
+    {
+       #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+        if (numValuesToProcess >= minValuesToShareBetweenThreads)
+        {
+            parallelForRange (pool != nullptr ? *pool : LowLevelGraphicsTiledSoftwareRenderer::getSharedThreadPool(),
+                              0, numItems, function);
+            return;
+        }
+       #else
+        ignoreUnused (pool, numValuesToProcess);
+       #endif
+
+        function (0, numItems);
+    }
+
+    //==============================================================================
+    /*  A separable filter is run in two passes. The first one filters each of the source rows
+        that are needed into a buffer of floats, and the second one filters the columns of this
+        buffer and writes the results to the destination. Because all the source pixels have
+        been read before anything is written, the source and destination can be the same.
+
+        The subclasses provide filterRow() and filterColumns().
+    */
+    struct SeparableFilter
+    {
+        SeparableFilter (const Image::BitmapData& source, const Image::BitmapData& dest,
+                         const Rectangle<int>& destArea, int reachX, int reachY)
+            : src (source), dst (dest), area (destArea),
+              numChannels (source.pixelStride),
+              rowStart (jmax (0, destArea.getY() - reachY)),
+              rowEnd (jmin (source.height, destArea.getBottom() + reachY)),
+              lineStart (destArea.getX() - reachX),
+              lineLength (destArea.getWidth() + 2 * reachX),
+              valuesPerRow (destArea.getWidth() * source.pixelStride),
+              rows ((size_t) (valuesPerRow * jmax (0, rowEnd - rowStart)))
+        {
+            jassert (source.pixelStride == dest.pixelStride);
+            jassert (source.width == dest.width && source.height == dest.height);
+        }
+
+        // Loads a source row, including the pixels on either side that the filter reaches,
+        // and with zeros for the parts that are off the edges of the image.
+        void readLine (float* line, int y) const noexcept
+        {
+            const int start = jmax (0, lineStart);
+            const int end = jmin (src.width, lineStart + lineLength);
+
+            zeromem (line, sizeof (float) * (size_t) (lineLength * numChannels));
+
+            if (end > start)
+                copyBytesToFloats (line + (start - lineStart) * numChannels,
+                                   src.getPixelPointer (start, y), (end - start) * numChannels);
+        }
+
+        float* getRow (int y) const noexcept
+        {
+            return isPositiveAndBelow (y - rowStart, rowEnd - rowStart) ? rows + (y - rowStart) * valuesPerRow
+                                                                          : nullptr;
+        }
+
+        uint8* getDestLine (int y) const noexcept
+        {
+            return dst.getPixelPointer (area.getX(), y);
+        }
+
+        const Image::BitmapData& src;
+        const Image::BitmapData& dst;
+        const Rectangle<int> area;
+        const int numChannels, rowStart, rowEnd, lineStart, lineLength, valuesPerRow;
+        HeapBlock<float> rows;
+    };
+
+    template <class FilterType>
+    struct RowPass
+    {
+        RowPass (FilterType& f) noexcept : filter (f) {}
+
+        void operator() (int start, int end) const
+        {
+            HeapBlock<float> line ((size_t) (filter.lineLength * filter.numChannels));
+            typename FilterType::RowWorkspace workspace (filter);
+
+            for (int i = start; i < end; ++i)
+            {
+                const int y = filter.rowStart + i;
+                filter.readLine (line, y);
+                filter.filterRow (filter.getRow (y), line, workspace);
+            }
+        }
+
+        FilterType& filter;
+    };
+
+    template <class FilterType>
+    struct ColumnPass
+    {
+        ColumnPass (FilterType& f) noexcept : filter (f) {}
+        void operator() (int start, int end) const    { filter.filterColumns (start, end); }
+
+        FilterType& filter;
+    };
+
+    template <class FilterType>
+    static void applyFilter (FilterType& filter, ThreadPool* pool)
+    {
+        const int numRows = filter.rowEnd - filter.rowStart;
+
+        if (numRows <= 0 || filter.valuesPerRow <= 0)
+            return;
+
+        const int64 numValues = numRows * (int64) filter.valuesPerRow;
+
+        runForRange (pool, numRows, numValues, RowPass<FilterType> (filter));
+        runForRange (pool, filter.getNumColumnItems(), numValues, ColumnPass<FilterType> (filter));
+    }
+
+    //==============================================================================
+    /*  Convolves the rows and columns with a pair of kernels. The kernel values are multiplied
+        with the pixels starting at (size / 2) before each destination pixel.
+    */
+    struct KernelFilter  : public SeparableFilter
+    {
+        KernelFilter (const Image::BitmapData& source, const Image::BitmapData& dest, const Rectangle<int>& destArea,
+                      const float* horizontal, const float* vertical, int kernelSize)
+            : SeparableFilter (source, dest, destArea, kernelSize / 2, kernelSize / 2),
+              kernelX (horizontal), kernelY (vertical), size (kernelSize)
+        {
+        }
+
+        struct RowWorkspace
+        {
+            RowWorkspace (const KernelFilter&) noexcept {}
+        };
+
+        void filterRow (float* dest, const float* line, RowWorkspace&) const noexcept
+        {
+            zeromem (dest, sizeof (float) * (size_t) valuesPerRow);
+
+            for (int i = 0; i < size; ++i)
+                addScaled (dest, line + i * numChannels, kernelX[i], valuesPerRow);
+        }
+
+        int getNumColumnItems() const noexcept      { return area.getHeight(); }
+
+        // This splits the work by destination row, each of which adds up a few of the buffered rows.
+        void filterColumns (int start, int end) const
+        {
+            HeapBlock<float> total ((size_t) valuesPerRow);
+
+            for (int i = start; i < end; ++i)
+            {
+                const int y = area.getY() + i;
+                zeromem (total, sizeof (float) * (size_t) valuesPerRow);
+
+                for (int j = 0; j < size; ++j)
+                    if (const float* row = getRow (y + j - size / 2))
+                        addScaled (total, row, kernelY[j], valuesPerRow);
+
+                copyFloatsToBytes (getDestLine (y), total, 1.0f, valuesPerRow);
+            }
+        }
+
+        const float* kernelX;
+        const float* kernelY;
+        const int size;
+    };
+
+    //==============================================================================
+    /*  A stack blur's triangular kernel is the same as two box filters, one after the other,
+        and each of these is a running total, so it costs the same for any radius.
+    */
+    struct StackBlurFilter  : public SeparableFilter
+    {
+        StackBlurFilter (const Image::BitmapData& source, const Image::BitmapData& dest,
+                         const Rectangle<int>& destArea, int blurRadius)
+            : SeparableFilter (source, dest, destArea, blurRadius, blurRadius),
+              radius (blurRadius),
+              scale (1.0f / (float) ((blurRadius + 1) * (blurRadius + 1)))
+        {
+        }
+
+        struct RowWorkspace
+        {
+            RowWorkspace (const StackBlurFilter& f)
+                : boxTotals ((size_t) (f.lineLength * f.numChannels)),
+                  triangleTotals ((size_t) (f.lineLength * f.numChannels))
+            {}
+
+            HeapBlock<float> boxTotals, triangleTotals;
+        };
+
+        // Adds up each set of (radius + 1) values, where consecutive values of the
+        // same channel are numChannels apart.
+        void getRunningTotals (float* dest, const float* src, int num) const noexcept
+        {
+            const int windowSize = (radius + 1) * numChannels;
+
+            for (int i = 0; i < num; ++i)
+                dest[i] = (i >= numChannels ? dest[i - numChannels] : 0.0f) + src[i]
+                            - (i >= windowSize ? src[i - windowSize] : 0.0f);
+        }
+
+        void filterRow (float* dest, const float* line, RowWorkspace& workspace) const noexcept
+        {
+            const int num = lineLength * numChannels;
+
+            // (the totals are all whole numbers that fit into a float's mantissa, so they're exact)
+            getRunningTotals (workspace.boxTotals, line, num);
+            getRunningTotals (workspace.triangleTotals, workspace.boxTotals, num);
+
+            const float* const totals = workspace.triangleTotals + 2 * radius * numChannels;
+
+            for (int i = 0; i < valuesPerRow; ++i)
+                dest[i] = totals[i] * scale;
+        }
+
+        enum { valuesPerColumnChunk = 256 };
+
+        int getNumColumnItems() const noexcept      { return (valuesPerRow + valuesPerColumnChunk - 1) / valuesPerColumnChunk; }
+
+        // The running totals have to go down the whole height of the columns, so this splits the
+        // work into vertical strips, and each of these is processed a whole row at a time.
+        void filterColumns (int start, int end) const
+        {
+            HeapBlock<float> boxTotal (valuesPerColumnChunk), triangleTotal (valuesPerColumnChunk),
+                             previousBoxTotals ((size_t) ((radius + 1) * valuesPerColumnChunk));
+
+            for (int chunk = start; chunk < end; ++chunk)
+            {
+                const int offset = chunk * valuesPerColumnChunk;
+                const int num = jmin ((int) valuesPerColumnChunk, valuesPerRow - offset);
+
+                zeromem (boxTotal, sizeof (float) * valuesPerColumnChunk);
+                zeromem (triangleTotal, sizeof (float) * valuesPerColumnChunk);
+                zeromem (previousBoxTotals, sizeof (float) * (size_t) ((radius + 1) * valuesPerColumnChunk));
+
+                // The box totals for row y are the sum of rows (y - radius) to y, and the triangle
+                // totals at row y are the sum of the box totals for rows (y - radius) to y, which
+                // makes them the blurred values for row (y - radius).
+                for (int y = rowStart; y < area.getBottom() + radius; ++y)
+                {
+                    if (const float* row = getRow (y))
+                        addScaled (boxTotal, row + offset, 1.0f, num);
+
+                    if (const float* oldRow = getRow (y - radius - 1))
+                        addScaled (boxTotal, oldRow + offset, -1.0f, num);
+
+                    float* const oldestBoxTotal = previousBoxTotals + (y % (radius + 1)) * valuesPerColumnChunk;
+                    addScaled (triangleTotal, boxTotal, 1.0f, num);
+                    addScaled (triangleTotal, oldestBoxTotal, -1.0f, num);
+                    memcpy (oldestBoxTotal, boxTotal, sizeof (float) * (size_t) num);
+
+                    const int destY = y - radius;
+
+                    if (destY >= area.getY())
+                        copyFloatsToBytes (getDestLine (destY) + offset, triangleTotal, scale, num);
+                }
+            }
+        }
+
+        const int radius;
+        const float scale;
+    };
+
+    //==============================================================================
+    static void applyKernels (Image& destImage, const Image& sourceImage, const Rectangle<int>& area,
+                              const float* horizontal, const float* vertical, int size, ThreadPool* pool)
+    {
+        const Rectangle<int> clippedArea (area.getIntersection (destImage.getBounds()));
+
+        if (clippedArea.isEmpty() || size <= 0)
+            return;
+
+        const Image::BitmapData destData (destImage, Image::BitmapData::readWrite);
+
+        if (sourceImage == destImage)
+        {
+            KernelFilter filter (destData, destData, clippedArea, horizontal, vertical, size);
+            applyFilter (filter, pool);
+        }
+        else
+        {
+            const Image::BitmapData srcData (sourceImage, Image::BitmapData::readOnly);
+            KernelFilter filter (srcData, destData, clippedArea, horizontal, vertical, size);
+            applyFilter (filter, pool);
+        }
+    }
+}
+
+//==============================================================================
+void ImageBlur::applyGaussianBlur (Image& image, const Rectangle<int>& area,
+                                   float standardDeviation, ThreadPool* pool)
+{
+    if (standardDeviation <= 0.0f || ! image.isValid())
+        return;
+
+    const int reach = jmax (1, (int) std::ceil (standardDeviation * 3.0f));
+    const int size = reach * 2 + 1;
+    const double factor = -1.0 / (2.0 * standardDeviation * standardDeviation);
+
+    HeapBlock<float> kernel ((size_t) size);
+    double total = 0;
+
+    for (int i = 0; i < size; ++i)
+    {
+        const double value = std::exp (factor * (i - reach) * (i - reach));
+        kernel[i] = (float) value;
+        total += value;
+    }
+
+    for (int i = 0; i < size; ++i)
+        kernel[i] = (float) (kernel[i] / total);
+
+    image.duplicateIfShared();
+    ImageBlurHelpers::applyKernels (image, image, area, kernel, kernel, size, pool);
+}
+
+void ImageBlur::applyStackBlur (Image& image, const Rectangle<int>& area, int radius, ThreadPool* pool)
+{
+    // The totals are kept as floats, which can only hold them exactly for radii below 255.
+    jassert (radius < 255);
+    radius = jmin (radius, 254);
+
+    const Rectangle<int> clippedArea (area.getIntersection (image.getBounds()));
+
+    if (radius <= 0 || clippedArea.isEmpty())
+        return;
+
+    image.duplicateIfShared();
+
+    const Image::BitmapData data (image, Image::BitmapData::readWrite);
+    ImageBlurHelpers::StackBlurFilter filter (data, data, clippedArea, radius);
+    ImageBlurHelpers::applyFilter (filter, pool);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageBlurTests  : public UnitTest
+{
+public:
+    ImageBlurTests() : UnitTest ("ImageBlur") {}
+
+    void runTest() override
+    {
+        const Image::PixelFormat formats[] = { Image::ARGB, Image::RGB, Image::SingleChannel };
+
+        beginTest ("Gaussian blur matches a full convolution");
+        {
+            for (int i = 0; i < numElementsInArray (formats); ++i)
+            {
+                ImageConvolutionKernel gaussian (11);
+                gaussian.createGaussianBlur (2.5f);
+                gaussian.rescaleAllValues (0.9f);
+
+                ImageConvolutionKernel unoptimised (gaussian.getKernelSize());
+                copyValues (unoptimised, gaussian);
+
+                const Image source (createRandomImage (formats[i], 150, 90));
+                const Rectangle<int> area (20, 10, 110, 60);
+
+                expectMatches (applyKernel (gaussian, source, area),
+                               applyKernel (unoptimised, source, area));
+            }
+        }
+
+        beginTest ("Stack blur matches a triangular kernel");
+        {
+            for (int i = 0; i < numElementsInArray (formats); ++i)
+            {
+                const int radius = 1 + getRandom().nextInt (6);
+                ImageConvolutionKernel triangle (radius * 2 + 1);
+                createTriangle (triangle, radius);
+
+                const Image source (createRandomImage (formats[i], 140, 100));
+                const Rectangle<int> area (-10, 5, 120, 200);
+
+                Image blurred (source.createCopy());
+                ImageBlur::applyStackBlur (blurred, area, radius);
+
+                expectMatches (blurred, applyKernel (triangle, source, area));
+            }
+        }
+
+        beginTest ("Blurring with several threads");
+        {
+            ThreadPool pool (3);
+            const Image source (createRandomImage (Image::ARGB, 300, 200));
+
+            // (a gaussian's kernel reaches out to three times its standard deviation)
+            ImageConvolutionKernel gaussian (13), unoptimisedGaussian (13), triangle (7);
+            gaussian.createGaussianBlur (2.0f);
+            copyValues (unoptimisedGaussian, gaussian);
+            createTriangle (triangle, 3);
+
+            Image blurred (source.createCopy());
+            ImageBlur::applyGaussianBlur (blurred, blurred.getBounds(), 2.0f, &pool);
+            expectMatches (blurred, applyKernel (unoptimisedGaussian, source, source.getBounds()));
+
+            blurred = source.createCopy();
+            ImageBlur::applyStackBlur (blurred, blurred.getBounds(), 3, &pool);
+            expectMatches (blurred, applyKernel (triangle, source, source.getBounds()));
+        }
+    }
+
+private:
+    static Image createRandomImage (Image::PixelFormat format, int width, int height)
+    {
+        Random r (12345);
+        Image image (format, width, height, true, SoftwareImageType());
+        const Image::BitmapData data (image, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                data.setPixelColour (x, y, Colour ((uint8) r.nextInt (256), (uint8) r.nextInt (256),
+                                                   (uint8) r.nextInt (256), (uint8) r.nextInt (256)));
+
+        return image;
+    }
+
+    static void createTriangle (ImageConvolutionKernel& kernel, int radius)
+    {
+        for (int y = 0; y < kernel.getKernelSize(); ++y)
+            for (int x = 0; x < kernel.getKernelSize(); ++x)
+                kernel.setKernelValue (x, y, (float) ((radius + 1 - std::abs (x - radius))
+                                                        * (radius + 1 - std::abs (y - radius))));
+
+        kernel.setOverallSum (1.0f);
+    }
+
+    static void copyValues (ImageConvolutionKernel& dest, const ImageConvolutionKernel& source)
+    {
+        for (int y = 0; y < source.getKernelSize(); ++y)
+            for (int x = 0; x < source.getKernelSize(); ++x)
+                dest.setKernelValue (x, y, source.getKernelValue (x, y));
+    }
+
+    static Image applyKernel (const ImageConvolutionKernel& kernel, const Image& source, const Rectangle<int>& area)
+    {
+        Image result (source.createCopy());
+        kernel.applyToImage (result, source, area);
+        return result;
+    }
+
+    // The blurs add things up in a different order, so allow for some rounding differences
+    void expectMatches (const Image& image1, const Image& image2)
+    {
+        expect (image1.getBounds() == image2.getBounds() && image1.getFormat() == image2.getFormat());
+
+        const Image::BitmapData data1 (image1, Image::BitmapData::readOnly);
+        const Image::BitmapData data2 (image2, Image::BitmapData::readOnly);
+        int maxDifference = 0;
+
+        for (int y = 0; y < data1.height; ++y)
+            for (int i = 0; i < data1.width * data1.pixelStride; ++i)
+                maxDifference = jmax (maxDifference, std::abs (data1.getLinePointer (y)[i] - data2.getLinePointer (y)[i]));
+
+        expect (maxDifference <= 1, "difference: " + String (maxDifference));
+    }
+};
+
+static ImageBlurTests imageBlurTests;
+
+#endif
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_IMAGEBLUR_H_INCLUDED
+#define JUCE_IMAGEBLUR_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Some fast blurring functions for images.
+
+    These work with ARGB, RGB and single-channel images. They blur the rows and then the
+    columns separately, using vectorised code, and large images are split up between the
+    threads of a ThreadPool.
+
+    The blurred area can pick up colour from pixels that lie outside it, but anything beyond
+    the edges of the image is treated as being transparent (or black), so a blur will fade
+    out towards the edges of an image.
+
+    @see ImageConvolutionKernel, DropShadow, GlowEffect
+*/
+class JUCE_API  ImageBlur
+{
+public:
+    //==============================================================================
+    /** Applies a gaussian blur to a region of an image.
+
+        @param image                the image to blur, which will be modified in-place
+        @param area                 the region of the image to blur
+        @param standardDeviation    the gaussian's standard deviation, in pixels. Each pixel
+                                    is affected by others up to about three times this
+                                    distance away.
+        @param poolToUse            an optional ThreadPool to use for large images. If this
+                                    is nullptr, the same shared pool that the
+                                    LowLevelGraphicsTiledSoftwareRenderer uses will be used.
+    */
+    static void applyGaussianBlur (Image& image, const Rectangle<int>& area,
+                                   float standardDeviation, ThreadPool* poolToUse = nullptr);
+
+    /** Applies a stack blur to a region of an image.
+
+        A stack blur uses a triangular kernel, which looks very similar to a gaussian, but
+        which takes the same amount of time to apply, no matter how large its radius is.
+
+        @param image        the image to blur, which will be modified in-place
+        @param area         the region of the image to blur
+        @param radius       the distance in pixels over which each pixel is spread out. This
+                            must be less than 255.
+        @param poolToUse    an optional ThreadPool to use for large images. If this
+                            is nullptr, the same shared pool that the
+                            LowLevelGraphicsTiledSoftwareRenderer uses will be used.
+    */
+    static void applyStackBlur (Image& image, const Rectangle<int>& area,
+                                int radius, ThreadPool* poolToUse = nullptr);
+
+private:
+    //==============================================================================
+    ImageBlur();
+
+    JUCE_DECLARE_NON_COPYABLE (ImageBlur)
+};
+
+
+#endif   // JUCE_IMAGEBLUR_H_INCLUDED
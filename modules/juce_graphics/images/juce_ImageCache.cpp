@@ -26,69 +26,248 @@ class ImageCache::Pimpl     : private Timer,
                               private DeletedAtShutdown
 {
 public:
-    Pimpl()  : cacheTimeout (5000)
+    Pimpl()
+        : cacheTimeout (5000), memoryBudget (128 * 1024 * 1024), numBytesUsed (0),
+          numImages (0), numHits (0), numMisses (0), numEvictions (0),
+          mostRecent (nullptr), leastRecent (nullptr)
     {
     }
 
     ~Pimpl()
     {
+       #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+        cancelPreloads();
+       #endif
+
+        while (mostRecent != nullptr)
+            removeItem (mostRecent);
+
         clearSingletonInstance();
     }
 
     Image getFromHashCode (const int64 hashCode)
     {
         const ScopedLock sl (lock);
+        const Image image (findImage (hashCode));
+        countLookup (image.isValid());
+        return image;
+    }
 
-        for (int i = images.size(); --i >= 0;)
+    void addImageToCache (const Image& image, const int64 hashCode)
+    {
+        if (image.isValid())
         {
-            const Item* const item = images.getUnchecked(i);
+            // (without a message loop, e.g. in a command-line app, there won't be any timer
+            // callbacks, so unused images are only released by the budget or releaseUnusedImages())
+            if (! isTimerRunning() && MessageManager::getInstanceWithoutCreating() != nullptr)
+                startTimer (2000);
+
+            const ScopedLock sl (lock);
+            Item* item = itemsByHashCode [hashCode];
 
-            if (item->hashCode == hashCode)
-                return item->image;
+            if (item == nullptr)
+            {
+                item = new Item();
+                item->hashCode = hashCode;
+                item->numBytes = 0;
+                addToFront (*item);
+                ++numImages;
+                itemsByHashCode.set (hashCode, item);
+            }
+
+            numBytesUsed -= item->numBytes;
+            item->image = image;
+            item->numBytes = getApproximateSize (image);
+            numBytesUsed += item->numBytes;
+            markAsUsed (*item);
+
+            releaseImagesToFitBudget();
         }
+    }
 
-        return Image();
+    Image getFromFile (const File& file)
+    {
+        bool wasCached;
+        const Image image (findOrLoadFile (file, wasCached));
+        countLookup (wasCached);
+        return image;
     }
 
-    void addImageToCache (const Image& image, const int64 hashCode)
+    Image getFromFile (const File& file, const int maxWidth, const int maxHeight)
     {
-        if (image.isValid())
+        jassert (maxWidth > 0 && maxHeight > 0);
+
+        // (each size gets its own entry, using a hash code that's derived from the file's)
+        const int64 hashCode = (int64) (((uint64) file.hashCode64() * 1000003)
+                                          ^ ((uint64) (uint32) maxWidth << 32)
+                                          ^ (uint64) (uint32) (maxHeight * 65599));
+
+        // This only counts as one lookup, however many images it had to look for
+        Image image (findImage (hashCode));
+        bool wasCached = image.isValid();
+
+        if (! wasCached)
         {
-            if (! isTimerRunning())
-                startTimer (2000);
+            const Image original (findOrLoadFile (file, wasCached));
 
-            Item* const item = new Item();
-            item->hashCode = hashCode;
-            item->image = image;
-            item->lastUseTime = Time::getApproximateMillisecondCounter();
+            if (original.getWidth() <= maxWidth && original.getHeight() <= maxHeight)
+            {
+                image = original;
+            }
+            else
+            {
+                const double scale = jmin (maxWidth / (double) original.getWidth(),
+                                           maxHeight / (double) original.getHeight());
+
+                image = original.rescaled (jmax (1, roundToInt (original.getWidth() * scale)),
+                                           jmax (1, roundToInt (original.getHeight() * scale)),
+                                           Graphics::highResamplingQuality);
+
+                addImageToCache (image, hashCode);
+                wasCached = false;
+            }
+        }
+
+        countLookup (wasCached);
+        return image;
+    }
 
+    Image findOrLoadFile (const File& file, bool& wasCached)
+    {
+        const int64 hashCode = file.hashCode64();
+        wasCached = false;
+
+       #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+        PendingLoad::Ptr pending;
+
+        {
             const ScopedLock sl (lock);
-            images.add (item);
+            const Image image (findImage (hashCode));
+
+            if (image.isValid())
+            {
+                wasCached = true;
+                return image;
+            }
+
+            pending = findPendingLoad (hashCode);
+        }
+
+        if (pending != nullptr)
+        {
+            // If its task hasn't started yet, we might as well load the file on this thread
+            // rather than waiting for the pool to get round to it.
+            if (pending->task.cancel())
+                return finishLoading (*pending);
+
+            return pending->task.get();
+        }
+       #else
+        {
+            const Image image (findImage (hashCode));
+
+            if (image.isValid())
+            {
+                wasCached = true;
+                return image;
+            }
         }
+       #endif
+
+        const Image image (ImageFileFormat::loadFrom (file));
+        addImageToCache (image, hashCode);
+        return image;
     }
 
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    //==============================================================================
+    struct PendingLoad  : public ReferenceCountedObject
+    {
+        PendingLoad (const File& f, int64 hash)  : file (f), hashCode (hash) {}
+
+        const File file;
+        const int64 hashCode;
+        ThreadPool::Future<Image> task;
+
+        typedef ReferenceCountedObjectPtr<PendingLoad> Ptr;
+    };
+
+    void preloadFiles (const Array<File>& files, ThreadPool* poolToUse)
+    {
+        ThreadPool& pool = poolToUse != nullptr ? *poolToUse : getLoadingThreads();
+
+        const ScopedLock sl (lock);
+
+        for (int i = 0; i < files.size(); ++i)
+        {
+            const File& file = files.getReference (i);
+            const int64 hashCode = file.hashCode64();
+
+            if (! itemsByHashCode.contains (hashCode) && findPendingLoad (hashCode) == nullptr)
+            {
+                PendingLoad* const pending = new PendingLoad (file, hashCode);
+                pendingLoads.add (pending);
+
+                // (the task can't hold a reference to the PendingLoad, as that would be a cycle - but
+                // it'll stay in the pendingLoads array until finishLoading() has been called)
+                pending->task = pool.addTask ([this, pending] { return finishLoading (*pending); });
+            }
+        }
+    }
+
+    bool waitForPreloadedFiles (const int timeOutMilliseconds)
+    {
+        ReferenceCountedArray<PendingLoad> loads;
+
+        {
+            const ScopedLock sl (lock);
+            loads = pendingLoads;
+        }
+
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        for (int i = 0; i < loads.size(); ++i)
+        {
+            int timeLeft = -1;
+
+            if (timeOutMilliseconds >= 0)
+                timeLeft = jmax (0, timeOutMilliseconds - (int) (Time::getMillisecondCounter() - startTime));
+
+            if (! loads.getObjectPointerUnchecked (i)->task.wait (timeLeft))
+                return false;
+        }
+
+        return true;
+    }
+   #endif
+
     void timerCallback() override
     {
         const uint32 now = Time::getApproximateMillisecondCounter();
 
         const ScopedLock sl (lock);
 
-        for (int i = images.size(); --i >= 0;)
+        for (Item* item = mostRecent; item != nullptr;)
         {
-            Item* const item = images.getUnchecked(i);
+            Item* const next = item->next;
 
             if (item->image.getReferenceCount() <= 1)
             {
                 if (now > item->lastUseTime + cacheTimeout || now < item->lastUseTime - 1000)
-                    images.remove (i);
+                    removeItem (item);
             }
             else
             {
-                item->lastUseTime = now; // multiply-referenced, so this image is still in use.
+                markAsUsed (*item); // multiply-referenced, so this image is still in use.
             }
+
+            item = next;
         }
 
-        if (images.size() == 0)
+        // (images that were still in use when the budget was exceeded may have been released since then)
+        releaseImagesToFitBudget();
+
+        if (numImages == 0)
             stopTimer();
     }
 
@@ -96,16 +275,57 @@ public:
     {
         const ScopedLock sl (lock);
 
-        for (int i = images.size(); --i >= 0;)
-            if (images.getUnchecked(i)->image.getReferenceCount() <= 1)
-                images.remove (i);
+        for (Item* item = mostRecent; item != nullptr;)
+        {
+            Item* const next = item->next;
+
+            if (item->image.getReferenceCount() <= 1)
+                removeItem (item);
+
+            item = next;
+        }
+    }
+
+    void setMemoryBudget (const size_t maxNumBytes)
+    {
+        const ScopedLock sl (lock);
+        memoryBudget = maxNumBytes;
+        releaseImagesToFitBudget();
+    }
+
+    size_t getMemoryBudget() const
+    {
+        const ScopedLock sl (lock);
+        return memoryBudget;
+    }
+
+    Statistics getStatistics() const
+    {
+        const ScopedLock sl (lock);
+
+        Statistics stats;
+        stats.numHits = numHits;
+        stats.numMisses = numMisses;
+        stats.numEvictions = numEvictions;
+        stats.numImages = numImages;
+        stats.numBytesUsed = numBytesUsed;
+        return stats;
+    }
+
+    void resetStatistics()
+    {
+        const ScopedLock sl (lock);
+        numHits = numMisses = numEvictions = 0;
     }
 
     struct Item
     {
         Image image;
         int64 hashCode;
+        size_t numBytes;
         uint32 lastUseTime;
+        Item* previous;
+        Item* next;
     };
 
     unsigned int cacheTimeout;
@@ -113,9 +333,163 @@ public:
     juce_DeclareSingleton_SingleThreaded_Minimal (ImageCache::Pimpl)
 
 private:
-    OwnedArray<Item> images;
+    // The items are kept in a list that's ordered by when they were last used, and are
+    // owned by the cache, so must be deleted with removeItem().
+    HashMap<int64, Item*> itemsByHashCode;
+    size_t memoryBudget, numBytesUsed;
+    int numImages;
+    int64 numHits, numMisses, numEvictions;
+    Item* mostRecent;
+    Item* leastRecent;
     CriticalSection lock;
 
+    // Returns the image without counting it in the statistics
+    Image findImage (const int64 hashCode)
+    {
+        const ScopedLock sl (lock);
+
+        if (Item* const item = itemsByHashCode [hashCode])
+        {
+            markAsUsed (*item);
+            return item->image;
+        }
+
+        return Image();
+    }
+
+    void countLookup (const bool wasFound) noexcept
+    {
+        const ScopedLock sl (lock);
+
+        if (wasFound)
+            ++numHits;
+        else
+            ++numMisses;
+    }
+
+    void markAsUsed (Item& item) noexcept
+    {
+        item.lastUseTime = Time::getApproximateMillisecondCounter();
+
+        if (mostRecent != &item)
+        {
+            unlink (item);
+            addToFront (item);
+        }
+    }
+
+    void addToFront (Item& item) noexcept
+    {
+        item.previous = nullptr;
+        item.next = mostRecent;
+
+        if (mostRecent != nullptr)  mostRecent->previous = &item;
+        else                        leastRecent = &item;
+
+        mostRecent = &item;
+    }
+
+    void unlink (Item& item) noexcept
+    {
+        if (item.previous != nullptr)  item.previous->next = item.next;
+        else                           mostRecent = item.next;
+
+        if (item.next != nullptr)      item.next->previous = item.previous;
+        else                           leastRecent = item.previous;
+
+        item.previous = item.next = nullptr;
+    }
+
+    void removeItem (Item* const item)
+    {
+        unlink (*item);
+        numBytesUsed -= item->numBytes;
+        --numImages;
+        itemsByHashCode.remove (item->hashCode);
+        delete item;
+    }
+
+    // Releases the least recently used images until the total fits into the budget. Images
+    // that are still in use elsewhere are left alone, as releasing them wouldn't free anything
+    // (and the timer moves these back to the front of the list, so they don't pile up at the end).
+    void releaseImagesToFitBudget()
+    {
+        for (Item* item = leastRecent; item != nullptr && numBytesUsed > memoryBudget;)
+        {
+            Item* const previous = item->previous;
+
+            if (item->image.getReferenceCount() <= 1)
+            {
+                removeItem (item);
+                ++numEvictions;
+            }
+
+            item = previous;
+        }
+    }
+
+    // This is only an estimate, as the native image types may add some padding
+    static size_t getApproximateSize (const Image& image) noexcept
+    {
+        const size_t bytesPerPixel = image.isARGB() ? 4 : (image.isRGB() ? 3 : 1);
+        return (size_t) image.getWidth() * (size_t) image.getHeight() * bytesPerPixel;
+    }
+
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS
+    ReferenceCountedArray<PendingLoad> pendingLoads;
+    ScopedPointer<ThreadPool> loadingThreads;
+
+    ThreadPool& getLoadingThreads()
+    {
+        const ScopedLock sl (lock);
+
+        if (loadingThreads == nullptr)
+            loadingThreads = new ThreadPool();
+
+        return *loadingThreads;
+    }
+
+    PendingLoad* findPendingLoad (const int64 hashCode) const noexcept
+    {
+        for (int i = pendingLoads.size(); --i >= 0;)
+            if (pendingLoads.getObjectPointerUnchecked (i)->hashCode == hashCode)
+                return pendingLoads.getObjectPointerUnchecked (i);
+
+        return nullptr;
+    }
+
+    // This is called either by a pool thread, or by getFromFile() if it asks for
+    // the image before the task has started.
+    Image finishLoading (PendingLoad& pending)
+    {
+        const PendingLoad::Ptr keepAlive (&pending);
+        const Image image (ImageFileFormat::loadFrom (pending.file));
+
+        const ScopedLock sl (lock);
+        pendingLoads.removeObject (&pending);
+
+        if (Item* const existing = itemsByHashCode [pending.hashCode])
+            return existing->image;
+
+        addImageToCache (image, pending.hashCode);
+        return image;
+    }
+
+    void cancelPreloads()
+    {
+        ReferenceCountedArray<PendingLoad> loads;
+
+        {
+            const ScopedLock sl (lock);
+            loads.swapWith (pendingLoads);
+        }
+
+        for (int i = 0; i < loads.size(); ++i)
+            if (! loads.getObjectPointerUnchecked (i)->task.cancel())
+                loads.getObjectPointerUnchecked (i)->task.wait();
+    }
+   #endif
+
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
 
@@ -138,18 +512,29 @@ void ImageCache::addImageToCache (const Image& image, const int64 hashCode)
 
 Image ImageCache::getFromFile (const File& file)
 {
-    const int64 hashCode = file.hashCode64();
-    Image image (getFromHashCode (hashCode));
+    return Pimpl::getInstance()->getFromFile (file);
+}
 
-    if (image.isNull())
-    {
-        image = ImageFileFormat::loadFrom (file);
-        addImageToCache (image, hashCode);
-    }
+Image ImageCache::getFromFile (const File& file, const int maxWidth, const int maxHeight)
+{
+    return Pimpl::getInstance()->getFromFile (file, maxWidth, maxHeight);
+}
 
-    return image;
+#if JUCE_COMPILER_SUPPORTS_LAMBDAS
+void ImageCache::preloadFiles (const Array<File>& files, ThreadPool* const poolToUse)
+{
+    Pimpl::getInstance()->preloadFiles (files, poolToUse);
 }
 
+bool ImageCache::waitForPreloadedFiles (const int timeOutMilliseconds)
+{
+    if (Pimpl* const pimpl = Pimpl::getInstanceWithoutCreating())
+        return pimpl->waitForPreloadedFiles (timeOutMilliseconds);
+
+    return true;
+}
+#endif
+
 Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
 {
     const int64 hashCode = (int64) (pointer_sized_int) imageData;
@@ -174,3 +559,174 @@ void ImageCache::releaseUnusedImages()
 {
     Pimpl::getInstance()->releaseUnusedImages();
 }
+
+void ImageCache::setMemoryBudget (const size_t maxNumBytes)
+{
+    Pimpl::getInstance()->setMemoryBudget (maxNumBytes);
+}
+
+size_t ImageCache::getMemoryBudget()
+{
+    return Pimpl::getInstance()->getMemoryBudget();
+}
+
+ImageCache::Statistics ImageCache::getStatistics()
+{
+    return Pimpl::getInstance()->getStatistics();
+}
+
+void ImageCache::resetStatistics()
+{
+    Pimpl::getInstance()->resetStatistics();
+}
+
+double ImageCache::Statistics::getHitRate() const noexcept
+{
+    const int64 total = numHits + numMisses;
+    return total > 0 ? numHits / (double) total : 0.0;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS && JUCE_COMPILER_SUPPORTS_LAMBDAS
+
+class ImageCacheTests  : public UnitTest
+{
+public:
+    ImageCacheTests() : UnitTest ("ImageCache") {}
+
+    void runTest() override
+    {
+        const TemporaryFile tempFolder;
+        const File folder (tempFolder.getFile());
+        folder.createDirectory();
+
+        for (int i = 0; i < numElementsInArray (originals); ++i)
+        {
+            Image& image = originals[i];
+            image = Image (Image::RGB, 40 + i, 30, true);
+            image.clear (Rectangle<int> (i, i, 20, 10), Colour ((uint32) getRandom().nextInt()).withAlpha (1.0f));
+
+            FileOutputStream out (folder.getChildFile ("image" + String (i) + ".png"));
+            PNGImageFormat().writeImageToStream (image, out);
+        }
+
+        Array<File> files;
+        folder.findChildFiles (files, File::findFiles, false, "*.png");
+
+        beginTest ("Preloading files");
+        {
+            expectEquals (files.size(), numElementsInArray (originals));
+
+            ThreadPool pool (2);
+            ImageCache::preloadFiles (files, &pool);
+
+            // Some of these will still be loading, and some won't have started
+            for (int i = 0; i < files.size(); i += 2)
+                expectImagesMatch (ImageCache::getFromFile (files.getReference (i)), getOriginal (files.getReference (i)));
+
+            expect (ImageCache::waitForPreloadedFiles());
+
+            for (int i = 0; i < files.size(); ++i)
+            {
+                const Image image (ImageCache::getFromFile (files.getReference (i)));
+                expectImagesMatch (image, getOriginal (files.getReference (i)));
+
+                // (each file should only have been loaded once)
+                expect (image == ImageCache::getFromHashCode (files.getReference (i).hashCode64()));
+            }
+        }
+
+        beginTest ("Releasing preloaded images");
+        {
+            ImageCache::releaseUnusedImages();
+
+            for (int i = 0; i < files.size(); ++i)
+                expect (ImageCache::getFromHashCode (files.getReference (i).hashCode64()).isNull());
+        }
+
+        beginTest ("Loading scaled-down images");
+        {
+            const File file (folder.getChildFile ("image0.png"));
+            ImageCache::resetStatistics();
+
+            const Image scaled (ImageCache::getFromFile (file, 20, 20));
+
+            expect (scaled.getWidth() == 20 && scaled.getHeight() == 15);
+            expect (scaled == ImageCache::getFromFile (file, 20, 20));
+            expect (ImageCache::getFromFile (file, 100, 100) == ImageCache::getFromFile (file));
+
+            // (each call should only count as one lookup, even if it had to load the full-size image)
+            const ImageCache::Statistics stats (ImageCache::getStatistics());
+            expectEquals ((int) stats.numMisses, 1);
+            expectEquals ((int) stats.numHits, 3);
+        }
+
+        beginTest ("Keeping within the memory budget");
+        {
+            ImageCache::releaseUnusedImages();
+
+            const size_t originalBudget = ImageCache::getMemoryBudget();
+            const size_t imageSize = 100 * 100 * 4;
+            const size_t bytesAlreadyUsed = ImageCache::getStatistics().numBytesUsed;
+
+            ImageCache::setMemoryBudget (bytesAlreadyUsed + 3 * imageSize);
+            ImageCache::resetStatistics();
+
+            const Image imageInUse (Image::ARGB, 100, 100, true);
+            ImageCache::addImageToCache (imageInUse, 1001);
+            ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true), 1002);
+            ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true), 1003);
+
+            // (this makes 1003 the least recently used image)
+            expect (ImageCache::getFromHashCode (1002).isValid());
+
+            ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true), 1004);
+
+            expect (ImageCache::getFromHashCode (1001) == imageInUse);
+            expect (ImageCache::getFromHashCode (1002).isValid());
+            expect (ImageCache::getFromHashCode (1003).isNull());
+            expect (ImageCache::getFromHashCode (1004).isValid());
+
+            const ImageCache::Statistics stats (ImageCache::getStatistics());
+            expectEquals ((int) stats.numEvictions, 1);
+            expectEquals ((int) stats.numHits, 4);
+            expectEquals ((int) stats.numMisses, 1);
+            expect (stats.numBytesUsed == bytesAlreadyUsed + 3 * imageSize);
+
+            ImageCache::setMemoryBudget (originalBudget);
+        }
+
+        ImageCache::releaseUnusedImages();
+        expectEquals (ImageCache::getStatistics().numImages, 0);
+
+        folder.deleteRecursively();
+
+        for (int i = 0; i < numElementsInArray (originals); ++i)
+            originals[i] = Image();
+    }
+
+private:
+    Image originals[12];
+
+    const Image& getOriginal (const File& file) const
+    {
+        return originals [file.getFileNameWithoutExtension().getTrailingIntValue()];
+    }
+
+    void expectImagesMatch (const Image& loaded, const Image& original)
+    {
+        expect (loaded.getBounds() == original.getBounds());
+
+        bool allPixelsMatch = true;
+
+        for (int y = 0; y < original.getHeight(); ++y)
+            for (int x = 0; x < original.getWidth(); ++x)
+                allPixelsMatch = allPixelsMatch && loaded.getPixelAt (x, y) == original.getPixelAt (x, y);
+
+        expect (allPixelsMatch);
+    }
+};
+
+static ImageCacheTests imageCacheTests;
+
+#endif
@@ -39,6 +39,13 @@
     loading/deleting the same image, it'll reduce the chances of having to reload it
     each time.
 
+    If you know which images you're going to need, e.g. when your app is starting up,
+    you can use preloadFiles() to decode them all in parallel on background threads.
+
+    The cache has a memory budget, and if the images that it holds add up to more than
+    that, the ones that were used least recently are released, as long as nothing else
+    is still using them.
+
     @see Image, ImageFileFormat
 */
 class JUCE_API  ImageCache
@@ -61,6 +68,46 @@ public:
     */
     static Image getFromFile (const File& file);
 
+    /** Loads an image from a file, scaled down to fit within a maximum size.
+
+        This is handy for things like thumbnails. The scaled-down image is cached separately
+        for each size that gets asked for, as well as the full-size image that it was made
+        from. If the image is already small enough, this just returns the full-size image.
+
+        @param file         the file to try to load
+        @param maxWidth     the maximum width of the image that's returned
+        @param maxHeight    the maximum height of the image that's returned
+        @returns            the image, or null if it there was an error loading it
+        @see getFromFile
+    */
+    static Image getFromFile (const File& file, int maxWidth, int maxHeight);
+
+   #if JUCE_COMPILER_SUPPORTS_LAMBDAS || DOXYGEN
+    /** Starts loading some image files on background threads.
+
+        Each file is decoded by a ThreadPool task and added to the cache, so that it'll be
+        ready by the time you call getFromFile() for it. Files that are already in the cache,
+        or which are already being loaded, are skipped.
+
+        If you call getFromFile() for one of these files before it has been loaded, it won't
+        load the file a second time: if the file's task has already started, it'll wait for it
+        to finish, otherwise it'll take over the job and load the file itself.
+
+        @param files        the files to load
+        @param poolToUse    an optional ThreadPool to run the tasks on. If this is nullptr,
+                            the cache will use a pool of its own, with a thread for each
+                            CPU core. If you supply your own pool, make sure that it isn't
+                            deleted until the files have finished loading.
+        @see getFromFile, waitForPreloadedFiles
+    */
+    static void preloadFiles (const Array<File>& files, ThreadPool* poolToUse = nullptr);
+
+    /** Waits until all the files passed to preloadFiles() have finished loading.
+        @returns true if they all finished, or false if the timeout expired first
+    */
+    static bool waitForPreloadedFiles (int timeOutMilliseconds = -1);
+   #endif
+
     /** Loads an image from an in-memory image file, (or just returns the image if it's already cached).
 
         If the cache already contains an image that was loaded from this block of memory,
@@ -103,6 +150,8 @@ public:
 
     /** Changes the amount of time before an unused image will be removed from the cache.
         By default this is about 5 seconds.
+
+        The images are released by a Timer, so this only happens if there's a MessageManager.
     */
     static void setCacheTimeout (int millisecs);
 
@@ -111,6 +160,51 @@ public:
     */
     static void releaseUnusedImages();
 
+    //==============================================================================
+    /** Sets the maximum amount of memory that the cached images should use.
+
+        When the total size of the images goes over this, the ones that were used least
+        recently will be released. Images that are still being used somewhere else can't be
+        released, so the total may still end up larger than the budget. By default this
+        is 128MB.
+
+        The sizes of the images are only estimated from their dimensions and pixel formats,
+        so they won't account for any padding that the native image types may add.
+    */
+    static void setMemoryBudget (size_t maxNumBytes);
+
+    /** Returns the maximum amount of memory that the cached images should use.
+        @see setMemoryBudget
+    */
+    static size_t getMemoryBudget();
+
+    /** Some statistics about how well the cache is working.
+        @see getStatistics
+    */
+    struct JUCE_API  Statistics
+    {
+        /** The number of times an image was found in the cache. */
+        int64 numHits;
+        /** The number of times an image wasn't found, and had to be loaded. */
+        int64 numMisses;
+        /** The number of images that were released to keep within the memory budget. */
+        int64 numEvictions;
+
+        /** The number of images in the cache. */
+        int numImages;
+        /** The approximate total size of the images in the cache. */
+        size_t numBytesUsed;
+
+        /** Returns the proportion of lookups that found their image, from 0 to 1. */
+        double getHitRate() const noexcept;
+    };
+
+    /** Returns the statistics that have been gathered since the last call to resetStatistics(). */
+    static Statistics getStatistics();
+
+    /** Resets the hit, miss and eviction counts returned by getStatistics(). */
+    static void resetStatistics();
+
 private:
     //==============================================================================
     class Pimpl;
@@ -24,6 +24,9 @@
 
 ImageConvolutionKernel::ImageConvolutionKernel (const int size_)
     : values ((size_t) (size_ * size_)),
+      separableValues ((size_t) size_),
+      separableScale (1.0f),
+      isSeparable (false),
       size (size_)
 {
     clear();
@@ -48,6 +51,7 @@ void ImageConvolutionKernel::setKernelValue (const int x, const int y, const flo
     if (isPositiveAndBelow (x, size) && isPositiveAndBelow (y, size))
     {
         values [x + y * size] = value;
+        isSeparable = false;
     }
     else
     {
@@ -59,6 +63,8 @@ void ImageConvolutionKernel::clear()
 {
     for (int i = size * size; --i >= 0;)
         values[i] = 0;
+
+    isSeparable = false;
 }
 
 void ImageConvolutionKernel::setOverallSum (const float desiredTotalSum)
@@ -75,6 +81,8 @@ void ImageConvolutionKernel::rescaleAllValues (const float multiplier)
 {
     for (int i = size * size; --i >= 0;)
         values[i] *= multiplier;
+
+    separableScale *= multiplier;
 }
 
 //==============================================================================
@@ -82,19 +90,27 @@ void ImageConvolutionKernel::createGaussianBlur (const float radius)
 {
     const double radiusFactor = -1.0 / (radius * radius * 2);
     const int centre = size >> 1;
+    double total = 0;
 
-    for (int y = size; --y >= 0;)
+    // exp (a + b) == exp (a) * exp (b), so each value is the product of a horizontal
+    // and a vertical one, which is what allows the kernel to be applied in two passes
+    for (int i = size; --i >= 0;)
     {
-        for (int x = size; --x >= 0;)
-        {
-            const int cx = x - centre;
-            const int cy = y - centre;
-
-            values [x + y * size] = (float) exp (radiusFactor * (cx * cx + cy * cy));
-        }
+        const int c = i - centre;
+        const double value = exp (radiusFactor * (c * c));
+        separableValues[i] = (float) value;
+        total += value;
     }
 
-    setOverallSum (1.0f);
+    for (int i = size; --i >= 0;)
+        separableValues[i] = (float) (separableValues[i] / total);
+
+    for (int y = size; --y >= 0;)
+        for (int x = size; --x >= 0;)
+            values [x + y * size] = separableValues[x] * separableValues[y];
+
+    separableScale = 1.0f;
+    isSeparable = true;
 }
 
 //==============================================================================
@@ -122,6 +138,17 @@ void ImageConvolutionKernel::applyToImage (Image& destImage,
     if (area.isEmpty())
         return;
 
+    if (isSeparable)
+    {
+        HeapBlock<float> verticalValues ((size_t) size);
+
+        for (int i = size; --i >= 0;)
+            verticalValues[i] = separableValues[i] * separableScale;
+
+        ImageBlurHelpers::applyKernels (destImage, sourceImage, area, separableValues, verticalValues, size, nullptr);
+        return;
+    }
+
     const int right = area.getRight();
     const int bottom = area.getBottom();
 
@@ -275,7 +302,7 @@ void ImageConvolutionKernel::applyToImage (Image& destImage,
                             }
                             else
                             {
-                                src += 3;
+                                src += 1;
                             }
 
                             ++sx;
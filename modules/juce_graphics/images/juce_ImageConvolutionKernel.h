@@ -72,10 +72,15 @@ public:
 
     /** Intialises the kernel for a gaussian blur.
 
+        A gaussian kernel can be applied as separate horizontal and vertical passes, so
+        applyToImage() will be much faster with one of these (as long as its values aren't
+        changed by setKernelValue()).
+
         @param blurRadius   this may be larger or smaller than the kernel's actual
                             size but this will obviously be wasteful or clip at the
                             edges. Ideally the kernel should be just larger than
                             (blurRadius * 2).
+        @see ImageBlur
     */
     void createGaussianBlur (float blurRadius);
 
@@ -101,7 +106,9 @@ public:
 
 private:
     //==============================================================================
-    HeapBlock<float> values;
+    HeapBlock<float> values, separableValues;
+    float separableScale;
+    bool isSeparable;
     const int size;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ImageConvolutionKernel)
@@ -103,6 +103,54 @@
  #define JUCE_USING_COREIMAGE_LOADER 0
 #endif
 
+//==============================================================================
+#if (JUCE_GCC || JUCE_CLANG) && ! defined (__SSE2__)
+ #define JUCE_USE_SSE_INTRINSICS 0
+#endif
+
+#ifndef JUCE_USE_SSE_INTRINSICS
+ #define JUCE_USE_SSE_INTRINSICS 1
+#endif
+
+#if ! JUCE_INTEL
+ #undef JUCE_USE_SSE_INTRINSICS
+#endif
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+
+ #ifndef JUCE_USE_AVX2_INTRINSICS
+  #if JUCE_MSVC
+   #define JUCE_USE_AVX2_INTRINSICS (_MSC_VER >= 1700)
+  #elif JUCE_GCC
+   #define JUCE_USE_AVX2_INTRINSICS ((__GNUC__ * 100 + __GNUC_MINOR__) >= 409)
+  #elif defined (__has_attribute)
+   #if __has_attribute (target)
+    #define JUCE_USE_AVX2_INTRINSICS 1
+   #endif
+  #endif
+ #endif
+
+ #if JUCE_USE_AVX2_INTRINSICS
+  #include <immintrin.h>
+ #endif
+#endif
+
+#if (__ARM_NEON__ || __ARM_NEON) && ! defined (JUCE_USE_ARM_NEON)
+ #define JUCE_USE_ARM_NEON 1
+#endif
+
+#if TARGET_IPHONE_SIMULATOR
+ #ifdef JUCE_USE_ARM_NEON
+  #undef JUCE_USE_ARM_NEON
+ #endif
+ #define JUCE_USE_ARM_NEON 0
+#endif
+
+#if JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
 //==============================================================================
 namespace juce
 {
@@ -116,11 +164,14 @@ namespace juce
 #include "geometry/juce_Path.cpp"
 #include "geometry/juce_PathIterator.cpp"
 #include "geometry/juce_PathStrokeType.cpp"
+#include "geometry/juce_RectangleList.cpp"
 #include "placement/juce_RectanglePlacement.cpp"
 #include "contexts/juce_GraphicsContext.cpp"
 #include "contexts/juce_LowLevelGraphicsPostScriptRenderer.cpp"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.cpp"
+#include "contexts/juce_LowLevelGraphicsTiledSoftwareRenderer.cpp"
 #include "images/juce_Image.cpp"
+#include "images/juce_ImageBlur.cpp"
 #include "images/juce_ImageCache.cpp"
 #include "images/juce_ImageConvolutionKernel.cpp"
 #include "images/juce_ImageFileFormat.cpp"
@@ -135,6 +186,7 @@ namespace juce
 #include "fonts/juce_TextLayout.cpp"
 #include "effects/juce_DropShadowEffect.cpp"
 #include "effects/juce_GlowEffect.cpp"
+#include "native/juce_PixelSpanKernels.cpp"
 
 #if JUCE_USE_FREETYPE
  #include "native/juce_freetype_Fonts.cpp"
@@ -115,6 +115,7 @@ class LowLevelGraphicsContext;
 #include "geometry/juce_PathIterator.h"
 #include "geometry/juce_PathStrokeType.h"
 #include "placement/juce_RectanglePlacement.h"
+#include "images/juce_ImageBlur.h"
 #include "images/juce_ImageCache.h"
 #include "images/juce_ImageConvolutionKernel.h"
 #include "images/juce_ImageFileFormat.h"
@@ -130,6 +131,7 @@ class LowLevelGraphicsContext;
 #include "colour/juce_FillType.h"
 #include "native/juce_RenderingHelpers.h"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.h"
+#include "contexts/juce_LowLevelGraphicsTiledSoftwareRenderer.h"
 #include "contexts/juce_LowLevelGraphicsPostScriptRenderer.h"
 #include "effects/juce_ImageEffectFilter.h"
 #include "effects/juce_DropShadowEffect.h"
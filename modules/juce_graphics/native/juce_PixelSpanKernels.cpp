@@ -0,0 +1,1005 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace RenderingHelpers
+{
+
+namespace PixelSpanKernelImplementations
+{
+    /*  Each implementation provides the same set of functions. The extraAlpha values
+        are the same as for the pixel classes' blend (src, extraAlpha) methods, except that
+        fullAlpha means "don't scale the source at all", i.e. a plain blend (src).
+    */
+    enum { fullAlpha = 256 };
+
+    struct Functions
+    {
+        const char* name;
+
+        void (*fill) (PixelARGB*, PixelARGB, int);
+
+        void (*blendColourARGB)  (PixelARGB*,  PixelARGB, int);
+        void (*blendColourRGB)   (PixelRGB*,   PixelARGB, int);
+        void (*blendColourAlpha) (PixelAlpha*, PixelARGB, int);
+
+        void (*blendARGB)        (PixelARGB*,  const PixelARGB*,  int, uint32 extraAlpha);
+        void (*blendARGBToRGB)   (PixelRGB*,   const PixelARGB*,  int, uint32 extraAlpha);
+        void (*blendARGBToAlpha) (PixelAlpha*, const PixelARGB*,  int, uint32 extraAlpha);
+        void (*blendRGB)         (PixelRGB*,   const PixelRGB*,   int, uint32 extraAlpha);
+        void (*blendAlpha)       (PixelAlpha*, const PixelAlpha*, int, uint32 extraAlpha);
+    };
+
+    // The vector versions treat an RGB pixel as the first three bytes of an ARGB one,
+    // which isn't the case on every platform.
+    static bool isRGBLayoutSameAsARGB() noexcept
+    {
+        return (int) PixelRGB::indexR == (int) PixelARGB::indexR
+            && (int) PixelRGB::indexG == (int) PixelARGB::indexG
+            && (int) PixelRGB::indexB == (int) PixelARGB::indexB;
+    }
+
+    // PixelAlpha::blend (src, extraAlpha) adds one to its extraAlpha, where the other pixel types don't.
+    static inline uint32 getAlphaMultiplier (uint32 extraAlpha) noexcept    { return jmin ((uint32) fullAlpha, extraAlpha + 1); }
+
+    //==============================================================================
+    namespace Scalar
+    {
+        static void fill (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            while (--num >= 0)
+                (dest++)->set (colour);
+        }
+
+        template <class DestPixelType>
+        static void blendColour (DestPixelType* dest, PixelARGB colour, int num) noexcept
+        {
+            while (--num >= 0)
+                (dest++)->blend (colour);
+        }
+
+        template <class DestPixelType, class SrcPixelType>
+        static void blend (DestPixelType* dest, const SrcPixelType* src, int num, uint32 extraAlpha) noexcept
+        {
+            if (extraAlpha >= fullAlpha)
+            {
+                while (--num >= 0)
+                    (dest++)->blend (*src++);
+            }
+            else
+            {
+                while (--num >= 0)
+                    (dest++)->blend (*src++, extraAlpha);
+            }
+        }
+
+        static const Functions functions =
+        {
+            "Scalar",
+            fill,
+            blendColour<PixelARGB>, blendColour<PixelRGB>, blendColour<PixelAlpha>,
+            blend<PixelARGB, PixelARGB>, blend<PixelRGB, PixelARGB>, blend<PixelAlpha, PixelARGB>,
+            blend<PixelRGB, PixelRGB>, blend<PixelAlpha, PixelAlpha>
+        };
+    }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    //==============================================================================
+    /*  These all work on 8-bit channels that have been unpacked into 16-bit lanes, so that
+        multiplying by a 0-256 level and shifting down gives exactly the same rounding as the
+        pixel classes.
+    */
+    namespace SSE2
+    {
+        static forcedinline __m128i scale (__m128i values, __m128i levels) noexcept
+        {
+            return _mm_srli_epi16 (_mm_mullo_epi16 (values, levels), 8);
+        }
+
+        static forcedinline __m128i getInverseAlphas (__m128i unpackedARGB) noexcept
+        {
+            return _mm_sub_epi16 (_mm_set1_epi16 (256), _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (unpackedARGB, 0xff), 0xff));
+        }
+
+        // Blends four ARGB pixels onto four pixels with the same layout.
+        static forcedinline __m128i blendFourPixels (__m128i src, __m128i dest, __m128i multiplier) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i srcLo = scale (_mm_unpacklo_epi8 (src, zero), multiplier);
+            const __m128i srcHi = scale (_mm_unpackhi_epi8 (src, zero), multiplier);
+
+            return _mm_packus_epi16 (_mm_add_epi16 (srcLo, scale (_mm_unpacklo_epi8 (dest, zero), getInverseAlphas (srcLo))),
+                                     _mm_add_epi16 (srcHi, scale (_mm_unpackhi_epi8 (dest, zero), getInverseAlphas (srcHi))));
+        }
+
+        // Blends 16 bytes with a constant (pre-multiplied) colour pattern.
+        static forcedinline __m128i blendColourBytes (__m128i dest, __m128i colour, __m128i inverseAlpha) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+
+            return _mm_adds_epu8 (colour, _mm_packus_epi16 (scale (_mm_unpacklo_epi8 (dest, zero), inverseAlpha),
+                                                            scale (_mm_unpackhi_epi8 (dest, zero), inverseAlpha)));
+        }
+
+        // Blends 16 alpha values, scaled by a multiplier, onto 16 others.
+        static forcedinline __m128i blendAlphaBytes (__m128i src, __m128i dest, __m128i multiplier) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i v256 = _mm_set1_epi16 (256);
+            const __m128i srcLo = scale (_mm_unpacklo_epi8 (src, zero), multiplier);
+            const __m128i srcHi = scale (_mm_unpackhi_epi8 (src, zero), multiplier);
+
+            return _mm_packus_epi16 (_mm_add_epi16 (srcLo, scale (_mm_unpacklo_epi8 (dest, zero), _mm_sub_epi16 (v256, srcLo))),
+                                     _mm_add_epi16 (srcHi, scale (_mm_unpackhi_epi8 (dest, zero), _mm_sub_epi16 (v256, srcHi))));
+        }
+
+        static forcedinline __m128i load (const void* p) noexcept          { return _mm_loadu_si128 ((const __m128i*) p); }
+        static forcedinline void store (void* p, __m128i v) noexcept       { _mm_storeu_si128 ((__m128i*) p, v); }
+
+        // Spreads four packed RGB pixels out into the first three bytes of four 32-bit lanes.
+        static forcedinline __m128i loadFourRGBPixels (const PixelRGB* p) noexcept
+        {
+            int lastFour;
+            memcpy (&lastFour, reinterpret_cast<const uint8*> (p) + 8, sizeof (lastFour));
+
+            const __m128i v = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i*) p), _mm_cvtsi32_si128 (lastFour));
+
+            return _mm_or_si128 (_mm_or_si128 (_mm_and_si128 (v,                     _mm_setr_epi32 (0xffffff, 0, 0, 0)),
+                                               _mm_and_si128 (_mm_slli_si128 (v, 1), _mm_setr_epi32 (0, 0xffffff, 0, 0))),
+                                 _mm_or_si128 (_mm_and_si128 (_mm_slli_si128 (v, 2), _mm_setr_epi32 (0, 0, 0xffffff, 0)),
+                                               _mm_and_si128 (_mm_slli_si128 (v, 3), _mm_setr_epi32 (0, 0, 0, 0xffffff))));
+        }
+
+        static forcedinline void storeFourRGBPixels (PixelRGB* p, __m128i v) noexcept
+        {
+            v = _mm_or_si128 (_mm_or_si128 (_mm_and_si128 (v, _mm_setr_epi32 (0xffffff, 0, 0, 0)),
+                                            _mm_srli_si128 (_mm_and_si128 (v, _mm_setr_epi32 (0, 0xffffff, 0, 0)), 1)),
+                              _mm_or_si128 (_mm_srli_si128 (_mm_and_si128 (v, _mm_setr_epi32 (0, 0, 0xffffff, 0)), 2),
+                                            _mm_srli_si128 (_mm_and_si128 (v, _mm_setr_epi32 (0, 0, 0, 0xffffff)), 3)));
+
+            _mm_storel_epi64 ((__m128i*) p, v);
+
+            const int lastFour = _mm_cvtsi128_si32 (_mm_srli_si128 (v, 8));
+            memcpy (reinterpret_cast<uint8*> (p) + 8, &lastFour, sizeof (lastFour));
+        }
+
+        //==============================================================================
+        static void fill (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            const __m128i c = _mm_set1_epi32 ((int) colour.getNativeARGB());
+
+            for (; num >= 4; num -= 4, dest += 4)
+                store (dest, c);
+
+            Scalar::fill (dest, colour, num);
+        }
+
+        static void blendColourARGB (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            const __m128i c = _mm_set1_epi32 ((int) colour.getNativeARGB());
+            const __m128i inverseAlpha = _mm_set1_epi16 ((short) (256 - colour.getAlpha()));
+
+            for (; num >= 4; num -= 4, dest += 4)
+                store (dest, blendColourBytes (load (dest), c, inverseAlpha));
+
+            Scalar::blendColour (dest, colour, num);
+        }
+
+        static void blendColourRGB (PixelRGB* dest, PixelARGB colour, int num) noexcept
+        {
+            PixelRGB pattern[16];
+
+            for (int i = 0; i < 16; ++i)
+                pattern[i].set (colour);
+
+            const uint8* p = reinterpret_cast<const uint8*> (pattern);
+            const __m128i c0 = load (p), c1 = load (p + 16), c2 = load (p + 32);
+            const __m128i inverseAlpha = _mm_set1_epi16 ((short) (256 - colour.getAlpha()));
+
+            for (; num >= 16; num -= 16, dest += 16)
+            {
+                uint8* d = reinterpret_cast<uint8*> (dest);
+                store (d,      blendColourBytes (load (d),      c0, inverseAlpha));
+                store (d + 16, blendColourBytes (load (d + 16), c1, inverseAlpha));
+                store (d + 32, blendColourBytes (load (d + 32), c2, inverseAlpha));
+            }
+
+            Scalar::blendColour (dest, colour, num);
+        }
+
+        static void blendColourAlpha (PixelAlpha* dest, PixelARGB colour, int num) noexcept
+        {
+            const __m128i c = _mm_set1_epi8 ((char) colour.getAlpha());
+            const __m128i inverseAlpha = _mm_set1_epi16 ((short) (256 - colour.getAlpha()));
+
+            for (; num >= 16; num -= 16, dest += 16)
+                store (dest, blendColourBytes (load (dest), c, inverseAlpha));
+
+            Scalar::blendColour (dest, colour, num);
+        }
+
+        static void blendARGB (PixelARGB* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const __m128i multiplier = _mm_set1_epi16 ((short) extraAlpha);
+            const __m128i allBitsSet = _mm_cmpeq_epi32 (multiplier, multiplier);
+
+            for (; num >= 4; num -= 4, dest += 4, src += 4)
+            {
+                const __m128i s = load (src);
+
+                if (extraAlpha >= fullAlpha)
+                {
+                    // Image pixels are very often either fully opaque or fully transparent..
+                    if ((_mm_movemask_epi8 (_mm_cmpeq_epi8 (s, allBitsSet)) & 0x8888) == 0x8888)
+                    {
+                        store (dest, s);
+                        continue;
+                    }
+
+                    if (_mm_movemask_epi8 (_mm_cmpeq_epi8 (s, _mm_setzero_si128())) == 0xffff)
+                        continue;
+                }
+
+                store (dest, blendFourPixels (s, load (dest), multiplier));
+            }
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static void blendARGBToRGB (PixelRGB* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const __m128i multiplier = _mm_set1_epi16 ((short) extraAlpha);
+
+            for (; num >= 4; num -= 4, dest += 4, src += 4)
+                storeFourRGBPixels (dest, blendFourPixels (load (src), loadFourRGBPixels (dest), multiplier));
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static void blendARGBToAlpha (PixelAlpha* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i multiplier = _mm_set1_epi16 ((short) getAlphaMultiplier (extraAlpha));
+
+            for (; num >= 8; num -= 8, dest += 8, src += 8)
+            {
+                const __m128i s = scale (_mm_packs_epi32 (_mm_srli_epi32 (load (src), 24),
+                                                          _mm_srli_epi32 (load (src + 4), 24)), multiplier);
+                const __m128i d = _mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i*) dest), zero);
+                const __m128i result = _mm_add_epi16 (s, scale (d, _mm_sub_epi16 (_mm_set1_epi16 (256), s)));
+
+                _mm_storel_epi64 ((__m128i*) dest, _mm_packus_epi16 (result, zero));
+            }
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static void blendRGB (PixelRGB* dest, const PixelRGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            if (extraAlpha >= fullAlpha)
+            {
+                memcpy (reinterpret_cast<uint8*> (dest), src, (size_t) num * sizeof (PixelRGB));
+                return;
+            }
+
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i multiplier = _mm_set1_epi16 ((short) extraAlpha);
+            const __m128i inverseAlpha = _mm_set1_epi16 ((short) (256 - ((255 * extraAlpha) >> 8)));
+
+            for (; num >= 16; num -= 16, dest += 16, src += 16)
+            {
+                for (int i = 0; i < 48; i += 16)
+                {
+                    uint8* d = reinterpret_cast<uint8*> (dest) + i;
+                    const __m128i s = load (reinterpret_cast<const uint8*> (src) + i);
+                    const __m128i dv = load (d);
+
+                    store (d, _mm_packus_epi16 (_mm_add_epi16 (scale (_mm_unpacklo_epi8 (s, zero), multiplier),
+                                                               scale (_mm_unpacklo_epi8 (dv, zero), inverseAlpha)),
+                                                _mm_add_epi16 (scale (_mm_unpackhi_epi8 (s, zero), multiplier),
+                                                               scale (_mm_unpackhi_epi8 (dv, zero), inverseAlpha))));
+                }
+            }
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static void blendAlpha (PixelAlpha* dest, const PixelAlpha* src, int num, uint32 extraAlpha) noexcept
+        {
+            const __m128i multiplier = _mm_set1_epi16 ((short) getAlphaMultiplier (extraAlpha));
+
+            for (; num >= 16; num -= 16, dest += 16, src += 16)
+                store (dest, blendAlphaBytes (load (src), load (dest), multiplier));
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static const Functions functions =
+        {
+            "SSE2",
+            fill,
+            blendColourARGB, blendColourRGB, blendColourAlpha,
+            blendARGB, blendARGBToRGB, blendARGBToAlpha, blendRGB, blendAlpha
+        };
+    }
+
+   #if JUCE_USE_AVX2_INTRINSICS
+    //==============================================================================
+    /*  The AVX2 instructions work on two independent 128-bit halves, so the same
+        unpack/pack tricks as the SSE2 code can be used on twice as many pixels. The
+        short tails and the RGB/alpha conversions are left to the SSE2 code, after clearing
+        the upper halves of the registers to avoid the penalty for mixing the two.
+    */
+    namespace AVX2
+    {
+       #if JUCE_GCC || JUCE_CLANG
+        #define JUCE_AVX2_FUNCTION __attribute__ ((target ("avx2")))
+       #else
+        #define JUCE_AVX2_FUNCTION
+       #endif
+
+        static forcedinline JUCE_AVX2_FUNCTION __m256i scale (__m256i values, __m256i levels) noexcept
+        {
+            return _mm256_srli_epi16 (_mm256_mullo_epi16 (values, levels), 8);
+        }
+
+        static forcedinline JUCE_AVX2_FUNCTION __m256i load (const void* p) noexcept       { return _mm256_loadu_si256 ((const __m256i*) p); }
+        static forcedinline JUCE_AVX2_FUNCTION void store (void* p, __m256i v) noexcept    { _mm256_storeu_si256 ((__m256i*) p, v); }
+
+        static forcedinline JUCE_AVX2_FUNCTION __m256i blendColourBytes (__m256i dest, __m256i colour, __m256i inverseAlpha) noexcept
+        {
+            const __m256i zero = _mm256_setzero_si256();
+
+            return _mm256_adds_epu8 (colour, _mm256_packus_epi16 (scale (_mm256_unpacklo_epi8 (dest, zero), inverseAlpha),
+                                                                  scale (_mm256_unpackhi_epi8 (dest, zero), inverseAlpha)));
+        }
+
+        //==============================================================================
+        static JUCE_AVX2_FUNCTION void fill (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            const __m256i c = _mm256_set1_epi32 ((int) colour.getNativeARGB());
+
+            for (; num >= 8; num -= 8, dest += 8)
+                store (dest, c);
+
+            _mm256_zeroupper();
+            SSE2::fill (dest, colour, num);
+        }
+
+        static JUCE_AVX2_FUNCTION void blendColourARGB (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            const __m256i c = _mm256_set1_epi32 ((int) colour.getNativeARGB());
+            const __m256i inverseAlpha = _mm256_set1_epi16 ((short) (256 - colour.getAlpha()));
+
+            for (; num >= 8; num -= 8, dest += 8)
+                store (dest, blendColourBytes (load (dest), c, inverseAlpha));
+
+            _mm256_zeroupper();
+            SSE2::blendColourARGB (dest, colour, num);
+        }
+
+        static JUCE_AVX2_FUNCTION void blendColourRGB (PixelRGB* dest, PixelARGB colour, int num) noexcept
+        {
+            PixelRGB pattern[32];
+
+            for (int i = 0; i < 32; ++i)
+                pattern[i].set (colour);
+
+            const uint8* p = reinterpret_cast<const uint8*> (pattern);
+            const __m256i c0 = load (p), c1 = load (p + 32), c2 = load (p + 64);
+            const __m256i inverseAlpha = _mm256_set1_epi16 ((short) (256 - colour.getAlpha()));
+
+            for (; num >= 32; num -= 32, dest += 32)
+            {
+                uint8* d = reinterpret_cast<uint8*> (dest);
+                store (d,      blendColourBytes (load (d),      c0, inverseAlpha));
+                store (d + 32, blendColourBytes (load (d + 32), c1, inverseAlpha));
+                store (d + 64, blendColourBytes (load (d + 64), c2, inverseAlpha));
+            }
+
+            _mm256_zeroupper();
+            SSE2::blendColourRGB (dest, colour, num);
+        }
+
+        static JUCE_AVX2_FUNCTION void blendColourAlpha (PixelAlpha* dest, PixelARGB colour, int num) noexcept
+        {
+            const __m256i c = _mm256_set1_epi8 ((char) colour.getAlpha());
+            const __m256i inverseAlpha = _mm256_set1_epi16 ((short) (256 - colour.getAlpha()));
+
+            for (; num >= 32; num -= 32, dest += 32)
+                store (dest, blendColourBytes (load (dest), c, inverseAlpha));
+
+            _mm256_zeroupper();
+            SSE2::blendColourAlpha (dest, colour, num);
+        }
+
+        static JUCE_AVX2_FUNCTION void blendARGB (PixelARGB* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i v256 = _mm256_set1_epi16 (256);
+            const __m256i multiplier = _mm256_set1_epi16 ((short) extraAlpha);
+            const __m256i alphaMask = _mm256_set1_epi32 ((int) 0xff000000);
+
+            for (; num >= 8; num -= 8, dest += 8, src += 8)
+            {
+                const __m256i s = load (src);
+
+                if (extraAlpha >= fullAlpha)
+                {
+                    if (_mm256_testc_si256 (s, alphaMask))  // all opaque
+                    {
+                        store (dest, s);
+                        continue;
+                    }
+
+                    if (_mm256_testz_si256 (s, s))  // all transparent
+                        continue;
+                }
+
+                const __m256i d = load (dest);
+                const __m256i srcLo = scale (_mm256_unpacklo_epi8 (s, zero), multiplier);
+                const __m256i srcHi = scale (_mm256_unpackhi_epi8 (s, zero), multiplier);
+                const __m256i invLo = _mm256_sub_epi16 (v256, _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (srcLo, 0xff), 0xff));
+                const __m256i invHi = _mm256_sub_epi16 (v256, _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (srcHi, 0xff), 0xff));
+
+                store (dest, _mm256_packus_epi16 (_mm256_add_epi16 (srcLo, scale (_mm256_unpacklo_epi8 (d, zero), invLo)),
+                                                  _mm256_add_epi16 (srcHi, scale (_mm256_unpackhi_epi8 (d, zero), invHi))));
+            }
+
+            _mm256_zeroupper();
+            SSE2::blendARGB (dest, src, num, extraAlpha);
+        }
+
+        static JUCE_AVX2_FUNCTION void blendAlpha (PixelAlpha* dest, const PixelAlpha* src, int num, uint32 extraAlpha) noexcept
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i v256 = _mm256_set1_epi16 (256);
+            const __m256i multiplier = _mm256_set1_epi16 ((short) getAlphaMultiplier (extraAlpha));
+
+            for (; num >= 32; num -= 32, dest += 32, src += 32)
+            {
+                const __m256i s = load (src), d = load (dest);
+                const __m256i srcLo = scale (_mm256_unpacklo_epi8 (s, zero), multiplier);
+                const __m256i srcHi = scale (_mm256_unpackhi_epi8 (s, zero), multiplier);
+
+                store (dest, _mm256_packus_epi16 (_mm256_add_epi16 (srcLo, scale (_mm256_unpacklo_epi8 (d, zero), _mm256_sub_epi16 (v256, srcLo))),
+                                                  _mm256_add_epi16 (srcHi, scale (_mm256_unpackhi_epi8 (d, zero), _mm256_sub_epi16 (v256, srcHi)))));
+            }
+
+            _mm256_zeroupper();
+            SSE2::blendAlpha (dest, src, num, extraAlpha);
+        }
+
+        static const Functions functions =
+        {
+            "AVX2",
+            fill,
+            blendColourARGB, blendColourRGB, blendColourAlpha,
+            blendARGB, SSE2::blendARGBToRGB, SSE2::blendARGBToAlpha, SSE2::blendRGB, blendAlpha
+        };
+
+        #undef JUCE_AVX2_FUNCTION
+    }
+   #endif
+   #endif
+
+   #if JUCE_USE_ARM_NEON
+    //==============================================================================
+    /*  NEON can load and store interleaved pixels as separate planes of bytes, so
+        each channel is simply handled as eight 16-bit lanes at a time.
+    */
+    namespace NEON
+    {
+        static forcedinline uint16x8_t scale (uint8x8_t values, uint16x8_t levels) noexcept
+        {
+            return vshrq_n_u16 (vmulq_u16 (vmovl_u8 (values), levels), 8);
+        }
+
+        static forcedinline uint8x8_t blendLanes (uint16x8_t src, uint8x8_t dest, uint16x8_t inverseAlpha) noexcept
+        {
+            return vqmovn_u16 (vaddq_u16 (src, scale (dest, inverseAlpha)));
+        }
+
+        static forcedinline uint8x16_t blendPlane (uint8x16_t src, uint8x16_t dest, uint16x8_t multiplier,
+                                                   uint16x8_t inverseAlphaLo, uint16x8_t inverseAlphaHi) noexcept
+        {
+            return vcombine_u8 (blendLanes (scale (vget_low_u8  (src), multiplier), vget_low_u8  (dest), inverseAlphaLo),
+                                blendLanes (scale (vget_high_u8 (src), multiplier), vget_high_u8 (dest), inverseAlphaHi));
+        }
+
+        static forcedinline uint16x8_t getInverseAlphas (uint8x8_t srcAlphas, uint16x8_t multiplier) noexcept
+        {
+            return vsubq_u16 (vdupq_n_u16 (256), scale (srcAlphas, multiplier));
+        }
+
+        static forcedinline uint8x16_t blendColourPlane (uint8x16_t dest, uint8x16_t colour, uint16x8_t inverseAlpha) noexcept
+        {
+            return vqaddq_u8 (colour, vcombine_u8 (vmovn_u16 (scale (vget_low_u8  (dest), inverseAlpha)),
+                                                   vmovn_u16 (scale (vget_high_u8 (dest), inverseAlpha))));
+        }
+
+        // Blends the colour channels of 16 ARGB pixels onto 16 pixels of a type with the given channel indexes.
+        template <class DestPixelType, class DestPlanes>
+        static forcedinline void blendColourChannels (const uint8x16x4_t& src, DestPlanes& dest, uint16x8_t multiplier,
+                                                      uint16x8_t inverseAlphaLo, uint16x8_t inverseAlphaHi) noexcept
+        {
+            dest.val[DestPixelType::indexR] = blendPlane (src.val[PixelARGB::indexR], dest.val[DestPixelType::indexR], multiplier, inverseAlphaLo, inverseAlphaHi);
+            dest.val[DestPixelType::indexG] = blendPlane (src.val[PixelARGB::indexG], dest.val[DestPixelType::indexG], multiplier, inverseAlphaLo, inverseAlphaHi);
+            dest.val[DestPixelType::indexB] = blendPlane (src.val[PixelARGB::indexB], dest.val[DestPixelType::indexB], multiplier, inverseAlphaLo, inverseAlphaHi);
+        }
+
+        //==============================================================================
+        static void fill (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            const uint32x4_t c = vdupq_n_u32 (colour.getNativeARGB());
+
+            for (; num >= 4; num -= 4, dest += 4)
+                vst1q_u32 ((uint32*) dest, c);
+
+            Scalar::fill (dest, colour, num);
+        }
+
+        static void blendColourARGB (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            const uint8x16_t c = vreinterpretq_u8_u32 (vdupq_n_u32 (colour.getNativeARGB()));
+            const uint16x8_t inverseAlpha = vdupq_n_u16 ((uint16) (256 - colour.getAlpha()));
+
+            for (; num >= 4; num -= 4, dest += 4)
+                vst1q_u8 ((uint8*) dest, blendColourPlane (vld1q_u8 ((const uint8*) dest), c, inverseAlpha));
+
+            Scalar::blendColour (dest, colour, num);
+        }
+
+        static void blendColourRGB (PixelRGB* dest, PixelARGB colour, int num) noexcept
+        {
+            PixelRGB pattern;
+            pattern.set (colour);
+
+            const uint8* p = reinterpret_cast<const uint8*> (&pattern);
+            const uint8x16_t c0 = vdupq_n_u8 (p[0]), c1 = vdupq_n_u8 (p[1]), c2 = vdupq_n_u8 (p[2]);
+            const uint16x8_t inverseAlpha = vdupq_n_u16 ((uint16) (256 - colour.getAlpha()));
+
+            for (; num >= 16; num -= 16, dest += 16)
+            {
+                uint8x16x3_t d = vld3q_u8 ((const uint8*) dest);
+                d.val[0] = blendColourPlane (d.val[0], c0, inverseAlpha);
+                d.val[1] = blendColourPlane (d.val[1], c1, inverseAlpha);
+                d.val[2] = blendColourPlane (d.val[2], c2, inverseAlpha);
+                vst3q_u8 ((uint8*) dest, d);
+            }
+
+            Scalar::blendColour (dest, colour, num);
+        }
+
+        static void blendColourAlpha (PixelAlpha* dest, PixelARGB colour, int num) noexcept
+        {
+            const uint8x16_t c = vdupq_n_u8 (colour.getAlpha());
+            const uint16x8_t inverseAlpha = vdupq_n_u16 ((uint16) (256 - colour.getAlpha()));
+
+            for (; num >= 16; num -= 16, dest += 16)
+                vst1q_u8 ((uint8*) dest, blendColourPlane (vld1q_u8 ((const uint8*) dest), c, inverseAlpha));
+
+            Scalar::blendColour (dest, colour, num);
+        }
+
+        static void blendARGB (PixelARGB* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const uint16x8_t multiplier = vdupq_n_u16 ((uint16) extraAlpha);
+
+            for (; num >= 16; num -= 16, dest += 16, src += 16)
+            {
+                const uint8x16x4_t s = vld4q_u8 ((const uint8*) src);
+                uint8x16x4_t d = vld4q_u8 ((const uint8*) dest);
+
+                const uint8x16_t srcAlpha = s.val[PixelARGB::indexA];
+                const uint16x8_t inverseAlphaLo = getInverseAlphas (vget_low_u8  (srcAlpha), multiplier);
+                const uint16x8_t inverseAlphaHi = getInverseAlphas (vget_high_u8 (srcAlpha), multiplier);
+
+                blendColourChannels<PixelARGB> (s, d, multiplier, inverseAlphaLo, inverseAlphaHi);
+                d.val[PixelARGB::indexA] = blendPlane (srcAlpha, d.val[PixelARGB::indexA], multiplier, inverseAlphaLo, inverseAlphaHi);
+
+                vst4q_u8 ((uint8*) dest, d);
+            }
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static void blendARGBToRGB (PixelRGB* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const uint16x8_t multiplier = vdupq_n_u16 ((uint16) extraAlpha);
+
+            for (; num >= 16; num -= 16, dest += 16, src += 16)
+            {
+                const uint8x16x4_t s = vld4q_u8 ((const uint8*) src);
+                uint8x16x3_t d = vld3q_u8 ((const uint8*) dest);
+
+                blendColourChannels<PixelRGB> (s, d, multiplier,
+                                               getInverseAlphas (vget_low_u8  (s.val[PixelARGB::indexA]), multiplier),
+                                               getInverseAlphas (vget_high_u8 (s.val[PixelARGB::indexA]), multiplier));
+                vst3q_u8 ((uint8*) dest, d);
+            }
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static void blendAlphaPlane (uint8* dest, uint8x16_t src, uint16x8_t multiplier) noexcept
+        {
+            const uint16x8_t v256 = vdupq_n_u16 (256);
+            const uint16x8_t srcLo = scale (vget_low_u8  (src), multiplier);
+            const uint16x8_t srcHi = scale (vget_high_u8 (src), multiplier);
+            const uint8x16_t d = vld1q_u8 (dest);
+
+            vst1q_u8 (dest, vcombine_u8 (blendLanes (srcLo, vget_low_u8  (d), vsubq_u16 (v256, srcLo)),
+                                         blendLanes (srcHi, vget_high_u8 (d), vsubq_u16 (v256, srcHi))));
+        }
+
+        static void blendARGBToAlpha (PixelAlpha* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const uint16x8_t multiplier = vdupq_n_u16 ((uint16) getAlphaMultiplier (extraAlpha));
+
+            for (; num >= 16; num -= 16, dest += 16, src += 16)
+                blendAlphaPlane ((uint8*) dest, vld4q_u8 ((const uint8*) src).val[PixelARGB::indexA], multiplier);
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static void blendRGB (PixelRGB* dest, const PixelRGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            if (extraAlpha >= fullAlpha)
+            {
+                memcpy (reinterpret_cast<uint8*> (dest), src, (size_t) num * sizeof (PixelRGB));
+                return;
+            }
+
+            const uint16x8_t multiplier = vdupq_n_u16 ((uint16) extraAlpha);
+            const uint16x8_t inverseAlpha = vdupq_n_u16 ((uint16) (256 - ((255 * extraAlpha) >> 8)));
+
+            for (; num >= 16; num -= 16, dest += 16, src += 16)
+            {
+                const uint8x16x3_t s = vld3q_u8 ((const uint8*) src);
+                uint8x16x3_t d = vld3q_u8 ((const uint8*) dest);
+
+                for (int i = 0; i < 3; ++i)
+                    d.val[i] = blendPlane (s.val[i], d.val[i], multiplier, inverseAlpha, inverseAlpha);
+
+                vst3q_u8 ((uint8*) dest, d);
+            }
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static void blendAlpha (PixelAlpha* dest, const PixelAlpha* src, int num, uint32 extraAlpha) noexcept
+        {
+            const uint16x8_t multiplier = vdupq_n_u16 ((uint16) getAlphaMultiplier (extraAlpha));
+
+            for (; num >= 16; num -= 16, dest += 16, src += 16)
+                blendAlphaPlane ((uint8*) dest, vld1q_u8 ((const uint8*) src), multiplier);
+
+            Scalar::blend (dest, src, num, extraAlpha);
+        }
+
+        static const Functions functions =
+        {
+            "NEON",
+            fill,
+            blendColourARGB, blendColourRGB, blendColourAlpha,
+            blendARGB, blendARGBToRGB, blendARGBToAlpha, blendRGB, blendAlpha
+        };
+    }
+   #endif
+
+    //==============================================================================
+    static void getAllAvailableFunctions (Array<Functions>& results)
+    {
+        results.add (Scalar::functions);
+
+       #if JUCE_USE_SSE_INTRINSICS
+        results.add (SSE2::functions);
+
+        if (! isRGBLayoutSameAsARGB())
+            results.getReference (results.size() - 1).blendARGBToRGB = Scalar::blend<PixelRGB, PixelARGB>;
+
+        #if JUCE_USE_AVX2_INTRINSICS
+         if (SystemStats::hasAVX2())
+         {
+             results.add (AVX2::functions);
+
+             if (! isRGBLayoutSameAsARGB())
+                 results.getReference (results.size() - 1).blendARGBToRGB = Scalar::blend<PixelRGB, PixelARGB>;
+         }
+        #endif
+       #endif
+
+       #if JUCE_USE_ARM_NEON
+        results.add (NEON::functions);
+       #endif
+    }
+
+    static Functions getBestAvailableFunctions()
+    {
+        Array<Functions> all;
+        getAllAvailableFunctions (all);
+        return all.getLast();
+    }
+
+    static Functions& getActiveFunctions() noexcept
+    {
+        static Functions functions (getBestAvailableFunctions());
+        return functions;
+    }
+}
+
+//==============================================================================
+namespace SpanKernels = PixelSpanKernelImplementations;
+
+void PixelSpanKernels::fill  (PixelARGB* d, PixelARGB c, int num) noexcept    { SpanKernels::getActiveFunctions().fill (d, c, num); }
+void PixelSpanKernels::blend (PixelARGB* d, PixelARGB c, int num) noexcept    { SpanKernels::getActiveFunctions().blendColourARGB (d, c, num); }
+void PixelSpanKernels::blend (PixelRGB* d, PixelARGB c, int num) noexcept     { SpanKernels::getActiveFunctions().blendColourRGB (d, c, num); }
+void PixelSpanKernels::blend (PixelAlpha* d, PixelARGB c, int num) noexcept   { SpanKernels::getActiveFunctions().blendColourAlpha (d, c, num); }
+
+void PixelSpanKernels::blend (PixelARGB* d, const PixelARGB* s, int num) noexcept                { SpanKernels::getActiveFunctions().blendARGB (d, s, num, SpanKernels::fullAlpha); }
+void PixelSpanKernels::blend (PixelARGB* d, const PixelARGB* s, int num, uint32 alpha) noexcept  { SpanKernels::getActiveFunctions().blendARGB (d, s, num, alpha); }
+void PixelSpanKernels::blend (PixelRGB* d, const PixelARGB* s, int num) noexcept                 { SpanKernels::getActiveFunctions().blendARGBToRGB (d, s, num, SpanKernels::fullAlpha); }
+void PixelSpanKernels::blend (PixelRGB* d, const PixelARGB* s, int num, uint32 alpha) noexcept   { SpanKernels::getActiveFunctions().blendARGBToRGB (d, s, num, alpha); }
+void PixelSpanKernels::blend (PixelAlpha* d, const PixelARGB* s, int num) noexcept               { SpanKernels::getActiveFunctions().blendARGBToAlpha (d, s, num, SpanKernels::fullAlpha); }
+void PixelSpanKernels::blend (PixelAlpha* d, const PixelARGB* s, int num, uint32 alpha) noexcept { SpanKernels::getActiveFunctions().blendARGBToAlpha (d, s, num, alpha); }
+void PixelSpanKernels::blend (PixelRGB* d, const PixelRGB* s, int num, uint32 alpha) noexcept    { SpanKernels::getActiveFunctions().blendRGB (d, s, num, alpha); }
+void PixelSpanKernels::blend (PixelAlpha* d, const PixelAlpha* s, int num) noexcept              { SpanKernels::getActiveFunctions().blendAlpha (d, s, num, SpanKernels::fullAlpha); }
+void PixelSpanKernels::blend (PixelAlpha* d, const PixelAlpha* s, int num, uint32 alpha) noexcept { SpanKernels::getActiveFunctions().blendAlpha (d, s, num, alpha); }
+
+const char* PixelSpanKernels::getImplementationName() noexcept   { return SpanKernels::getActiveFunctions().name; }
+
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PixelSpanKernelsTests  : public UnitTest
+{
+public:
+    PixelSpanKernelsTests() : UnitTest ("PixelSpanKernels") {}
+
+    void runTest() override
+    {
+        using namespace RenderingHelpers::PixelSpanKernelImplementations;
+
+        Array<Functions> implementations;
+        getAllAvailableFunctions (implementations);
+
+        for (int i = 0; i < implementations.size(); ++i)
+        {
+            beginTest (String ("Matches the pixel classes: ") + implementations.getReference (i).name);
+            Random r (getRandom());
+
+            for (int iteration = 0; iteration < 10; ++iteration)
+            {
+                const int extraAlphas[] = { 0, 1, 127, 254, 255, r.nextInt (256) };
+
+                for (int num = 0; num < 70; ++num)
+                    for (int j = 0; j < numElementsInArray (extraAlphas); ++j)
+                        checkSpans (implementations.getReference (i), r, num, (uint32) extraAlphas[j]);
+
+                checkSpans (implementations.getReference (i), r, 1000 + r.nextInt (100), (uint32) r.nextInt (256));
+            }
+        }
+
+        beginTest ("Rendering is identical with every implementation");
+        {
+            Functions& active = getActiveFunctions();
+            const Functions original (active);
+
+            const Image::PixelFormat formats[] = { Image::ARGB, Image::RGB, Image::SingleChannel };
+
+            for (int f = 0; f < numElementsInArray (formats); ++f)
+            {
+                active = Scalar::functions;
+                const Image expected (renderTestScene (formats[f]));
+
+                for (int i = 0; i < implementations.size(); ++i)
+                {
+                    active = implementations.getReference (i);
+                    expect (areIdentical (expected, renderTestScene (formats[f])),
+                            String (implementations.getReference (i).name) + " differs with format " + String ((int) formats[f]));
+                }
+            }
+
+            active = original;
+        }
+    }
+
+private:
+    typedef RenderingHelpers::PixelSpanKernelImplementations::Functions Functions;
+
+    template <class PixelType>
+    struct Buffer
+    {
+        Buffer (Random& r, int num) : data ((size_t) num + 4), pixels (data + r.nextInt (4)), size (num)
+        {
+            uint8* bytes = reinterpret_cast<uint8*> (data.getData());
+
+            for (size_t i = 0; i < (num + 4) * sizeof (PixelType); ++i)
+                bytes[i] = (uint8) r.nextInt (256);
+
+            // Make some runs of pixels opaque or transparent, like real images
+            if (sizeof (PixelType) == sizeof (PixelARGB) && r.nextBool())
+            {
+                const int start = r.nextInt (num + 1), end = start + r.nextInt (num + 1 - start);
+                const bool opaque = r.nextBool();
+
+                for (int i = start; i < end; ++i)
+                    reinterpret_cast<PixelARGB*> (pixels)[i].setARGB (opaque ? 255 : 0, opaque ? (uint8) i : 0, 0, 0);
+            }
+        }
+
+        Buffer (const Buffer& other) : data ((size_t) other.size + 4), pixels (data + (other.pixels - other.data)), size (other.size)
+        {
+            memcpy (data, other.data, ((size_t) size + 4) * sizeof (PixelType));
+        }
+
+        bool operator== (const Buffer& other) const noexcept
+        {
+            return memcmp (data, other.data, ((size_t) size + 4) * sizeof (PixelType)) == 0;
+        }
+
+        HeapBlock<PixelType> data;
+        PixelType* pixels;
+        int size;
+    };
+
+    template <class DestPixelType, class SrcPixelType>
+    void checkBlend (void (*function) (DestPixelType*, const SrcPixelType*, int, uint32),
+                     Random& r, int num, uint32 extraAlpha, const char* name)
+    {
+        const Buffer<SrcPixelType> src (r, num);
+        Buffer<DestPixelType> dest (r, num), expected (dest);
+
+        for (int i = 0; i < num; ++i)
+            expected.pixels[i].blend (src.pixels[i], extraAlpha);
+
+        function (dest.pixels, src.pixels, num, extraAlpha);
+        expect (dest == expected, String (name) + " with extra alpha, size " + String (num));
+
+        Buffer<DestPixelType> dest2 (r, num), expected2 (dest2);
+
+        for (int i = 0; i < num; ++i)
+            expected2.pixels[i].blend (src.pixels[i]);
+
+        function (dest2.pixels, src.pixels, num, RenderingHelpers::PixelSpanKernelImplementations::fullAlpha);
+        expect (dest2 == expected2, String (name) + ", size " + String (num));
+    }
+
+    template <class DestPixelType>
+    void checkBlendColour (void (*function) (DestPixelType*, PixelARGB, int),
+                           Random& r, int num, const char* name)
+    {
+        PixelARGB colour ((uint8) r.nextInt (256), (uint8) r.nextInt (256), (uint8) r.nextInt (256), (uint8) r.nextInt (256));
+
+        if (r.nextBool())
+            colour.setAlpha (r.nextBool() ? 0 : 255);
+
+        Buffer<DestPixelType> dest (r, num), expected (dest);
+
+        for (int i = 0; i < num; ++i)
+            expected.pixels[i].blend (colour);
+
+        function (dest.pixels, colour, num);
+        expect (dest == expected, String (name) + ", size " + String (num));
+    }
+
+    void checkSpans (const Functions& functions, Random& r, int num, uint32 extraAlpha)
+    {
+        {
+            const PixelARGB colour ((uint8) r.nextInt (256), (uint8) r.nextInt (256), (uint8) r.nextInt (256), (uint8) r.nextInt (256));
+            Buffer<PixelARGB> dest (r, num), expected (dest);
+
+            for (int i = 0; i < num; ++i)
+                expected.pixels[i].set (colour);
+
+            functions.fill (dest.pixels, colour, num);
+            expect (dest == expected, "fill, size " + String (num));
+        }
+
+        checkBlendColour (functions.blendColourARGB,  r, num, "ARGB colour");
+        checkBlendColour (functions.blendColourRGB,   r, num, "RGB colour");
+        checkBlendColour (functions.blendColourAlpha, r, num, "Alpha colour");
+
+        checkBlend (functions.blendARGB,        r, num, extraAlpha, "ARGB onto ARGB");
+        checkBlend (functions.blendARGBToRGB,   r, num, extraAlpha, "ARGB onto RGB");
+        checkBlend (functions.blendARGBToAlpha, r, num, extraAlpha, "ARGB onto alpha");
+        checkBlend (functions.blendRGB,         r, num, extraAlpha, "RGB onto RGB");
+        checkBlend (functions.blendAlpha,       r, num, extraAlpha, "Alpha onto alpha");
+    }
+
+    //==============================================================================
+    static Image createSourceImage (Image::PixelFormat format, int w, int h)
+    {
+        Image image (format, w, h, true);
+        Graphics g (image);
+        g.setGradientFill (ColourGradient (Colours::red.withAlpha (0.8f), 0.0f, 0.0f,
+                                           Colours::blue.withAlpha (0.3f), (float) w, (float) h, false));
+        g.fillEllipse (0.0f, 0.0f, (float) w, (float) h);
+        g.setColour (Colours::green);
+        g.fillRect (w / 4, h / 4, w / 2, h / 8);
+        return image;
+    }
+
+    static Image renderTestScene (Image::PixelFormat format)
+    {
+        Image image (format, 211, 157, false);
+        image.clear (image.getBounds(), Colour (0xff336699));
+
+        Graphics g (image);
+
+        g.setColour (Colours::orange.withAlpha (0.6f));
+        g.fillRect (3, 4, 150, 60);
+        g.fillEllipse (40.5f, 30.2f, 120.0f, 90.0f);
+
+        g.setColour (Colours::white);
+        g.fillRect (100, 100, 90, 40);
+        g.drawLine (0.0f, 150.0f, 210.0f, 5.0f, 3.5f);
+
+        g.setGradientFill (ColourGradient (Colours::yellow, 10.0f, 10.0f, Colours::transparentBlack, 200.0f, 140.0f, false));
+        g.fillRoundedRectangle (20.0f, 60.0f, 180.0f, 50.0f, 8.0f);
+
+        ColourGradient radial (Colours::cyan, 100.0f, 80.0f, Colours::purple.withAlpha (0.2f), 160.0f, 80.0f, true);
+        radial.addColour (0.5, Colours::black.withAlpha (0.7f));
+        g.setGradientFill (radial);
+        g.setOpacity (0.7f);
+        g.fillEllipse (50.0f, 20.0f, 120.0f, 120.0f);
+
+        const Image::PixelFormat sourceFormats[] = { Image::ARGB, Image::RGB, Image::SingleChannel };
+
+        for (int i = 0; i < numElementsInArray (sourceFormats); ++i)
+        {
+            const Image source (createSourceImage (sourceFormats[i], 64, 48));
+
+            g.setOpacity (1.0f);
+            g.drawImageAt (source, 5 + i * 70, 90);
+            g.setOpacity (0.5f);
+            g.drawImageAt (source, 10 + i * 70, 5);
+            g.drawImageTransformed (source, AffineTransform::rotation (0.3f).translated (30.0f + i * 60.0f, 60.0f));
+
+            g.setTiledImageFill (source, 3, 7, 0.8f);
+            g.fillRect (i * 70, 120, 65, 30);
+        }
+
+        return image;
+    }
+
+    static bool areIdentical (const Image& a, const Image& b)
+    {
+        const Image::BitmapData da (a, Image::BitmapData::readOnly);
+        const Image::BitmapData db (b, Image::BitmapData::readOnly);
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            if (memcmp (da.getLinePointer (y), db.getLinePointer (y), (size_t) (a.getWidth() * da.pixelStride)) != 0)
+                return false;
+
+        return true;
+    }
+};
+
+static PixelSpanKernelsTests pixelSpanKernelsTests;
+
+#endif
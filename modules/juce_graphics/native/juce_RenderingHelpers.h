@@ -136,7 +136,12 @@ public:
 };
 
 //==============================================================================
-/** Holds a cache of recently-used glyph objects of some type. */
+/** Holds a cache of recently-used glyph objects of some type.
+
+    The glyphs are spread across several shards, each with its own lock, hash table
+    and least-recently-used list, so that several threads can render text at once
+    without queueing up behind each other.
+*/
 template <class CachedGlyphType, class RenderTargetType>
 class GlyphCache  : private DeletedAtShutdown
 {
@@ -164,102 +169,275 @@ public:
     //==============================================================================
     void reset()
     {
-        const ScopedLock sl (lock);
-        glyphs.clear();
-        addNewGlyphSlots (120);
-        hits.set (0);
-        misses.set (0);
+        for (int i = 0; i < numShards; ++i)
+            shards[i].reset();
     }
 
     void drawGlyph (RenderTargetType& target, const Font& font, const int glyphNumber, Point<float> pos)
     {
         if (ReferenceCountedObjectPtr<CachedGlyphType> glyph = findOrCreateGlyph (font, glyphNumber))
-        {
-            glyph->lastAccessCount = ++accessCounter;
             glyph->draw (target, pos);
-        }
     }
 
+    /** Returns the lock that's held while glyphs are being generated.
+        Some typefaces load their glyph outlines lazily, so anything else that asks a typeface
+        for an outline while other threads may be rendering should hold this lock too.
+    */
+    const CriticalSection& getLock() const noexcept     { return generationLock; }
+
     ReferenceCountedObjectPtr<CachedGlyphType> findOrCreateGlyph (const Font& font, int glyphNumber)
     {
-        const ScopedLock sl (lock);
+        const uint32 hash = getHash (font, glyphNumber);
+        Shard& shard = shards [hash >> (32 - numShardBits)];
+        const ScopedLock sl (shard.lock);
 
-        if (CachedGlyphType* g = findExistingGlyph (font, glyphNumber))
+        if (Entry* e = shard.findExistingEntry (font, glyphNumber, hash))
         {
-            ++hits;
-            return g;
+            ++shard.hits;
+            ++shard.recentHits;
+            shard.moveToFront (*e);
+            return e->glyph;
         }
 
-        ++misses;
-        CachedGlyphType* g = getGlyphForReuse();
-        jassert (g != nullptr);
-        g->generate (font, glyphNumber);
-        return g;
+        ++shard.misses;
+        ++shard.recentMisses;
+        Entry& e = shard.getEntryForReuse();
+
+        {
+            const ScopedLock gl (generationLock);
+            e.glyph->generate (font, glyphNumber);
+        }
+
+        shard.addToTable (e, hash);
+        return e.glyph;
     }
 
-private:
-    friend struct ContainerDeletePolicy<CachedGlyphType>;
-    ReferenceCountedArray<CachedGlyphType> glyphs;
-    Atomic<int> accessCounter, hits, misses;
-    CriticalSection lock;
+    //==============================================================================
+    struct Statistics
+    {
+        int64 hits, misses;  /**< The number of lookups since the cache was last reset. */
+        int numGlyphs;       /**< The number of glyphs the cache currently has room for. */
+    };
 
-    CachedGlyphType* findExistingGlyph (const Font& font, int glyphNumber) const
+    Statistics getStatistics() const
     {
-        for (int i = 0; i < glyphs.size(); ++i)
+        Statistics stats = { 0, 0, 0 };
+
+        for (int i = 0; i < numShards; ++i)
         {
-            CachedGlyphType* const g = glyphs.getUnchecked (i);
+            const Shard& shard = shards[i];
+            const ScopedLock sl (shard.lock);
 
-            if (g->glyph == glyphNumber && g->font == font)
-                return g;
+            stats.hits      += shard.hits;
+            stats.misses    += shard.misses;
+            stats.numGlyphs += shard.entries.size();
         }
 
-        return nullptr;
+        return stats;
     }
 
-    CachedGlyphType* getGlyphForReuse()
+private:
+    friend struct ContainerDeletePolicy<CachedGlyphType>;
+
+    enum
     {
-        if (hits.value + misses.value > glyphs.size() * 16)
-        {
-            if (misses.value * 2 > hits.value)
-                addNewGlyphSlots (32);
+        numShardBits = 3,
+        numShards = 1 << numShardBits,
+        initialEntriesPerShard = 16,
+        entriesToAddWhenFull = 4
+    };
 
-            hits.set (0);
-            misses.set (0);
+    struct Entry
+    {
+        Entry() : glyph (new CachedGlyphType()), hash (0), nextInBucket (nullptr),
+                  previous (nullptr), next (nullptr), isInTable (false)
+        {
         }
 
-        if (CachedGlyphType* g = findLeastRecentlyUsedGlyph())
-            return g;
+        ReferenceCountedObjectPtr<CachedGlyphType> glyph;
+        uint32 hash;
+        Entry* nextInBucket;
+        Entry* previous;
+        Entry* next;
+        bool isInTable;
 
-        addNewGlyphSlots (32);
-        return glyphs.getLast();
-    }
+        JUCE_DECLARE_NON_COPYABLE (Entry)
+    };
 
-    void addNewGlyphSlots (int num)
+    struct Shard
     {
-        glyphs.ensureStorageAllocated (glyphs.size() + num);
+        Shard() : mostRecent (nullptr), leastRecent (nullptr), numBuckets (0),
+                  hits (0), misses (0), recentHits (0), recentMisses (0)
+        {
+        }
 
-        while (--num >= 0)
-            glyphs.add (new CachedGlyphType());
-    }
+        void reset()
+        {
+            const ScopedLock sl (lock);
+            entries.clear();
+            buckets.free();
+            numBuckets = 0;
+            mostRecent = leastRecent = nullptr;
+            hits = misses = 0;
+            recentHits = recentMisses = 0;
+            addNewEntries (initialEntriesPerShard);
+        }
 
-    CachedGlyphType* findLeastRecentlyUsedGlyph() const noexcept
-    {
-        CachedGlyphType* oldest = nullptr;
-        int oldestCounter = std::numeric_limits<int>::max();
+        Entry* findExistingEntry (const Font& font, int glyphNumber, uint32 hash) const noexcept
+        {
+            for (Entry* e = buckets [hash & (uint32) (numBuckets - 1)]; e != nullptr; e = e->nextInBucket)
+                if (e->hash == hash && e->glyph->glyph == glyphNumber && e->glyph->font == font)
+                    return e;
+
+            return nullptr;
+        }
+
+        Entry& getEntryForReuse()
+        {
+            if (recentHits + recentMisses > entries.size() * 16)
+            {
+                if (recentMisses * 2 > recentHits)
+                    addNewEntries (entriesToAddWhenFull);
+
+                recentHits = recentMisses = 0;
+            }
+
+            // Glyphs that are still being drawn by another thread can't be recycled yet
+            for (Entry* e = leastRecent; e != nullptr; e = e->previous)
+            {
+                if (e->glyph->getReferenceCount() == 1)
+                {
+                    removeFromTable (*e);
+                    return *e;
+                }
+            }
+
+            addNewEntries (entriesToAddWhenFull);
+            return *leastRecent;
+        }
+
+        void addToTable (Entry& e, uint32 hash) noexcept
+        {
+            jassert (! e.isInTable);
+            e.hash = hash;
+            e.isInTable = true;
+
+            Entry*& bucket = buckets [hash & (uint32) (numBuckets - 1)];
+            e.nextInBucket = bucket;
+            bucket = &e;
+
+            moveToFront (e);
+        }
+
+        void moveToFront (Entry& e) noexcept
+        {
+            if (mostRecent != &e)
+            {
+                unlink (e);
+                e.next = mostRecent;
+                mostRecent->previous = &e;
+                mostRecent = &e;
+            }
+        }
 
-        for (int i = glyphs.size() - 1; --i >= 0;)
+        CriticalSection lock;
+        OwnedArray<Entry> entries;
+        HeapBlock<Entry*> buckets;
+        Entry* mostRecent;
+        Entry* leastRecent;
+        int numBuckets;
+        int64 hits, misses;
+        int recentHits, recentMisses;
+
+    private:
+        void unlink (Entry& e) noexcept
         {
-            CachedGlyphType* const glyph = glyphs.getUnchecked(i);
+            if (e.previous != nullptr)  e.previous->next = e.next;
+            else                        mostRecent = e.next;
+
+            if (e.next != nullptr)      e.next->previous = e.previous;
+            else                        leastRecent = e.previous;
 
-            if (glyph->lastAccessCount <= oldestCounter
-                 && glyph->getReferenceCount() == 1)
+            e.previous = e.next = nullptr;
+        }
+
+        void removeFromTable (Entry& e) noexcept
+        {
+            if (e.isInTable)
             {
-                oldestCounter = glyph->lastAccessCount;
-                oldest = glyph;
+                for (Entry** p = &buckets [e.hash & (uint32) (numBuckets - 1)]; *p != nullptr; p = &((*p)->nextInBucket))
+                {
+                    if (*p == &e)
+                    {
+                        *p = e.nextInBucket;
+                        break;
+                    }
+                }
+
+                e.nextInBucket = nullptr;
+                e.isInTable = false;
             }
         }
 
-        return oldest;
+        void addNewEntries (int num)
+        {
+            while (--num >= 0)
+            {
+                // new entries go on the end of the list, so that they're the first to be used
+                Entry* const e = entries.add (new Entry());
+                e->previous = leastRecent;
+
+                if (leastRecent != nullptr)
+                    leastRecent->next = e;
+                else
+                    mostRecent = e;
+
+                leastRecent = e;
+            }
+
+            if (entries.size() > numBuckets)
+                rehash (nextPowerOfTwo (entries.size() * 2));
+        }
+
+        void rehash (int newNumBuckets)
+        {
+            numBuckets = newNumBuckets;
+            buckets.calloc ((size_t) numBuckets);
+
+            for (int i = 0; i < entries.size(); ++i)
+            {
+                Entry* const e = entries.getUnchecked (i);
+
+                if (e->isInTable)
+                {
+                    Entry*& bucket = buckets [e->hash & (uint32) (numBuckets - 1)];
+                    e->nextInBucket = bucket;
+                    bucket = e;
+                }
+            }
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (Shard)
+    };
+
+    Shard shards [numShards];
+    CriticalSection generationLock;
+
+    static uint32 getHash (const Font& font, int glyphNumber) noexcept
+    {
+        uint32 h = (uint32) font.getTypefaceName().hashCode();
+        h = h * 31 + (uint32) font.getTypefaceStyle().hashCode();
+        h = h * 31 + (uint32) roundToInt (font.getHeight() * 256.0f);
+        h = h * 31 + (uint32) roundToInt (font.getHorizontalScale() * 256.0f);
+        h = h * 31 + (uint32) glyphNumber;
+
+        // spread the bits out, as the shard is chosen from the top ones
+        h ^= h >> 16;
+        h *= 0x7feb352d;
+        h ^= h >> 15;
+        h *= 0x846ca68b;
+        h ^= h >> 16;
+        return h;
     }
 
     static GlyphCache*& getSingletonPointer() noexcept
@@ -277,7 +455,7 @@ template <class RendererType>
 class CachedGlyphEdgeTable  : public ReferenceCountedObject
 {
 public:
-    CachedGlyphEdgeTable() : glyph (0), lastAccessCount (0) {}
+    CachedGlyphEdgeTable() : glyph (0) {}
 
     void draw (RendererType& state, Point<float> pos) const
     {
@@ -303,7 +481,7 @@ public:
 
     Font font;
     ScopedPointer<EdgeTable> edgeTable;
-    int glyph, lastAccessCount;
+    int glyph;
     bool snapToIntegerCoordinate;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedGlyphEdgeTable)
@@ -463,6 +641,20 @@ namespace GradientPixelIterators
                             : lookupTable [jlimit (0, numEntries, (x * scale - start) >> (int) numScaleBits)];
         }
 
+        void getPixels (PixelARGB* dest, const int x, int num) const noexcept
+        {
+            if (vertical)
+            {
+                while (--num >= 0)
+                    *dest++ = linePix;
+            }
+            else
+            {
+                for (int position = x * scale - start; --num >= 0; position += scale)
+                    *dest++ = lookupTable [jlimit (0, numEntries, position >> (int) numScaleBits)];
+            }
+        }
+
     private:
         const PixelARGB* const lookupTable;
         const int numEntries;
@@ -509,6 +701,12 @@ namespace GradientPixelIterators
             return lookupTable [x >= maxDist ? numEntries : roundToInt (std::sqrt (x) * invScale)];
         }
 
+        void getPixels (PixelARGB* dest, int x, int num) const noexcept
+        {
+            while (--num >= 0)
+                *dest++ = getPixel (x++);
+        }
+
     protected:
         const PixelARGB* const lookupTable;
         const int numEntries;
@@ -553,6 +751,12 @@ namespace GradientPixelIterators
             return lookupTable [jmin (numEntries, roundToInt (std::sqrt (x) * invScale))];
         }
 
+        void getPixels (PixelARGB* dest, int x, int num) const noexcept
+        {
+            while (--num >= 0)
+                *dest++ = getPixel (x++);
+        }
+
     private:
         double tM10, tM00, lineYM01, lineYM11;
         const AffineTransform inverseTransform;
@@ -561,6 +765,55 @@ namespace GradientPixelIterators
     };
 }
 
+//==============================================================================
+/** Blends whole runs of pixels at once, using SSE2/AVX2 or NEON where the CPU
+    supports them.
+
+    Every function here produces exactly the same result as calling the equivalent
+    set() or blend() method of the pixel classes on each pixel in turn. The pixels
+    must be tightly packed, i.e. for images whose pixelStride is the same as the size
+    of the pixel type. The extraAlpha parameters are the same as for the pixel classes'
+    blend (src, extraAlpha) methods, and must be 255 or less.
+
+    The fastest implementation available is chosen the first time one is used.
+*/
+struct JUCE_API PixelSpanKernels
+{
+    static void fill  (PixelARGB* dest, PixelARGB colour, int numPixels) noexcept;
+
+    static void blend (PixelARGB* dest, PixelARGB colour, int numPixels) noexcept;
+    static void blend (PixelRGB* dest, PixelARGB colour, int numPixels) noexcept;
+    static void blend (PixelAlpha* dest, PixelARGB colour, int numPixels) noexcept;
+
+    static void blend (PixelARGB* dest, const PixelARGB* src, int numPixels) noexcept;
+    static void blend (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    static void blend (PixelRGB* dest, const PixelARGB* src, int numPixels) noexcept;
+    static void blend (PixelRGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    static void blend (PixelAlpha* dest, const PixelARGB* src, int numPixels) noexcept;
+    static void blend (PixelAlpha* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    static void blend (PixelRGB* dest, const PixelRGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    static void blend (PixelAlpha* dest, const PixelAlpha* src, int numPixels) noexcept;
+    static void blend (PixelAlpha* dest, const PixelAlpha* src, int numPixels, uint32 extraAlpha) noexcept;
+
+    /** The remaining format combinations are rarely used, so just loop over the pixels. */
+    template <class DestPixelType, class SrcPixelType>
+    static void blend (DestPixelType* dest, const SrcPixelType* src, int numPixels) noexcept
+    {
+        while (--numPixels >= 0)
+            (dest++)->blend (*src++);
+    }
+
+    template <class DestPixelType, class SrcPixelType>
+    static void blend (DestPixelType* dest, const SrcPixelType* src, int numPixels, uint32 extraAlpha) noexcept
+    {
+        while (--numPixels >= 0)
+            (dest++)->blend (*src++, extraAlpha);
+    }
+
+    /** Returns the name of the implementation in use, e.g. "SSE2" or "AVX2". */
+    static const char* getImplementationName() noexcept;
+};
+
 #define JUCE_PERFORM_PIXEL_OP_LOOP(op) \
 { \
     const int destStride = destData.pixelStride;  \
@@ -652,7 +905,10 @@ namespace EdgeTableFillers
 
         inline void blendLine (PixelType* dest, const PixelARGB colour, int width) const noexcept
         {
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
+            if (destData.pixelStride == sizeof (PixelType))
+                PixelSpanKernels::blend (dest, colour, width);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
         }
 
         forcedinline void replaceLine (PixelRGB* dest, const PixelARGB colour, int width) const noexcept
@@ -710,7 +966,10 @@ namespace EdgeTableFillers
 
         forcedinline void replaceLine (PixelARGB* dest, const PixelARGB colour, int width) const noexcept
         {
-            JUCE_PERFORM_PIXEL_OP_LOOP (set (colour))
+            if (destData.pixelStride == sizeof (*dest))
+                PixelSpanKernels::fill (dest, colour, width);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (set (colour))
         }
 
         JUCE_DECLARE_NON_COPYABLE (SolidColour)
@@ -749,7 +1008,9 @@ namespace EdgeTableFillers
         {
             PixelType* dest = getPixel (x);
 
-            if (alphaLevel < 0xff)
+            if (destData.pixelStride == sizeof (PixelType))
+                blendInChunks (dest, x, width, alphaLevel);
+            else if (alphaLevel < 0xff)
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
             else
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
@@ -758,13 +1019,39 @@ namespace EdgeTableFillers
         void handleEdgeTableLineFull (int x, int width) const noexcept
         {
             PixelType* dest = getPixel (x);
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+
+            if (destData.pixelStride == sizeof (PixelType))
+                blendInChunks (dest, x, width, 0xff);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
         }
 
     private:
         const Image::BitmapData& destData;
         PixelType* linePixels;
 
+        // The gradient colours are looked up into a small buffer, which can then be blended in one go
+        void blendInChunks (PixelType* dest, int x, int width, const int alphaLevel) const noexcept
+        {
+            PixelARGB chunk [64];
+
+            while (width > 0)
+            {
+                const int num = jmin (width, (int) numElementsInArray (chunk));
+
+                GradientType::getPixels (chunk, x, num);
+
+                if (alphaLevel < 0xff)
+                    PixelSpanKernels::blend (dest, chunk, num, (uint32) alphaLevel);
+                else
+                    PixelSpanKernels::blend (dest, chunk, num);
+
+                dest += num;
+                x += num;
+                width -= num;
+            }
+        }
+
         forcedinline PixelType* getPixel (const int x) const noexcept
         {
             return addBytesToPointer (linePixels, x * destData.pixelStride);
@@ -823,7 +1110,9 @@ namespace EdgeTableFillers
 
             if (repeatPattern)
             {
-                if (alphaLevel < 0xfe)
+                if (canBlendRepeatedRuns())
+                    blendRepeatedRuns (dest, x, width, alphaLevel);
+                else if (alphaLevel < 0xfe)
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) alphaLevel))
                 else
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width)))
@@ -832,10 +1121,12 @@ namespace EdgeTableFillers
             {
                 jassert (x >= 0 && x + width <= srcData.width);
 
-                if (alphaLevel < 0xfe)
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) alphaLevel))
-                else
+                if (alphaLevel >= 0xfe)
                     copyRow (dest, getSrcPixel (x), width);
+                else if (arePixelsPacked())
+                    PixelSpanKernels::blend (dest, getSrcPixel (x), width, (uint32) alphaLevel);
+                else
+                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) alphaLevel))
             }
         }
 
@@ -846,7 +1137,9 @@ namespace EdgeTableFillers
 
             if (repeatPattern)
             {
-                if (extraAlpha < 0xfe)
+                if (canBlendRepeatedRuns())
+                    blendRepeatedRuns (dest, x, width, extraAlpha);
+                else if (extraAlpha < 0xfe)
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) extraAlpha))
                 else
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width)))
@@ -855,10 +1148,12 @@ namespace EdgeTableFillers
             {
                 jassert (x >= 0 && x + width <= srcData.width);
 
-                if (extraAlpha < 0xfe)
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) extraAlpha))
-                else
+                if (extraAlpha >= 0xfe)
                     copyRow (dest, getSrcPixel (x), width);
+                else if (arePixelsPacked())
+                    PixelSpanKernels::blend (dest, getSrcPixel (x), width, (uint32) extraAlpha);
+                else
+                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) extraAlpha))
             }
         }
 
@@ -902,6 +1197,10 @@ namespace EdgeTableFillers
             {
                 memcpy (dest, src, (size_t) (width * srcStride));
             }
+            else if (arePixelsPacked())
+            {
+                PixelSpanKernels::blend (dest, src, width);
+            }
             else
             {
                 do
@@ -913,6 +1212,36 @@ namespace EdgeTableFillers
             }
         }
 
+        forcedinline bool arePixelsPacked() const noexcept
+        {
+            return destData.pixelStride == sizeof (DestPixelType)
+                    && srcData.pixelStride == sizeof (SrcPixelType);
+        }
+
+        // For very narrow tiles, it's quicker to just loop over the pixels
+        forcedinline bool canBlendRepeatedRuns() const noexcept
+        {
+            return arePixelsPacked() && srcData.width >= 16;
+        }
+
+        void blendRepeatedRuns (DestPixelType* dest, int x, int width, const int alphaLevel) const noexcept
+        {
+            while (width > 0)
+            {
+                const int srcX = x % srcData.width;
+                const int num = jmin (width, srcData.width - srcX);
+
+                if (alphaLevel < 0xfe)
+                    PixelSpanKernels::blend (dest, getSrcPixel (srcX), num, (uint32) alphaLevel);
+                else
+                    PixelSpanKernels::blend (dest, getSrcPixel (srcX), num);
+
+                dest += num;
+                x += num;
+                width -= num;
+            }
+        }
+
         JUCE_DECLARE_NON_COPYABLE (ImageFill)
     };
 
@@ -975,10 +1304,21 @@ namespace EdgeTableFillers
             alphaLevel *= extraAlpha;
             alphaLevel >>= 8;
 
-            if (alphaLevel < 0xfe)
+            if (destData.pixelStride == sizeof (DestPixelType))
+            {
+                if (alphaLevel < 0xfe)
+                    PixelSpanKernels::blend (dest, span, width, (uint32) alphaLevel);
+                else
+                    PixelSpanKernels::blend (dest, span, width);
+            }
+            else if (alphaLevel < 0xfe)
+            {
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++, (uint32) alphaLevel))
+            }
             else
+            {
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++))
+            }
         }
 
         forcedinline void handleEdgeTableLineFull (const int x, int width) noexcept
@@ -1588,6 +1928,15 @@ struct ClipRegions
         EdgeTableRegion (const RectangleList<int>& r)   : edgeTable (r) {}
         EdgeTableRegion (const RectangleList<float>& r) : edgeTable (r) {}
         EdgeTableRegion (const Rectangle<int>& bounds, const Path& p, const AffineTransform& t) : edgeTable (bounds, p, t) {}
+
+        EdgeTableRegion (const Rectangle<int>& bounds, const Point<float>* points, int numPoints,
+                         float lineThickness, const AffineTransform& t)
+            : edgeTable (bounds, points, numPoints, lineThickness, t) {}
+
+        EdgeTableRegion (const Rectangle<int>& bounds, float x, float columnWidth,
+                         const Range<float>* spans, int numSpans, const AffineTransform& t)
+            : edgeTable (bounds, x, columnWidth, spans, numSpans, t) {}
+
         EdgeTableRegion (const EdgeTableRegion& other)  : Base(), edgeTable (other.edgeTable) {}
 
         typedef typename Base::Ptr Ptr;
@@ -2301,6 +2650,20 @@ public:
         fillPath (p, AffineTransform());
     }
 
+    void drawPolyline (const Point<float>* points, int numPoints, float lineThickness)
+    {
+        if (clip != nullptr)
+            fillShape (new EdgeTableRegionType (clip->getClipBounds(), points, numPoints,
+                                                lineThickness, transform.getTransform()), false);
+    }
+
+    void fillVerticalSpans (float x, float columnWidth, const Range<float>* spans, int numSpans)
+    {
+        if (clip != nullptr)
+            fillShape (new EdgeTableRegionType (clip->getClipBounds(), x, columnWidth,
+                                                spans, numSpans, transform.getTransform()), false);
+    }
+
     void drawImage (const Image& sourceImage, const AffineTransform& trans)
     {
         if (clip != nullptr && ! fillType.colour.isTransparent())
@@ -2517,7 +2880,12 @@ public:
                 AffineTransform t (transform.getTransformWith (AffineTransform::scale (fontHeight * font.getHorizontalScale(), fontHeight)
                                                                                .followedBy (trans)));
 
-                const ScopedPointer<EdgeTable> et (font.getTypeface()->getEdgeTableForGlyph (glyphNumber, t, fontHeight));
+                ScopedPointer<EdgeTable> et;
+
+                {
+                    const ScopedLock sl (GlyphCacheType::getInstance().getLock());
+                    et = font.getTypeface()->getEdgeTableForGlyph (glyphNumber, t, fontHeight);
+                }
 
                 if (et != nullptr)
                     fillShape (new EdgeTableRegionType (*et), false);
@@ -2670,6 +3038,8 @@ public:
     void drawImage (const Image& im, const AffineTransform& t) override          { stack->drawImage (im, t); }
     void drawGlyph (int glyphNumber, const AffineTransform& t) override          { stack->drawGlyph (glyphNumber, t); }
     void drawLine (const Line<float>& line) override                             { stack->drawLine (line); }
+    void drawPolyline (const Point<float>* points, int num, float thickness) override  { stack->drawPolyline (points, num, thickness); }
+    void fillVerticalSpans (float x, float w, const Range<float>* spans, int num) override  { stack->fillVerticalSpans (x, w, spans, num); }
     void setFont (const Font& newFont) override                                  { stack->font = newFont; }
     const Font& getFont() override                                               { return stack->font; }
 
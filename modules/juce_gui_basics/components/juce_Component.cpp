@@ -847,11 +847,12 @@ void Component::setBufferedToImage (const bool shouldBeBuffered)
     // so by calling setBufferedToImage, you'll be deleting the custom one - this is almost certainly
     // not what you wanted to happen... If you really do know what you're doing here, and want to
     // avoid this assertion, just call setCachedComponentImage (nullptr) before setBufferedToImage().
-    jassert (cachedImage == nullptr || dynamic_cast<StandardCachedComponentImage*> (cachedImage.get()) != nullptr);
+    jassert (cachedImage == nullptr || dynamic_cast<StandardCachedComponentImage*> (cachedImage.get()) != nullptr
+              || ComponentRenderCache::isAutomaticCachedImage (cachedImage));
 
     if (shouldBeBuffered)
     {
-        if (cachedImage == nullptr)
+        if (cachedImage == nullptr || ComponentRenderCache::isAutomaticCachedImage (cachedImage))
             cachedImage = new StandardCachedComponentImage (*this);
     }
     else
@@ -1956,6 +1957,10 @@ void Component::paintWithinParentContext (Graphics& g)
 {
     g.setOrigin (getPosition());
 
+    // (components that can paint outside their bounds can't be buffered automatically)
+    if (cachedImage == nullptr && ! flags.dontClipGraphicsFlag && ComponentRenderCache::isEnabled())
+        cachedImage = ComponentRenderCache::createAutomaticCachedImage (*this);
+
     if (cachedImage != nullptr)
         cachedImage->paint (g);
     else
@@ -2006,20 +2011,28 @@ void Component::paintComponentAndChildren (Graphics& g)
                 }
                 else if (g.reduceClipRegion (child.getBounds()))
                 {
-                    bool nothingClipped = true;
+                    bool nothingClipped = true, isCompletelyHidden = false;
 
                     for (int j = i + 1; j < childComponentList.size(); ++j)
                     {
                         const Component& sibling = *childComponentList.getUnchecked (j);
 
-                        if (sibling.flags.opaqueFlag && sibling.isVisible() && sibling.affineTransform == nullptr)
+                        if (sibling.flags.opaqueFlag && sibling.componentTransparency == 0
+                             && sibling.isVisible() && sibling.affineTransform == nullptr
+                             && sibling.getBounds().intersects (child.getBounds()))
                         {
+                            if (sibling.getBounds().contains (child.getBounds()))
+                            {
+                                isCompletelyHidden = true;
+                                break;
+                            }
+
                             nothingClipped = false;
                             g.excludeClipRegion (sibling.getBounds());
                         }
                     }
 
-                    if (nothingClipped || ! g.isClipEmpty())
+                    if (! isCompletelyHidden && (nothingClipped || ! g.isClipEmpty()))
                         child.paintWithinParentContext (g);
                 }
 
@@ -2035,6 +2048,8 @@ void Component::paintComponentAndChildren (Graphics& g)
 
 void Component::paintEntireComponent (Graphics& g, const bool ignoreAlphaLevel)
 {
+    JUCE_TRACE_SCOPE_IN ("gui", "Component::paintEntireComponent");
+
     // If sizing a top-level-window and the OS paint message is delivered synchronously
     // before resized() is called, then we'll invoke the callback here, to make sure
     // the components inside have had a chance to sort their sizes out..
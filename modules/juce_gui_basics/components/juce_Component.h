@@ -987,7 +987,10 @@ public:
         Parts of the buffer are invalidated when repaint() is called on this component
         or its children. The buffer is then repainted at the next paint() callback.
 
-        @see repaint, paint, createComponentSnapshot
+        To have buffers chosen automatically for components that are slow to paint,
+        see ComponentRenderCache.
+
+        @see repaint, paint, createComponentSnapshot, ComponentRenderCache
     */
     void setBufferedToImage (bool shouldBeBuffered);
 
@@ -0,0 +1,550 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+static bool isComponentRenderCacheEnabled = false;
+
+struct ComponentRenderCache::Pimpl  : private DeletedAtShutdown
+{
+    Pimpl()
+        : memoryBudget (64 * 1024 * 1024), numBytesUsed (0), paintCounter (0),
+          numHits (0), numPartialHits (0), numMisses (0), numUnbufferedPaints (0)
+    {
+    }
+
+    ~Pimpl()
+    {
+        clearSingletonInstance();
+    }
+
+    // Makes room for a buffer of the given size, releasing the least recently drawn
+    // buffers if necessary. Returns false if it won't fit into the budget at all.
+    bool setBufferSize (AutomaticCachedImage& image, size_t newNumBytes);
+    bool releaseLeastRecentlyUsedBuffer (const AutomaticCachedImage* imageToKeep);
+    void removeBuffer (AutomaticCachedImage& image);
+    void releaseAll();
+
+    Array<AutomaticCachedImage*> bufferedImages;
+    size_t memoryBudget, numBytesUsed;
+    int64 paintCounter;
+    int64 numHits, numPartialHits, numMisses, numUnbufferedPaints;
+    CriticalSection lock;
+
+    juce_DeclareSingleton_SingleThreaded_Minimal (ComponentRenderCache::Pimpl)
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+juce_ImplementSingleton_SingleThreaded (ComponentRenderCache::Pimpl)
+
+//==============================================================================
+class ComponentRenderCache::AutomaticCachedImage  : public CachedComponentImage
+{
+public:
+    AutomaticCachedImage (Component& c) noexcept
+        : owner (c), averagePaintTime (0), unchangedProportion (0), invalidatedPixels (0),
+          lastPaintIndex (0), numBytes (0), hasBeenPainted (false)
+    {
+    }
+
+    ~AutomaticCachedImage()
+    {
+        releaseBuffer();
+    }
+
+    void paint (Graphics& g) override
+    {
+        Pimpl& pimpl = *Pimpl::getInstance();
+        const Rectangle<int> bounds (owner.getLocalBounds());
+        const int numPixels = bounds.getWidth() * bounds.getHeight();
+
+        // This keeps a running average of how much of the component was still valid each
+        // time it got painted, which is the proportion of it that a buffer would have saved.
+        const double proportionUnchanged = hasBeenPainted ? 1.0 - jmin (1.0, invalidatedPixels / (double) jmax (1, numPixels))
+                                                          : 0.0;
+        unchangedProportion += (proportionUnchanged - unchangedProportion) * 0.25;
+        invalidatedPixels = 0;
+        hasBeenPainted = true;
+
+        bool isNewBuffer = false;
+
+        if (! isComponentRenderCacheEnabled || unchangedProportion < minProportionToKeepBuffer)
+        {
+            releaseBuffer();
+        }
+        else if (buffer == nullptr && unchangedProportion >= minProportionToCreateBuffer && isWorthBuffering (numPixels))
+        {
+            buffer = new StandardCachedComponentImage (owner);
+            isNewBuffer = true;
+        }
+
+        if (buffer != nullptr)
+        {
+            const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+            if (! pimpl.setBufferSize (*this, (size_t) (numPixels * scale * scale) * 4))
+                releaseBuffer();
+        }
+
+        if (buffer != nullptr)
+        {
+            {
+                const ScopedLock sl (pimpl.lock);
+                lastPaintIndex = ++pimpl.paintCounter;
+
+                if (isNewBuffer || proportionUnchanged <= 0)  ++pimpl.numMisses;
+                else if (proportionUnchanged < 1.0)           ++pimpl.numPartialHits;
+                else                                          ++pimpl.numHits;
+            }
+
+            buffer->paint (g);
+        }
+        else
+        {
+            const int64 startTime = Time::getHighResolutionTicks();
+            owner.paintEntireComponent (g, false);
+            const double paintTime = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTime);
+
+            averagePaintTime = averagePaintTime > 0 ? averagePaintTime + (paintTime - averagePaintTime) * 0.25
+                                                    : paintTime;
+
+            const ScopedLock sl (pimpl.lock);
+            ++pimpl.numUnbufferedPaints;
+        }
+    }
+
+    bool invalidateAll() override
+    {
+        invalidatedPixels = owner.getWidth() * owner.getHeight();
+
+        if (buffer != nullptr)
+            buffer->invalidateAll();
+
+        return true;
+    }
+
+    bool invalidate (const Rectangle<int>& area) override
+    {
+        // (a component that isn't being painted can be repainted any number of times, so
+        // this can't be allowed to count more than the whole area)
+        const Rectangle<int> invalidArea (area.getIntersection (owner.getLocalBounds()));
+        invalidatedPixels = jmin (owner.getWidth() * owner.getHeight(),
+                                  invalidatedPixels + invalidArea.getWidth() * invalidArea.getHeight());
+
+        if (buffer != nullptr)
+            buffer->invalidate (area);
+
+        return true;
+    }
+
+    void releaseResources() override
+    {
+        releaseBuffer();
+    }
+
+    void releaseBuffer()
+    {
+        if (buffer != nullptr)
+        {
+            buffer = nullptr;
+
+            if (Pimpl* const pimpl = Pimpl::getInstanceWithoutCreating())
+                pimpl->removeBuffer (*this);
+        }
+    }
+
+    Component& owner;
+    double averagePaintTime, unchangedProportion;
+    int invalidatedPixels;
+    int64 lastPaintIndex;
+    size_t numBytes;
+    bool hasBeenPainted;
+
+private:
+    ScopedPointer<StandardCachedComponentImage> buffer;
+
+    // A buffer is only created for a component that takes a good deal longer to paint than
+    // it would take to draw the buffer. Drawing an image costs roughly a nanosecond per pixel,
+    // so the component has to take at least four times that, and at least 0.1ms.
+    bool isWorthBuffering (int numPixels) const noexcept
+    {
+        return averagePaintTime > jmax (0.1e-3, numPixels * 4.0e-9);
+    }
+
+    static const double minProportionToCreateBuffer, minProportionToKeepBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomaticCachedImage)
+};
+
+const double ComponentRenderCache::AutomaticCachedImage::minProportionToCreateBuffer = 0.5;
+const double ComponentRenderCache::AutomaticCachedImage::minProportionToKeepBuffer = 0.25;
+
+//==============================================================================
+bool ComponentRenderCache::Pimpl::setBufferSize (AutomaticCachedImage& image, size_t newNumBytes)
+{
+    const ScopedLock sl (lock);
+
+    numBytesUsed -= image.numBytes;
+    image.numBytes = 0;
+
+    // (no single buffer is allowed to take up more than a quarter of the budget)
+    if (newNumBytes > memoryBudget / 4)
+        return false;
+
+    while (numBytesUsed + newNumBytes > memoryBudget)
+        if (! releaseLeastRecentlyUsedBuffer (&image))
+            return false;
+
+    numBytesUsed += newNumBytes;
+    image.numBytes = newNumBytes;
+    bufferedImages.addIfNotAlreadyThere (&image);
+    return true;
+}
+
+bool ComponentRenderCache::Pimpl::releaseLeastRecentlyUsedBuffer (const AutomaticCachedImage* imageToKeep)
+{
+    const ScopedLock sl (lock);
+    AutomaticCachedImage* oldest = nullptr;
+
+    for (int i = bufferedImages.size(); --i >= 0;)
+    {
+        AutomaticCachedImage* const image = bufferedImages.getUnchecked (i);
+
+        if (image != imageToKeep && (oldest == nullptr || image->lastPaintIndex < oldest->lastPaintIndex))
+            oldest = image;
+    }
+
+    if (oldest == nullptr)
+        return false;
+
+    oldest->releaseBuffer();
+    return true;
+}
+
+void ComponentRenderCache::Pimpl::removeBuffer (AutomaticCachedImage& image)
+{
+    const ScopedLock sl (lock);
+
+    numBytesUsed -= image.numBytes;
+    image.numBytes = 0;
+    bufferedImages.removeFirstMatchingValue (&image);
+}
+
+void ComponentRenderCache::Pimpl::releaseAll()
+{
+    const ScopedLock sl (lock);
+
+    while (bufferedImages.size() > 0)
+        bufferedImages.getLast()->releaseBuffer();
+}
+
+//==============================================================================
+void ComponentRenderCache::setEnabled (const bool shouldBeEnabled)
+{
+    isComponentRenderCacheEnabled = shouldBeEnabled;
+
+    if (! shouldBeEnabled)
+        releaseAll();
+}
+
+bool ComponentRenderCache::isEnabled() noexcept
+{
+    return isComponentRenderCacheEnabled;
+}
+
+void ComponentRenderCache::setMemoryBudget (const size_t maxNumBytes)
+{
+    Pimpl& pimpl = *Pimpl::getInstance();
+    const ScopedLock sl (pimpl.lock);
+
+    pimpl.memoryBudget = maxNumBytes;
+
+    while (pimpl.numBytesUsed > maxNumBytes)
+        if (! pimpl.releaseLeastRecentlyUsedBuffer (nullptr))
+            break;
+}
+
+size_t ComponentRenderCache::getMemoryBudget() noexcept
+{
+    return Pimpl::getInstance()->memoryBudget;
+}
+
+static const Identifier& getRenderCacheDisallowedProperty()
+{
+    static const Identifier id ("juce_renderCacheDisallowed");
+    return id;
+}
+
+void ComponentRenderCache::setAllowedForComponent (Component& component, const bool shouldBeAllowed)
+{
+    if (shouldBeAllowed)
+    {
+        component.getProperties().remove (getRenderCacheDisallowedProperty());
+    }
+    else
+    {
+        component.getProperties().set (getRenderCacheDisallowedProperty(), true);
+
+        if (isAutomaticCachedImage (component.getCachedComponentImage()))
+            component.setCachedComponentImage (nullptr);
+    }
+}
+
+void ComponentRenderCache::releaseAll()
+{
+    if (Pimpl* const pimpl = Pimpl::getInstanceWithoutCreating())
+        pimpl->releaseAll();
+}
+
+ComponentRenderCache::Statistics ComponentRenderCache::getStatistics()
+{
+    Pimpl& pimpl = *Pimpl::getInstance();
+    const ScopedLock sl (pimpl.lock);
+
+    Statistics stats;
+    stats.numHits = pimpl.numHits;
+    stats.numPartialHits = pimpl.numPartialHits;
+    stats.numMisses = pimpl.numMisses;
+    stats.numUnbufferedPaints = pimpl.numUnbufferedPaints;
+    stats.numBufferedComponents = pimpl.bufferedImages.size();
+    stats.numBytesUsed = pimpl.numBytesUsed;
+    return stats;
+}
+
+void ComponentRenderCache::resetStatistics()
+{
+    Pimpl& pimpl = *Pimpl::getInstance();
+    const ScopedLock sl (pimpl.lock);
+
+    pimpl.numHits = pimpl.numPartialHits = pimpl.numMisses = pimpl.numUnbufferedPaints = 0;
+}
+
+double ComponentRenderCache::Statistics::getHitRate() const noexcept
+{
+    const int64 total = numHits + numPartialHits + numMisses + numUnbufferedPaints;
+    return total > 0 ? (numHits + numPartialHits) / (double) total : 0.0;
+}
+
+CachedComponentImage* ComponentRenderCache::createAutomaticCachedImage (Component& component)
+{
+    if (component.getProperties().contains (getRenderCacheDisallowedProperty()))
+        return nullptr;
+
+    return new AutomaticCachedImage (component);
+}
+
+bool ComponentRenderCache::isAutomaticCachedImage (const CachedComponentImage* image) noexcept
+{
+    return dynamic_cast<const AutomaticCachedImage*> (image) != nullptr;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+#if JUCE_LINUX
+ extern ::Display* display;
+#endif
+
+class ComponentRenderCacheTests  : public UnitTest
+{
+public:
+    ComponentRenderCacheTests() : UnitTest ("ComponentRenderCache") {}
+
+    // An opaque component that takes a millisecond to paint
+    struct SlowComponent  : public Component
+    {
+        SlowComponent()  : numPaints (0)    { setOpaque (true); }
+
+        void paint (Graphics& g) override
+        {
+            ++numPaints;
+
+            const int64 endTime = Time::getHighResolutionTicks() + Time::secondsToHighResolutionTicks (0.001);
+
+            while (Time::getHighResolutionTicks() < endTime)
+            {}
+
+            g.fillAll (Colours::darkblue);
+            g.setColour (Colours::orange);
+            g.fillEllipse (getLocalBounds().reduced (20).toFloat());
+            g.drawLine (0.0f, 0.0f, (float) getWidth(), (float) getHeight(), 3.0f);
+        }
+
+        int numPaints;
+    };
+
+    static Image render (Component& c)
+    {
+        Image image (Image::ARGB, c.getWidth(), c.getHeight(), true);
+        Graphics g (image);
+        c.paintEntireComponent (g, false);
+        return image;
+    }
+
+    static int getMaxDifference (const Image& image1, const Image& image2)
+    {
+        int maxDifference = 0;
+
+        for (int y = 0; y < image1.getHeight(); ++y)
+        {
+            for (int x = 0; x < image1.getWidth(); ++x)
+            {
+                const Colour c1 (image1.getPixelAt (x, y)), c2 (image2.getPixelAt (x, y));
+
+                maxDifference = jmax (maxDifference,
+                                      jmax (std::abs (c1.getRed() - c2.getRed()), std::abs (c1.getGreen() - c2.getGreen())),
+                                      jmax (std::abs (c1.getBlue() - c2.getBlue()), std::abs (c1.getAlpha() - c2.getAlpha())));
+            }
+        }
+
+        return maxDifference;
+    }
+
+    void expectStatistics (int64 numHits, int64 numPartialHits, int64 numMisses, int64 numUnbufferedPaints)
+    {
+        const ComponentRenderCache::Statistics stats (ComponentRenderCache::getStatistics());
+        expectEquals (stats.numHits, numHits);
+        expectEquals (stats.numPartialHits, numPartialHits);
+        expectEquals (stats.numMisses, numMisses);
+        expectEquals (stats.numUnbufferedPaints, numUnbufferedPaints);
+    }
+
+    void runTest() override
+    {
+       #if JUCE_LINUX
+        // (showing a component needs the Desktop, which can't be created without an X display)
+        if (display == nullptr)
+        {
+            logMessage ("Skipping the ComponentRenderCache tests, as there's no display");
+            return;
+        }
+       #endif
+
+        Component parent;
+        SlowComponent child;
+        parent.setBounds (0, 0, 400, 300);
+        child.setBounds (50, 50, 300, 200);
+        parent.addAndMakeVisible (child);
+
+        const Image unbuffered (render (parent));
+
+        ComponentRenderCache::setEnabled (true);
+        ComponentRenderCache::resetStatistics();
+
+        beginTest ("A slow component that doesn't change gets buffered");
+        {
+            // it takes a few paints for the running average to show that the component isn't changing
+            for (int i = 0; i < 3; ++i)
+                render (parent);
+
+            expectEquals (child.numPaints, 4);
+            expectEquals (ComponentRenderCache::getStatistics().numBufferedComponents, 0);
+            expectStatistics (0, 0, 0, 3);
+
+            render (parent);
+            expectEquals (ComponentRenderCache::getStatistics().numBufferedComponents, 1);
+            expect (ComponentRenderCache::getStatistics().numBytesUsed == (size_t) (300 * 200 * 4));
+            expectStatistics (0, 0, 1, 3);
+
+            Image buffered;
+
+            for (int i = 0; i < 3; ++i)
+                buffered = render (parent);
+
+            expectEquals (child.numPaints, 5);
+            expectStatistics (3, 0, 1, 3);
+            expectEquals (getMaxDifference (buffered, unbuffered), 0);
+        }
+
+        beginTest ("Repainting part of it gives a partial hit");
+        {
+            // (the line crosses the edge of this area, and when it's redrawn with a clip, the
+            // pixels along that edge can be anti-aliased a tiny bit differently)
+            child.repaint (10, 10, 20, 20);
+            expect (getMaxDifference (render (parent), unbuffered) <= 2);
+            expectEquals (child.numPaints, 6);
+            expectStatistics (3, 1, 1, 3);
+        }
+
+        beginTest ("The buffer is dropped when the component keeps changing");
+        {
+            for (int i = 0; i < 10 && ComponentRenderCache::getStatistics().numBufferedComponents > 0; ++i)
+            {
+                child.repaint();
+                render (parent);
+            }
+
+            expectEquals (ComponentRenderCache::getStatistics().numBufferedComponents, 0);
+            expect (ComponentRenderCache::getStatistics().numBytesUsed == 0);
+        }
+
+        beginTest ("Repeated repaints without a paint only count the component's area once");
+        {
+            for (int i = 0; i < 10 && ComponentRenderCache::getStatistics().numBufferedComponents == 0; ++i)
+                render (parent);
+
+            expectEquals (ComponentRenderCache::getStatistics().numBufferedComponents, 1);
+
+            // e.g. if the parent was hidden, this would be enough to overflow the total
+            for (int i = 0; i < 40000; ++i)
+                child.repaint (0, 0, 300, 200);
+
+            const ComponentRenderCache::Statistics before (ComponentRenderCache::getStatistics());
+            render (parent);
+            const ComponentRenderCache::Statistics after (ComponentRenderCache::getStatistics());
+
+            expect (after.numHits == before.numHits && after.numPartialHits == before.numPartialHits);
+            expect (after.numMisses == before.numMisses + 1);
+        }
+
+        beginTest ("Buffers are released when the budget shrinks");
+        {
+            const size_t originalBudget = ComponentRenderCache::getMemoryBudget();
+
+            for (int i = 0; i < 10; ++i)
+                render (parent);
+
+            expectEquals (ComponentRenderCache::getStatistics().numBufferedComponents, 1);
+
+            ComponentRenderCache::setMemoryBudget (100000);
+            expectEquals (ComponentRenderCache::getStatistics().numBufferedComponents, 0);
+            expect (ComponentRenderCache::getStatistics().numBytesUsed == 0);
+
+            // and it's too big to fit into the smaller budget now
+            const int numPaints = child.numPaints;
+            render (parent);
+            expectEquals (child.numPaints, numPaints + 1);
+            expectEquals (ComponentRenderCache::getStatistics().numBufferedComponents, 0);
+
+            ComponentRenderCache::setMemoryBudget (originalBudget);
+        }
+
+        ComponentRenderCache::setEnabled (false);
+        ComponentRenderCache::resetStatistics();
+    }
+};
+
+static ComponentRenderCacheTests componentRenderCacheTests;
+
+#endif
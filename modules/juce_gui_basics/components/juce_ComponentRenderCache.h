@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_COMPONENTRENDERCACHE_H_INCLUDED
+#define JUCE_COMPONENTRENDERCACHE_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Automatically buffers components to images when that's likely to speed up painting.
+
+    When this is enabled, the time that each component takes to paint itself and its
+    children is measured, along with how much of it gets repainted between one paint
+    and the next. Components that are expensive to draw but which mostly stay the same
+    are then buffered in the same way as Component::setBufferedToImage() would do, so
+    only the areas that get repainted have to be redrawn. If a component starts changing
+    too much for its buffer to be useful, the buffer gets thrown away again.
+
+    All the buffers share a memory budget, and when it runs out, the ones that were
+    drawn least recently are released.
+
+    Only components that don't already have a CachedComponentImage get buffered
+    automatically, so this won't interfere with setBufferedToImage(), or with things
+    like an OpenGLContext that use their own cached image.
+
+    This is disabled by default, because a buffered component will only be redrawn when
+    it (or one of its children) gets repainted - any components that rely on being redrawn
+    as a side-effect of their parents being repainted will need to call repaint() themselves,
+    or be excluded with setAllowedForComponent().
+
+    @see Component::setBufferedToImage, CachedComponentImage
+*/
+class JUCE_API  ComponentRenderCache
+{
+public:
+    //==============================================================================
+    /** Turns automatic buffering on or off.
+        Turning it off releases all the buffers that it had created.
+    */
+    static void setEnabled (bool shouldBeEnabled);
+
+    /** Returns true if automatic buffering is turned on. */
+    static bool isEnabled() noexcept;
+
+    /** Sets the maximum number of bytes that all the buffers can use between them.
+        By default this is 64MB.
+    */
+    static void setMemoryBudget (size_t maxNumBytes);
+
+    /** Returns the maximum number of bytes that the buffers can use.
+        @see setMemoryBudget
+    */
+    static size_t getMemoryBudget() noexcept;
+
+    /** Allows or prevents a particular component from being buffered automatically.
+        By default, all components are allowed.
+    */
+    static void setAllowedForComponent (Component& component, bool shouldBeAllowed);
+
+    /** Releases all the buffers that have been created. */
+    static void releaseAll();
+
+    //==============================================================================
+    /** Some statistics about how well the buffers are working.
+        @see getStatistics
+    */
+    struct JUCE_API  Statistics
+    {
+        /** The number of paints that were drawn entirely from a buffer. */
+        int64 numHits;
+        /** The number of paints where part of a buffer had to be redrawn. */
+        int64 numPartialHits;
+        /** The number of paints where a whole buffer had to be redrawn. */
+        int64 numMisses;
+        /** The number of paints of components that weren't buffered. */
+        int64 numUnbufferedPaints;
+
+        /** The number of components that currently have a buffer. */
+        int numBufferedComponents;
+        /** The total size of the current buffers. */
+        size_t numBytesUsed;
+
+        /** Returns the proportion of paints that used a buffer, from 0 to 1. */
+        double getHitRate() const noexcept;
+    };
+
+    /** Returns the statistics that have been gathered since the last call to resetStatistics(). */
+    static Statistics getStatistics();
+
+    /** Resets the paint counts returned by getStatistics(). */
+    static void resetStatistics();
+
+private:
+    //==============================================================================
+    class AutomaticCachedImage;
+    struct Pimpl;
+    friend class Component;
+    friend class AutomaticCachedImage;
+
+    static CachedComponentImage* createAutomaticCachedImage (Component&);
+    static bool isAutomaticCachedImage (const CachedComponentImage*) noexcept;
+
+    ComponentRenderCache();
+
+    JUCE_DECLARE_NON_COPYABLE (ComponentRenderCache)
+};
+
+
+#endif   // JUCE_COMPONENTRENDERCACHE_H_INCLUDED
@@ -143,6 +143,7 @@ namespace juce
 extern bool juce_areThereAnyAlwaysOnTopWindows();
 
 #include "components/juce_Component.cpp"
+#include "components/juce_ComponentRenderCache.cpp"
 #include "components/juce_ComponentListener.cpp"
 #include "mouse/juce_MouseInputSource.cpp"
 #include "components/juce_Desktop.cpp"
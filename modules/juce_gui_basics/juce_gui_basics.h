@@ -58,8 +58,9 @@
 //==============================================================================
 /** Config: JUCE_ENABLE_REPAINT_DEBUGGING
     If this option is turned on, each area of the screen that gets repainted will
-    flash in a random colour, so that you can see exactly which bits of your
-    components are being drawn.
+    flash in a colour, so that you can see exactly which bits of your components
+    are being drawn. The colour goes from green to red depending on how long the
+    repaint took, and the time is written in the top-left corner of each area.
 */
 #ifndef JUCE_ENABLE_REPAINT_DEBUGGING
  #define JUCE_ENABLE_REPAINT_DEBUGGING 0
@@ -167,6 +168,7 @@ class FlexBox;
 #include "components/juce_ComponentListener.h"
 #include "components/juce_CachedComponentImage.h"
 #include "components/juce_Component.h"
+#include "components/juce_ComponentRenderCache.h"
 #include "layout/juce_ComponentAnimator.h"
 #include "components/juce_Desktop.h"
 #include "layout/juce_ComponentBoundsConstrainer.h"
@@ -785,6 +785,8 @@ public:
         // scale factor
         Point<int> topLeftScaled;
         double dpi, scale;
+        // The display's refresh rate in Hz, or 0 if it's not known
+        double refreshRate;
         bool isMain;
     };
 
@@ -1158,6 +1160,28 @@ private:
         return round (info.dpi / 150.0);
     }
 
+   #if JUCE_USE_XRANDR
+    static double getRefreshRate (const XRRScreenResources& resources, RRMode mode) noexcept
+    {
+        for (int i = 0; i < resources.nmode; ++i)
+        {
+            const XRRModeInfo& info = resources.modes[i];
+
+            if (info.id == mode && info.hTotal > 0 && info.vTotal > 0)
+            {
+                double rate = info.dotClock / ((double) info.hTotal * (double) info.vTotal);
+
+                if ((info.modeFlags & RR_DoubleScan) != 0)  rate *= 0.5;
+                if ((info.modeFlags & RR_Interlace) != 0)   rate *= 2.0;
+
+                return rate;
+            }
+        }
+
+        return 0.0;
+    }
+   #endif
+
     //==============================================================================
     void queryDisplayInfos (::Display* dpy, double masterScale) noexcept
     {
@@ -1208,6 +1232,7 @@ private:
                                     e.topLeftScaled = e.totalBounds.getTopLeft();
                                     e.isMain = (mainDisplay == screens->outputs[j]) && (i == 0);
                                     e.dpi = getDisplayDPI (0);
+                                    e.refreshRate = getRefreshRate (*screens, crtc->mode);
 
                                     // The raspberry pi returns a zero sized display, so we need to guard for divide-by-zero
                                     if (output->mm_width > 0 && output->mm_height > 0)
@@ -1250,6 +1275,7 @@ private:
                         e.isMain = (index == 0);
                         e.scale = masterScale;
                         e.dpi = getDisplayDPI (0); // (all screens share the same DPI)
+                        e.refreshRate = 0.0;
 
                         infos.add (e);
                     }
@@ -1282,6 +1308,7 @@ private:
                         e.isMain = (infos.size() == 0);
                         e.scale = masterScale;
                         e.dpi = getDisplayDPI (i);
+                        e.refreshRate = 0.0;
 
                         infos.add (e);
                     }
@@ -1298,6 +1325,7 @@ private:
                 e.isMain = true;
                 e.scale = masterScale;
                 e.dpi = getDisplayDPI (0);
+                e.refreshRate = 0.0;
 
                 infos.add (e);
             }
@@ -1491,7 +1519,7 @@ public:
           fullScreen (false), mapped (false),
           visual (nullptr), depth (0),
           isAlwaysOnTop (comp.isAlwaysOnTop()),
-          currentScaleFactor (1.0)
+          currentScaleFactor (1.0), currentRefreshRate (0.0)
     {
         // it's dangerous to create a window on a thread other than the message thread..
         jassert (MessageManager::getInstance()->currentThreadHasLockedMessageManager());
@@ -1619,7 +1647,9 @@ public:
             bounds = newBounds.withSize (jmax (1, newBounds.getWidth()),
                                          jmax (1, newBounds.getHeight()));
 
-            currentScaleFactor = DisplayGeometry::getInstance().findDisplayForRect (bounds, true).scale;
+            const DisplayGeometry::ExtendedInfo& displayInfo = DisplayGeometry::getInstance().findDisplayForRect (bounds, true);
+            currentScaleFactor = displayInfo.scale;
+            currentRefreshRate = displayInfo.refreshRate;
 
             Rectangle<int> physicalBounds =
                 DisplayGeometry::scaledToPhysical (bounds);
@@ -2534,7 +2564,7 @@ private:
     {
     public:
         LinuxRepaintManager (LinuxComponentPeer& p)
-            : peer (p), lastTimeImageUsed (0)
+            : peer (p), lastTimeImageUsed (0), lastFrameTime (0)
         {
            #if JUCE_USE_XSHM
             shmPaintsPending = 0;
@@ -2565,6 +2595,14 @@ private:
 
             if (! regionsNeedingRepaint.isEmpty())
             {
+                const int msUntilNextFrame = getMillisecondsUntilNextFrame();
+
+                if (msUntilNextFrame > 0)
+                {
+                    startTimer (msUntilNextFrame);
+                    return;
+                }
+
                 stopTimer();
                 performAnyPendingRepaintsNow();
             }
@@ -2573,12 +2611,16 @@ private:
                 stopTimer();
                 image = Image();
             }
+            else if (getTimerInterval() != roundToInt (getFramePeriod()))
+            {
+                startTimer (roundToInt (getFramePeriod()));
+            }
         }
 
         void repaint (const Rectangle<int>& area)
         {
             if (! isTimerRunning())
-                startTimer (repaintTimerPeriod);
+                startTimer (jmax (1, getMillisecondsUntilNextFrame()));
 
             regionsNeedingRepaint.add (area * peer.currentScaleFactor);
         }
@@ -2588,7 +2630,7 @@ private:
            #if JUCE_USE_XSHM
             if (shmPaintsPending != 0)
             {
-                startTimer (repaintTimerPeriod);
+                startTimer (jmax (1, getMillisecondsUntilNextFrame()));
                 return;
             }
            #endif
@@ -2599,6 +2641,13 @@ private:
 
             if (! totalArea.isEmpty())
             {
+                lastFrameTime = Time::getMillisecondCounterHiRes();
+
+                // Every separate rectangle costs another blit, and makes the clip region more complex
+                // for everything that gets painted, so rectangles that are close to each other are merged
+                // whenever the extra pixels that this paints will cost less than the rectangle that's saved.
+                originalRepaintRegion.coalesce (maxRectangles, costPerRectangle);
+
                 if (image.isNull() || image.getWidth() < totalArea.getWidth()
                      || image.getHeight() < totalArea.getHeight())
                 {
@@ -2613,8 +2662,6 @@ private:
                                                      false, (unsigned int) peer.depth, peer.visual));
                 }
 
-                startTimer (repaintTimerPeriod);
-
                 RectangleList<int> adjustedList (originalRepaintRegion);
                 adjustedList.offsetAll (-totalArea.getX(), -totalArea.getY());
 
@@ -2647,7 +2694,7 @@ private:
             }
 
             lastTimeImageUsed = Time::getApproximateMillisecondCounter();
-            startTimer (repaintTimerPeriod);
+            startTimer (jmax (1, getMillisecondsUntilNextFrame()));
         }
 
        #if JUCE_USE_XSHM
@@ -2655,13 +2702,33 @@ private:
        #endif
 
     private:
-        enum { repaintTimerPeriod = 1000 / 100 };
+        enum
+        {
+            defaultFramePeriod = 1000 / 100,
+            costPerRectangle = 64 * 64,
+            maxRectangles = 16
+        };
 
         LinuxComponentPeer& peer;
         Image image;
         uint32 lastTimeImageUsed;
+        double lastFrameTime;
         RectangleList<int> regionsNeedingRepaint;
 
+        // Repaints are paced to match the refresh rate of the display that the window is on, so
+        // that no time is wasted painting frames that will never be seen. (X doesn't tell us
+        // when the vertical blank happens, so this can only match its rate, not its phase).
+        double getFramePeriod() const noexcept
+        {
+            const double rate = peer.currentRefreshRate;
+            return (rate >= 20.0 && rate <= 500.0) ? 1000.0 / rate : (double) defaultFramePeriod;
+        }
+
+        int getMillisecondsUntilNextFrame() const noexcept
+        {
+            return roundToInt (lastFrameTime + getFramePeriod() - Time::getMillisecondCounterHiRes());
+        }
+
        #if JUCE_USE_XSHM
         bool useARGBImagesForRendering;
         int shmPaintsPending;
@@ -2681,7 +2748,7 @@ private:
     int depth;
     BorderSize<int> windowBorder;
     bool isAlwaysOnTop;
-    double currentScaleFactor;
+    double currentScaleFactor, currentRefreshRate;
     Array<Component*> glRepaintListeners;
     enum { KeyPressEventType = 2 };
 
@@ -3109,8 +3176,9 @@ private:
 
             Rectangle<int> physicalBounds (wx, wy, (int) ww, (int) wh);
 
-            currentScaleFactor =
-                DisplayGeometry::getInstance().findDisplayForRect (physicalBounds, false).scale;
+            const DisplayGeometry::ExtendedInfo& displayInfo = DisplayGeometry::getInstance().findDisplayForRect (physicalBounds, false);
+            currentScaleFactor = displayInfo.scale;
+            currentRefreshRate = displayInfo.refreshRate;
 
             bounds = DisplayGeometry::physicalToScaled (physicalBounds);
         }
@@ -127,6 +127,8 @@ void ComponentPeer::handlePaint (LowLevelGraphicsContext& contextToPaintTo)
     {
         g.saveState();
     }
+
+    const double paintStartTime = Time::getMillisecondCounterHiRes();
   #endif
 
     JUCE_TRY
@@ -141,15 +143,22 @@ void ComponentPeer::handlePaint (LowLevelGraphicsContext& contextToPaintTo)
    #endif
     {
         // enabling this code will fill all areas that get repainted with a colour overlay, to show
-        // clearly when things are being repainted.
+        // clearly when things are being repainted. The overlay's hue goes from green to red as the
+        // time taken to paint goes up to a 60Hz frame, and its brightness is random, so that each
+        // repaint flashes.
+        const double paintTime = Time::getMillisecondCounterHiRes() - paintStartTime;
+
         g.restoreState();
 
         static Random rng;
 
-        g.fillAll (Colour ((uint8) rng.nextInt (255),
-                           (uint8) rng.nextInt (255),
-                           (uint8) rng.nextInt (255),
-                           (uint8) 0x50));
+        g.fillAll (Colour ((float) (0.33 * (1.0 - jmin (1.0, paintTime / 16.7))),
+                           1.0f, 0.5f + 0.5f * rng.nextFloat(), (uint8) 0x50));
+
+        g.setColour (Colours::black);
+        g.setFont (10.0f);
+        g.drawText (String (paintTime, 1) + " ms", g.getClipBounds().removeFromTop (12).reduced (2, 0),
+                    Justification::centredLeft, false);
     }
   #endif
 
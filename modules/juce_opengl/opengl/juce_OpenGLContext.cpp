@@ -647,7 +647,7 @@ private:
 
     static bool isAttached (const Component& comp) noexcept
     {
-        return comp.getCachedComponentImage() != nullptr;
+        return dynamic_cast<CachedImage*> (comp.getCachedComponentImage()) != nullptr;
     }
 
     void attach()